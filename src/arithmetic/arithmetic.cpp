@@ -0,0 +1,143 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file arithmetic.cpp
+    Constructor and destructor for Arithmetic class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <iostream>
+#include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "arithmetic.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Friends
+//  -----------------------------------------------------------------
+
+
+/*!
+     Overloaded << operator defined as a friend of Arithmetic for debugging purposes.
+
+     \param[in] os Output stream
+     \param[in] ac Arithmetic passed as reference
+     \return Output stream
+*/
+ostream &operator<< (ostream &os, const Arithmetic& ac) {
+  os << "II\tArithmetic:  " << ac.m_MessageLength << " symbols; " << ac.m_DistinctSymbols << " distinct; " << ac.m_Bytes.size () << " bytes";
+
+  return os;
+}
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Default constructor that takes one optional argument.
+
+     \param[in] debug Set to true if in debug mode; false by default
+*/
+Arithmetic::Arithmetic (bool debug)
+  : m_Debug (debug),
+    m_MessageLength (0),
+    m_MessageLengthDecoded (0),
+    m_MaximumSymbol (0),
+    m_DistinctSymbols (0),
+    m_FrequencyBits (0),
+    m_Frequency (),
+    m_Cumulative (),
+    m_Lookup (),
+    m_Low (0),
+    m_Range (0xFFFFFFFF),
+    m_Code (0),
+    m_Step (0),
+    m_Cache (0),
+    m_CacheSize (1),
+    m_Bytes (),
+    m_BytesNext (0)
+{
+  //  Symbol 0 is never used
+  m_Frequency.push_back (0);
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+Arithmetic::~Arithmetic () {
+}
+
+
+//  -----------------------------------------------------------------
+//  Accessors and mutators
+//  -----------------------------------------------------------------
+
+/*!
+     Return m_Debug
+
+     \return Debug mode or not
+*/
+bool Arithmetic::GetDebug () const {
+  return m_Debug;
+}
+
+
+/*!
+     Set m_Debug to true
+*/
+void Arithmetic::SetDebug () {
+  m_Debug = true;
+}
+
+
+/*!
+     Return m_MessageLength
+
+     \return Length of the encoded message (same as "one/current" block)
+*/
+unsigned int Arithmetic::GetMessageLength () const {
+  return m_MessageLength;
+}
+
+
+/*!
+     Return m_DistinctSymbols
+
+     \return Number of distinct symbols in the message (set by EncodeBegin () or DecodeBegin ())
+*/
+unsigned int Arithmetic::GetDistinctSymbols () const {
+  return m_DistinctSymbols;
+}
+
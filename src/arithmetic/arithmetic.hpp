@@ -0,0 +1,347 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file arithmetic.hpp
+    Header file for Arithmetic class.
+*/
+/*******************************************************************/
+
+#ifndef ARITHMETIC_HPP
+#define ARITHMETIC_HPP
+
+/*!
+     Maximum number of bits in the total of the scaled frequencies; each symbol which appears is given
+     a frequency of at least 1 out of 2 to the power of this
+*/
+const unsigned int g_ARITHMETIC_FREQUENCY_BITS = 12;
+
+/*!
+     The range is renormalized (shifted left by a byte) whenever it is less than this
+*/
+const unsigned int g_ARITHMETIC_RANGE_TOP = (1U << 24);
+
+/*!
+     Number of bytes that the encoder writes to flush low (and that the decoder reads to start)
+*/
+const unsigned int g_ARITHMETIC_FLUSH_BYTES = 5;
+
+/*!
+     Amount added to the frequency of a symbol in a context of ArithmeticContext each time that it occurs
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_INCREMENT = 16;
+
+/*!
+     The frequencies of a context of ArithmeticContext are halved when their total is more than this;
+     it is small enough for them to be kept in 16 bits
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_LIMIT = ((1U << 16) - 1) - g_ARITHMETIC_CONTEXT_INCREMENT;
+
+/*!
+     Number of classes of the previous quality score in a context of ArithmeticContext; larger symbols
+     are scaled down to fit
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_Q1 = 64;
+
+/*!
+     Number of classes of the quality score before the previous one (compared to the previous one)
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_Q2 = 3;
+
+/*!
+     Number of buckets of read positions; each is g_ARITHMETIC_CONTEXT_POSITION_WIDTH positions wide, except
+     the last which goes to the end of the read
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_POSITIONS = 4;
+
+/*!
+     Width of each bucket of read positions
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_POSITION_WIDTH = 32;
+
+/*!
+     Number of buckets of the mean of the quality scores read so far in the read
+*/
+const unsigned int g_ARITHMETIC_CONTEXT_MEANS = 4;
+
+
+/*!
+    \class Arithmetic
+
+    \details Class used to represent arithmetic coding with a static model.  It is a range coder
+    in the style of the one in LZMA:  the interval is kept in a 32-bit range and a 64-bit low, and
+    whenever the range falls below g_ARITHMETIC_RANGE_TOP, a byte is shifted out of low.  A carry
+    out of low is propagated into the bytes which have been held back (m_Cache and m_CacheSize), so
+    the output never has to be revised.  As with Huffman coding, we assume symbols are 1-based.
+
+    The frequencies of the symbols are counted for the whole message and then scaled so that they
+    sum to a power of 2 (m_FrequencyBits), which is at most g_ARITHMETIC_FREQUENCY_BITS and no more
+    than is needed for the length of the message.  So, the scaled frequencies of a short message are
+    small, as is its prelude.  A symbol is coded with a shift, a
+    multiplication and (when decoding) a division and a table lookup.  Unlike Huffman coding, a
+    symbol can be coded in less than 1 bit, which matters when one symbol is very frequent (e.g.,
+    after quality scores are binned).
+
+    The bytes of the range coder are kept in memory and appended to the BitBuffer by
+    EncodeFinish (), after their number.  The decoder reads them into memory in DecodeBegin ().
+    So, the coder is byte-oriented and never calls the BitBuffer for each symbol.
+
+    See the test driver in testing.cpp for example usage.  For encoding, do the following:
+
+    1)  Initialize the BitBuffer.
+    2)  Create an Arithmetic object.
+    3)  foreach vector, run UpdateFrequencies () to accumulate the frequencies.
+    4)  Scale the frequencies and output the prelude using EncodeBegin ().
+    5)  foreach vector, run EncodeMessage ().
+    6)  Finalize using EncodeFinish ().
+
+    For decoding:
+
+    1)  Initialize the BitBuffer.
+    2)  Create an Arithmetic object.
+    3)  Decode the prelude with DecodeBegin ().
+    4)  Decode a block of symbols using DecodeMessage ().
+    5)  Finalize using DecodeFinish ().
+*/
+class Arithmetic {
+  //  Friend function to print out statistics for debugging  [arithmetic.cpp]
+  friend ostream &operator<< (ostream &os, const Arithmetic& ac);
+  //  Adaptive coding, which codes the symbols with the frequencies of a context  [context.cpp]
+  friend class ArithmeticContext;
+
+  public:
+    //  Constructors/destructors  [arithmetic.cpp]
+    Arithmetic (bool debug=false);
+    ~Arithmetic ();
+    bool GetDebug () const;
+    void SetDebug ();
+    unsigned int GetMessageLength () const;
+    unsigned int GetDistinctSymbols () const;
+
+    //  Encoding functions  [encode.cpp]
+    void EncodeBegin (BitBuffer &bitbuffer);
+    void EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x);
+    void EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len);
+    void EncodeFinish (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [decode.cpp]
+    void DecodeBegin (BitBuffer &bitbuffer);
+    vector<unsigned int> DecodeMessage (BitBuffer &bitbuffer, unsigned int len);
+    void DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x);
+    void DecodeFinish (BitBuffer &bitbuffer);
+
+    //  Main processing functions  [process.cpp]
+    void UpdateFrequencies (const vector<unsigned int> &x);
+    void UpdateFrequencies (const unsigned int *x, unsigned int len);
+  private:
+    //  Encoding functions  [encode.cpp; EncodeRange () is at the end of this file]
+    void EncodePrelude (BitBuffer &bitbuffer);
+    void EncodeRange (unsigned int start, unsigned int size, unsigned int total);
+    void ShiftLow ();
+    void WriteBytes (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [decode.cpp; DecodeTarget (), DecodeRange () and NextByte () are at the end of this file]
+    void DecodePrelude (BitBuffer &bitbuffer);
+    void SetLookupTable ();
+    unsigned int DecodeTarget (unsigned int total);
+    void DecodeRange (unsigned int start, unsigned int size);
+    unsigned int NextByte ();
+    void ReadBytes (BitBuffer &bitbuffer);
+
+    //  Main processing functions  [process.cpp]
+    void ScaleFrequencies ();
+    void SetCumulativeFrequencies ();
+
+    //!  Debug mode?
+    bool m_Debug;
+    //!  Length of the message (i.e., number of symbols to encode/decode)
+    unsigned int m_MessageLength;
+    //!  Length of the message already decoded (must be <= m_MessageLength); not used for encoding
+    unsigned int m_MessageLengthDecoded;
+    //!  Maximum possible symbol
+    unsigned int m_MaximumSymbol;
+    //!  Number of distinct values
+    unsigned int m_DistinctSymbols;
+    //!  Number of bits in the total of the scaled frequencies
+    unsigned int m_FrequencyBits;
+
+    //!  For each symbol, its frequency; after EncodeBegin () or DecodeBegin (), its scaled frequency
+    vector<unsigned int> m_Frequency;
+    //!  For each symbol, the sum of the scaled frequencies of the symbols before it
+    vector<unsigned int> m_Cumulative;
+    //!  For each value of the sum of scaled frequencies, the symbol whose interval it is in (set by DecodeBegin ())
+    vector<unsigned int> m_Lookup;
+
+    //!  The lower end of the interval; bits above the lowest 32 are a carry
+    unsigned long long m_Low;
+    //!  The width of the interval
+    unsigned int m_Range;
+    //!  The position in the interval that was encoded (only used for decoding)
+    unsigned int m_Code;
+    //!  The width of the interval divided by the total of the frequencies (set by DecodeTarget ())
+    unsigned int m_Step;
+    //!  The byte held back from the output in case a carry is added to it
+    unsigned char m_Cache;
+    //!  Number of bytes held back (m_Cache followed by bytes of 0xFF)
+    unsigned long long m_CacheSize;
+    //!  The bytes of the range coder
+    vector<unsigned char> m_Bytes;
+    //!  Position of the next byte of m_Bytes to read (only used for decoding)
+    unsigned int m_BytesNext;
+};
+
+
+
+/*!
+    \class ArithmeticContext
+
+    \details Class used to represent adaptive arithmetic coding of quality scores, where each symbol
+    is coded with the frequencies of its context.  The context is made from the previous quality score,
+    how the one before it compares to it, the bucket of the read position and the bucket of the mean of
+    the quality scores so far in the read.  Each message is one read, so the context starts again with
+    each of them.
+
+    The frequencies start at 1 for every symbol up to the maximum one and are updated after each
+    symbol, so the encoder and decoder change them in the same way.  So, no frequencies are sent and
+    the symbols are encoded as they are given, with no pass over them beforehand; only the maximum
+    symbol is written before them.  The range coding and the bytes that it writes are those of an
+    Arithmetic object.
+
+    Each context keeps its symbols with their 16-bit frequencies side by side, roughly in order of
+    decreasing frequency, so that the search for a symbol is usually short and touches one or two
+    cache lines.  A context is only set up when it is first used, so unused contexts cost nothing.
+
+    Symbols can be at most g_MAX_ASCII.  For encoding, call EncodeBegin () with the maximum symbol,
+    EncodeMessage () for each read and EncodeFinish ().  For decoding, call DecodeBegin (),
+    DecodeMessage () with the length of each read in the same order, and DecodeFinish ().
+*/
+class ArithmeticContext {
+  public:
+    //  Constructors/destructors  [context.cpp]
+    ArithmeticContext (bool debug=false);
+    ~ArithmeticContext ();
+    bool GetDebug () const;
+    unsigned int GetMaximumSymbol () const;
+
+    //  Encoding functions  [context.cpp]
+    void EncodeBegin (BitBuffer &bitbuffer, unsigned int maximum_symbol);
+    void EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len);
+    void EncodeFinish (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [context.cpp]
+    void DecodeBegin (BitBuffer &bitbuffer);
+    void DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x);
+    void DecodeFinish (BitBuffer &bitbuffer);
+  private:
+    void SetContexts (unsigned int maximum_symbol);
+    unsigned int GetContext (unsigned int q1, unsigned int q2, unsigned int position, unsigned int sum) const;
+    unsigned short *GetContextEntries (unsigned int context);
+    void UpdateContext (unsigned int context, unsigned short *entries, unsigned int k);
+
+    //!  Debug mode?
+    bool m_Debug;
+    //!  Maximum symbol
+    unsigned int m_MaximumSymbol;
+    //!  The range coder
+    Arithmetic m_Coder;
+    //!  Number of contexts
+    unsigned int m_NumContexts;
+    //!  For each context, its symbols and their frequencies, one after the other (m_MaximumSymbol pairs each); set up when the context is first used
+    unsigned short *m_Entries;
+    //!  For each context, the total of its frequencies; 0 if it has not been used yet
+    vector<unsigned int> m_Total;
+};
+
+
+//  -----------------------------------------------------------------
+//  Inline functions
+//  -----------------------------------------------------------------
+
+/*!
+     Encode the interval [start, start + size) out of total.  Unlike EncodeMessage (), the total does not
+     have to be a power of 2.  It is defined here so that it can be inlined into ArithmeticContext.
+
+     \param[in] start The sum of the frequencies of the symbols before this one
+     \param[in] size The frequency of this symbol
+     \param[in] total The total of the frequencies; at most 2 to the power of 16
+*/
+inline void Arithmetic::EncodeRange (unsigned int start, unsigned int size, unsigned int total) {
+  unsigned int r = m_Range / total;
+  m_Low += static_cast<unsigned long long> (start) * r;
+  m_Range = r * size;
+  while (m_Range < g_ARITHMETIC_RANGE_TOP) {
+    m_Range <<= g_CHAR_SIZE_BITS;
+    ShiftLow ();
+  }
+
+  return;
+}
+
+
+/*!
+     Return the next byte of the range coder; 0 after the last one.
+
+     \return The next byte
+*/
+inline unsigned int Arithmetic::NextByte () {
+  unsigned int x = (m_BytesNext < m_Bytes.size ()) ? m_Bytes[m_BytesNext] : 0;
+  m_BytesNext++;
+
+  return x;
+}
+
+
+/*!
+     Find where the next symbol is out of total; DecodeRange () must then be called with the interval of
+     the symbol that this is in.
+
+     \param[in] total The total of the frequencies; at most 2 to the power of 16
+     \return A value from 0 to total - 1
+*/
+inline unsigned int Arithmetic::DecodeTarget (unsigned int total) {
+  m_Step = m_Range / total;
+  unsigned int value = m_Code / m_Step;
+
+  return ((value < total) ? value : total - 1);
+}
+
+
+/*!
+     Remove the interval [start, start + size) of the symbol found with DecodeTarget ().
+
+     \param[in] start The sum of the frequencies of the symbols before this one
+     \param[in] size The frequency of this symbol
+*/
+inline void Arithmetic::DecodeRange (unsigned int start, unsigned int size) {
+  m_Code -= start * m_Step;
+  m_Range = m_Step * size;
+  while (m_Range < g_ARITHMETIC_RANGE_TOP) {
+    m_Code = (m_Code << g_CHAR_SIZE_BITS) | NextByte ();
+    m_Range <<= g_CHAR_SIZE_BITS;
+  }
+
+  return;
+}
+
+#endif
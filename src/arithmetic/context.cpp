@@ -0,0 +1,332 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file context.cpp
+    Member functions for ArithmeticContext class definition (adaptive arithmetic coding).
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <iostream>
+#include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+#include <algorithm>  //  min, swap
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "arithmetic.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Default constructor that takes one optional argument.
+
+     \param[in] debug Set to true if in debug mode; false by default
+*/
+ArithmeticContext::ArithmeticContext (bool debug)
+  : m_Debug (debug),
+    m_MaximumSymbol (0),
+    m_Coder (debug),
+    m_NumContexts (0),
+    m_Entries (NULL),
+    m_Total ()
+{
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+ArithmeticContext::~ArithmeticContext () {
+  delete [] m_Entries;
+}
+
+
+//  -----------------------------------------------------------------
+//  Accessors and mutators
+//  -----------------------------------------------------------------
+
+/*!
+     Return m_Debug
+
+     \return Debug mode or not
+*/
+bool ArithmeticContext::GetDebug () const {
+  return m_Debug;
+}
+
+
+/*!
+     Return m_MaximumSymbol
+
+     \return The maximum symbol (set by EncodeBegin () or DecodeBegin ())
+*/
+unsigned int ArithmeticContext::GetMaximumSymbol () const {
+  return m_MaximumSymbol;
+}
+
+
+//  -----------------------------------------------------------------
+//  Encoding functions
+//  -----------------------------------------------------------------
+
+/*!
+     Write the maximum symbol and set up the contexts in preparation for encoding.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] maximum_symbol The maximum symbol that will be encoded
+*/
+void ArithmeticContext::EncodeBegin (BitBuffer &bitbuffer, unsigned int maximum_symbol) {
+  Delta_Encode (bitbuffer, maximum_symbol);
+  SetContexts (maximum_symbol);
+
+  return;
+}
+
+
+/*!
+     Encode a message (i.e., one read); its first symbol has no previous ones.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols of the message
+     \param[in] len The number of symbols in x
+*/
+void ArithmeticContext::EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len) {
+  unsigned int q1 = 0;
+  unsigned int q2 = 0;
+  unsigned int sum = 0;
+
+  for (unsigned int i = 0; i < len; i++) {
+    if ((x[i] == 0) || (x[i] > m_MaximumSymbol)) {
+      cerr << "EE\tThe symbol " << x[i] << " cannot be coded by ArithmeticContext, whose maximum symbol is " << m_MaximumSymbol << "." << endl;
+      exit (EXIT_FAILURE);
+    }
+
+    unsigned int context = GetContext (q1, q2, i, sum);
+    unsigned short *entries = GetContextEntries (context);
+
+    //  Find the symbol and the sum of the frequencies before it
+    unsigned int start = 0;
+    unsigned int k = 0;
+    while (entries[2 * k] != x[i]) {
+      start += entries[(2 * k) + 1];
+      k++;
+    }
+
+    m_Coder.EncodeRange (start, entries[(2 * k) + 1], m_Total[context]);
+    UpdateContext (context, entries, k);
+
+    q2 = q1;
+    q1 = x[i];
+    sum += x[i];
+  }
+
+  return;
+}
+
+
+/*!
+     Finish encoding by writing the bytes of the range coder.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void ArithmeticContext::EncodeFinish (BitBuffer &bitbuffer) {
+  m_Coder.WriteBytes (bitbuffer);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Decoding functions
+//  -----------------------------------------------------------------
+
+/*!
+     Read the maximum symbol and the bytes of the range coder in preparation for decoding.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void ArithmeticContext::DecodeBegin (BitBuffer &bitbuffer) {
+  SetContexts (Delta_Decode (bitbuffer));
+  m_Coder.ReadBytes (bitbuffer);
+
+  return;
+}
+
+
+/*!
+     Decode a message (i.e., one read) and append it to a vector.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len The number of symbols in the message
+     \param[out] x The vector to append the message to
+*/
+void ArithmeticContext::DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x) {
+  unsigned int q1 = 0;
+  unsigned int q2 = 0;
+  unsigned int sum = 0;
+
+  for (unsigned int i = 0; i < len; i++) {
+    unsigned int context = GetContext (q1, q2, i, sum);
+    unsigned short *entries = GetContextEntries (context);
+
+    //  Find the symbol whose interval has the target in it
+    unsigned int target = m_Coder.DecodeTarget (m_Total[context]);
+    unsigned int start = 0;
+    unsigned int k = 0;
+    while (start + entries[(2 * k) + 1] <= target) {
+      start += entries[(2 * k) + 1];
+      k++;
+    }
+
+    m_Coder.DecodeRange (start, entries[(2 * k) + 1]);
+    unsigned int symbol = entries[2 * k];
+    UpdateContext (context, entries, k);
+    x.push_back (symbol);
+
+    q2 = q1;
+    q1 = symbol;
+    sum += symbol;
+  }
+
+  return;
+}
+
+
+/*!
+     Finish decoding.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void ArithmeticContext::DecodeFinish (BitBuffer &bitbuffer) {
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Allocate the contexts for the maximum symbol.  Their entries are not initialized until they are
+     used (see GetContextEntries ()).
+
+     \param[in] maximum_symbol The maximum symbol
+*/
+void ArithmeticContext::SetContexts (unsigned int maximum_symbol) {
+  if ((maximum_symbol == 0) || (maximum_symbol > g_MAX_ASCII)) {
+    cerr << "EE\tThe maximum symbol of ArithmeticContext must be from 1 to " << g_MAX_ASCII << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  m_MaximumSymbol = maximum_symbol;
+  m_NumContexts = min (m_MaximumSymbol + 1, g_ARITHMETIC_CONTEXT_Q1) * g_ARITHMETIC_CONTEXT_Q2 * g_ARITHMETIC_CONTEXT_POSITIONS * g_ARITHMETIC_CONTEXT_MEANS;
+
+  delete [] m_Entries;
+  m_Entries = new unsigned short [static_cast<size_t> (m_NumContexts) * m_MaximumSymbol * 2];
+  m_Total.assign (m_NumContexts, 0);
+
+  return;
+}
+
+
+/*!
+     Return the context of a symbol.  The previous quality score is scaled down if there are more than
+     g_ARITHMETIC_CONTEXT_Q1 of them; the one before it only adds whether it is the same, smaller or
+     larger.  The mean of the quality scores so far is bucketed evenly from 0 to the maximum symbol.
+
+     \param[in] q1 The previous symbol in the message; 0 if there is none
+     \param[in] q2 The symbol before q1; 0 if there is none
+     \param[in] position The position of the symbol in the message
+     \param[in] sum The sum of the symbols before it in the message
+     \return The context
+*/
+unsigned int ArithmeticContext::GetContext (unsigned int q1, unsigned int q2, unsigned int position, unsigned int sum) const {
+  unsigned int c1 = (m_MaximumSymbol < g_ARITHMETIC_CONTEXT_Q1) ? q1 : ((q1 * g_ARITHMETIC_CONTEXT_Q1) / (m_MaximumSymbol + 1));
+  unsigned int c2 = (q2 == q1) ? 0 : ((q2 < q1) ? 1 : 2);
+  unsigned int cp = min (position / g_ARITHMETIC_CONTEXT_POSITION_WIDTH, g_ARITHMETIC_CONTEXT_POSITIONS - 1);
+  unsigned int cm = (position == 0) ? 0 : (((sum / position) * g_ARITHMETIC_CONTEXT_MEANS) / (m_MaximumSymbol + 1));
+
+  return ((((((c1 * g_ARITHMETIC_CONTEXT_Q2) + c2) * g_ARITHMETIC_CONTEXT_POSITIONS) + cp) * g_ARITHMETIC_CONTEXT_MEANS) + cm);
+}
+
+
+/*!
+     Return the entries of a context, giving each symbol a frequency of 1 if it has not been used yet.
+
+     \param[in] context The context
+     \return Its symbols and their frequencies
+*/
+unsigned short *ArithmeticContext::GetContextEntries (unsigned int context) {
+  unsigned short *entries = m_Entries + (static_cast<size_t> (context) * m_MaximumSymbol * 2);
+
+  if (m_Total[context] == 0) {
+    for (unsigned int k = 0; k < m_MaximumSymbol; k++) {
+      entries[2 * k] = static_cast<unsigned short> (k + 1);
+      entries[(2 * k) + 1] = 1;
+    }
+    m_Total[context] = m_MaximumSymbol;
+  }
+
+  return entries;
+}
+
+
+/*!
+     Add to the frequency of a symbol which has been coded.  It is moved ahead of the symbol before it if
+     it is now more frequent, and the frequencies are halved if their total becomes too large.
+
+     \param[in] context The context
+     \param[in] entries Its symbols and their frequencies
+     \param[in] k The position of the symbol in entries
+*/
+void ArithmeticContext::UpdateContext (unsigned int context, unsigned short *entries, unsigned int k) {
+  entries[(2 * k) + 1] += g_ARITHMETIC_CONTEXT_INCREMENT;
+  m_Total[context] += g_ARITHMETIC_CONTEXT_INCREMENT;
+
+  if ((k > 0) && (entries[(2 * k) + 1] > entries[(2 * k) - 1])) {
+    swap (entries[2 * k], entries[(2 * k) - 2]);
+    swap (entries[(2 * k) + 1], entries[(2 * k) - 1]);
+  }
+
+  if (m_Total[context] > g_ARITHMETIC_CONTEXT_LIMIT) {
+    m_Total[context] = 0;
+    for (unsigned int j = 0; j < m_MaximumSymbol; j++) {
+      entries[(2 * j) + 1] = static_cast<unsigned short> ((entries[(2 * j) + 1] + 1) / 2);
+      m_Total[context] += entries[(2 * j) + 1];
+    }
+  }
+
+  return;
+}
+
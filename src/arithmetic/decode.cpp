@@ -0,0 +1,216 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file decode.cpp
+    Decoding functions for Arithmetic coding class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <iostream>
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "interpolative.hpp"
+#include "arithmetic.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+/*!
+     Decode the prelude and read the bytes of the range coder into memory in preparation for decoding.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Arithmetic::DecodeBegin (BitBuffer &bitbuffer) {
+  DecodePrelude (bitbuffer);
+  SetCumulativeFrequencies ();
+  SetLookupTable ();
+  ReadBytes (bitbuffer);
+
+  return;
+}
+
+
+/*!
+     Decode a number of symbols and return them as a vector
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len The number of symbols to decode.
+     \return The decoded symbols
+*/
+vector<unsigned int> Arithmetic::DecodeMessage (BitBuffer &bitbuffer, unsigned int len) {
+  vector<unsigned int> x;
+
+  DecodeMessage (bitbuffer, len, x);
+
+  return x;
+}
+
+
+/*!
+     Decode a number of symbols and append them to a vector.  The bytes of the range coder were read
+     into memory by DecodeBegin (), so the BitBuffer is not used; any bytes after the last one are 0.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len Length of the message to decode; can be less than m_MessageLength if we want to decode a piece at a time
+     \param[out] x The vector to append the message to
+*/
+void Arithmetic::DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x) {
+  const unsigned int *frequency = m_Frequency.data ();
+  const unsigned int *cumulative = m_Cumulative.data ();
+  const unsigned int *lookup = m_Lookup.data ();
+  const unsigned int bits = m_FrequencyBits;
+  const unsigned int last = (1U << bits) - 1;
+
+  //  Ensure we aren't decoding too much
+  if (m_MessageLengthDecoded + len > m_MessageLength) {
+    len = m_MessageLength - m_MessageLengthDecoded;
+  }
+
+  size_t start = x.size ();
+  x.resize (start + len);
+  unsigned int *out = x.data () + start;
+
+  for (unsigned int i = 0; i < len; i++) {
+    unsigned int r = m_Range >> bits;
+    unsigned int value = m_Code / r;
+    if (value > last) {
+      value = last;
+    }
+    unsigned int sym = lookup[value];
+    m_Code -= cumulative[sym] * r;
+    m_Range = r * frequency[sym];
+    while (m_Range < g_ARITHMETIC_RANGE_TOP) {
+      m_Code = (m_Code << g_CHAR_SIZE_BITS) | NextByte ();
+      m_Range <<= g_CHAR_SIZE_BITS;
+    }
+    out[i] = sym;
+  }
+
+  m_MessageLengthDecoded += len;
+
+  return;
+}
+
+
+/*!
+     Finish decoding; check that the whole message was decoded.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Arithmetic::DecodeFinish (BitBuffer &bitbuffer) {
+  if (m_MessageLengthDecoded != m_MessageLength) {
+    cerr << "WW\tOnly " << m_MessageLengthDecoded << " of the " << m_MessageLength << " arithmetic coded symbols were decoded." << endl;
+  }
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Decode the prelude written by EncodePrelude ().
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Arithmetic::DecodePrelude (BitBuffer &bitbuffer) {
+  vector<unsigned int> tmp;
+  unsigned int sum = 0;
+
+  m_MessageLength = Delta_Decode (bitbuffer);
+  m_MaximumSymbol = Delta_Decode (bitbuffer);
+  m_DistinctSymbols = Delta_Decode (bitbuffer);
+  m_FrequencyBits = Delta_Decode (bitbuffer) - 1;
+  if (m_FrequencyBits > g_ARITHMETIC_FREQUENCY_BITS) {
+    cerr << "EE\tThe prelude of an arithmetic coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  const unsigned int total = (1U << m_FrequencyBits);
+
+  Interpolative_Decode (bitbuffer, tmp, m_DistinctSymbols);
+
+  m_Frequency.assign (m_MaximumSymbol + 1, 0);
+  for (unsigned int i = 0; i + 1 < tmp.size (); i++) {
+    m_Frequency[tmp[i]] = Delta_Decode (bitbuffer);
+    sum += m_Frequency[tmp[i]];
+  }
+  if ((tmp.empty ()) || (sum >= total)) {
+    cerr << "EE\tThe prelude of an arithmetic coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  m_Frequency[tmp.back ()] = total - sum;
+
+  return;
+}
+
+
+/*!
+     Set m_Lookup, which gives the symbol for each value of the sum of the scaled frequencies.
+*/
+void Arithmetic::SetLookupTable () {
+  m_Lookup.assign (1U << m_FrequencyBits, 0);
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    for (unsigned int j = 0; j < m_Frequency[i]; j++) {
+      m_Lookup[m_Cumulative[i] + j] = i;
+    }
+  }
+
+  return;
+}
+
+
+/*!
+     Read the bytes of the range coder, written by WriteBytes (), into memory and start decoding them.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Arithmetic::ReadBytes (BitBuffer &bitbuffer) {
+  //  The first byte, which is always 0, was not written
+  unsigned int num_bytes = Delta_Decode (bitbuffer) - 1;
+  m_Bytes.assign (num_bytes, 0);
+  bitbuffer.ExtractBits (reinterpret_cast<char*> (m_Bytes.data ()), static_cast<unsigned long long> (num_bytes) * g_CHAR_SIZE_BITS);
+
+  m_Range = 0xFFFFFFFF;
+  m_Code = 0;
+  m_BytesNext = 0;
+  for (unsigned int i = 1; i < g_ARITHMETIC_FLUSH_BYTES; i++) {
+    m_Code = (m_Code << g_CHAR_SIZE_BITS) | NextByte ();
+  }
+
+  return;
+}
+
@@ -0,0 +1,223 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file encode.cpp
+    Encoding functions for Arithmetic coding class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <iostream>
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "interpolative.hpp"
+#include "arithmetic.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+/*!
+     Scale the frequencies and write the prelude in preparation for encoding.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Arithmetic::EncodeBegin (BitBuffer &bitbuffer) {
+  if (m_MessageLength == 0) {
+    cerr << "EE\tArithmetic coding requires a message of at least one symbol." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  ScaleFrequencies ();
+  SetCumulativeFrequencies ();
+
+  if (GetDebug ()) {
+    for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+      if (m_Frequency[i] != 0) {
+        cerr << "\t[EncodeBegin]\t" << i << "\t" << m_Cumulative[i] << "\t" << m_Frequency[i] << endl;
+      }
+    }
+  }
+
+  EncodePrelude (bitbuffer);
+
+  return;
+}
+
+
+/*!
+     Encode a vector of symbols
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+*/
+void Arithmetic::EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x) {
+  EncodeMessage (bitbuffer, x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Encode an array of symbols.  The bytes of the range coder are kept in memory until EncodeFinish (),
+     so the BitBuffer is not used.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+     \param[in] len The number of symbols in x
+*/
+void Arithmetic::EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len) {
+  const unsigned int *frequency = m_Frequency.data ();
+  const unsigned int *cumulative = m_Cumulative.data ();
+  const unsigned int bits = m_FrequencyBits;
+
+  for (unsigned int i = 0; i < len; i++) {
+    unsigned int r = m_Range >> bits;
+    m_Low += static_cast<unsigned long long> (cumulative[x[i]]) * r;
+    m_Range = r * frequency[x[i]];
+    while (m_Range < g_ARITHMETIC_RANGE_TOP) {
+      m_Range <<= g_CHAR_SIZE_BITS;
+      ShiftLow ();
+    }
+  }
+
+  return;
+}
+
+
+/*!
+     Finish encoding by writing the bytes of the range coder to the BitBuffer.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Arithmetic::EncodeFinish (BitBuffer &bitbuffer) {
+  WriteBytes (bitbuffer);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Encode the prelude:  the length of the message, the symbols which appear in it and their scaled
+     frequencies.  The scaled frequency of the last symbol is not written since they sum to 2 to the
+     power of m_FrequencyBits.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Arithmetic::EncodePrelude (BitBuffer &bitbuffer) {
+  vector<unsigned int> tmp;
+
+  Delta_Encode (bitbuffer, m_MessageLength);
+  Delta_Encode (bitbuffer, m_MaximumSymbol);
+  Delta_Encode (bitbuffer, m_DistinctSymbols);
+  Delta_Encode (bitbuffer, m_FrequencyBits + 1);
+
+  //  Encode the sub-alphabet (symbols that appear in this block)
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    if (m_Frequency[i] != 0) {
+      tmp.push_back (i);
+    }
+  }
+  Interpolative_Encode (bitbuffer, tmp);
+
+  //  Encode the scaled frequencies
+  for (unsigned int i = 0; i + 1 < tmp.size (); i++) {
+    Delta_Encode (bitbuffer, m_Frequency[tmp[i]]);
+  }
+
+  return;
+}
+
+
+/*!
+     Shift the top byte out of the lowest 32 bits of m_Low.  It is held back in m_Cache (along with any
+     bytes of 0xFF after it) until it is known that a carry cannot be added to it.
+*/
+void Arithmetic::ShiftLow () {
+  if ((m_Low < 0xFF000000ULL) || (m_Low > 0xFFFFFFFFULL)) {
+    unsigned char carry = static_cast<unsigned char> (m_Low >> 32);
+    m_Bytes.push_back (static_cast<unsigned char> (m_Cache + carry));
+    for (; m_CacheSize > 1; m_CacheSize--) {
+      m_Bytes.push_back (static_cast<unsigned char> (0xFF + carry));
+    }
+    m_CacheSize = 0;
+    m_Cache = static_cast<unsigned char> (m_Low >> 24);
+  }
+  m_CacheSize++;
+  m_Low = (m_Low & 0x00FFFFFFULL) << g_CHAR_SIZE_BITS;
+
+  return;
+}
+
+
+/*!
+     Flush the range coder and write its bytes to the BitBuffer, after the number of them.  Any value in
+     the final interval can be flushed, so the one with the most 0's at the end is chosen.  The first
+     byte is always 0 and the decoder reads 0's after the last byte, so neither the first byte nor any
+     0's at the end are written.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Arithmetic::WriteBytes (BitBuffer &bitbuffer) {
+  for (unsigned int k = g_UINT_SIZE_BITS - 1; k > 0; k--) {
+    unsigned long long mask = (1ULL << k) - 1;
+    unsigned long long value = (m_Low + mask) & ~mask;
+    if (value < m_Low + m_Range) {
+      m_Low = value;
+      break;
+    }
+  }
+
+  for (unsigned int i = 0; i < g_ARITHMETIC_FLUSH_BYTES; i++) {
+    ShiftLow ();
+  }
+
+  while ((m_Bytes.size () > 1) && (m_Bytes.back () == 0)) {
+    m_Bytes.pop_back ();
+  }
+
+  //  Add 1 since the number of bytes is encoded with a Delta code
+  if (m_Bytes.size () >= UINT_MAX) {
+    cerr << "EE\tAn arithmetic coded message is too long; please use fewer symbols in each message." << endl;
+    exit (EXIT_FAILURE);
+  }
+  Delta_Encode (bitbuffer, static_cast<unsigned int> (m_Bytes.size ()));
+  bitbuffer.AppendBits (reinterpret_cast<const char*> (m_Bytes.data ()) + 1, static_cast<unsigned long long> (m_Bytes.size () - 1) * g_CHAR_SIZE_BITS);
+
+  return;
+}
+
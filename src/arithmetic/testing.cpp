@@ -0,0 +1,297 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file testing.cpp
+    Testing functions of main-test.
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <iostream>
+#include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+#include <algorithm>  //  min, max
+
+using namespace std;
+
+#include "Arithmetic_Config.hpp"
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "arithmetic.hpp"
+#include "testing.hpp"
+
+
+/*!
+     Compare two vectors
+
+     \return true if the vectors are the same; false otherwise
+*/
+bool VectorSame (vector<unsigned int> x, vector<unsigned int> y) {
+  if (x.size () != y.size ()) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < x.size (); i++) {
+    if (x[i] != y[i]) {
+      cerr << "EE\tMismatch at position " << i << endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*!
+     Encode a message with arithmetic coding, followed by a marker, and then decode it a random number
+     of symbols at a time.
+
+     \param[in] tmp The message to encode
+     \param[out] tmp2 The decoded message
+     \param[out] bits The number of bits used by the prelude and the message
+     \return true if the marker was read correctly after the message; false otherwise
+*/
+static bool ArithmeticRoundTrip (const vector<unsigned int> &tmp, vector<unsigned int> &tmp2, unsigned long long &bits) {
+  string str = "tmp.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the message
+
+  //  Test encoding
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  Arithmetic ac_out;
+  ac_out.UpdateFrequencies (tmp);
+  ac_out.EncodeBegin (bitbuff_out);
+  ac_out.EncodeMessage (bitbuff_out, tmp);
+  ac_out.EncodeFinish (bitbuff_out);
+  cout << ac_out << endl;
+  bits = bitbuff_out.GetBitPosition ();
+  bitbuff_out.WriteBits (marker, 16);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding " << tmp.size () << " symbols in " << bits << " bits..." << endl;
+
+  //  Test decoding
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  Arithmetic ac_in;
+  ac_in.DecodeBegin (bitbuff_in);
+  while (tmp2.size () < ac_in.GetMessageLength ()) {
+    ac_in.DecodeMessage (bitbuff_in, (rand () % 100) + 1, tmp2);
+  }
+  ac_in.DecodeFinish (bitbuff_in);
+  unsigned int marker_in = bitbuff_in.ReadBits (16);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  return (marker_in == marker);
+}
+
+
+/*!
+     Show basic information about the program
+
+     \return Always returns true
+*/
+bool ShowInfo () {
+  cout << "Arithmetic version " << ARITHMETIC_PROGRAM_VERSION << " compiled on:  " << __DATE__ <<  " (" << __TIME__ << ")" << endl;
+  cout << "Git hash:  " << ARITHMETIC_GIT_HASH << endl;
+
+  cout << "II\tShowInfo successful!" << endl;
+
+  return (true);
+}
+
+
+/*!
+     Simple example with only one symbol in the alphabet.
+
+     \return true if the symbols are decoded correctly; false otherwise
+*/
+bool ArithmeticSimpleExample () {
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+  unsigned long long bits = 0;
+
+  //  Generate test data
+  for (unsigned int i = 0; i < 11; i++) {
+    tmp.push_back (10);
+  }
+
+  if ((!ArithmeticRoundTrip (tmp, tmp2, bits)) || (!VectorSame (tmp, tmp2))) {
+    cerr << "EE\tArithmetic coding of one symbol unsuccessful!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tArithmetic coding of one symbol successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Arithmetic code a set of random numbers.
+
+     \return true if the numbers are decoded correctly; false otherwise
+*/
+bool ArithmeticRandom () {
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+  unsigned long long bits = 0;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data
+  for (unsigned int i = 0; i < g_TEST_SIZE; i++) {
+    unsigned int pos = (rand () % g_MAX_ASCII) + 1;  //  Avoid a 0 from appearing
+    tmp.push_back (pos);
+  }
+
+  if ((!ArithmeticRoundTrip (tmp, tmp2, bits)) || (!VectorSame (tmp, tmp2))) {
+    cerr << "EE\tArithmetic coding of random numbers unsuccessful!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tArithmetic coding of random numbers successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Arithmetic code a set of random numbers where one symbol is much more frequent than the others, as
+     it is after quality scores are binned.  Huffman coding needs at least 1 bit for each symbol, but
+     arithmetic coding should need less.
+
+     \return true if the numbers are decoded correctly in less than 1 bit each; false otherwise
+*/
+bool ArithmeticSkewed () {
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+  unsigned long long bits = 0;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; about 95% of the symbols are 1
+  for (unsigned int i = 0; i < g_TEST_SIZE * 10; i++) {
+    if (rand () % 20 == 0) {
+      tmp.push_back ((rand () % 4) + 2);
+    }
+    else {
+      tmp.push_back (1);
+    }
+  }
+
+  if ((!ArithmeticRoundTrip (tmp, tmp2, bits)) || (!VectorSame (tmp, tmp2))) {
+    cerr << "EE\tArithmetic coding of skewed random numbers unsuccessful!" << endl;
+    return (false);
+  }
+
+  if (bits >= tmp.size ()) {
+    cerr << "EE\tArithmetic coding of skewed random numbers used " << bits << " bits for " << tmp.size () << " symbols!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tArithmetic coding of skewed random numbers successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Code random reads whose symbols are close to the ones before them with ArithmeticContext, and check
+     that they take fewer bits than with Arithmetic, which does not use the previous symbols.
+
+     \return true if the reads are decoded correctly and take fewer bits; false otherwise
+*/
+bool ArithmeticContextExample () {
+  string str = "tmp.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the reads
+  const unsigned int maximum_symbol = 40;
+  const unsigned int read_length = 100;
+  vector<vector<unsigned int> > reads;
+  vector<unsigned int> all;
+  vector<unsigned int> tmp2;
+  unsigned long long static_bits = 0;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; each symbol is within 2 of the one before it
+  for (unsigned int i = 0; i < g_TEST_SIZE / 10; i++) {
+    vector<unsigned int> read;
+    unsigned int x = (rand () % maximum_symbol) + 1;
+    for (unsigned int j = 0; j < read_length; j++) {
+      x = min (max (static_cast<int> (x) + (rand () % 5) - 2, 1), static_cast<int> (maximum_symbol));
+      read.push_back (x);
+      all.push_back (x);
+    }
+    reads.push_back (read);
+  }
+
+  //  Test encoding
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  ArithmeticContext ac_out;
+  ac_out.EncodeBegin (bitbuff_out, maximum_symbol);
+  for (unsigned int i = 0; i < reads.size (); i++) {
+    ac_out.EncodeMessage (bitbuff_out, reads[i].data (), static_cast<unsigned int> (reads[i].size ()));
+  }
+  ac_out.EncodeFinish (bitbuff_out);
+  unsigned long long bits = bitbuff_out.GetBitPosition ();
+  bitbuff_out.WriteBits (marker, 16);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding " << all.size () << " symbols in " << bits << " bits..." << endl;
+
+  //  Test decoding
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  ArithmeticContext ac_in;
+  ac_in.DecodeBegin (bitbuff_in);
+  for (unsigned int i = 0; i < reads.size (); i++) {
+    ac_in.DecodeMessage (bitbuff_in, read_length, tmp2);
+  }
+  ac_in.DecodeFinish (bitbuff_in);
+  unsigned int marker_in = bitbuff_in.ReadBits (16);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  if ((!VectorSame (all, tmp2)) || (marker_in != marker)) {
+    cerr << "EE\tAdaptive arithmetic coding with contexts unsuccessful!" << endl;
+    return (false);
+  }
+
+  //  Compare with the static model
+  vector<unsigned int> tmp3;
+  ArithmeticRoundTrip (all, tmp3, static_bits);
+  if (bits >= static_bits) {
+    cerr << "EE\tAdaptive arithmetic coding with contexts used " << bits << " bits instead of fewer than " << static_bits << "!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tAdaptive arithmetic coding with contexts successful!" << endl;
+  return (true);
+}
+
@@ -58,16 +58,22 @@ BitBuffer::BitBuffer ()
     m_Mini_Buffer (0),
     m_Mini_Buffer_Used (0),
     m_Main_Buffer (),
+    m_Read_Buffer (NULL),
+    m_Map (NULL),
+    m_Map_Size (0),
     m_Main_Buffer_Ptr (0),
-    m_Main_Buffer_End (0)
+    m_Main_Buffer_End (0),
+    m_File_Offset (0),
+    m_Main_Buffer_Size (g_BITBUFFER_SIZE),
+    m_Memory_Bits (0)
 {
   //  Allocate space for the buffer
-  m_Main_Buffer = new char[g_BITBUFFER_SIZE];
+  m_Main_Buffer = new char[m_Main_Buffer_Size];
 
-  int i = 0;
-  for (i = 0; i < g_BITBUFFER_SIZE; i++) {
+  for (size_t i = 0; i < m_Main_Buffer_Size; i++) {
     m_Main_Buffer[i] = 0;
   }
+  m_Read_Buffer = m_Main_Buffer;
 }
 
 
@@ -86,7 +92,7 @@ BitBuffer::~BitBuffer () {
      Initialization function
 
      \param[in] fn Filename to read from/write to
-     \param[in] mode Indicate whether the object is in read, write, or append mode
+     \param[in] mode Indicate whether the object is in read (from a file or a memory-mapped file), write, or append mode
      \param[in] debug Whether or not debugging is turned on
 */
 void BitBuffer::Initialize (string fn, e_READWRITE_MODE mode, bool debug) {
@@ -100,8 +106,16 @@ void BitBuffer::Initialize (string fn, e_READWRITE_MODE mode, bool debug) {
     exit (EXIT_FAILURE);
   }
   
+  //  Map the file into memory; if that is not possible, read it instead
+  if ((GetMode () == e_MODE_MMAP) && (!MapFile ())) {
+    m_Mode = e_MODE_READ;
+  }
+
   //  Open the file for reading or writing
-  if (GetMode () == e_MODE_READ) {
+  if (GetMode () == e_MODE_MMAP) {
+    //  Nothing else to do
+  }
+  else if (GetMode () == e_MODE_READ) {
     m_In_Fp.open (GetFilename ().c_str (), ios::in|ios::binary);
     if (!m_In_Fp) {
       cerr << "EE\tCannot open " << GetFilename () << " for reading." << endl;
@@ -131,6 +145,47 @@ void BitBuffer::Initialize (string fn, e_READWRITE_MODE mode, bool debug) {
 }
 
 
+/*!
+     Initialization function for writing to memory instead of a file.  The bits
+     can be retrieved with GetMemory () after Finish () has been called.
+
+     \param[in] debug Whether or not debugging is turned on
+*/
+void BitBuffer::InitializeMemory (bool debug) {
+  m_Debug = debug;
+  m_Filename = "";
+  m_Mode = e_MODE_MEMORY_WRITE;
+  m_Memory_Bits = 0;
+
+  return;
+}
+
+
+/*!
+     Initialization function for reading from memory instead of a file.  The
+     buffer is read in place, so it must remain unchanged until Close () or
+     Finish () has been called.
+
+     \param[in] buffer The bytes to read from
+     \param[in] num_bytes The number of bytes in buffer
+     \param[in] debug Whether or not debugging is turned on
+*/
+void BitBuffer::InitializeMemory (const char *buffer, unsigned long long num_bytes, bool debug) {
+  m_Debug = debug;
+  m_Filename = "";
+  m_Mode = e_MODE_MEMORY_READ;
+
+  m_Map = buffer;
+  m_Map_Size = num_bytes;
+  m_Read_Buffer = m_Map;
+  m_Main_Buffer_Ptr = 0;
+  m_Main_Buffer_End = 0;
+  m_File_Offset = 0;
+
+  return;
+}
+
+
 //  -----------------------------------------------------------------
 //  Accessors and mutators
 //  -----------------------------------------------------------------
@@ -196,3 +251,53 @@ void BitBuffer::SetClosed (bool value) {
 }
 
 
+/*!
+     Return the bytes written to memory.  The last byte is padded with 0's and
+     more padding may follow it; use GetMemoryBits () to know where the bits end.
+
+     \return Pointer to the main buffer
+*/
+const char* BitBuffer::GetMemory () const {
+  return m_Main_Buffer;
+}
+
+
+/*!
+     Return the number of bytes written to memory, including the padding added by Finish ().  These
+     are the bytes to give to InitializeMemory () in order to read the bits back.
+
+     \return The number of bytes in the main buffer
+*/
+unsigned long long BitBuffer::GetMemoryBytes () const {
+  return (static_cast<unsigned long long> (m_Main_Buffer_Ptr));
+}
+
+
+/*!
+     Return the current position in bits, counted from where reading or writing started.  When
+     reading, this is the position of the next bit to be read; when writing, it is the number of
+     bits written so far.
+
+     \return The current position in bits
+*/
+unsigned long long BitBuffer::GetBitPosition () const {
+  unsigned long long position = (m_File_Offset + static_cast<unsigned long long> (m_Main_Buffer_Ptr)) * g_CHAR_SIZE_BITS;
+
+  if ((GetMode () == e_MODE_READ) || (GetMode () == e_MODE_MMAP) || (GetMode () == e_MODE_MEMORY_READ)) {
+    return (position - m_Mini_Buffer_Used);
+  }
+
+  return (position + m_Mini_Buffer_Used);
+}
+
+
+/*!
+     Return m_Memory_Bits
+
+     \return The number of bits written to memory, without any padding
+*/
+unsigned long long BitBuffer::GetMemoryBits () const {
+  return m_Memory_Bits;
+}
+
+
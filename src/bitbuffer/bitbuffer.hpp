@@ -35,6 +35,21 @@
 */
 const int g_BITBUFFER_SIZE = 131072;
 
+/*!
+     Size of the mini-buffer in bits
+*/
+const unsigned int g_BITBUFFER_ACCUMULATOR_BITS = 64;
+
+/*!
+     Size of the mini-buffer in bytes
+*/
+const unsigned int g_BITBUFFER_ACCUMULATOR_BYTES = 8;
+
+/*!
+     Size of the part of a memory-mapped file that is read from at a time, in bytes
+*/
+const int g_BITBUFFER_MMAP_WINDOW = 1 << 30;
+
 /*!
      \enum e_READWRITE_MODE
      Mode of the BitBuffer (reading or writing).
@@ -44,6 +59,9 @@ enum e_READWRITE_MODE {
   e_MODE_READ, /*!< Read from file mode  */
   e_MODE_WRITE, /*!< Write to file mode  */ 
   e_MODE_APPEND, /*!< Append to file mode  */
+  e_MODE_MEMORY_WRITE, /*!< Write to a growable buffer in memory  */
+  e_MODE_MMAP, /*!< Read from file mode, using a memory-mapped file  */
+  e_MODE_MEMORY_READ, /*!< Read from a buffer in memory  */
   e_MODE_LAST /*!< Last read/write mode  */
 };
 
@@ -57,20 +75,77 @@ enum e_READWRITE_MODE {
 const unsigned int g_MASK_LOWER_BYTE = 0xff;
 
 
+/*!
+    \struct BitBufferTraceOff
+
+    \details Policy for ReadBits () and WriteBits () which neither checks nor traces each call, so that
+             they compile to a few shifts in their callers.
+*/
+struct BitBufferTraceOff {
+  //!  Check and trace each call?
+  static const bool s_Enabled = false;
+};
+
+
+/*!
+    \struct BitBufferTraceOn
+
+    \details Policy for ReadBits () and WriteBits () which checks each call and prints it if debugging
+             is turned on.
+*/
+struct BitBufferTraceOn {
+  //!  Check and trace each call?
+  static const bool s_Enabled = true;
+};
+
+
+//  Policy used when none is given; build with BITBUFFER_TRACE defined (a CMake option) to check and trace every call
+#ifdef BITBUFFER_TRACE
+typedef BitBufferTraceOn BitBufferTraceDefault;
+#else
+typedef BitBufferTraceOff BitBufferTraceDefault;
+#endif
+
+
 /*! 
     \class BitBuffer
 
     \details Class used to buffer bits when reading from or writing to disk.
-    A two-level buffer is employed -- a smaller one of size unsigned int and
-    a larger one which is used to access the disk directly.
+    A two-level buffer is employed -- a smaller one of 64 bits (the mini-buffer)
+    and a larger one which is used to access the disk directly.  The mini-buffer
+    is moved to and from the larger one 8 bytes at a time, so most calls to
+    ReadBits () and WriteBits () only shift bits in and out of it.  Bits are
+    stored most significant first, and the file is always a whole number of
+    unsigned int's.
+
+    Instead of a file, the bits can also be written to memory (see
+    InitializeMemory ()).  In this case, the main buffer grows as needed and is
+    never written to disk.  After Finish (), the bits are available through
+    GetMemory (), GetMemoryBytes () and GetMemoryBits ().
+
+    Bits can be read from memory as well (see the second InitializeMemory ()).
+    The caller's buffer is read in place, in the same way as a memory-mapped
+    file, and it must not be changed or freed until the BitBuffer is closed.
+
+    A file can also be read by mapping it into memory (e_MODE_MMAP), in which
+    case the bits are read straight from the mapping instead of being copied to
+    the main buffer.  If the file cannot be mapped, it is read as in e_MODE_READ.
+
+    ReadBits () and WriteBits () are defined in this header so that they can be
+    inlined into the coders which call them.  Only when the mini-buffer needs to be
+    refilled or emptied is a function in io.cpp called.  Checking and tracing of
+    each call is selected at compile time (see BitBufferTraceDefault).  PeekBits ()
+    returns the next bits without reading them, and SkipBits () then reads (some of)
+    them; this is how a decoder can look ahead without putting bits back.
 
     Functions are available which read and write char's and unsigned int's.
-    Unfortunately, they are not very efficient since they also access the bit
-    buffers.  A more efficient approach would have them access the disk directly.
-    But this would require more work to ensure that the bit buffer remains in an
-    consistent state.
+    When the char's start on a byte boundary, they are copied to and from the
+    main buffer directly, and large numbers of them go straight to or from the
+    file.  Otherwise, they are moved an unsigned int at a time.
 
-    Perhaps this will be for "future work".
+    AppendBits () appends the bits of another stream (such as one written to
+    memory) starting at any bit position, 8 bytes at a time.  ExtractBits ()
+    does the reverse, so that part of a file can be read from memory.
 */
 class BitBuffer {
   public:
@@ -78,6 +153,8 @@ class BitBuffer {
     BitBuffer ();
     ~BitBuffer ();
     void Initialize (std::string fn, e_READWRITE_MODE mode, bool debug=false);
+    void InitializeMemory (bool debug=false);
+    void InitializeMemory (const char *buffer, unsigned long long num_bytes, bool debug=false);
 
     //  Accessors/mutators  [bitbuffer.cpp]
     std::string GetFilename () const;
@@ -86,14 +163,26 @@ class BitBuffer {
     void SetDebug (bool value);
     void SetFlushed (bool value);
     void SetClosed (bool value);
+    const char* GetMemory () const;
+    unsigned long long GetMemoryBytes () const;
+    unsigned long long GetMemoryBits () const;
+    unsigned long long GetBitPosition () const;
 
-    //  Main functions  [io.cpp]
+    //  Main functions  [io.cpp; ReadBits (), WriteBits (), PeekBits () and SkipBits () are at the end of this file]
+    template <typename TracePolicy = BitBufferTraceDefault>
     unsigned int ReadBits (unsigned int num_bits);
-    void WriteBits (unsigned int x, unsigned int bits);
+    template <typename TracePolicy = BitBufferTraceDefault>
+    void WriteBits (unsigned int value, unsigned int num_bits);
+    template <typename TracePolicy = BitBufferTraceDefault>
+    unsigned int PeekBits (unsigned int num_bits);
+    void SkipBits (unsigned int num_bits);
     bool ReadUInts (unsigned int *buffer, int num_values);
     bool WriteUInts (unsigned int *buffer, int num_values);
     bool ReadChars (char *buffer, int num_values);
-    bool WriteChars (char *buffer, int num_values);
+    bool WriteChars (const char *buffer, int num_values);
+    void AppendBits (const char *data, unsigned long long num_bits);
+    void ExtractBits (char *data, unsigned long long num_bits);
+    void SeekBits (unsigned long long bit_position);
 
     //  Finalizing functions  [finish.cpp]
     void Flush ();
@@ -101,7 +190,17 @@ class BitBuffer {
     void Finish ();
   private:
     //  Main functions  [io.cpp]
+    bool FillMainBuffer ();
     bool ReadBitsLowLevel (unsigned int min_bits);
+    void WriteBitsLowLevel (unsigned long long x, unsigned int num_bits);
+    void ReserveMainBuffer (size_t num_bytes);
+    void CheckBits (const char *function, unsigned int num_bits) const;
+    void TraceBits (const char *function, unsigned int x, unsigned int num_bits) const;
+    void GrowMainBuffer (size_t min_size);
+
+    //  Memory-mapped files  [mmap.cpp]
+    bool MapFile ();
+    void UnmapFile ();
 
     //  Finalizing functions  [finish.cpp]
     bool IsFlushed ();
@@ -126,18 +225,135 @@ class BitBuffer {
     //!  Indicate whether the file pointer has been closed
     bool m_Closed;
     
-    //!  Mini buffer of 4 bytes long
-    unsigned int m_Mini_Buffer;
+    //!  Mini buffer of 8 bytes long; the bits are at its high-order end when reading and at its low-order end when writing
+    unsigned long long m_Mini_Buffer;
     //!  Number of useful bits in the mini-buffer
     unsigned int m_Mini_Buffer_Used;
 
     //!  Main buffer
     char *m_Main_Buffer;
+    //!  Buffer that bits are read from; either m_Main_Buffer or part of m_Map
+    const char *m_Read_Buffer;
+    //!  The memory-mapped file (e_MODE_MMAP) or the caller's buffer (e_MODE_MEMORY_READ)
+    const char *m_Map;
+    //!  Size of m_Map in bytes
+    unsigned long long m_Map_Size;
     //!  Pointer to next available position in the buffer
-    int m_Main_Buffer_Ptr;
-    //!  Pointer to the end of the buffer; in the end, it should be less than BITBUFFER_SIZE because it will not be full
-    int m_Main_Buffer_End;
+    size_t m_Main_Buffer_Ptr;
+    //!  Pointer to the end of the buffer; in the end, it should be less than BITBUFFER_SIZE because it will not be full (or than g_BITBUFFER_MMAP_WINDOW for a memory-mapped file)
+    size_t m_Main_Buffer_End;
+    //!  Position in the file of the start of the main buffer, in bytes
+    unsigned long long m_File_Offset;
+    //!  Allocated size of the main buffer; only grows beyond g_BITBUFFER_SIZE when writing to memory
+    size_t m_Main_Buffer_Size;
+    //!  Number of bits written to memory, excluding the padding added when flushing
+    unsigned long long m_Memory_Bits;
 };
 
+
+//  -----------------------------------------------------------------
+//  Inlined functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Read a specified number of bits.
+
+     \param[in] num_bits The number of bits requested
+     \return The value of the bits as an unsigned integer
+     \throw BitBuffer_Input_Exception
+*/
+template <typename TracePolicy>
+inline unsigned int BitBuffer::ReadBits (unsigned int num_bits) {
+  if (TracePolicy::s_Enabled) {
+    CheckBits ("ReadBits", num_bits);
+  }
+
+  m_Flushed = false;
+
+  //  Top up the mini-buffer if it does not have enough bits to satisfy our request
+  if (m_Mini_Buffer_Used < num_bits) {
+    ReadBitsLowLevel (num_bits);
+  }
+
+  //  The bits are at the high-order end of the mini-buffer; shifting in two steps gives 0 if no bits were requested
+  unsigned int x = static_cast<unsigned int> ((m_Mini_Buffer >> 1) >> (g_BITBUFFER_ACCUMULATOR_BITS - 1 - num_bits));
+  m_Mini_Buffer <<= num_bits;
+  m_Mini_Buffer_Used -= num_bits;
+
+  if ((TracePolicy::s_Enabled) && (m_Debug)) {
+    TraceBits ("ReadBits", x, num_bits);
+  }
+
+  return x;
+}
+
+
+/*!
+     Write a value using the specified number of bits.
+
+     \param[in] value Number to write
+     \param[in] num_bits Number of bits to use
+*/
+template <typename TracePolicy>
+inline void BitBuffer::WriteBits (unsigned int value, unsigned int num_bits) {
+  unsigned long long x = static_cast<unsigned long long> (value) & ((1ULL << num_bits) - 1);
+
+  if (TracePolicy::s_Enabled) {
+    CheckBits ("WriteBits", num_bits);
+    if (m_Debug) {
+      TraceBits ("WriteBits", value, num_bits);
+    }
+  }
+
+  m_Flushed = false;
+
+  //  The bits are added to the low-order end of the mini-buffer, unless it would become full
+  if (num_bits < g_BITBUFFER_ACCUMULATOR_BITS - m_Mini_Buffer_Used) {
+    m_Mini_Buffer = (m_Mini_Buffer << num_bits) | x;
+    m_Mini_Buffer_Used += num_bits;
+  }
+  else {
+    WriteBitsLowLevel (x, num_bits);
+  }
+
+  return;
+}
+
+
+/*!
+     Return the next bits without reading them.  As with ReadBits (), the bits must be in the file.
+
+     \param[in] num_bits The number of bits requested
+     \return The value of the bits as an unsigned integer
+     \throw BitBuffer_Input_Exception
+*/
+template <typename TracePolicy>
+inline unsigned int BitBuffer::PeekBits (unsigned int num_bits) {
+  if (TracePolicy::s_Enabled) {
+    CheckBits ("PeekBits", num_bits);
+  }
+
+  if (m_Mini_Buffer_Used < num_bits) {
+    ReadBitsLowLevel (num_bits);
+  }
+
+  return (static_cast<unsigned int> ((m_Mini_Buffer >> 1) >> (g_BITBUFFER_ACCUMULATOR_BITS - 1 - num_bits)));
+}
+
+
+/*!
+     Read bits which were returned by the last call to PeekBits () without returning them again.
+
+     \param[in] num_bits The number of bits to read; at most the number passed to PeekBits ()
+*/
+inline void BitBuffer::SkipBits (unsigned int num_bits) {
+  m_Flushed = false;
+  m_Mini_Buffer <<= num_bits;
+  m_Mini_Buffer_Used -= num_bits;
+
+  return;
+}
+
 #endif
 
@@ -73,21 +73,42 @@ bool BitBuffer::FlushRead () {
      \return Always returns true
 */
 bool BitBuffer::FlushWrite () {
-  unsigned int unused_bits = g_UINT_SIZE_BITS - m_Mini_Buffer_Used;
-
   if (IsFlushed ()) {
     return true;
   }
+
+  //  Pad the bits in the mini-buffer with 0's so that the output is a whole number of unsigned int's;
+  //  an output with nothing written to it still has one
+  unsigned long long padded_bits = ((GetBitPosition () + g_UINT_SIZE_BITS - 1) / g_UINT_SIZE_BITS) * g_UINT_SIZE_BITS;
+  if (padded_bits == 0) {
+    padded_bits = g_UINT_SIZE_BITS;
+  }
+  unsigned int num_bytes = static_cast<unsigned int> ((padded_bits / g_CHAR_SIZE_BITS) - (m_File_Offset + m_Main_Buffer_Ptr));
   
-  m_Mini_Buffer <<= unused_bits;      //  Pad remaining space with 0's
-  unused_bits = 0;
+  //  Record how many bits were actually written before padding
+  if (GetMode () == e_MODE_MEMORY_WRITE) {
+    m_Memory_Bits = (static_cast<unsigned long long> (m_Main_Buffer_Ptr) * g_CHAR_SIZE_BITS) + m_Mini_Buffer_Used;
+  }
+
+  if (m_Mini_Buffer_Used != 0) {
+    m_Mini_Buffer <<= (g_BITBUFFER_ACCUMULATOR_BITS - m_Mini_Buffer_Used);
+  }
 
   //  Copy the mini-buffer to the main-buffer
-  while (unused_bits < g_UINT_SIZE_BITS) {
-    m_Main_Buffer[m_Main_Buffer_Ptr] = static_cast<char>((m_Mini_Buffer >> (g_UINT_SIZE_BITS - g_CHAR_SIZE_BITS)) & g_MASK_LOWER_BYTE);
+  ReserveMainBuffer (num_bytes);
+  for (unsigned int i = 0; i < num_bytes; i++) {
+    m_Main_Buffer[m_Main_Buffer_Ptr] = static_cast<char>((m_Mini_Buffer >> (g_BITBUFFER_ACCUMULATOR_BITS - g_CHAR_SIZE_BITS)) & g_MASK_LOWER_BYTE);
     m_Main_Buffer_Ptr++;
     m_Mini_Buffer = m_Mini_Buffer << g_CHAR_SIZE_BITS;
-    unused_bits += g_CHAR_SIZE_BITS;
+  }
+
+  //  When writing to memory, the main-buffer is the output; leave it as is
+  if (GetMode () == e_MODE_MEMORY_WRITE) {
+    m_Mini_Buffer_Used = 0;
+    m_Mini_Buffer = 0;
+    SetFlushed (true);
+
+    return true;
   }
 
   //  Write the main-buffer to disk
@@ -98,6 +119,7 @@ bool BitBuffer::FlushWrite () {
       exit (EXIT_FAILURE);
     }
   }
+  m_File_Offset += m_Main_Buffer_Ptr;
   m_Main_Buffer_Ptr = 0;
   m_Mini_Buffer_Used = 0;
   m_Mini_Buffer = 0;
@@ -124,7 +146,18 @@ bool BitBuffer::IsClosed () {
      \return Always returns true
 */
 bool BitBuffer::CloseRead () {
-  m_In_Fp.close ();
+  if (GetMode () == e_MODE_MMAP) {
+    UnmapFile ();
+  }
+  else if (GetMode () == e_MODE_MEMORY_READ) {
+    //  The buffer belongs to the caller, so it is only forgotten
+    m_Map = NULL;
+    m_Map_Size = 0;
+    m_Read_Buffer = m_Main_Buffer;
+  }
+  else {
+    m_In_Fp.close ();
+  }
 
   SetClosed (true);
 
@@ -155,9 +188,14 @@ bool BitBuffer::CloseWrite () {
      Flush the file pointer
 */
 void BitBuffer::Flush () {
+  //  Nothing to do if the BitBuffer was never initialized
+  if (GetMode () == e_MODE_UNSET) {
+    return;
+  }
+
   if (!IsFlushed ()) {
     bool result = false;
-    if (GetMode () == e_MODE_READ) {
+    if ((GetMode () == e_MODE_READ) || (GetMode () == e_MODE_MMAP) || (GetMode () == e_MODE_MEMORY_READ)) {
       result = FlushRead ();
     }
     else if (GetMode () == e_MODE_WRITE) {
@@ -166,6 +204,9 @@ void BitBuffer::Flush () {
     else if (GetMode () == e_MODE_APPEND) {
       result = FlushWrite ();
     }
+    else if (GetMode () == e_MODE_MEMORY_WRITE) {
+      result = FlushWrite ();
+    }
 
     if (!result) {
       cerr << "WW\tUnexpected error while flushing the bit buffer." << endl;
@@ -182,13 +223,18 @@ void BitBuffer::Flush () {
      Close the file pointer; flush the buffer if it hasn't yet been flushed.
 */
 void BitBuffer::Close () {
+  //  Nothing to do if the BitBuffer was never initialized
+  if (GetMode () == e_MODE_UNSET) {
+    return;
+  }
+
   if (!IsFlushed ()) {
     Flush ();
   }
   
   if (!IsClosed ()) {
     bool result = false;
-    if (GetMode () == e_MODE_READ) {
+    if ((GetMode () == e_MODE_READ) || (GetMode () == e_MODE_MMAP) || (GetMode () == e_MODE_MEMORY_READ)) {
       result = CloseRead ();
     }
     else if (GetMode () == e_MODE_WRITE) {
@@ -197,6 +243,10 @@ void BitBuffer::Close () {
     else if (GetMode () == e_MODE_APPEND) {
       result = CloseWrite ();
     }
+    else if (GetMode () == e_MODE_MEMORY_WRITE) {
+      SetClosed (true);
+      result = true;
+    }
 
     if (!result) {
       cerr << "WW\tUnexpected error while closing the bit buffer." << endl;
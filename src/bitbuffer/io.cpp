@@ -31,7 +31,12 @@
 #include <string>
 #include <fstream>
 #include <cstdlib>  //  exit
+#include <cstring>  //  memcpy, memset
 #include <cassert>  //  assert
+#include <algorithm>  //  min
+#include <climits>  //  INT_MAX
+#include <cstdint>  //  SIZE_MAX
+#include <new>  //  nothrow
 
 using namespace std;
 
@@ -40,72 +45,150 @@ using namespace std;
 #include "bitbuffer.hpp"
 
 
+/*!
+     Load 8 bytes from memory, which need not be aligned, as a big-endian value
+
+     \param[in] ptr Where to load the bytes from
+     \return The value of the bytes
+*/
+static inline unsigned long long LoadBigEndian (const char *ptr) {
+  unsigned long long x = 0;
+
+#if defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  memcpy (&x, ptr, sizeof (x));
+  x = __builtin_bswap64 (x);
+#elif defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  memcpy (&x, ptr, sizeof (x));
+#else
+  for (unsigned int i = 0; i < g_BITBUFFER_ACCUMULATOR_BYTES; i++) {
+    x = (x << g_CHAR_SIZE_BITS) | (static_cast<unsigned long long> (ptr[i]) & g_MASK_LOWER_BYTE);
+  }
+#endif
+
+  return x;
+}
+
+
+/*!
+     Store 8 bytes to memory, which need not be aligned, as a big-endian value
+
+     \param[in] ptr Where to store the bytes to
+     \param[in] x The value to store
+*/
+static inline void StoreBigEndian (char *ptr, unsigned long long x) {
+#if defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  x = __builtin_bswap64 (x);
+  memcpy (ptr, &x, sizeof (x));
+#elif defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  memcpy (ptr, &x, sizeof (x));
+#else
+  for (unsigned int i = 0; i < g_BITBUFFER_ACCUMULATOR_BYTES; i++) {
+    ptr[i] = static_cast<char> ((x >> (g_BITBUFFER_ACCUMULATOR_BITS - g_CHAR_SIZE_BITS)) & g_MASK_LOWER_BYTE);
+    x <<= g_CHAR_SIZE_BITS;
+  }
+#endif
+
+  return;
+}
+
+
 //  -----------------------------------------------------------------
 //  Private functions
 //  -----------------------------------------------------------------
 
 
 /*!
-     A low-level read (private member function) that reads at *least* the given number of bits
-     from the main-buffer
+     Read the next part of the file into the main-buffer, which must be empty.
+
+     \return Returns false if the end of the file has been reached; true otherwise.
+*/
+bool BitBuffer::FillMainBuffer () {
+  int bytes_read = 0;
+
+  m_File_Offset += m_Main_Buffer_End;
+
+  //  Move to the next part of a memory-mapped file or buffer in memory instead of reading it
+  if ((GetMode () == e_MODE_MMAP) || (GetMode () == e_MODE_MEMORY_READ)) {
+    m_Main_Buffer_Ptr = 0;
+    m_Main_Buffer_End = 0;
+    if (m_File_Offset >= m_Map_Size) {
+      return false;
+    }
+    m_Read_Buffer = m_Map + m_File_Offset;
+    if (m_Map_Size - m_File_Offset < static_cast<unsigned long long> (g_BITBUFFER_MMAP_WINDOW)) {
+      m_Main_Buffer_End = static_cast<size_t> (m_Map_Size - m_File_Offset);
+    }
+    else {
+      m_Main_Buffer_End = g_BITBUFFER_MMAP_WINDOW;
+    }
+
+    return true;
+  }
+
+  m_In_Fp.read ((char*) m_Main_Buffer, g_BITBUFFER_SIZE);
+  bytes_read = m_In_Fp.gcount ();
+
+  //  Check if either the failbit or badbit flags are set
+  if (m_In_Fp.bad ()) {
+    cerr << "EE\tError:  Serious error in reading from input buffer after reading in " << bytes_read << " bytes." << endl;
+    exit (EXIT_FAILURE);
+  }
+  if (m_In_Fp.fail ()) {
+    if (bytes_read < g_BITBUFFER_SIZE) {
+      //  Clear the fail bit since we only reached the end of the buffer,
+      //  which is not a problem
+      m_In_Fp.clear ();
+    }
+    else {
+      cerr << "EE\tError:  Fail while reading from input buffer after reading in " << bytes_read << " bytes." << endl;
+    }
+  }
+
+  m_Main_Buffer_Ptr = 0;
+  m_Main_Buffer_End = static_cast<size_t> (bytes_read);
+
+  return (bytes_read != 0);
+}
+
+
+/*!
+     A low-level read (private member function) that tops up the mini-buffer from the main-buffer
+     so that it holds at *least* the given number of bits.  Unless the end of the file is near, the
+     mini-buffer is left with at least g_BITBUFFER_ACCUMULATOR_BITS - 7 bits.
 
      \param[in] min_bits The minimum number of bits requested
      \return Boolean indicating success or failure
      \throw BitBuffer_Input_Exception
 */
 bool BitBuffer::ReadBitsLowLevel (unsigned int min_bits) {
-  int bytes_read = 0;
-
   //  Cannot read from a closed file handle
   assert (IsClosed () == false);
 
   //  Ensure m_Main_Buffer_Ptr is not pointing out of bounds
   assert (m_Main_Buffer_Ptr <= m_Main_Buffer_End);
 
-  //  Check if the main-buffer is empty and if so, read from file
-  if (m_Main_Buffer_Ptr == m_Main_Buffer_End) {
-    m_In_Fp.read ((char*) m_Main_Buffer, g_BITBUFFER_SIZE);
-    bytes_read = m_In_Fp.gcount ();
-
-    //  Check if either the failbit or badbit flags are set
-    if (m_In_Fp.bad ()) {
-      cerr << "EE\tError:  Serious error in reading from input buffer after reading in " << bytes_read << " bytes." << endl;
-      exit (EXIT_FAILURE);
-    }
-    if (m_In_Fp.fail ()) {
-      if (bytes_read < g_BITBUFFER_SIZE) {
-        //  Clear the fail bit since we only reached the end of the buffer,
-        //  which is not a problem
-        m_In_Fp.clear ();
-      }
-      else {
-        cerr << "EE\tError:  Fail while reading from input buffer after reading in " << bytes_read << " bytes." << endl;
-      }
-    }
+  //  Usual case:  load 8 bytes at once and keep the whole bytes that fit.  The bits after them are
+  //  also loaded, but they are the same bits that the next load will put there.
+  if (m_Main_Buffer_Ptr + g_BITBUFFER_ACCUMULATOR_BYTES <= m_Main_Buffer_End) {
+    unsigned int new_bytes = (g_BITBUFFER_ACCUMULATOR_BITS - 1 - m_Mini_Buffer_Used) / g_CHAR_SIZE_BITS;
 
-    //  If nothing read, then error
-    if (bytes_read == 0) {
-      throw BitBuffer_Input_Exception ();
-    }
+    m_Mini_Buffer |= LoadBigEndian (&m_Read_Buffer[m_Main_Buffer_Ptr]) >> m_Mini_Buffer_Used;
+    m_Main_Buffer_Ptr += new_bytes;
+    m_Mini_Buffer_Used += new_bytes * g_CHAR_SIZE_BITS;
 
-    m_Main_Buffer_Ptr = 0;
-    m_Main_Buffer_End = bytes_read;
+    return true;
   }
 
-  //  Copy the main-buffer to the mini-buffer
-  unsigned int new_bits = 0;
-  while (new_bits < g_UINT_SIZE_BITS) {
-    m_Mini_Buffer = m_Mini_Buffer << g_CHAR_SIZE_BITS;
-    m_Mini_Buffer |= static_cast<unsigned int>(m_Main_Buffer[m_Main_Buffer_Ptr]) & g_MASK_LOWER_BYTE;
-    m_Main_Buffer_Ptr++;
-    new_bits += g_CHAR_SIZE_BITS;
-    if (m_Main_Buffer_Ptr > m_Main_Buffer_End) {
-      m_Main_Buffer_End = m_Main_Buffer_Ptr;
+  //  Near the end of the main-buffer, copy one byte at a time; read from file when it is empty
+  while (m_Mini_Buffer_Used <= g_BITBUFFER_ACCUMULATOR_BITS - g_CHAR_SIZE_BITS) {
+    if ((m_Main_Buffer_Ptr == m_Main_Buffer_End) && (!FillMainBuffer ())) {
       break;
     }
+    m_Mini_Buffer |= (static_cast<unsigned long long> (m_Read_Buffer[m_Main_Buffer_Ptr]) & g_MASK_LOWER_BYTE) << (g_BITBUFFER_ACCUMULATOR_BITS - g_CHAR_SIZE_BITS - m_Mini_Buffer_Used);
+    m_Main_Buffer_Ptr++;
+    m_Mini_Buffer_Used += g_CHAR_SIZE_BITS;
   }
 
-  m_Mini_Buffer_Used = new_bits;
   if (m_Mini_Buffer_Used < min_bits) {
     throw BitBuffer_Input_Exception ();
   }
@@ -114,145 +197,170 @@ bool BitBuffer::ReadBitsLowLevel (unsigned int min_bits) {
 }
 
 
-//  -----------------------------------------------------------------
-//  Public functions (bit-based)
-//  -----------------------------------------------------------------
-
-
 /*!
-     Read a specified number of bits.
+     A low-level write (private member function) for when the bits do not fit in the mini-buffer.
+     The mini-buffer is filled, copied to the main-buffer, and then holds the remaining bits.
 
-     \param[in] num_bits The number of bits requested
-     \return The value of the bits as an unsigned integer
-     \throw BitBuffer_Input_Exception
+     \param[in] x The bits to write, with any higher-order bits cleared
+     \param[in] num_bits The number of bits to write
 */
-unsigned int BitBuffer::ReadBits (unsigned int num_bits) {
-  unsigned int x = 0;
+void BitBuffer::WriteBitsLowLevel (unsigned long long x, unsigned int num_bits) {
+  unsigned int unused_bits = g_BITBUFFER_ACCUMULATOR_BITS - m_Mini_Buffer_Used;
+  unsigned int remaining_bits = num_bits - unused_bits;
 
-  //  Cannot read from a closed file handle
-  assert (IsClosed () == false);
+  //  Fill the mini-buffer with the first "unused_bits" of x and copy it to the main-buffer
+  m_Mini_Buffer = (m_Mini_Buffer << unused_bits) | (x >> remaining_bits);
+  ReserveMainBuffer (g_BITBUFFER_ACCUMULATOR_BYTES);
+  StoreBigEndian (&m_Main_Buffer[m_Main_Buffer_Ptr], m_Mini_Buffer);
+  m_Main_Buffer_Ptr += g_BITBUFFER_ACCUMULATOR_BYTES;
 
-  if (IsFlushed ()) {
-    SetFlushed (false);
-  }
-  
-  if (num_bits > g_UINT_SIZE_BITS) {
-    cerr << "EE\tMore bits (" << num_bits << ") requested than what can be provided [BitBuffer::ReadBits ()]." << endl;
-    exit (EXIT_FAILURE);
-  }
+  //  Keep the remaining bits, which is "num_bits - unused_bits"
+  m_Mini_Buffer = x & ((1ULL << remaining_bits) - 1);
+  m_Mini_Buffer_Used = remaining_bits;
+
+  return;
+}
 
-  //  No bits requested
-  if (num_bits == 0) {
-    return (0);
+
+/*!
+     Make space in the main-buffer for the given number of bytes.  When writing to memory, the main
+     buffer is enlarged; otherwise, it is written to the file.
+
+     \param[in] num_bytes The number of bytes needed
+*/
+void BitBuffer::ReserveMainBuffer (size_t num_bytes) {
+  if (num_bytes <= m_Main_Buffer_Size - m_Main_Buffer_Ptr) {
+    return;
   }
 
-  //  Initialize x depending on whether or not there are any bits in the
-  //  mini-buffer
-  if (m_Mini_Buffer_Used == 0) {
-    x = 0;
+  if (GetMode () == e_MODE_MEMORY_WRITE) {
+    if (num_bytes > SIZE_MAX - m_Main_Buffer_Ptr) {
+      cerr << "EE\tError:  The bits written to memory do not fit in a buffer." << endl;
+      exit (EXIT_FAILURE);
+    }
+    GrowMainBuffer (m_Main_Buffer_Ptr + num_bytes);
   }
   else {
-    x = (m_Mini_Buffer) >> (g_UINT_SIZE_BITS - num_bits);
+    m_Out_Fp.write ((char*) m_Main_Buffer, m_Main_Buffer_Ptr);
+    if (m_Out_Fp.bad ()) {
+      cerr << "EE\tError while writing to output file." << endl;
+      exit (EXIT_FAILURE);
+    }
+    m_File_Offset += m_Main_Buffer_Ptr;
+    m_Main_Buffer_Ptr = 0;
   }
 
-  //  Check if the mini-buffer has enough bits to satisfy our request
-  if (num_bits <= m_Mini_Buffer_Used) {
-    m_Mini_Buffer = m_Mini_Buffer << num_bits;
-    m_Mini_Buffer_Used -= num_bits;
+  return;
+}
+
+
+/*!
+     Double the size of the main buffer, as many times as needed, keeping its contents.  Only used
+     when writing to memory, where the main buffer holds everything written so far.
+
+     \param[in] min_size The smallest size, in bytes, that the main buffer must have
+*/
+void BitBuffer::GrowMainBuffer (size_t min_size) {
+  size_t new_size = m_Main_Buffer_Size;
+  while (new_size < min_size) {
+    //  Stop doubling before the size overflows
+    new_size = (new_size <= SIZE_MAX / 2) ? new_size * 2 : SIZE_MAX;
   }
-  else {
-    num_bits -= m_Mini_Buffer_Used;
-    bool retval = ReadBitsLowLevel (num_bits);
-    if (retval == false) {
-      throw BitBuffer_Input_Exception ();
-    }
-    x |= (m_Mini_Buffer) >> (g_UINT_SIZE_BITS - num_bits);
-    m_Mini_Buffer = m_Mini_Buffer << num_bits;
-    m_Mini_Buffer_Used -= num_bits;
+
+  char *new_buffer = new (nothrow) char[new_size];
+  if (new_buffer == NULL) {
+    cerr << "EE\tError:  Cannot allocate " << new_size << " bytes for the bits written to memory." << endl;
+    exit (EXIT_FAILURE);
   }
 
-  if (GetDebug ()) {
-    cerr << "\tBitbuffer::ReadBits\t" << x << "\t" << num_bits << endl;
+  memcpy (new_buffer, m_Main_Buffer, m_Main_Buffer_Ptr);
+  memset (&new_buffer[m_Main_Buffer_Ptr], 0, new_size - m_Main_Buffer_Ptr);
+
+  delete [] m_Main_Buffer;
+  m_Main_Buffer = new_buffer;
+  m_Main_Buffer_Size = new_size;
+
+  return;
+}
+
+
+/*!
+     Check a call to ReadBits () or WriteBits (); only called when checking is turned on (see
+     BitBufferTraceOn).
+
+     \param[in] function The name of the function being checked
+     \param[in] num_bits The number of bits to read or write
+*/
+void BitBuffer::CheckBits (const char *function, unsigned int num_bits) const {
+  //  Cannot read from or write to a closed file handle
+  assert (m_Closed == false);
+
+  if (num_bits > g_UINT_SIZE_BITS) {
+    cerr << "EE\tMore bits (" << num_bits << ") requested than what can be provided [BitBuffer::" << function << " ()]." << endl;
+    exit (EXIT_FAILURE);
   }
 
-  return x;
+  return;
 }
 
 
 /*!
-     Write a value using the specified number of bits.
+     Print a call to ReadBits () or WriteBits (); only called when checking is turned on (see
+     BitBufferTraceOn) and debugging is turned on.
 
-     \param[in] value Number to write
-     \param[in] num_bits Number of bits to use
+     \param[in] function The name of the function being traced
+     \param[in] x The value read or written
+     \param[in] num_bits The number of bits read or written
 */
-void BitBuffer::WriteBits (unsigned int value, unsigned int num_bits) {
-  unsigned int x = value;
-  unsigned int unused_bits = g_UINT_SIZE_BITS - m_Mini_Buffer_Used;
+void BitBuffer::TraceBits (const char *function, unsigned int x, unsigned int num_bits) const {
+  cerr << "\tBitbuffer::" << function << "\t" << x << "\t" << num_bits << endl;
 
-  //  Cannot write to a closed file handle
-  assert (IsClosed () == false);
+  return;
+}
 
-  //  Number of bits to be written out should never be greater than this limit
-  assert (num_bits <= g_UINT_SIZE_BITS);
 
-  if (IsFlushed ()) {
-    SetFlushed (false);
-  }
+//  -----------------------------------------------------------------
+//  Public functions (bit-based)
+//  -----------------------------------------------------------------
 
-  if (GetDebug ()) {
-    cerr << "\tBitbuffer::WriteBits\t" << value << "\t" << num_bits << endl;
-  }
 
-  //  Check if there is space in the mini-buffer for the bits that we want to write
-  if (num_bits <= unused_bits) {
-    if (num_bits != g_UINT_SIZE_BITS) {
-      //  Make space for the bits and add them in.  The following line works even if
-      //  (num_bits == g_UINT_SIZE_BITS) since (1 << g_UINT_SIZE_BITS) == 0.
-      m_Mini_Buffer = (m_Mini_Buffer << num_bits) | (x & ((1 << num_bits) - 1));
-    }
-    else {
-      m_Mini_Buffer = x;
-    }
+/*!
+     Move to the given position in the file (in bits, from the start of the file) so that the next
+     bit read is the one at that position.  Since the file is read an unsigned int at a time, the
+     file pointer is moved to the unsigned int containing the bit and the bits before it are skipped.
 
-    //  Update the number of bits in use
-    m_Mini_Buffer_Used += num_bits;
-  }
-  else {
-    //  If there is no space in the mini-buffer, make some space and add what we can,
-    //  (which is the first "unused_bits" of x)
-    m_Mini_Buffer = m_Mini_Buffer << unused_bits;
-    m_Mini_Buffer = m_Mini_Buffer | ((x >> (num_bits - unused_bits)) & ((1 << (unused_bits)) - 1));
-
-    //  Copy the mini-buffer to the main-buffer
-    unsigned int processed_bits = 0;
-    while (processed_bits < g_UINT_SIZE_BITS) {
-      m_Main_Buffer[m_Main_Buffer_Ptr] = static_cast<char>((m_Mini_Buffer >> (g_UINT_SIZE_BITS - g_CHAR_SIZE_BITS)) & g_MASK_LOWER_BYTE);
-
-      m_Main_Buffer_Ptr++;
-      m_Mini_Buffer = m_Mini_Buffer << g_CHAR_SIZE_BITS;
-      processed_bits += g_CHAR_SIZE_BITS;
-    }
+     \param[in] bit_position The position to move to
+     \throw BitBuffer_Input_Exception
+*/
+void BitBuffer::SeekBits (unsigned long long bit_position) {
+  unsigned long long byte_position = (bit_position / g_UINT_SIZE_BITS) * (g_UINT_SIZE_BITS / g_CHAR_SIZE_BITS);
 
-    //  Add the remaining bits to the mini-buffer, which is "num_bits - unused_bits"
-    if (num_bits - unused_bits != g_UINT_SIZE_BITS) {
-      m_Mini_Buffer = x & ((1 << (num_bits - unused_bits)) - 1);
-    }
-    else {
-      m_Mini_Buffer = x;
-    }
-    m_Mini_Buffer_Used = num_bits - unused_bits;
+  if ((GetMode () != e_MODE_READ) && (GetMode () != e_MODE_MMAP) && (GetMode () != e_MODE_MEMORY_READ)) {
+    cerr << "EE\tSeeking is only possible when reading [BitBuffer::SeekBits ()]." << endl;
+    exit (EXIT_FAILURE);
+  }
 
-    //  Check if the main-buffer needs to be written out
-    if (m_Main_Buffer_Ptr >= g_BITBUFFER_SIZE) {            /*  Write bits out  */
-      m_Out_Fp.write ((char*) m_Main_Buffer, m_Main_Buffer_Ptr);
-      if (m_Out_Fp.bad ()) {
-        cerr << "EE\tError while writing to output file." << endl;
-        exit (EXIT_FAILURE);
-      }
-      m_Main_Buffer_Ptr = 0;
+  //  Clear the end-of-file flag, if it was set, before moving; a memory-mapped file or a buffer in
+  //  memory only needs the offset to be changed
+  if (GetMode () == e_MODE_READ) {
+    m_In_Fp.clear ();
+    m_In_Fp.seekg (byte_position, ios::beg);
+    if (m_In_Fp.fail ()) {
+      cerr << "EE\tError:  Cannot move to byte " << byte_position << " of the input file." << endl;
+      exit (EXIT_FAILURE);
     }
   }
 
+  //  Empty both buffers
+  m_File_Offset = byte_position;
+  m_Main_Buffer_Ptr = 0;
+  m_Main_Buffer_End = 0;
+  m_Mini_Buffer = 0;
+  m_Mini_Buffer_Used = 0;
+
+  //  Skip the bits in the unsigned int before the requested one
+  ReadBits (static_cast<unsigned int> (bit_position - (byte_position * g_CHAR_SIZE_BITS)));
+
   return;
 }
 
@@ -314,13 +422,18 @@ bool BitBuffer::WriteUInts (unsigned int *buffer, int num_values) {
 
 
 /*!
-     Read a specified number of unsigned characters.  Also allocates the space needed.
+     Read a specified number of unsigned characters.  If the next bit to be read starts a byte, the
+     characters are copied from the main-buffer (or, for many of them, straight from the file);
+     otherwise, they are read 4 at a time.
 
      \param[in] buffer The buffer where the values will go
      \param[in] num_values The number of values to read
      \return true upon success; false otherwise.
+     \throw BitBuffer_Input_Exception
 */
 bool BitBuffer::ReadChars (char *buffer, int num_values) {
+  int i = 0;
+
   //  Cannot read from a closed file handle
   assert (IsClosed () == false);
 
@@ -328,8 +441,66 @@ bool BitBuffer::ReadChars (char *buffer, int num_values) {
     SetFlushed (false);
   }
 
-  for (int i = 0; i < num_values; i++) {
-    buffer[i] = static_cast<char> (ReadBits (8));
+  if ((m_Mini_Buffer_Used % g_CHAR_SIZE_BITS) != 0) {
+    for (; i + static_cast<int> (g_UINT_SIZE_BYTES) <= num_values; i += g_UINT_SIZE_BYTES) {
+      unsigned int x = ReadBits (g_UINT_SIZE_BITS);
+      buffer[i] = static_cast<char> (x >> (g_UINT_SIZE_BITS - g_CHAR_SIZE_BITS));
+      buffer[i + 1] = static_cast<char> (x >> (g_UINT_SIZE_BITS - (2 * g_CHAR_SIZE_BITS)));
+      buffer[i + 2] = static_cast<char> (x >> g_CHAR_SIZE_BITS);
+      buffer[i + 3] = static_cast<char> (x);
+    }
+    for (; i < num_values; i++) {
+      buffer[i] = static_cast<char> (ReadBits (g_CHAR_SIZE_BITS));
+    }
+
+    return true;
+  }
+
+  //  Use up the whole bytes in the mini-buffer first
+  while ((m_Mini_Buffer_Used > 0) && (i < num_values)) {
+    buffer[i] = static_cast<char> (ReadBits (g_CHAR_SIZE_BITS));
+    i++;
+  }
+  if (i == num_values) {
+    return true;
+  }
+
+  //  The mini-buffer may still hold the bits after the ones used (see ReadBitsLowLevel ()), which are
+  //  copied below instead
+  m_Mini_Buffer = 0;
+
+  while (i < num_values) {
+    if (m_Main_Buffer_Ptr == m_Main_Buffer_End) {
+      //  Read many characters from the file straight into the buffer
+      if ((GetMode () == e_MODE_READ) && (num_values - i >= g_BITBUFFER_SIZE)) {
+        m_File_Offset += m_Main_Buffer_End;
+        m_Main_Buffer_Ptr = 0;
+        m_Main_Buffer_End = 0;
+
+        m_In_Fp.read (&buffer[i], num_values - i);
+        int bytes_read = m_In_Fp.gcount ();
+        m_File_Offset += bytes_read;
+        if (m_In_Fp.bad ()) {
+          cerr << "EE\tError:  Serious error in reading from input buffer after reading in " << bytes_read << " bytes." << endl;
+          exit (EXIT_FAILURE);
+        }
+        if (bytes_read < num_values - i) {
+          m_In_Fp.clear ();
+          throw BitBuffer_Input_Exception ();
+        }
+
+        return true;
+      }
+
+      if (!FillMainBuffer ()) {
+        throw BitBuffer_Input_Exception ();
+      }
+    }
+
+    int num_bytes = static_cast<int> (min (static_cast<size_t> (num_values - i), m_Main_Buffer_End - m_Main_Buffer_Ptr));
+    memcpy (&buffer[i], &m_Read_Buffer[m_Main_Buffer_Ptr], num_bytes);
+    m_Main_Buffer_Ptr += num_bytes;
+    i += num_bytes;
   }
 
   return true;
@@ -337,13 +508,17 @@ bool BitBuffer::ReadChars (char *buffer, int num_values) {
 
 
 /*!
-     Write a specified number of unsigned characters.
+     Write a specified number of unsigned characters.  If the next bit to be written starts a byte,
+     the characters are copied to the main-buffer (or, for many of them, straight to the file);
+     otherwise, they are written 4 at a time.
 
      \param[in] buffer The buffer where the values are from
      \param[in] num_values The number of values to write
      \return true upon success; false otherwise.
 */
-bool BitBuffer::WriteChars (char *buffer, int num_values) {
+bool BitBuffer::WriteChars (const char *buffer, int num_values) {
+  int i = 0;
+
   //  Cannot write to a closed file handle
   assert (IsClosed () == false);
 
@@ -351,11 +526,145 @@ bool BitBuffer::WriteChars (char *buffer, int num_values) {
     SetFlushed (false);
   }
 
-  for (int i = 0; i < num_values; i++) {
-    WriteBits (static_cast<unsigned int> (buffer[i]), 8);
+  if ((m_Mini_Buffer_Used % g_CHAR_SIZE_BITS) != 0) {
+    for (; i + static_cast<int> (g_UINT_SIZE_BYTES) <= num_values; i += g_UINT_SIZE_BYTES) {
+      unsigned int x = ((static_cast<unsigned int> (buffer[i]) & g_MASK_LOWER_BYTE) << (g_UINT_SIZE_BITS - g_CHAR_SIZE_BITS)) |
+                       ((static_cast<unsigned int> (buffer[i + 1]) & g_MASK_LOWER_BYTE) << (g_UINT_SIZE_BITS - (2 * g_CHAR_SIZE_BITS))) |
+                       ((static_cast<unsigned int> (buffer[i + 2]) & g_MASK_LOWER_BYTE) << g_CHAR_SIZE_BITS) |
+                       (static_cast<unsigned int> (buffer[i + 3]) & g_MASK_LOWER_BYTE);
+      WriteBits (x, g_UINT_SIZE_BITS);
+    }
+    for (; i < num_values; i++) {
+      WriteBits (static_cast<unsigned int> (buffer[i]), g_CHAR_SIZE_BITS);
+    }
+
+    return true;
+  }
+
+  //  Move the whole bytes in the mini-buffer to the main-buffer
+  ReserveMainBuffer (g_BITBUFFER_ACCUMULATOR_BYTES);
+  while (m_Mini_Buffer_Used > 0) {
+    m_Mini_Buffer_Used -= g_CHAR_SIZE_BITS;
+    m_Main_Buffer[m_Main_Buffer_Ptr] = static_cast<char> ((m_Mini_Buffer >> m_Mini_Buffer_Used) & g_MASK_LOWER_BYTE);
+    m_Main_Buffer_Ptr++;
+  }
+  m_Mini_Buffer = 0;
+
+  while (i < num_values) {
+    //  Write many characters straight to the file, after what is in the main-buffer
+    if ((GetMode () != e_MODE_MEMORY_WRITE) && (num_values - i >= g_BITBUFFER_SIZE)) {
+      ReserveMainBuffer (m_Main_Buffer_Size);
+
+      m_Out_Fp.write (&buffer[i], num_values - i);
+      if (m_Out_Fp.bad ()) {
+        cerr << "EE\tError while writing to output file." << endl;
+        exit (EXIT_FAILURE);
+      }
+      m_File_Offset += num_values - i;
+
+      return true;
+    }
+
+    ReserveMainBuffer (1);
+    int num_bytes = static_cast<int> (min (static_cast<size_t> (num_values - i), m_Main_Buffer_Size - m_Main_Buffer_Ptr));
+    memcpy (&m_Main_Buffer[m_Main_Buffer_Ptr], &buffer[i], num_bytes);
+    m_Main_Buffer_Ptr += num_bytes;
+    i += num_bytes;
   }
 
   return true;
 }
 
 
+//  -----------------------------------------------------------------
+//  Public functions (streams)
+//  -----------------------------------------------------------------
+
+
+/*!
+     Append a stream of bits, such as one written to memory by another BitBuffer, so that its first bit
+     follows the last bit written.  If the next bit to be written starts a byte, the whole bytes are
+     copied with WriteChars ().  Otherwise, each 8 bytes are shifted across the mini-buffer and stored
+     in the main-buffer at once.
+
+     \param[in] data The bits to append, most significant first
+     \param[in] num_bits The number of bits in data to append
+*/
+void BitBuffer::AppendBits (const char *data, unsigned long long num_bits) {
+  unsigned long long num_bytes = num_bits / g_CHAR_SIZE_BITS;
+  unsigned long long i = 0;
+
+  //  Cannot write to a closed file handle
+  assert (IsClosed () == false);
+
+  m_Flushed = false;
+
+  if ((m_Mini_Buffer_Used % g_CHAR_SIZE_BITS) == 0) {
+    //  WriteChars () takes at most INT_MAX characters at a time
+    while (i < num_bytes) {
+      int chunk = static_cast<int> (min (num_bytes - i, static_cast<unsigned long long> (INT_MAX)));
+      WriteChars (&data[i], chunk);
+      i += chunk;
+    }
+  }
+  else {
+    //  The mini-buffer keeps its m_Mini_Buffer_Used bits; those before them are completed with the
+    //  start of each 8 bytes and stored
+    unsigned int used = m_Mini_Buffer_Used;
+    while (i + g_BITBUFFER_ACCUMULATOR_BYTES <= num_bytes) {
+      ReserveMainBuffer (g_BITBUFFER_ACCUMULATOR_BYTES);
+      unsigned long long num_words = min ((num_bytes - i) / g_BITBUFFER_ACCUMULATOR_BYTES, static_cast<unsigned long long> ((m_Main_Buffer_Size - m_Main_Buffer_Ptr) / g_BITBUFFER_ACCUMULATOR_BYTES));
+      for (unsigned long long j = 0; j < num_words; j++) {
+        unsigned long long x = LoadBigEndian (&data[i]);
+        StoreBigEndian (&m_Main_Buffer[m_Main_Buffer_Ptr], (m_Mini_Buffer << (g_BITBUFFER_ACCUMULATOR_BITS - used)) | (x >> used));
+        m_Mini_Buffer = x & ((1ULL << used) - 1);
+        m_Main_Buffer_Ptr += g_BITBUFFER_ACCUMULATOR_BYTES;
+        i += g_BITBUFFER_ACCUMULATOR_BYTES;
+      }
+    }
+    for (; i < num_bytes; i++) {
+      WriteBits (static_cast<unsigned int> (data[i]) & g_MASK_LOWER_BYTE, g_CHAR_SIZE_BITS);
+    }
+  }
+
+  //  The bits after the last whole byte are at the high-order end of the next one
+  unsigned int remaining = static_cast<unsigned int> (num_bits % g_CHAR_SIZE_BITS);
+  if (remaining != 0) {
+    WriteBits ((static_cast<unsigned int> (data[num_bytes]) & g_MASK_LOWER_BYTE) >> (g_CHAR_SIZE_BITS - remaining), remaining);
+  }
+
+  return;
+}
+
+
+/*!
+     Read a stream of bits into memory, which is the reverse of AppendBits ().  The bits are read an
+     unsigned int at a time and stored most significant first, so that they can be read again with
+     InitializeMemory ().  The bits after the last one, up to the end of its byte, are 0.
+
+     \param[out] data Where the bits are stored; it must have room for (num_bits + 7) / 8 bytes
+     \param[in] num_bits The number of bits to read
+     \throw BitBuffer_Input_Exception
+*/
+void BitBuffer::ExtractBits (char *data, unsigned long long num_bits) {
+  unsigned long long i = 0;
+
+  while (num_bits >= g_UINT_SIZE_BITS) {
+    unsigned int x = ReadBits<BitBufferTraceOff> (g_UINT_SIZE_BITS);
+    for (unsigned int j = 0; j < g_UINT_SIZE_BYTES; j++) {
+      data[i] = static_cast<char> ((x >> (g_UINT_SIZE_BITS - ((j + 1) * g_CHAR_SIZE_BITS))) & g_MASK_LOWER_BYTE);
+      i++;
+    }
+    num_bits -= g_UINT_SIZE_BITS;
+  }
+
+  while (num_bits > 0) {
+    unsigned int bits = static_cast<unsigned int> (min (num_bits, static_cast<unsigned long long> (g_CHAR_SIZE_BITS)));
+    unsigned int x = ReadBits<BitBufferTraceOff> (bits);
+    data[i] = static_cast<char> ((x << (g_CHAR_SIZE_BITS - bits)) & g_MASK_LOWER_BYTE);
+    i++;
+    num_bits -= bits;
+  }
+
+  return;
+}
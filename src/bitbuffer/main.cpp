@@ -74,6 +74,33 @@ int main(int argc, char **argv) {
   else if (strcmp (argv[1], "7") == 0) {
     result = TestUnsignedChars ();
   }
+  else if (strcmp (argv[1], "8") == 0) {
+    result = TestMemoryWrite ();
+  }
+  else if (strcmp (argv[1], "9") == 0) {
+    result = TestSeek ();
+  }
+  else if (strcmp (argv[1], "10") == 0) {
+    result = BenchmarkBits ();
+  }
+  else if (strcmp (argv[1], "11") == 0) {
+    result = TestMemoryMap ();
+  }
+  else if (strcmp (argv[1], "12") == 0) {
+    result = TestBulkChars ();
+  }
+  else if (strcmp (argv[1], "13") == 0) {
+    result = TestMemoryRead ();
+  }
+  else if (strcmp (argv[1], "14") == 0) {
+    result = TestAppendBits ();
+  }
+  else if (strcmp (argv[1], "15") == 0) {
+    result = TestPeekBits ();
+  }
+  else if (strcmp (argv[1], "16") == 0) {
+    result = TestExtractBits ();
+  }
   else {
     cerr << "==\tError:  Test case unknown!" << endl;
     return (EXIT_FAILURE);
@@ -0,0 +1,100 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file mmap.cpp
+    Member functions for BitBuffer class related to memory-mapped files.
+*/
+/*******************************************************************/
+
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdlib>  //  exit
+
+#include <fcntl.h>  //  open
+#include <unistd.h>  //  close
+#include <sys/mman.h>  //  mmap, madvise, munmap
+#include <sys/stat.h>  //  fstat
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Map the file into memory for reading.  Since it is read from the beginning to the end, the
+     operating system is told to read ahead.
+
+     \return Returns false if the file cannot be mapped (i.e., it is empty or not a regular file); true otherwise.
+*/
+bool BitBuffer::MapFile () {
+  struct stat file_stat;
+  int fd = open (GetFilename ().c_str (), O_RDONLY);
+
+  if (fd == -1) {
+    cerr << "EE\tCannot open " << GetFilename () << " for reading." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((fstat (fd, &file_stat) != 0) || (!S_ISREG (file_stat.st_mode)) || (file_stat.st_size == 0)) {
+    close (fd);
+    return false;
+  }
+
+  void *map = mmap (NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  madvise (map, file_stat.st_size, MADV_SEQUENTIAL);
+
+  m_Map = static_cast<char*> (map);
+  m_Map_Size = static_cast<unsigned long long> (file_stat.st_size);
+  m_Read_Buffer = m_Map;
+  m_Main_Buffer_Ptr = 0;
+  m_Main_Buffer_End = 0;
+
+  return true;
+}
+
+
+/*!
+     Unmap the file from memory.
+*/
+void BitBuffer::UnmapFile () {
+  if (m_Map != NULL) {
+    munmap (const_cast<char*> (m_Map), m_Map_Size);
+  }
+
+  m_Map = NULL;
+  m_Map_Size = 0;
+  m_Read_Buffer = m_Main_Buffer;
+
+  return;
+}
@@ -34,6 +34,7 @@
 
 #include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE
 #include <cmath>  //  log
+#include <chrono>  //  steady_clock
 
 using namespace std;
 
@@ -356,3 +357,582 @@ int TestUnsignedChars () {
   cerr << "==\tTestUnsignedChars successful!" << endl;
   return (EXIT_SUCCESS);
 }
+
+
+/*!
+     Write random values with a variable width to memory and to a file; the bits written
+     to memory should be identical to the file's contents.
+
+     \return The program exit condition
+*/
+int TestMemoryWrite () {
+  string str = "tmp.data";  //  Input/output filename
+  vector<int> nums;
+  vector<int>::iterator iter;
+  unsigned long long bits_total = 0;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+  }
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+
+  BitBuffer bitbuff_mem;
+  bitbuff_mem.InitializeMemory ();
+
+  for (iter = nums.begin(); iter != nums.end(); iter++) {
+    int bits = BitLength (*iter);
+    bitbuff_out.WriteBits (*iter, bits);
+    bitbuff_mem.WriteBits (*iter, bits);
+    bits_total += bits;
+  }
+  bitbuff_out.Finish ();
+  bitbuff_mem.Finish ();
+
+  if (bitbuff_mem.GetMemoryBits () != bits_total) {
+    cerr << "==\tError:  Mismatch in number of bits (" << bitbuff_mem.GetMemoryBits () << " : " << bits_total << ")" << endl;
+    return (EXIT_FAILURE);
+  }
+
+  //  Compare the file with the memory, byte by byte
+  ifstream fp_in (str.c_str (), ios::in|ios::binary);
+  const char *memory = bitbuff_mem.GetMemory ();
+  char c;
+  unsigned long long pos = 0;
+  while (fp_in.get (c)) {
+    if (c != memory[pos]) {
+      cerr << "==\tError:  Mismatch in byte " << pos << endl;
+      return (EXIT_FAILURE);
+    }
+    pos++;
+  }
+  fp_in.close ();
+
+  if (pos * 8 < bits_total) {
+    cerr << "==\tError:  File is shorter than the bits in memory (" << pos << " bytes)" << endl;
+    return (EXIT_FAILURE);
+  }
+
+  cerr << "==\tTestMemoryWrite successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write random values with a variable width to a file, recording the bit position of each.
+     Then seek to some of those positions and check that the value read back is correct.
+
+     \return The program exit condition
+*/
+int TestSeek () {
+  string str = "tmp.data";  //  Input/output filename
+  vector<int> nums;
+  vector<unsigned long long> positions;
+  unsigned long long bits_total = 0;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+  }
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    if (bitbuff_out.GetBitPosition () != bits_total) {
+      cerr << "==\tError:  Mismatch in write position (" << bitbuff_out.GetBitPosition () << " : " << bits_total << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+    positions.push_back (bits_total);
+    bitbuff_out.WriteBits (nums[i], BitLength (nums[i]));
+    bits_total += BitLength (nums[i]);
+  }
+  bitbuff_out.Finish ();
+
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  for (int i = 0; i < g_TEST_SIZE; i += (rand() % 1000) + 1) {
+    bitbuff_in.SeekBits (positions[i]);
+    if (bitbuff_in.GetBitPosition () != positions[i]) {
+      cerr << "==\tError:  Mismatch in read position (" << bitbuff_in.GetBitPosition () << " : " << positions[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+
+    //  Read a few values sequentially after seeking
+    for (int j = i; (j < i + 10) && (j < g_TEST_SIZE); j++) {
+      int num = static_cast<int> (bitbuff_in.ReadBits (BitLength (nums[j])));
+      if (num != nums[j]) {
+        cerr << "==\tError:  Mismatch in value " << j << " (" << num << " : " << nums[j] << ")" << endl;
+        return (EXIT_FAILURE);
+      }
+    }
+  }
+  bitbuff_in.Finish ();
+
+  cerr << "==\tTestSeek successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write and then read random values with a variable width using the given policy for checking
+     and tracing (see BitBufferTraceOff), printing the time taken per value.
+
+     \param[in] name The name of the policy, for printing
+     \param[in] nums The values to write
+     \param[in] widths The number of bits to write each value with
+     \return The program exit condition
+*/
+template <typename TracePolicy>
+static int BenchmarkPolicy (string name, const vector<unsigned int> &nums, const vector<unsigned int> &widths) {
+  string str = "tmp.data";  //  Input/output filename
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now ();
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  for (unsigned int i = 0; i < nums.size (); i++) {
+    bitbuff_out.WriteBits<TracePolicy> (nums[i], widths[i]);
+  }
+  bitbuff_out.Finish ();
+
+  chrono::steady_clock::time_point middle = chrono::steady_clock::now ();
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  for (unsigned int i = 0; i < nums.size (); i++) {
+    if (bitbuff_in.ReadBits<TracePolicy> (widths[i]) != nums[i]) {
+      cerr << "==\tError:  Mismatch in value " << i << " with " << name << endl;
+      return (EXIT_FAILURE);
+    }
+  }
+  bitbuff_in.Finish ();
+  chrono::steady_clock::time_point end = chrono::steady_clock::now ();
+
+  double write_ns = chrono::duration<double, nano> (middle - start).count () / nums.size ();
+  double read_ns = chrono::duration<double, nano> (end - middle).count () / nums.size ();
+  cerr << "==\t" << name << ":  " << write_ns << " ns per value written, " << read_ns << " ns per value read" << endl;
+
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Benchmark ReadBits () and WriteBits () with and without checking and tracing each call.
+
+     \return The program exit condition
+*/
+int BenchmarkBits () {
+  vector<unsigned int> nums;
+  vector<unsigned int> widths;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers of 1 to 16 bits, as Huffman codewords and static codes would be
+  for (int i = 0; i < g_TEST_SIZE * 10; i++) {
+    unsigned int width = (rand() % 16) + 1;
+    widths.push_back (width);
+    nums.push_back (static_cast<unsigned int> (rand()) & ((1u << width) - 1));
+  }
+
+  if ((BenchmarkPolicy<BitBufferTraceOn> ("BitBufferTraceOn", nums, widths) != EXIT_SUCCESS) ||
+      (BenchmarkPolicy<BitBufferTraceOff> ("BitBufferTraceOff", nums, widths) != EXIT_SUCCESS)) {
+    return (EXIT_FAILURE);
+  }
+
+  cerr << "==\tBenchmarkBits successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write random values with a variable width to a file and read them back from the memory-mapped
+     file, both in order and after seeking to some of them.
+
+     \return The program exit condition
+*/
+int TestMemoryMap () {
+  string str = "tmp.data";  //  Input/output filename
+  vector<int> nums;
+  vector<unsigned long long> positions;
+  unsigned long long bits_total = 0;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+  }
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    positions.push_back (bits_total);
+    bitbuff_out.WriteBits (nums[i], BitLength (nums[i]));
+    bits_total += BitLength (nums[i]);
+  }
+  bitbuff_out.Finish ();
+
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_MMAP);
+  if (bitbuff_in.GetMode () != e_MODE_MMAP) {
+    cerr << "==\tError:  The file could not be memory-mapped" << endl;
+    return (EXIT_FAILURE);
+  }
+
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = static_cast<int> (bitbuff_in.ReadBits (BitLength (nums[i])));
+    if (num != nums[i]) {
+      cerr << "==\tError:  Mismatch in value " << i << " (" << num << " : " << nums[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+  }
+
+  for (int i = 0; i < g_TEST_SIZE; i += (rand() % 1000) + 1) {
+    bitbuff_in.SeekBits (positions[i]);
+    if (bitbuff_in.GetBitPosition () != positions[i]) {
+      cerr << "==\tError:  Mismatch in read position (" << bitbuff_in.GetBitPosition () << " : " << positions[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+
+    int num = static_cast<int> (bitbuff_in.ReadBits (BitLength (nums[i])));
+    if (num != nums[i]) {
+      cerr << "==\tError:  Mismatch in value " << i << " after seeking (" << num << " : " << nums[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+  }
+  bitbuff_in.Finish ();
+
+  cerr << "==\tTestMemoryMap successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write runs of characters of random lengths (some larger than the main buffer), each preceded by a
+     random number of bits so that they may or may not start on a byte boundary.  Read them back from
+     the file and from the memory-mapped file.
+
+     \return The program exit condition
+*/
+int TestBulkChars () {
+  string str = "tmp.data";  //  Input/output filename
+  vector<unsigned int> widths;
+  vector<vector<char> > runs;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate the runs of characters
+  for (int i = 0; i < 100; i++) {
+    int length = rand() % ((i % 10 == 0) ? (3 * g_BITBUFFER_SIZE) : 100);
+    vector<char> run;
+    for (int j = 0; j < length; j++) {
+      run.push_back (static_cast<char> (rand() % 256));
+    }
+    widths.push_back (rand() % 17);
+    runs.push_back (run);
+  }
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  for (unsigned int i = 0; i < runs.size (); i++) {
+    bitbuff_out.WriteBits (i, widths[i]);
+    bitbuff_out.WriteChars (runs[i].data (), static_cast<int> (runs[i].size ()));
+  }
+  bitbuff_out.Finish ();
+
+  e_READWRITE_MODE modes[2] = {e_MODE_READ, e_MODE_MMAP};
+  for (unsigned int m = 0; m < 2; m++) {
+    BitBuffer bitbuff_in;
+    bitbuff_in.Initialize (str, modes[m]);
+    for (unsigned int i = 0; i < runs.size (); i++) {
+      vector<char> run (runs[i].size ());
+      unsigned int x = bitbuff_in.ReadBits (widths[i]);
+      bitbuff_in.ReadChars (run.data (), static_cast<int> (run.size ()));
+      if ((x != (i & ((1u << widths[i]) - 1))) || (run != runs[i])) {
+        cerr << "==\tError:  Mismatch in run " << i << " (mode " << modes[m] << ")" << endl;
+        return (EXIT_FAILURE);
+      }
+    }
+    bitbuff_in.Finish ();
+  }
+
+  cerr << "==\tTestBulkChars successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write random values with a variable width, each followed by a run of characters, to memory.
+     Read them back from the same bytes in memory, both in order and after seeking to some of them.
+
+     \return The program exit condition
+*/
+int TestMemoryRead () {
+  vector<int> nums;
+  vector<unsigned long long> positions;
+  unsigned long long bits_total = 0;
+  char run_out[16];
+  char run_in[16];
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+  }
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.InitializeMemory ();
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    positions.push_back (bits_total);
+    bitbuff_out.WriteBits (nums[i], BitLength (nums[i]));
+    bits_total += BitLength (nums[i]);
+    if (i % 1000 == 0) {
+      for (int j = 0; j < 16; j++) {
+        run_out[j] = static_cast<char> (nums[i] + j);
+      }
+      bitbuff_out.WriteChars (run_out, 16);
+      bits_total += 16 * 8;
+    }
+  }
+  bitbuff_out.Finish ();
+
+  if (bitbuff_out.GetMemoryBytes () * 8 < bits_total) {
+    cerr << "==\tError:  Fewer bytes in memory than bits written (" << bitbuff_out.GetMemoryBytes () << " : " << bits_total << ")" << endl;
+    return (EXIT_FAILURE);
+  }
+
+  BitBuffer bitbuff_in;
+  bitbuff_in.InitializeMemory (bitbuff_out.GetMemory (), bitbuff_out.GetMemoryBytes ());
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = static_cast<int> (bitbuff_in.ReadBits (BitLength (nums[i])));
+    if (num != nums[i]) {
+      cerr << "==\tError:  Mismatch in value " << i << " (" << num << " : " << nums[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+    if (i % 1000 == 0) {
+      bitbuff_in.ReadChars (run_in, 16);
+      for (int j = 0; j < 16; j++) {
+        if (run_in[j] != static_cast<char> (nums[i] + j)) {
+          cerr << "==\tError:  Mismatch in the characters after value " << i << endl;
+          return (EXIT_FAILURE);
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < g_TEST_SIZE; i += (rand() % 1000) + 1) {
+    bitbuff_in.SeekBits (positions[i]);
+    if (bitbuff_in.GetBitPosition () != positions[i]) {
+      cerr << "==\tError:  Mismatch in read position (" << bitbuff_in.GetBitPosition () << " : " << positions[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+
+    int num = static_cast<int> (bitbuff_in.ReadBits (BitLength (nums[i])));
+    if (num != nums[i]) {
+      cerr << "==\tError:  Mismatch in value " << i << " after seeking (" << num << " : " << nums[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+  }
+  bitbuff_in.Finish ();
+
+  cerr << "==\tTestMemoryRead successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write streams of random values with a variable width to memory, and append them one after the
+     other to a file, so that each may start at any bit position.  The file should be identical to
+     one where the values were written directly.
+
+     \return The program exit condition
+*/
+int TestAppendBits () {
+  string str = "tmp.data";  //  Output filename
+  string str_direct = "tmp2.data";  //  Output filename for the values written directly
+  vector<int> nums;
+  vector<int> stream_ends;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers, split into streams of random lengths (some of them empty)
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+    if (rand() % 1000 == 0) {
+      stream_ends.push_back (i);
+      if (rand() % 2 == 0) {
+        stream_ends.push_back (i);
+      }
+    }
+  }
+  stream_ends.push_back (g_TEST_SIZE);
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  BitBuffer bitbuff_direct;
+  bitbuff_direct.Initialize (str_direct, e_MODE_WRITE);
+
+  int start = 0;
+  for (unsigned int s = 0; s < stream_ends.size (); s++) {
+    BitBuffer bitbuff_mem;
+    bitbuff_mem.InitializeMemory ();
+    for (int i = start; i < stream_ends[s]; i++) {
+      bitbuff_mem.WriteBits (nums[i], BitLength (nums[i]));
+      bitbuff_direct.WriteBits (nums[i], BitLength (nums[i]));
+    }
+    bitbuff_mem.Finish ();
+    bitbuff_out.AppendBits (bitbuff_mem.GetMemory (), bitbuff_mem.GetMemoryBits ());
+    start = stream_ends[s];
+  }
+  bitbuff_out.Finish ();
+  bitbuff_direct.Finish ();
+
+  //  Compare the two files, byte by byte
+  ifstream fp_in (str.c_str (), ios::in|ios::binary);
+  ifstream fp_direct (str_direct.c_str (), ios::in|ios::binary);
+  char c;
+  char c_direct;
+  unsigned long long pos = 0;
+  while (fp_direct.get (c_direct)) {
+    if ((!fp_in.get (c)) || (c != c_direct)) {
+      cerr << "==\tError:  Mismatch in byte " << pos << endl;
+      return (EXIT_FAILURE);
+    }
+    pos++;
+  }
+  if (fp_in.get (c)) {
+    cerr << "==\tError:  Appended file is longer than " << pos << " bytes" << endl;
+    return (EXIT_FAILURE);
+  }
+  fp_in.close ();
+  fp_direct.close ();
+
+  cerr << "==\tTestAppendBits successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write random values with a variable width to a file.  Read them back by peeking at more bits
+     than each value has and then skipping only the bits of the value.
+
+     \return The program exit condition
+*/
+int TestPeekBits () {
+  string str = "tmp.data";  //  Input/output filename
+  vector<int> nums;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+  }
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    bitbuff_out.WriteBits (nums[i], BitLength (nums[i]));
+  }
+  //  Enough bits for the last peek
+  bitbuff_out.WriteBits (0, 16);
+  bitbuff_out.Finish ();
+
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int bits = BitLength (nums[i]);
+    int num = static_cast<int> (bitbuff_in.PeekBits (16) >> (16 - bits));
+    if (num != nums[i]) {
+      cerr << "==\tError:  Mismatch in value " << i << " (" << num << " : " << nums[i] << ")" << endl;
+      return (EXIT_FAILURE);
+    }
+    bitbuff_in.SkipBits (bits);
+  }
+  bitbuff_in.Finish ();
+
+  cerr << "==\tTestPeekBits successful!" << endl;
+  return (EXIT_SUCCESS);
+}
+
+
+/*!
+     Write random values with a variable width to a file and read them back in pieces, each of which is
+     extracted to memory with ExtractBits () and then read from there.  The pieces start and end at
+     any bit position.
+
+     \return The program exit condition
+*/
+int TestExtractBits () {
+  string str = "tmp.data";  //  Input/output filename
+  vector<int> nums;
+  vector<int> piece_ends;
+
+  //  Initialize the random seed
+  srand (time (NULL));
+
+  //  Generate random numbers, split into pieces of random lengths
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    int num = (rand() % g_TEST_RANGE) + 1;
+    nums.push_back (num);
+    if (rand() % 1000 == 0) {
+      piece_ends.push_back (i);
+    }
+  }
+  piece_ends.push_back (g_TEST_SIZE);
+
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  for (int i = 0; i < g_TEST_SIZE; i++) {
+    bitbuff_out.WriteBits (nums[i], BitLength (nums[i]));
+  }
+  bitbuff_out.Finish ();
+
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  int start = 0;
+  for (unsigned int p = 0; p < piece_ends.size (); p++) {
+    unsigned long long num_bits = 0;
+    for (int i = start; i < piece_ends[p]; i++) {
+      num_bits += BitLength (nums[i]);
+    }
+
+    vector<char> piece ((num_bits + g_CHAR_SIZE_BITS - 1) / g_CHAR_SIZE_BITS, 0);
+    bitbuff_in.ExtractBits (piece.data (), num_bits);
+
+    BitBuffer bitbuff_mem;
+    bitbuff_mem.InitializeMemory (piece.data (), piece.size ());
+    for (int i = start; i < piece_ends[p]; i++) {
+      int num = static_cast<int> (bitbuff_mem.ReadBits (BitLength (nums[i])));
+      if (num != nums[i]) {
+        cerr << "==\tError:  Mismatch in value " << i << " (" << num << " : " << nums[i] << ")" << endl;
+        return (EXIT_FAILURE);
+      }
+    }
+    bitbuff_mem.Finish ();
+    start = piece_ends[p];
+  }
+  bitbuff_in.Finish ();
+
+  cerr << "==\tTestExtractBits successful!" << endl;
+  return (EXIT_SUCCESS);
+}
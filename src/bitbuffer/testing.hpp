@@ -47,6 +47,15 @@ int GenerateFixed ();
 int GenerateVariable ();
 int TestUnsignedInts ();
 int TestUnsignedChars ();
+int TestMemoryWrite ();
+int TestSeek ();
+int BenchmarkBits ();
+int TestMemoryMap ();
+int TestBulkChars ();
+int TestMemoryRead ();
+int TestAppendBits ();
+int TestPeekBits ();
+int TestExtractBits ();
 
 #endif
 
@@ -79,7 +79,7 @@ class BlockStatistics {
     vector<unsigned int> GetIDsToQScores ();
 
     //  Main processing functions  [process.cpp]
-    void UpdateFrequencyTable (vector<unsigned int> x);
+    void UpdateFrequencyTable (const vector<unsigned int> &x);
     void CopyIDsToQScores (vector<unsigned int> x);
   private:
     //  Main processing functions  [process.cpp]
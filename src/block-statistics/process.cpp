@@ -97,7 +97,7 @@ bool SortByQScore (FrequencyEntry const& lhs, FrequencyEntry const& rhs) {
      
      \param[in] x The vector of integers to update the table with
 */
-void BlockStatistics::UpdateFrequencyTable (vector<unsigned int> x) {
+void BlockStatistics::UpdateFrequencyTable (const vector<unsigned int> &x) {
   for (unsigned int i = 0; i < x.size (); i++) {
     unsigned int pos = x[i];
     m_FrequencyTable[pos].freq++;
@@ -51,3 +51,10 @@ set (MY_CXX_FLAGS "-O3 -Wall -Wno-unused-variable -Wno-unused-but-set-variable")
 
 ##  Set compiler flags based on global variable (if there are any)
 set (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${MY_CXX_FLAGS}")
+
+##  Check every bit read or written by BitBuffer and print them with debugging turned on;
+##    otherwise, these checks are compiled away
+option (BITBUFFER_TRACE "Check and trace each call to BitBuffer::ReadBits () and BitBuffer::WriteBits ()" OFF)
+if (BITBUFFER_TRACE)
+  add_compile_definitions (BITBUFFER_TRACE)
+endif ()
@@ -33,3 +33,8 @@ if (BZIP2_FOUND)
   endif (NOT BZIP2_NEED_PREFIX)
 endif (BZIP2_FOUND)
 
+if (ZSTD_FOUND)
+  include_directories (${ZSTD_INCLUDE_DIRS})
+  target_link_libraries (${TARGET_NAME_EXEC} PRIVATE ${ZSTD_LIBRARIES})
+endif (ZSTD_FOUND)
+
@@ -0,0 +1,38 @@
+###########################################################################
+##  Copyright 2011-2015, 2024-2025 by Raymond Wan (rwan.work@gmail.com)
+##    https://github.com/rwanwork/QScores-Archiver
+##
+##  This file is part of QScores-Archiver.
+##
+##  QScores-Archiver is free software; you can redistribute it and/or
+##  modify it under the terms of the GNU Lesser General Public License
+##  as published by the Free Software Foundation; either version
+##  3 of the License, or (at your option) any later version.
+##
+##  QScores-Archiver is distributed in the hope that it will be useful,
+##  but WITHOUT ANY WARRANTY; without even the implied warranty of
+##  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+##  GNU Lesser General Public License for more details.
+##
+##  You should have received a copy of the GNU Lesser General Public
+##  License along with QScores-Archiver; if not, see
+##  <http://www.gnu.org/licenses/>.
+###########################################################################
+
+
+##  Locate the Zstandard library; CMake has no module for it, so look for its headers and library
+##    directly.  Sets ZSTD_FOUND, ZSTD_INCLUDE_DIRS and ZSTD_LIBRARIES, like find_package (ZLIB).
+find_path (ZSTD_INCLUDE_DIR NAMES zstd.h)
+find_library (ZSTD_LIBRARY NAMES zstd)
+
+if (ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY AND EXISTS "${ZSTD_INCLUDE_DIR}/zdict.h")
+  set (ZSTD_FOUND TRUE)
+  set (ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+  set (ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+  message (STATUS "II\tZstandard has been found:  ${ZSTD_LIBRARY}")
+else ()
+  set (ZSTD_FOUND FALSE)
+  message (STATUS "II\tZstandard has not been found; --zstd will be unavailable.")
+endif ()
+
+mark_as_advanced (ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
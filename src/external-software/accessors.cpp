@@ -114,45 +114,6 @@ bool ExternalSoftware::GetBunzipCommand () const {
 }
 
 
-/*!
-     Test if the Re-Pair command was found
-
-     \return Boolean indicating if the path exists.
-*/
-bool ExternalSoftware::GetRepairCommand () const {
-  if (m_RepairCommand.length () == 0) {
-    return (false);
-  }
-  return (true);
-}
-
-
-/*!
-     Test if the Des-Pair command was found
-
-     \return Boolean indicating if the path exists.
-*/
-bool ExternalSoftware::GetDespairCommand () const {
-  if (m_DespairCommand.length () == 0) {
-    return (false);
-  }
-  return (true);
-}
-
-
-/*!
-     Test if the shuff command was found
-
-     \return Boolean indicating if the path exists.
-*/
-bool ExternalSoftware::GetShuffCommand () const {
-  if (m_ShuffCommand.length () == 0) {
-    return (false);
-  }
-  return (true);
-}
-
-
 /*!
      Get the gzip command
 
@@ -206,67 +167,78 @@ string ExternalSoftware::GetBunzipCommandPath () const {
 
 
 /*!
-     Get the Re-Pair command
+     Show the search paths
 
-     \return Command as a string.
+     \return Search paths as a string.
 */
-string ExternalSoftware::GetRepairCommandPath () const {
-  if (m_RepairCommand.length () == 0) {
+string ExternalSoftware::ShowSearchPaths () const {
+  string result = "";
+  vector<string>::const_iterator iter;
+
+  //  The search paths is empty
+  if (m_SearchPaths.size () == 0) {
     return (g_COMMAND_NOT_FOUND_STR);
   }
-  return (m_RepairCommand);
+  
+  iter = m_SearchPaths.begin ();
+  result = *iter;
+  iter++;
+  for (; iter != m_SearchPaths.end(); iter++) {
+    result = result + ";" + *iter;
+  }
+  result = result + "\n";
+  
+  return (result);
 }
 
 
+
+
 /*!
-     Get the Des-Pair command
+     Get the order of PPM
 
-     \return Command as a string.
+     \return Order as an unsigned int.
 */
-string ExternalSoftware::GetDespairCommandPath () const {
-  if (m_DespairCommand.length () == 0) {
-    return (g_COMMAND_NOT_FOUND_STR);
-  }
-  return (m_DespairCommand);
+unsigned int ExternalSoftware::GetPPMOrder () const {
+  return (m_PPMOrder);
 }
 
 
 /*!
-     Get the shuff command
+     Get the memory of PPM
 
-     \return Command as a string.
+     \return Memory in megabytes.
 */
-string ExternalSoftware::GetShuffCommandPath () const {
-  if (m_ShuffCommand.length () == 0) {
-    return (g_COMMAND_NOT_FOUND_STR);
-  }
-  return (m_ShuffCommand);
+unsigned int ExternalSoftware::GetPPMMemory () const {
+  return (m_PPMMemory);
 }
 
 
 /*!
-     Show the search paths
+     Get the memory of Re-Pair
 
-     \return Search paths as a string.
+     \return Memory in megabytes.
 */
-string ExternalSoftware::ShowSearchPaths () const {
-  string result = "";
-  vector<string>::const_iterator iter;
+unsigned int ExternalSoftware::GetRePairMemory () const {
+  return (m_RePairMemory);
+}
 
-  //  The search paths is empty
-  if (m_SearchPaths.size () == 0) {
-    return (g_COMMAND_NOT_FOUND_STR);
-  }
-  
-  iter = m_SearchPaths.begin ();
-  result = *iter;
-  iter++;
-  for (; iter != m_SearchPaths.end(); iter++) {
-    result = result + ";" + *iter;
-  }
-  result = result + "\n";
-  
-  return (result);
+
+/*!
+     Get the compression level of Zstandard
+
+     \return Compression level.
+*/
+unsigned int ExternalSoftware::GetZstdLevel () const {
+  return (m_ZstdLevel);
 }
 
 
+/*!
+     Get whether Zstandard uses long-distance matching
+
+     \return Returns true if long-distance matching is used; false otherwise.
+*/
+bool ExternalSoftware::GetZstdLong () const {
+  return (m_ZstdLong);
+}
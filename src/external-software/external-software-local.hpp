@@ -60,14 +60,5 @@ const string g_COMMAND_BZIP = "bzip2";
 //!  bunzip2 command
 const string g_COMMAND_BUNZIP = "bunzip2";
 
-//!  Re-Pair command
-const string g_COMMAND_REPAIR = "repair";
-
-//!  Des-Pair command
-const string g_COMMAND_DESPAIR = "despair";
-
-//!  shuff command
-const string g_COMMAND_SHUFF = "shuff";
-
 #endif
 
@@ -27,6 +27,7 @@
 */
 /*******************************************************************/
 
+#include <fstream>
 #include <string>
 #include <vector>
 #include <iomanip>  //  setw
@@ -38,6 +39,9 @@ using namespace std;
 #include "common.hpp"
 #include "external-software-local.hpp"
 #include "external-software.hpp"
+#include "ppm-model.hpp"
+#include "bitbuffer.hpp"
+#include "repair-model.hpp"
 
 
 /*!
@@ -55,14 +59,23 @@ ExternalSoftware::ExternalSoftware (bool debug)
     m_GunzipCommand (""),
     m_BzipCommand (""),
     m_BunzipCommand (""),
-    m_RepairCommand (""),
-    m_DespairCommand (""),
-    m_ShuffCommand (""),
+    m_PPMOrder (g_PPM_DEFAULT_ORDER),
+    m_PPMMemory (g_PPM_DEFAULT_MEMORY),
+    m_RePairMemory (g_REPAIR_DEFAULT_MEMORY),
+    m_ZstdLevel (g_ZSTD_DEFAULT_LEVEL),
+    m_ZstdLong (false),
+    m_ZstdDictionary (),
 #if ZLIB_FOUND
     m_ZStream (NULL),
 #endif
 #if BZIP2_FOUND
     m_BZStream (NULL),
+#endif
+#if ZSTD_FOUND
+    m_ZstdCCtx (NULL),
+    m_ZstdDCtx (NULL),
+    m_ZstdCCtxDictionary (false),
+    m_ZstdDCtxDictionary (false),
 #endif
     m_InBuffer (),
     m_InBufferPtr (0),
@@ -82,11 +95,6 @@ ExternalSoftware::ExternalSoftware (bool debug)
 
   m_SearchPaths.push_back (g_PATH_BIN);
   
-  //  Allocate the input buffer
-  m_DictionaryBufferPtr = 0;
-  m_DictionaryBufferSize = g_INIT_BUFFER_SIZE;
-  m_DictionaryBuffer = (char*) calloc (m_DictionaryBufferSize,  sizeof (char));
-
   //  Allocate the input buffer
   m_InBufferPtr = 0;
   m_InBufferRetrieval = 0;
@@ -112,11 +120,10 @@ ExternalSoftware::~ExternalSoftware () {
 #if BZIP2_FOUND
   free (m_BZStream);
 #endif
-
-  if (m_DictionaryBuffer != NULL) {
-    free (m_DictionaryBuffer);
-  }
-  m_DictionaryBuffer = NULL;
+#if ZSTD_FOUND
+  ZSTD_freeCCtx (m_ZstdCCtx);
+  ZSTD_freeDCtx (m_ZstdDCtx);
+#endif
 
   if (m_InBuffer != NULL) {
     free (m_InBuffer);
@@ -153,14 +160,25 @@ ostream &operator<< (ostream &os, const ExternalSoftware& es) {
   os << left << setw (g_VERBOSE_WIDTH) << "II\t  bzlib2:" << "Unavailable" << endl;
 #endif
 
+#if ZSTD_FOUND
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  zstd:" << "Available (" << ZSTD_versionString () << ")" << endl;
+#else
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  zstd:" << "Unavailable" << endl;
+#endif
+
   os << left << setw (g_VERBOSE_WIDTH) << "II\tExternal software:" << endl;  
   os << left << setw (g_VERBOSE_WIDTH) << "II\t  gzip:" << es.GetGzipCommandPath () << endl;
   os << left << setw (g_VERBOSE_WIDTH) << "II\t  gunzip:" << es.GetGunzipCommandPath () << endl;
   os << left << setw (g_VERBOSE_WIDTH) << "II\t  bzip2:" << es.GetBzipCommandPath () << endl;
   os << left << setw (g_VERBOSE_WIDTH) << "II\t  bunzip2:" << es.GetBunzipCommandPath () << endl;
-  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Re-Pair:" << es.GetRepairCommandPath () << endl;
-  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Des-Pair:" << es.GetDespairCommandPath () << endl;
-  os << left << setw (g_VERBOSE_WIDTH) << "II\t  shuff:" << es.GetShuffCommandPath () << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\tPPM (in-process):" << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Order:" << es.GetPPMOrder () << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Memory (MB):" << es.GetPPMMemory () << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\tRe-Pair (in-process):" << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Memory (MB):" << es.GetRePairMemory () << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\tZstandard:" << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Level:" << es.GetZstdLevel () << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Long-distance matching:" << (es.GetZstdLong () ? "Yes" : "No") << endl;
   os << left << setw (g_VERBOSE_WIDTH) << "II\tSearch paths:" << es.ShowSearchPaths ();
 
   return os;
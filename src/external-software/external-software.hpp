@@ -45,6 +45,41 @@ const bool g_USE_BZLIB = true;
 const bool g_USE_BZLIB = false;
 #endif
 
+#if ZSTD_FOUND
+#include "zstd.h"
+#include "zdict.h"
+const bool g_USE_ZSTD = true;
+#else
+const bool g_USE_ZSTD = false;
+#endif
+
+/*!
+     Default compression level of Zstandard
+*/
+const unsigned int g_ZSTD_DEFAULT_LEVEL = 19;
+
+/*!
+     Maximum compression level of Zstandard
+*/
+const unsigned int g_ZSTD_MAX_LEVEL = 22;
+
+/*!
+     Base 2 logarithm of the window of Zstandard when long-distance matching is used; the same as
+     "zstd --long", so that the decompressor needs no option to accept it
+*/
+const unsigned int g_ZSTD_LONG_WINDOW_LOG = 27;
+
+/*!
+     Smallest dictionary that Zstandard can train, in bytes
+*/
+const unsigned int g_ZSTD_MIN_DICTIONARY_SIZE = 256;
+
+/*!
+     Largest dictionary of Zstandard, in bytes; the dictionary is kept in the header of the
+     compressed file
+*/
+const unsigned int g_ZSTD_MAX_DICTIONARY_SIZE = 16777216;
+
 
 /*!
      \enum e_EXTERNAL_METHOD
@@ -54,7 +89,9 @@ enum e_EXTERNAL_METHOD {
   e_EXTERNAL_METHOD_UNSET,  /*!< External method not yet decided */
   e_EXTERNAL_METHOD_GZIP_ZLIB,  /*!< Gzip/Zlib method */
   e_EXTERNAL_METHOD_BZIP_BZLIB,  /*!< Bzip2/BZlib method */
-  e_EXTERNAL_METHOD_REPAIR,  /*!< Re-Pair method */
+  e_EXTERNAL_METHOD_REPAIR,  /*!< Re-Pair method (in-process) */
+  e_EXTERNAL_METHOD_PPM,  /*!< PPM method (in-process) */
+  e_EXTERNAL_METHOD_ZSTD,  /*!< Zstandard method (zstd library) */
   e_EXTERNAL_METHOD_LAST  /*!< Last external method */
 };
 
@@ -95,17 +132,16 @@ class ExternalSoftware {
     bool GetGunzipCommand () const;
     bool GetBzipCommand () const;
     bool GetBunzipCommand () const;
-    bool GetRepairCommand () const;
-    bool GetDespairCommand () const;
-    bool GetShuffCommand () const;
     std::string GetGzipCommandPath () const;
     std::string GetGunzipCommandPath () const;
     std::string GetBzipCommandPath () const;
     std::string GetBunzipCommandPath () const;
-    std::string GetRepairCommandPath () const;
-    std::string GetDespairCommandPath () const;
-    std::string GetShuffCommandPath () const;
     std::string ShowSearchPaths () const;
+    unsigned int GetPPMOrder () const;
+    unsigned int GetPPMMemory () const;
+    unsigned int GetRePairMemory () const;
+    unsigned int GetZstdLevel () const;
+    bool GetZstdLong () const;
 
     //  Mutators  [mutators.cpp]
     bool SetDebug ();
@@ -114,11 +150,20 @@ class ExternalSoftware {
     bool SetGunzipCommand (std::string cmd);
     bool SetBzipCommand (std::string cmd);
     bool SetBunzipCommand (std::string cmd);
-    bool SetRepairCommand (std::string cmd);
-    bool SetDespairCommand (std::string cmd);
-    bool SetShuffCommand (std::string cmd);
     void AddSearchPath (std::string path);
+    bool SetPPMOrder (unsigned int order);
+    bool SetPPMMemory (unsigned int memory);
+    bool SetRePairMemory (unsigned int memory);
+    bool SetZstdLevel (unsigned int level);
+    void SetZstdLong (bool x);
+
+    //  Zstandard dictionaries  [zstd.cpp]
+    bool TrainZstdDictionary (const vector<char> &samples, const vector<size_t> &sample_sizes, unsigned int capacity, vector<char> &dictionary) const;
+    void SetZstdDictionary (const vector<char> &dictionary);
   private:
+    //  Main processing functions  [process.cpp]
+    void SetOutBuffer (const std::vector<unsigned char> &bytes);
+
     //  Main zlib/gzip processing functions  [gzip-zlib.cpp]
     void ProcessZlib ();
     void UnProcessZlib ();
@@ -133,10 +178,18 @@ class ExternalSoftware {
     void ProcessBzip ();
     void UnProcessBzip ();
 
-    //  Main zlib/gzip processing functions  [repair-shuff.cpp]
+    //  Main Re-Pair processing functions  [repair.cpp]
     void ProcessRePair ();
     void UnProcessRePair ();
 
+    //  Main PPM processing functions  [ppm.cpp]
+    void ProcessPPM ();
+    void UnProcessPPM ();
+
+    //  Main Zstandard processing functions  [zstd.cpp]
+    void ProcessZstd ();
+    void UnProcessZstd ();
+
     //!  Debug mode?
     bool m_Debug;
 
@@ -164,14 +217,23 @@ class ExternalSoftware {
     //!  Command to run bunzip
     std::string m_BunzipCommand;
 
-    //!  Command to run Re-Pair
-    std::string m_RepairCommand;
+    //!  Order of PPM (the number of bytes in its longest context)
+    unsigned int m_PPMOrder;
+
+    //!  Memory of PPM, in megabytes
+    unsigned int m_PPMMemory;
+
+    //!  Memory of Re-Pair, in megabytes
+    unsigned int m_RePairMemory;
 
-    //!  Command to run Des-Pair
-    std::string m_DespairCommand;
+    //!  Compression level of Zstandard
+    unsigned int m_ZstdLevel;
 
-    //!  Command to run Shuff
-    std::string m_ShuffCommand;
+    //!  Use long-distance matching with Zstandard?
+    bool m_ZstdLong;
+
+    //!  Dictionary of Zstandard; empty if there is none
+    vector<char> m_ZstdDictionary;
 
 #if ZLIB_FOUND
     //  Data structure required for using zlib
@@ -183,14 +245,19 @@ class ExternalSoftware {
     bz_stream *m_BZStream;
 #endif
 
-    //!  Dictionary buffer
-    char *m_DictionaryBuffer;
+#if ZSTD_FOUND
+    //!  Context for compressing with Zstandard; kept for all blocks, so that the dictionary is only loaded once
+    ZSTD_CCtx *m_ZstdCCtx;
+
+    //!  Context for decompressing with Zstandard; kept for all blocks, like m_ZstdCCtx
+    ZSTD_DCtx *m_ZstdDCtx;
 
-    //!  Pointer indicating how much of the dictionary buffer has been used
-    unsigned int m_DictionaryBufferPtr;
+    //!  Has m_ZstdDictionary been loaded into m_ZstdCCtx?
+    bool m_ZstdCCtxDictionary;
 
-    //!  Total size of the dictionary buffer
-    unsigned int m_DictionaryBufferSize;
+    //!  Has m_ZstdDictionary been loaded into m_ZstdDCtx?
+    bool m_ZstdDCtxDictionary;
+#endif
 
     //!  Input buffer
     char *m_InBuffer;
@@ -64,7 +64,7 @@ int main(int argc, char **argv) {
     ExternalSoftware external_software (true);
     cout << external_software << endl;
   }
-  else if ((strcmp (argv[1], "3") == 0) || (strcmp (argv[1], "5") == 0)) {
+  else if ((strcmp (argv[1], "3") == 0) || (strcmp (argv[1], "5") == 0) || (strcmp (argv[1], "7") == 0) || (strcmp (argv[1], "9") == 0) || (strcmp (argv[1], "11") == 0)) {
     enum e_EXTERNAL_METHOD method;
     if (strcmp (argv[1], "3") == 0) {
       method = e_EXTERNAL_METHOD_GZIP_ZLIB;
@@ -72,6 +72,15 @@ int main(int argc, char **argv) {
     if (strcmp (argv[1], "5") == 0) {
       method = e_EXTERNAL_METHOD_BZIP_BZLIB;
     }
+    if (strcmp (argv[1], "7") == 0) {
+      method = e_EXTERNAL_METHOD_PPM;
+    }
+    if (strcmp (argv[1], "9") == 0) {
+      method = e_EXTERNAL_METHOD_REPAIR;
+    }
+    if (strcmp (argv[1], "11") == 0) {
+      method = e_EXTERNAL_METHOD_ZSTD;
+    }
     
     unsigned int size = 100;
     char tmp1[32] = "zenzizenzizenzizenzizenzizenzic";
@@ -100,7 +109,7 @@ int main(int argc, char **argv) {
     free (tmp2);
     free (tmp3);
   }
-  else if ((strcmp (argv[1], "4") == 0) || (strcmp (argv[1], "6") == 0)) {
+  else if ((strcmp (argv[1], "4") == 0) || (strcmp (argv[1], "6") == 0) || (strcmp (argv[1], "8") == 0) || (strcmp (argv[1], "10") == 0) || (strcmp (argv[1], "12") == 0)) {
     enum e_EXTERNAL_METHOD method;
     if (strcmp (argv[1], "4") == 0) {
       method = e_EXTERNAL_METHOD_GZIP_ZLIB;
@@ -108,6 +117,15 @@ int main(int argc, char **argv) {
     if (strcmp (argv[1], "6") == 0) {
       method = e_EXTERNAL_METHOD_BZIP_BZLIB;
     }
+    if (strcmp (argv[1], "8") == 0) {
+      method = e_EXTERNAL_METHOD_PPM;
+    }
+    if (strcmp (argv[1], "10") == 0) {
+      method = e_EXTERNAL_METHOD_REPAIR;
+    }
+    if (strcmp (argv[1], "12") == 0) {
+      method = e_EXTERNAL_METHOD_ZSTD;
+    }
     
     unsigned int size = 0;
     char* tmp1 = ReadFile (string (argv[2]), size);
@@ -158,6 +176,54 @@ int main(int argc, char **argv) {
     free (tmp2);
     free (tmp3);
   }
+  else if (strcmp (argv[1], "13") == 0) {
+    //  Train a Zstandard dictionary with each line of the file as a sample, and then compress the file with it
+    unsigned int size = 0;
+    char* tmp1 = ReadFile (string (argv[2]), size);
+    if (tmp1 == NULL) {
+      return (EXIT_FAILURE);
+    }
+
+    vector<char> samples (tmp1, tmp1 + size);
+    vector<size_t> sample_sizes;
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < size; i++) {
+      if ((tmp1[i] == '\n') || (i == size - 1)) {
+        sample_sizes.push_back (i + 1 - start);
+        start = i + 1;
+      }
+    }
+
+    ExternalSoftware external_software1 (true);
+    vector<char> dictionary;
+    if (!external_software1.TrainZstdDictionary (samples, sample_sizes, 4096, dictionary)) {
+      cerr << "EE\tThe dictionary could not be trained." << endl;
+      return (EXIT_FAILURE);
+    }
+    cout << "Dictionary of " << dictionary.size () << " bytes trained from " << sample_sizes.size () << " samples." << endl;
+
+    external_software1.Initialize (e_EXTERNAL_METHOD_ZSTD, true);
+    external_software1.SetZstdDictionary (dictionary);
+    external_software1.Process (tmp1, size, true);
+    unsigned int compressed_size = external_software1.GetOutBufferLength ();
+    char* tmp2 = external_software1.RetrieveChar ();
+    cout << size << " bytes compressed to " << compressed_size << " bytes." << endl;
+
+    ExternalSoftware external_software2 (true);
+    external_software2.Initialize (e_EXTERNAL_METHOD_ZSTD, false);
+    external_software2.SetZstdDictionary (dictionary);
+    external_software2.UnProcess (tmp2, compressed_size, true);
+    unsigned int outbuffer_size = external_software2.GetOutBufferLength ();
+    char* tmp3 = external_software2.RetrieveChar ();
+    if ((outbuffer_size != size) || (!CompareChar (tmp1, tmp3, size))) {
+      cerr << "EE\tStrings failed to match." << endl;
+      return (EXIT_FAILURE);
+    }
+
+    free (tmp1);
+    free (tmp2);
+    free (tmp3);
+  }
   cerr << "Hello" << endl;
   return (EXIT_SUCCESS);
 }
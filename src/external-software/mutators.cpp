@@ -27,6 +27,7 @@
 */
 /*******************************************************************/
 
+#include <fstream>
 #include <vector>
 #include <string>
 #include <cassert>  //  assert
@@ -36,8 +37,12 @@
 using namespace std;
 using namespace boost;
 
+#include "common.hpp"
 #include "external-software-local.hpp"
 #include "external-software.hpp"
+#include "ppm-model.hpp"
+#include "bitbuffer.hpp"
+#include "repair-model.hpp"
 
 
 //  -----------------------------------------------------------------
@@ -112,38 +117,76 @@ bool ExternalSoftware::SetBunzipCommand (string cmd) {
 
 
 /*!
-     Set the Re-Pair command
+     Set the order of PPM
 
-     \return Always returns true.
+     \param[in] order Number of bytes in the longest context, from 0 to g_PPM_MAX_ORDER
+     \return Returns false if the order is out of range; true otherwise.
 */
-bool ExternalSoftware::SetRepairCommand (string cmd) {
-  m_RepairCommand = cmd;
+bool ExternalSoftware::SetPPMOrder (unsigned int order) {
+  if (order > g_PPM_MAX_ORDER) {
+    return false;
+  }
+  m_PPMOrder = order;
   return true;
 }
 
 
 /*!
-     Set the Des-Pair command
+     Set the memory of PPM
 
-     \return Always returns true.
+     \param[in] memory Memory in megabytes, from 1 to g_PPM_MAX_MEMORY
+     \return Returns false if the memory is out of range; true otherwise.
 */
-bool ExternalSoftware::SetDespairCommand (string cmd) {
-  m_DespairCommand = cmd;
+bool ExternalSoftware::SetPPMMemory (unsigned int memory) {
+  if ((memory == 0) || (memory > g_PPM_MAX_MEMORY)) {
+    return false;
+  }
+  m_PPMMemory = memory;
   return true;
 }
 
 
 /*!
-     Set the shuff command
+     Set the memory of Re-Pair
 
-     \return Always returns true.
+     \param[in] memory Memory in megabytes, from 1 to g_REPAIR_MAX_MEMORY
+     \return Returns false if the memory is out of range; true otherwise.
 */
-bool ExternalSoftware::SetShuffCommand (string cmd) {
-  m_ShuffCommand = cmd;
+bool ExternalSoftware::SetRePairMemory (unsigned int memory) {
+  if ((memory == 0) || (memory > g_REPAIR_MAX_MEMORY)) {
+    return false;
+  }
+  m_RePairMemory = memory;
   return true;
 }
 
 
+/*!
+     Set the compression level of Zstandard
+
+     \param[in] level Compression level, from 1 to g_ZSTD_MAX_LEVEL
+     \return Returns false if the level is out of range; true otherwise.
+*/
+bool ExternalSoftware::SetZstdLevel (unsigned int level) {
+  if ((level == 0) || (level > g_ZSTD_MAX_LEVEL)) {
+    return false;
+  }
+  m_ZstdLevel = level;
+  return true;
+}
+
+
+/*!
+     Set whether Zstandard uses long-distance matching
+
+     \param[in] x Set to true to use long-distance matching
+*/
+void ExternalSoftware::SetZstdLong (bool x) {
+  m_ZstdLong = x;
+  return;
+}
+
+
 /*!
      Add a set of search paths to the list of paths
 */
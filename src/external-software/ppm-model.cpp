@@ -0,0 +1,638 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file ppm-model.cpp
+    Member functions for PPMModel class definition .
+*/
+/*******************************************************************/
+
+#include <vector>
+#include <iostream>
+#include <climits>  //  UINT_MAX
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "ppm-model.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Constructor that takes two optional arguments.
+
+     \param[in] order Number of bytes in the longest context; at most g_PPM_MAX_ORDER
+     \param[in] memory Memory for the contexts and symbols, in megabytes; from 1 to g_PPM_MAX_MEMORY
+*/
+PPMModel::PPMModel (unsigned int order, unsigned int memory)
+  : m_Order (order),
+    m_Memory (memory),
+    m_MaxContexts (0),
+    m_MaxSymbols (0),
+    m_Contexts (),
+    m_Symbols (),
+    m_ExcludedStamp (0),
+    m_ExcludedCount (0),
+    m_Low (0),
+    m_Range (0),
+    m_Code (0),
+    m_Step (0),
+    m_Cache (0),
+    m_CacheSize (0),
+    m_Out (NULL),
+    m_In (NULL),
+    m_InLength (0),
+    m_InNext (0)
+{
+  if (m_Order > g_PPM_MAX_ORDER) {
+    cerr << "EE\tThe order of PPM must be at most " << g_PPM_MAX_ORDER << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+  if ((m_Memory == 0) || (m_Memory > g_PPM_MAX_MEMORY)) {
+    cerr << "EE\tThe memory of PPM must be from 1 to " << g_PPM_MAX_MEMORY << " megabytes." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  for (unsigned int i = 0; i < g_PPM_ALPHABET; i++) {
+    m_Excluded[i] = 0;
+  }
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+PPMModel::~PPMModel () {
+}
+
+
+/*!
+     Return m_Order
+
+     \return Number of bytes in the longest context
+*/
+unsigned int PPMModel::GetOrder () const {
+  return m_Order;
+}
+
+
+/*!
+     Return m_Memory
+
+     \return Memory for the contexts and symbols, in megabytes
+*/
+unsigned int PPMModel::GetMemory () const {
+  return m_Memory;
+}
+
+
+//  -----------------------------------------------------------------
+//  Main processing functions
+//  -----------------------------------------------------------------
+
+/*!
+     Compress an array of bytes, after the header (see g_PPM_HEADER_BYTES).
+
+     \param[in] in The bytes to compress
+     \param[in] len The number of bytes in in
+     \param[out] out The vector to write the compressed bytes to
+*/
+void PPMModel::Encode (const unsigned char *in, unsigned int len, vector<unsigned char> &out) {
+  out.clear ();
+  for (unsigned int k = 0; k < 4; k++) {
+    out.push_back (static_cast<unsigned char> ((len >> (k * g_CHAR_SIZE_BITS)) & 0xFF));
+  }
+  out.push_back (static_cast<unsigned char> (m_Order));
+  out.push_back (static_cast<unsigned char> (m_Memory & 0xFF));
+  out.push_back (static_cast<unsigned char> (m_Memory >> g_CHAR_SIZE_BITS));
+
+  //  The first byte of the range coder is always 0, so it is removed at the end
+  m_Out = &out;
+  m_Low = 0;
+  m_Range = 0xFFFFFFFF;
+  m_Cache = 0;
+  m_CacheSize = 1;
+
+  Restart ();
+  for (unsigned int i = 0; i < len; i++) {
+    CheckMemory ();
+    EncodeSymbol (in[i]);
+  }
+  FlushRange ();
+
+  out.erase (out.begin () + g_PPM_HEADER_BYTES);
+  m_Out = NULL;
+
+  return;
+}
+
+
+/*!
+     Decompress an array of bytes made by Encode ().  The order and memory are taken from its header.
+
+     \param[in] in The bytes to decompress
+     \param[in] len The number of bytes in in
+     \param[out] out The vector to write the decompressed bytes to
+*/
+void PPMModel::Decode (const unsigned char *in, unsigned int len, vector<unsigned char> &out) {
+  if (len < g_PPM_HEADER_BYTES) {
+    cerr << "EE\tThe PPM compressed data is too short." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  unsigned int num_bytes = 0;
+  for (unsigned int k = 0; k < 4; k++) {
+    num_bytes |= static_cast<unsigned int> (in[k]) << (k * g_CHAR_SIZE_BITS);
+  }
+  m_Order = in[4];
+  m_Memory = static_cast<unsigned int> (in[5]) | (static_cast<unsigned int> (in[6]) << g_CHAR_SIZE_BITS);
+  if ((m_Order > g_PPM_MAX_ORDER) || (m_Memory == 0) || (m_Memory > g_PPM_MAX_MEMORY)) {
+    cerr << "EE\tThe header of the PPM compressed data is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  //  The first byte of the range coder, which is always 0, was not written
+  m_In = in + g_PPM_HEADER_BYTES;
+  m_InLength = len - g_PPM_HEADER_BYTES;
+  m_InNext = 0;
+  m_Range = 0xFFFFFFFF;
+  m_Code = 0;
+  for (unsigned int i = 1; i < g_PPM_FLUSH_BYTES; i++) {
+    m_Code = (m_Code << g_CHAR_SIZE_BITS) | NextByte ();
+  }
+
+  out.clear ();
+  out.reserve (num_bytes);
+  Restart ();
+  for (unsigned int i = 0; i < num_bytes; i++) {
+    CheckMemory ();
+    out.push_back (DecodeSymbol ());
+  }
+  m_In = NULL;
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Start the model again with only the empty context.  The first time, the arenas are given all of
+     their memory:  a quarter for the contexts and the rest for the symbols, since there are fewer
+     contexts than symbols.
+*/
+void PPMModel::Restart () {
+  if (m_MaxContexts == 0) {
+    unsigned long long bytes = static_cast<unsigned long long> (m_Memory) << 20;
+    m_MaxContexts = static_cast<unsigned int> ((bytes / 4) / sizeof (PPMContext));
+    m_MaxSymbols = static_cast<unsigned int> ((bytes - (bytes / 4)) / sizeof (PPMSymbol));
+    m_Contexts.reserve (m_MaxContexts);
+    m_Symbols.reserve (m_MaxSymbols);
+  }
+
+  m_Contexts.clear ();
+  m_Symbols.clear ();
+  m_History[0] = NewContext ();
+  for (unsigned int k = 1; k <= m_Order; k++) {
+    m_History[k] = g_PPM_NONE;
+  }
+
+  return;
+}
+
+
+/*!
+     Start the model again if the arenas might not have room for the contexts and symbols added by the
+     next byte:  at most one symbol for each order and one context for each order except the highest.
+*/
+void PPMModel::CheckMemory () {
+  if ((m_Contexts.size () + m_Order > m_MaxContexts) || (m_Symbols.size () + m_Order + 1 > m_MaxSymbols)) {
+    Restart ();
+  }
+
+  return;
+}
+
+
+/*!
+     Add a context with no symbols to its arena.
+
+     \return The index of the context
+*/
+unsigned int PPMModel::NewContext () {
+  PPMContext context;
+
+  context.first = g_PPM_NONE;
+  context.distinct = 0;
+  context.total = 0;
+  m_Contexts.push_back (context);
+
+  return static_cast<unsigned int> (m_Contexts.size () - 1);
+}
+
+
+/*!
+     Add a byte to the front of the symbols of a context, with a frequency of 1.
+
+     \param[in] context The index of the context
+     \param[in] c The byte
+     \param[in] shorter The index of the byte in the context which is one byte shorter
+     \return The index of the symbol
+*/
+unsigned int PPMModel::AddSymbol (unsigned int context, unsigned char c, unsigned int shorter) {
+  PPMSymbol symbol;
+
+  symbol.symbol = c;
+  symbol.frequency = 1;
+  symbol.successor = g_PPM_NONE;
+  symbol.next = m_Contexts[context].first;
+  symbol.shorter = shorter;
+  m_Symbols.push_back (symbol);
+
+  m_Contexts[context].first = static_cast<unsigned int> (m_Symbols.size () - 1);
+  m_Contexts[context].distinct++;
+  m_Contexts[context].total++;
+
+  return m_Contexts[context].first;
+}
+
+
+/*!
+     Halve the frequencies of the symbols of a context, so that recent bytes count for more.  Each
+     frequency stays at least 1.
+
+     \param[in] context The index of the context
+*/
+void PPMModel::Rescale (unsigned int context) {
+  unsigned int total = 0;
+
+  for (unsigned int e = m_Contexts[context].first; e != g_PPM_NONE; e = m_Symbols[e].next) {
+    m_Symbols[e].frequency = static_cast<unsigned short> ((m_Symbols[e].frequency + 1) / 2);
+    total += m_Symbols[e].frequency;
+  }
+  m_Contexts[context].total = static_cast<unsigned short> (total);
+
+  return;
+}
+
+
+/*!
+     Encode a byte in the longest context where it has been seen, escaping from the longer ones, and
+     then update the model.  A context is skipped if it has no symbols which are not excluded.
+
+     \param[in] c The byte to encode
+*/
+void PPMModel::EncodeSymbol (unsigned char c) {
+  int found_order = -1;
+
+  m_ExcludedStamp++;
+  m_ExcludedCount = 0;
+  for (unsigned int k = 0; k <= m_Order; k++) {
+    m_Found[k] = g_PPM_NONE;
+  }
+
+  for (int k = static_cast<int> (m_Order); k >= 0; k--) {
+    unsigned int context = m_History[k];
+    if (context == g_PPM_NONE) {
+      continue;
+    }
+
+    //  Without exclusions, the search can stop at the byte since the total of the context is kept
+    unsigned int escape = m_Contexts[context].distinct;
+    if ((m_ExcludedCount == 0) && (m_Contexts[context].first != g_PPM_NONE)) {
+      unsigned int start = 0;
+      unsigned int e = m_Contexts[context].first;
+      for (; (e != g_PPM_NONE) && (m_Symbols[e].symbol != c); e = m_Symbols[e].next) {
+        start += m_Symbols[e].frequency;
+      }
+      if (e != g_PPM_NONE) {
+        EncodeRange (start, m_Symbols[e].frequency, m_Contexts[context].total + escape);
+        m_Found[k] = e;
+        found_order = k;
+        break;
+      }
+    }
+
+    //  Sum the frequencies of the symbols which are not excluded, and then exclude them
+    unsigned int start = 0;
+    unsigned int total = 0;
+    unsigned int entry = g_PPM_NONE;
+    for (unsigned int e = m_Contexts[context].first; e != g_PPM_NONE; e = m_Symbols[e].next) {
+      const PPMSymbol &symbol = m_Symbols[e];
+      if (m_Excluded[symbol.symbol] == m_ExcludedStamp) {
+        continue;
+      }
+      if (symbol.symbol == c) {
+        entry = e;
+        start = total;
+      }
+      total += symbol.frequency;
+      m_Excluded[symbol.symbol] = m_ExcludedStamp;
+      m_ExcludedCount++;
+    }
+    if (total == 0) {
+      continue;
+    }
+
+    if (entry != g_PPM_NONE) {
+      EncodeRange (start, m_Symbols[entry].frequency, total + escape);
+      m_Found[k] = entry;
+      found_order = k;
+      break;
+    }
+    EncodeRange (total, escape, total + escape);
+  }
+
+  //  A byte which has not been seen is coded with all bytes which are not excluded equally likely
+  if (found_order < 0) {
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < c; i++) {
+      if (m_Excluded[i] != m_ExcludedStamp) {
+        start++;
+      }
+    }
+    EncodeRange (start, 1, g_PPM_ALPHABET - m_ExcludedCount);
+  }
+
+  Update (c, found_order);
+
+  return;
+}
+
+
+/*!
+     Decode a byte, as it was encoded by EncodeSymbol (), and then update the model.
+
+     \return The byte
+*/
+unsigned char PPMModel::DecodeSymbol () {
+  int found_order = -1;
+  unsigned char c = 0;
+
+  m_ExcludedStamp++;
+  m_ExcludedCount = 0;
+  for (unsigned int k = 0; k <= m_Order; k++) {
+    m_Found[k] = g_PPM_NONE;
+  }
+
+  for (int k = static_cast<int> (m_Order); k >= 0; k--) {
+    unsigned int context = m_History[k];
+    if (context == g_PPM_NONE) {
+      continue;
+    }
+
+    unsigned int total = m_Contexts[context].total;
+    if (m_ExcludedCount != 0) {
+      total = 0;
+      for (unsigned int e = m_Contexts[context].first; e != g_PPM_NONE; e = m_Symbols[e].next) {
+        if (m_Excluded[m_Symbols[e].symbol] != m_ExcludedStamp) {
+          total += m_Symbols[e].frequency;
+        }
+      }
+    }
+    if (total == 0) {
+      continue;
+    }
+
+    unsigned int escape = m_Contexts[context].distinct;
+    unsigned int target = DecodeTarget (total + escape);
+    if (target < total) {
+      unsigned int start = 0;
+      unsigned int e = m_Contexts[context].first;
+      for (; e != g_PPM_NONE; e = m_Symbols[e].next) {
+        if (m_Excluded[m_Symbols[e].symbol] == m_ExcludedStamp) {
+          continue;
+        }
+        if (start + m_Symbols[e].frequency > target) {
+          break;
+        }
+        start += m_Symbols[e].frequency;
+      }
+      DecodeRange (start, m_Symbols[e].frequency);
+      c = m_Symbols[e].symbol;
+      m_Found[k] = e;
+      found_order = k;
+      break;
+    }
+
+    DecodeRange (total, escape);
+    for (unsigned int e = m_Contexts[context].first; e != g_PPM_NONE; e = m_Symbols[e].next) {
+      if (m_Excluded[m_Symbols[e].symbol] != m_ExcludedStamp) {
+        m_Excluded[m_Symbols[e].symbol] = m_ExcludedStamp;
+        m_ExcludedCount++;
+      }
+    }
+  }
+
+  if (found_order < 0) {
+    unsigned int target = DecodeTarget (g_PPM_ALPHABET - m_ExcludedCount);
+    unsigned int start = 0;
+    unsigned int i = 0;
+    for (; i < g_PPM_ALPHABET; i++) {
+      if (m_Excluded[i] == m_ExcludedStamp) {
+        continue;
+      }
+      if (start == target) {
+        break;
+      }
+      start++;
+    }
+    DecodeRange (start, 1);
+    c = static_cast<unsigned char> (i);
+  }
+
+  Update (c, found_order);
+
+  return c;
+}
+
+
+/*!
+     Update the model after a byte is coded.  Its frequency is increased in the context where it was
+     found and it is added to each longer context.  The contexts of the next byte are then those which
+     follow each of the current ones with this byte; they are made if they do not exist.
+
+     \param[in] c The byte which was coded
+     \param[in] found_order The order of the context where it was found; -1 if it was not found
+*/
+void PPMModel::Update (unsigned char c, int found_order) {
+  unsigned int next_history[g_PPM_MAX_ORDER + 1];
+
+  if (found_order >= 0) {
+    unsigned int context = m_History[found_order];
+    PPMSymbol &symbol = m_Symbols[m_Found[found_order]];
+    symbol.frequency = static_cast<unsigned short> (symbol.frequency + g_PPM_INCREMENT);
+    m_Contexts[context].total = static_cast<unsigned short> (m_Contexts[context].total + g_PPM_INCREMENT);
+    if (symbol.frequency > g_PPM_MAX_FREQUENCY) {
+      Rescale (context);
+    }
+
+    //  The byte is also in each shorter context, since whenever a byte is added to a context, it is
+    //  already in (or also added to) the shorter ones
+    for (int k = found_order; k > 0; k--) {
+      m_Found[k - 1] = m_Symbols[m_Found[k]].shorter;
+    }
+  }
+  for (unsigned int k = static_cast<unsigned int> (found_order + 1); k <= m_Order; k++) {
+    if (m_History[k] != g_PPM_NONE) {
+      m_Found[k] = AddSymbol (m_History[k], c, (k == 0) ? g_PPM_NONE : m_Found[k - 1]);
+    }
+  }
+
+  next_history[0] = 0;
+  for (unsigned int k = 0; k < m_Order; k++) {
+    unsigned int context = m_History[k];
+    if (context == g_PPM_NONE) {
+      next_history[k + 1] = g_PPM_NONE;
+      continue;
+    }
+
+    unsigned int entry = m_Found[k];
+    if (m_Symbols[entry].successor == g_PPM_NONE) {
+      unsigned int successor = NewContext ();
+      m_Symbols[entry].successor = successor;
+    }
+    next_history[k + 1] = m_Symbols[entry].successor;
+  }
+
+  for (unsigned int k = 0; k <= m_Order; k++) {
+    m_History[k] = next_history[k];
+  }
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Range coder
+//  -----------------------------------------------------------------
+
+/*!
+     Encode the interval [start, start + size) out of total.
+
+     \param[in] start The sum of the frequencies of the symbols before this one
+     \param[in] size The frequency of this symbol
+     \param[in] total The total of the frequencies; at most 2 to the power of 16
+*/
+void PPMModel::EncodeRange (unsigned int start, unsigned int size, unsigned int total) {
+  unsigned int r = m_Range / total;
+  m_Low += static_cast<unsigned long long> (start) * r;
+  m_Range = r * size;
+  while (m_Range < g_PPM_RANGE_TOP) {
+    m_Range <<= g_CHAR_SIZE_BITS;
+    ShiftLow ();
+  }
+
+  return;
+}
+
+
+/*!
+     Shift the top byte out of the lowest 32 bits of m_Low.  It is held back in m_Cache (along with any
+     0xFF bytes after it) until it is known whether a carry will be added to it.
+*/
+void PPMModel::ShiftLow () {
+  if ((m_Low < 0xFF000000ULL) || (m_Low > 0xFFFFFFFFULL)) {
+    unsigned char carry = static_cast<unsigned char> (m_Low >> 32);
+    m_Out -> push_back (static_cast<unsigned char> (m_Cache + carry));
+    for (; m_CacheSize > 1; m_CacheSize--) {
+      m_Out -> push_back (static_cast<unsigned char> (0xFF + carry));
+    }
+    m_CacheSize = 0;
+    m_Cache = static_cast<unsigned char> (m_Low >> 24);
+  }
+  m_CacheSize++;
+  m_Low = (m_Low & 0x00FFFFFFULL) << g_CHAR_SIZE_BITS;
+
+  return;
+}
+
+
+/*!
+     Flush the range coder.  The decoder reads 0's after the last byte, so any 0's at the end are removed.
+*/
+void PPMModel::FlushRange () {
+  for (unsigned int i = 0; i < g_PPM_FLUSH_BYTES; i++) {
+    ShiftLow ();
+  }
+
+  while ((m_Out -> size () > g_PPM_HEADER_BYTES + 1) && (m_Out -> back () == 0)) {
+    m_Out -> pop_back ();
+  }
+
+  return;
+}
+
+
+/*!
+     Find where the next symbol is out of total; DecodeRange () must then be called with the interval of
+     the symbol that this is in.
+
+     \param[in] total The total of the frequencies; at most 2 to the power of 16
+     \return A value from 0 to total - 1
+*/
+unsigned int PPMModel::DecodeTarget (unsigned int total) {
+  m_Step = m_Range / total;
+  unsigned int value = m_Code / m_Step;
+
+  return ((value < total) ? value : total - 1);
+}
+
+
+/*!
+     Remove the interval [start, start + size) of the symbol found with DecodeTarget ().
+
+     \param[in] start The sum of the frequencies of the symbols before this one
+     \param[in] size The frequency of this symbol
+*/
+void PPMModel::DecodeRange (unsigned int start, unsigned int size) {
+  m_Code -= start * m_Step;
+  m_Range = m_Step * size;
+  while (m_Range < g_PPM_RANGE_TOP) {
+    m_Code = (m_Code << g_CHAR_SIZE_BITS) | NextByte ();
+    m_Range <<= g_CHAR_SIZE_BITS;
+  }
+
+  return;
+}
+
+
+/*!
+     Return the next byte of the range coder; 0 after the last one.
+
+     \return The next byte
+*/
+unsigned int PPMModel::NextByte () {
+  unsigned int x = (m_InNext < m_InLength) ? m_In[m_InNext] : 0;
+  m_InNext++;
+
+  return x;
+}
@@ -0,0 +1,224 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file ppm-model.hpp
+    Header file for the PPM compressor used by ExternalSoftware.
+*/
+/*******************************************************************/
+
+#ifndef PPM_MODEL_HPP
+#define PPM_MODEL_HPP
+
+#include <climits>  //  UINT_MAX
+
+/*!
+     Maximum order of PPMModel (i.e., the most bytes in a context)
+*/
+const unsigned int g_PPM_MAX_ORDER = 16;
+
+/*!
+     Default order of PPMModel
+*/
+const unsigned int g_PPM_DEFAULT_ORDER = 2;
+
+/*!
+     Default memory of PPMModel, in megabytes
+*/
+const unsigned int g_PPM_DEFAULT_MEMORY = 16;
+
+/*!
+     Maximum memory of PPMModel, in megabytes
+*/
+const unsigned int g_PPM_MAX_MEMORY = 4095;
+
+/*!
+     Index of a context or symbol which does not exist
+*/
+const unsigned int g_PPM_NONE = UINT_MAX;
+
+/*!
+     Number of different bytes
+*/
+const unsigned int g_PPM_ALPHABET = 256;
+
+/*!
+     Amount added to the frequency of a symbol each time it is seen after the first
+*/
+const unsigned int g_PPM_INCREMENT = 2;
+
+/*!
+     Largest frequency of a symbol; when it is passed, the frequencies of the context are halved, so that
+     the total of a context and its escape is at most 2 to the power of 16
+*/
+const unsigned int g_PPM_MAX_FREQUENCY = 250;
+
+/*!
+     Bottom of the range of the range coder; the range is shifted by a byte when it falls below this
+*/
+const unsigned int g_PPM_RANGE_TOP = (1U << 24);
+
+/*!
+     Number of bytes written to flush the range coder
+*/
+const unsigned int g_PPM_FLUSH_BYTES = 5;
+
+/*!
+     Number of bytes at the start of the output of PPMModel:  the length of the input (4 bytes), the
+     order (1 byte) and the memory in megabytes (2 bytes)
+*/
+const unsigned int g_PPM_HEADER_BYTES = 7;
+
+
+/*!
+    \struct PPMContext
+    A context of PPMModel:  the last few bytes.
+*/
+struct PPMContext {
+  //!  Index of the first of its symbols in the arena of symbols; g_PPM_NONE if it has none
+  unsigned int first;
+  //!  Number of symbols which have been seen in this context
+  unsigned short distinct;
+  //!  Sum of the frequencies of the symbols
+  unsigned short total;
+};
+
+
+/*!
+    \struct PPMSymbol
+    A byte which has been seen in a context of PPMModel.
+*/
+struct PPMSymbol {
+  //!  The byte
+  unsigned char symbol;
+  //!  Its frequency
+  unsigned short frequency;
+  //!  Index of the context which is this one followed by the byte; g_PPM_NONE if it has not been made
+  unsigned int successor;
+  //!  Index of the next symbol of the same context; g_PPM_NONE if this is the last one
+  unsigned int next;
+  //!  Index of the same byte in the context which is one byte shorter; g_PPM_NONE for the empty context
+  unsigned int shorter;
+};
+
+
+/*!
+    \class PPMModel
+
+    \details Class used to compress bytes with prediction by partial matching (PPM), so that
+    ExternalSoftware can use PPM without an external program.  Each byte is predicted by the contexts
+    of the last m_Order bytes, the last m_Order - 1 bytes, etc., down to the empty context.  The byte
+    is coded in the longest context where it has been seen, after an escape from each longer context;
+    the bytes of a context which was escaped from are excluded from the shorter ones.  A byte which has
+    not been seen in any context is coded with all bytes equally likely.  As in PPMD, a symbol seen c
+    times has a frequency of 2c - 1 and the escape has the number of distinct symbols of the context,
+    so that it has a probability of d / 2n.  Only the contexts from the one where the byte was coded
+    upwards are updated.  The probabilities are coded with a range coder.
+
+    The contexts and symbols are kept in two arenas, which are vectors whose size is set from
+    m_Memory megabytes when the model starts, so that they never need to grow.  Each context is a
+    node with a linked list of its symbols, and each symbol links to the context that it leads to,
+    so that the contexts form a trie.  Each symbol also links to the same byte in the context which
+    is one byte shorter, so that updating the shorter contexts does not search their lists.  As in
+    PPMd, the model is thrown away and started again when the arenas are full, at the same place when
+    encoding and decoding.
+
+    The output starts with the length of the input, the order and the memory (see
+    g_PPM_HEADER_BYTES), so that Decode () does not need to be told them.
+*/
+class PPMModel {
+  public:
+    //  Constructors/destructors  [ppm-model.cpp]
+    PPMModel (unsigned int order=g_PPM_DEFAULT_ORDER, unsigned int memory=g_PPM_DEFAULT_MEMORY);
+    ~PPMModel ();
+    unsigned int GetOrder () const;
+    unsigned int GetMemory () const;
+
+    //  Main processing functions  [ppm-model.cpp]
+    void Encode (const unsigned char *in, unsigned int len, vector<unsigned char> &out);
+    void Decode (const unsigned char *in, unsigned int len, vector<unsigned char> &out);
+  private:
+    void Restart ();
+    void CheckMemory ();
+    unsigned int NewContext ();
+    unsigned int AddSymbol (unsigned int context, unsigned char c, unsigned int shorter);
+    void Rescale (unsigned int context);
+    void EncodeSymbol (unsigned char c);
+    unsigned char DecodeSymbol ();
+    void Update (unsigned char c, int found_order);
+
+    //  Range coder  [ppm-model.cpp]
+    void EncodeRange (unsigned int start, unsigned int size, unsigned int total);
+    void ShiftLow ();
+    void FlushRange ();
+    unsigned int DecodeTarget (unsigned int total);
+    void DecodeRange (unsigned int start, unsigned int size);
+    unsigned int NextByte ();
+
+    //!  Number of bytes in the longest context
+    unsigned int m_Order;
+    //!  Memory for the contexts and symbols, in megabytes
+    unsigned int m_Memory;
+    //!  Number of contexts that the arena has room for
+    unsigned int m_MaxContexts;
+    //!  Number of symbols that the arena has room for
+    unsigned int m_MaxSymbols;
+
+    //!  Arena of contexts; the first is the empty context
+    vector<PPMContext> m_Contexts;
+    //!  Arena of symbols
+    vector<PPMSymbol> m_Symbols;
+    //!  For each order, the context of the last bytes; g_PPM_NONE if there have not been enough bytes
+    unsigned int m_History[g_PPM_MAX_ORDER + 1];
+    //!  For each order, the index of the current byte in the context of m_History; g_PPM_NONE if unknown
+    unsigned int m_Found[g_PPM_MAX_ORDER + 1];
+    //!  For each byte, the value of m_ExcludedStamp if it is excluded from the current context
+    unsigned int m_Excluded[g_PPM_ALPHABET];
+    //!  Changed for each byte, so that m_Excluded does not need to be cleared
+    unsigned int m_ExcludedStamp;
+    //!  Number of bytes which are excluded
+    unsigned int m_ExcludedCount;
+
+    //!  Low end of the range of the range coder, with room for a carry
+    unsigned long long m_Low;
+    //!  Size of the range
+    unsigned int m_Range;
+    //!  Value read by the decoder, relative to the low end of the range
+    unsigned int m_Code;
+    //!  The range divided by the total, from DecodeTarget ()
+    unsigned int m_Step;
+    //!  Byte held back by the encoder in case of a carry
+    unsigned char m_Cache;
+    //!  Number of bytes held back (the cache and any 0xFF bytes after it)
+    unsigned long long m_CacheSize;
+    //!  Output of the encoder
+    vector<unsigned char> *m_Out;
+    //!  Input of the decoder
+    const unsigned char *m_In;
+    //!  Number of bytes in m_In
+    unsigned int m_InLength;
+    //!  Position of the next byte of m_In
+    unsigned int m_InNext;
+};
+
+#endif
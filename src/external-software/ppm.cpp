@@ -0,0 +1,78 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file ppm.cpp
+    Main processing functions for PPM.
+*/
+/*******************************************************************/
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <climits>
+
+using namespace std;
+
+#include "common.hpp"
+#include "external-software-local.hpp"
+#include "external-software-exception.hpp"
+#include "external-software.hpp"
+#include "ppm-model.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Process the buffer of input using PPM, with the order and memory given by SetPPMOrder () and
+     SetPPMMemory ().  In the end, the compressed data is in m_OutBuffer, occupying m_OutBufferPtr bytes.
+*/
+void ExternalSoftware::ProcessPPM () {
+  PPMModel ppm (GetPPMOrder (), GetPPMMemory ());
+  vector<unsigned char> out;
+
+  ppm.Encode (reinterpret_cast<const unsigned char*> (m_InBuffer), m_InBufferPtr, out);
+  SetOutBuffer (out);
+
+  return;
+}
+
+
+/*!
+     Unprocess the buffer of input using PPM; the order and memory are read from it.  In the end, the
+     decompressed data is in m_OutBuffer, occupying m_OutBufferPtr bytes.
+*/
+void ExternalSoftware::UnProcessPPM () {
+  PPMModel ppm;
+  vector<unsigned char> out;
+
+  ppm.Decode (reinterpret_cast<const unsigned char*> (m_InBuffer), m_InBufferPtr, out);
+  SetOutBuffer (out);
+
+  return;
+}
@@ -99,6 +99,15 @@ void ExternalSoftware::Process (char* buffer, unsigned int buffer_size, bool las
           ProcessBzip ();
         }
         break;
+      case e_EXTERNAL_METHOD_REPAIR :
+        ProcessRePair ();
+        break;
+      case e_EXTERNAL_METHOD_PPM :
+        ProcessPPM ();
+        break;
+      case e_EXTERNAL_METHOD_ZSTD :
+        ProcessZstd ();
+        break;
       default :
         cerr << "EE\tMethod not yet implemented!" << endl;
         exit (EXIT_FAILURE);
@@ -164,6 +173,15 @@ void ExternalSoftware::UnProcess (char* buffer, unsigned int buffer_size, bool l
           UnProcessBzip ();
         }
         break;
+      case e_EXTERNAL_METHOD_REPAIR :
+        UnProcessRePair ();
+        break;
+      case e_EXTERNAL_METHOD_PPM :
+        UnProcessPPM ();
+        break;
+      case e_EXTERNAL_METHOD_ZSTD :
+        UnProcessZstd ();
+        break;
       default :
         cerr << "EE\tMethod not yet implemented!" << endl;
         exit (EXIT_FAILURE);
@@ -201,3 +219,31 @@ unsigned int ExternalSoftware::GetOutBufferLength () const {
 }
 
 
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Copy bytes to m_OutBuffer, enlarging it if necessary.
+
+     \param[in] bytes The bytes to copy
+*/
+void ExternalSoftware::SetOutBuffer (const vector<unsigned char> &bytes) {
+  if (bytes.size () >= UINT_MAX) {
+    cerr << "EE\tOutBuffer size exhausted while executing ExternalSoftware::SetOutBuffer ()!" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  unsigned int size = static_cast<unsigned int> (bytes.size ());
+  if (size > m_OutBufferSize) {
+    m_OutBufferSize = size;
+    m_OutBuffer = (char*) realloc (m_OutBuffer, sizeof (char) * m_OutBufferSize);
+  }
+  if (size != 0) {
+    memcpy (m_OutBuffer, bytes.data (), size);
+  }
+  m_OutBufferPtr = size;
+
+  return;
+}
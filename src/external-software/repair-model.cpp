@@ -0,0 +1,792 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file repair-model.cpp
+    Member functions for RePairModel class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>
+#include <vector>
+#include <iostream>
+#include <climits>  //  UINT_MAX
+#include <cmath>  //  sqrt
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "huffman.hpp"
+#include "repair-model.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Constructor that takes one optional argument.
+
+     \param[in] memory Memory for the sequence, the pairs and the hash table, in megabytes; from 1 to g_REPAIR_MAX_MEMORY
+*/
+RePairModel::RePairModel (unsigned int memory)
+  : m_Memory (memory),
+    m_Sequence (),
+    m_Length (0),
+    m_Pairs (),
+    m_FreePairs (g_REPAIR_NONE),
+    m_Hash (),
+    m_HashMask (0),
+    m_Queue (),
+    m_QueueTop (0),
+    m_Replacing (g_REPAIR_NONE),
+    m_Rules ()
+{
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+RePairModel::~RePairModel () {
+}
+
+
+/*!
+     Return m_Memory
+
+     \return Memory for the sequence, the pairs and the hash table, in megabytes
+*/
+unsigned int RePairModel::GetMemory () const {
+  return m_Memory;
+}
+
+
+/*!
+     Return the length of the chunks that the input is split into.  Each byte of a chunk needs a
+     position, at most one pair, at most two buckets of the hash table and at most one symbol of the
+     rules (since each rule removes at least two positions).
+
+     \return The number of bytes in each chunk, except perhaps the last
+*/
+unsigned int RePairModel::GetChunkLength () const {
+  unsigned long long bytes = static_cast<unsigned long long> (m_Memory) << 20;
+  unsigned long long length = bytes / (sizeof (RePairPosition) + sizeof (RePairPair) + (3 * sizeof (unsigned int)));
+
+  if (length == 0) {
+    length = 1;
+  }
+  if (length > (UINT_MAX / 2)) {
+    length = UINT_MAX / 2;
+  }
+
+  return static_cast<unsigned int> (length);
+}
+
+
+//  -----------------------------------------------------------------
+//  Main processing functions
+//  -----------------------------------------------------------------
+
+/*!
+     Compress an array of bytes.
+
+     \param[in] in The bytes to compress
+     \param[in] len The number of bytes in in
+     \param[out] out The vector to write the compressed bytes to
+*/
+void RePairModel::Encode (const unsigned char *in, unsigned int len, vector<unsigned char> &out) {
+  BitBuffer bitbuffer;
+  unsigned int chunk_length = GetChunkLength ();
+  unsigned int start = 0;
+
+  bitbuffer.InitializeMemory ();
+  Delta_Encode (bitbuffer, len + 1);
+  while (start < len) {
+    unsigned int n = chunk_length;
+    if (n > len - start) {
+      n = len - start;
+    }
+    EncodeChunk (bitbuffer, in + start, n);
+    start += n;
+  }
+  bitbuffer.Finish ();
+
+  const unsigned char *memory = reinterpret_cast<const unsigned char*> (bitbuffer.GetMemory ());
+  out.assign (memory, memory + bitbuffer.GetMemoryBytes ());
+
+  return;
+}
+
+
+/*!
+     Decompress an array of bytes made by Encode ().
+
+     \param[in] in The bytes to decompress
+     \param[in] len The number of bytes in in
+     \param[out] out The vector to write the decompressed bytes to
+*/
+void RePairModel::Decode (const unsigned char *in, unsigned int len, vector<unsigned char> &out) {
+  BitBuffer bitbuffer;
+
+  bitbuffer.InitializeMemory (reinterpret_cast<const char*> (in), len);
+  unsigned int num_bytes = Delta_Decode (bitbuffer) - 1;
+
+  out.clear ();
+  out.reserve (num_bytes);
+  while (out.size () < num_bytes) {
+    DecodeChunk (bitbuffer, out);
+  }
+  if (out.size () != num_bytes) {
+    cerr << "EE\tThe Re-Pair compressed data is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  bitbuffer.Finish ();
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Compress a chunk:  replace the pairs and then code its length, the rules and the sequence.
+
+     \param[in] bitbuffer The BitBuffer to write to
+     \param[in] in The bytes of the chunk
+     \param[in] len The number of bytes in the chunk; at least 1
+*/
+void RePairModel::EncodeChunk (BitBuffer &bitbuffer, const unsigned char *in, unsigned int len) {
+  vector<unsigned int> tmp;
+
+  Initialize (in, len);
+  for (unsigned int pair = QueueMostFrequent (); pair != g_REPAIR_NONE; pair = QueueMostFrequent ()) {
+    if (m_Pairs[pair].count < g_REPAIR_MIN_COUNT) {
+      break;
+    }
+    Replace (pair);
+  }
+
+  Delta_Encode (bitbuffer, len);
+  Delta_Encode (bitbuffer, static_cast<unsigned int> (m_Rules.size () / 2) + 1);
+
+  //  The Huffman class needs symbols from 1
+  if (m_Rules.size () != 0) {
+    for (unsigned int k = 0; k < m_Rules.size (); k++) {
+      tmp.push_back (m_Rules[k] + 1);
+    }
+    Huffman rules_code;
+    rules_code.SetCodewordLimit (g_UINT_SIZE_BITS);
+    rules_code.UpdateFrequencies (tmp);
+    rules_code.EncodeBegin (bitbuffer);
+    rules_code.EncodeMessage (bitbuffer, tmp);
+    rules_code.EncodeFinish (bitbuffer);
+  }
+
+  //  Position 0 is never removed, since only the right symbol of a pair is
+  tmp.clear ();
+  for (unsigned int i = 0; i != g_REPAIR_NONE; i = NextPosition (i)) {
+    tmp.push_back (m_Sequence[i].symbol + 1);
+  }
+  Huffman sequence_code;
+  sequence_code.SetCodewordLimit (g_UINT_SIZE_BITS);
+  sequence_code.UpdateFrequencies (tmp);
+  sequence_code.EncodeBegin (bitbuffer);
+  sequence_code.EncodeMessage (bitbuffer, tmp);
+  sequence_code.EncodeFinish (bitbuffer);
+
+  m_Sequence.clear ();
+  m_Pairs.clear ();
+  m_Hash.clear ();
+  m_Queue.clear ();
+  m_Rules.clear ();
+
+  return;
+}
+
+
+/*!
+     Decompress a chunk made by EncodeChunk () and append it to out.  The rules are expanded with a
+     stack instead of recursion, since they can be nested deeply.
+
+     \param[in] bitbuffer The BitBuffer to read from
+     \param[out] out The vector to append the bytes to
+*/
+void RePairModel::DecodeChunk (BitBuffer &bitbuffer, vector<unsigned char> &out) {
+  vector<unsigned int> rules;
+  vector<unsigned int> sequence;
+  vector<unsigned int> stack;
+
+  unsigned int len = Delta_Decode (bitbuffer);
+  unsigned int num_rules = Delta_Decode (bitbuffer) - 1;
+
+  if (num_rules != 0) {
+    Huffman rules_code;
+    rules_code.DecodeBegin (bitbuffer);
+    rules_code.DecodeMessage (bitbuffer, num_rules * 2, rules);
+    rules_code.DecodeFinish (bitbuffer);
+
+    //  Each rule can only use the bytes and the rules before it
+    for (unsigned int k = 0; k < rules.size (); k++) {
+      rules[k]--;
+      if (rules[k] >= g_REPAIR_ALPHABET + (k / 2)) {
+        cerr << "EE\tThe Re-Pair compressed data is corrupt." << endl;
+        exit (EXIT_FAILURE);
+      }
+    }
+  }
+
+  Huffman sequence_code;
+  sequence_code.DecodeBegin (bitbuffer);
+  sequence_code.DecodeMessage (bitbuffer, sequence_code.GetMessageLength (), sequence);
+  sequence_code.DecodeFinish (bitbuffer);
+
+  size_t end = out.size () + len;
+  for (unsigned int i = 0; i < sequence.size (); i++) {
+    if (sequence[i] - 1 >= g_REPAIR_ALPHABET + num_rules) {
+      cerr << "EE\tThe Re-Pair compressed data is corrupt." << endl;
+      exit (EXIT_FAILURE);
+    }
+    stack.push_back (sequence[i] - 1);
+    while (stack.size () != 0) {
+      unsigned int symbol = stack.back ();
+      stack.pop_back ();
+      if (symbol < g_REPAIR_ALPHABET) {
+        out.push_back (static_cast<unsigned char> (symbol));
+        continue;
+      }
+      symbol = (symbol - g_REPAIR_ALPHABET) * 2;
+      stack.push_back (rules[symbol + 1]);
+      stack.push_back (rules[symbol]);
+    }
+  }
+  if (out.size () != end) {
+    cerr << "EE\tThe Re-Pair compressed data is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  return;
+}
+
+
+/*!
+     Set up the sequence, the pairs and the priority queue for a chunk.  The positions of each pair are
+     added from left to right, so that their lists are in increasing order.
+
+     \param[in] in The bytes of the chunk
+     \param[in] len The number of bytes in the chunk; at least 1
+*/
+void RePairModel::Initialize (const unsigned char *in, unsigned int len) {
+  RePairPosition position;
+
+  m_Length = len;
+  position.next = g_REPAIR_NONE;
+  position.prev = g_REPAIR_NONE;
+  m_Sequence.clear ();
+  m_Sequence.reserve (len);
+  for (unsigned int i = 0; i < len; i++) {
+    position.symbol = in[i];
+    m_Sequence.push_back (position);
+  }
+
+  //  There are never more pairs than positions, so the arena does not need to grow
+  m_Pairs.clear ();
+  m_Pairs.reserve (len);
+  m_FreePairs = g_REPAIR_NONE;
+
+  unsigned int buckets = 1;
+  while (buckets < len) {
+    buckets *= 2;
+  }
+  m_Hash.assign (buckets, g_REPAIR_NONE);
+  m_HashMask = buckets - 1;
+
+  unsigned int queue_size = static_cast<unsigned int> (sqrt (static_cast<double> (len)));
+  if (queue_size < 3) {
+    queue_size = 3;
+  }
+  m_Queue.assign (queue_size, g_REPAIR_NONE);
+  m_QueueTop = queue_size - 2;
+  m_Replacing = g_REPAIR_NONE;
+  m_Rules.clear ();
+
+  for (unsigned int i = 0; i + 1 < len; i++) {
+    AddOccurrence (i);
+  }
+
+  return;
+}
+
+
+/*!
+     Replace each position of a pair with a new symbol, from left to right.  The pairs which overlap it
+     on the left and right are removed and the ones with the new symbol are added.
+
+     \param[in] pair The pair to replace
+*/
+void RePairModel::Replace (unsigned int pair) {
+  unsigned int left = m_Pairs[pair].left;
+  unsigned int right = m_Pairs[pair].right;
+  unsigned int symbol = g_REPAIR_ALPHABET + static_cast<unsigned int> (m_Rules.size () / 2);
+
+  m_Rules.push_back (left);
+  m_Rules.push_back (right);
+  QueueRemove (pair);
+  m_Replacing = pair;
+
+  unsigned int i = m_Pairs[pair].first;
+  while (i != g_REPAIR_NONE) {
+    //  Take the position off the list of the pair
+    unsigned int next = m_Sequence[i].next;
+    m_Sequence[i].next = g_REPAIR_NONE;
+    if (next != g_REPAIR_NONE) {
+      m_Sequence[next].prev = g_REPAIR_NONE;
+    }
+
+    unsigned int j = NextPosition (i);
+    if ((m_Sequence[i].symbol == left) && (j != g_REPAIR_NONE) && (m_Sequence[j].symbol == right)) {
+      unsigned int h = PrevPosition (i);
+      unsigned int k = NextPosition (j);
+      if (h != g_REPAIR_NONE) {
+        RemoveOccurrence (h);
+      }
+      if (k != g_REPAIR_NONE) {
+        RemoveOccurrence (j);
+      }
+      m_Sequence[i].symbol = symbol;
+      RemovePosition (i, j);
+      if (h != g_REPAIR_NONE) {
+        AddOccurrence (h);
+      }
+      if (k != g_REPAIR_NONE) {
+        AddOccurrence (i);
+      }
+    }
+    i = next;
+  }
+
+  m_Replacing = g_REPAIR_NONE;
+  m_Pairs[pair].count = 0;
+  FreePair (pair);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Sequence
+//  -----------------------------------------------------------------
+
+/*!
+     Return the next position of the sequence which has not been removed.
+
+     \param[in] i A position which has not been removed
+     \return The next position; g_REPAIR_NONE if there is none
+*/
+unsigned int RePairModel::NextPosition (unsigned int i) const {
+  unsigned int k = i + 1;
+
+  if ((k < m_Length) && (m_Sequence[k].symbol == g_REPAIR_EMPTY)) {
+    k = m_Sequence[k].next;
+  }
+  if (k >= m_Length) {
+    return g_REPAIR_NONE;
+  }
+
+  return k;
+}
+
+
+/*!
+     Return the previous position of the sequence which has not been removed.
+
+     \param[in] i A position which has not been removed
+     \return The previous position; g_REPAIR_NONE if there is none
+*/
+unsigned int RePairModel::PrevPosition (unsigned int i) const {
+  if (i == 0) {
+    return g_REPAIR_NONE;
+  }
+
+  unsigned int k = i - 1;
+  if (m_Sequence[k].symbol == g_REPAIR_EMPTY) {
+    k = m_Sequence[k].prev;
+  }
+
+  return k;
+}
+
+
+/*!
+     Remove position j, the one after i, and join the run of removed positions between them with the
+     run after j, if there is one.
+
+     \param[in] i A position which has not been removed
+     \param[in] j The position after i
+*/
+void RePairModel::RemovePosition (unsigned int i, unsigned int j) {
+  unsigned int end = j;
+
+  m_Sequence[j].symbol = g_REPAIR_EMPTY;
+  if ((j + 1 < m_Length) && (m_Sequence[j + 1].symbol == g_REPAIR_EMPTY)) {
+    end = m_Sequence[j + 1].next - 1;
+  }
+  m_Sequence[i + 1].next = end + 1;
+  m_Sequence[end].prev = i;
+
+  return;
+}
+
+
+/*!
+     Add position i to the list of the pair which starts there, unless it is a pair such as "aa" which
+     overlaps the previous position of the same pair.
+
+     \param[in] i A position which has not been removed and is not the last one
+*/
+void RePairModel::AddOccurrence (unsigned int i) {
+  unsigned int left = m_Sequence[i].symbol;
+  unsigned int right = m_Sequence[NextPosition (i)].symbol;
+  unsigned int pair = FindPair (left, right);
+
+  if ((left == right) && (pair != g_REPAIR_NONE)) {
+    unsigned int h = PrevPosition (i);
+    if ((h != g_REPAIR_NONE) && (m_Sequence[h].symbol == left) &&
+        ((m_Sequence[h].prev != g_REPAIR_NONE) || (m_Pairs[pair].first == h))) {
+      return;
+    }
+  }
+  if (pair == g_REPAIR_NONE) {
+    pair = AddPair (left, right);
+  }
+
+  //  Added at the end, since the positions are added from left to right
+  m_Sequence[i].next = g_REPAIR_NONE;
+  m_Sequence[i].prev = m_Pairs[pair].last;
+  if (m_Pairs[pair].last != g_REPAIR_NONE) {
+    m_Sequence[m_Pairs[pair].last].next = i;
+  }
+  else {
+    m_Pairs[pair].first = i;
+  }
+  m_Pairs[pair].last = i;
+  IncreaseCount (pair);
+
+  return;
+}
+
+
+/*!
+     Remove position i from the list of the pair which starts there, if it is in it.
+
+     \param[in] i A position which has not been removed and is not the last one
+*/
+void RePairModel::RemoveOccurrence (unsigned int i) {
+  unsigned int pair = FindPair (m_Sequence[i].symbol, m_Sequence[NextPosition (i)].symbol);
+
+  if ((pair == g_REPAIR_NONE) || (pair == m_Replacing)) {
+    return;
+  }
+  if ((m_Sequence[i].prev == g_REPAIR_NONE) && (m_Pairs[pair].first != i)) {
+    return;
+  }
+
+  unsigned int prev = m_Sequence[i].prev;
+  unsigned int next = m_Sequence[i].next;
+  if (prev != g_REPAIR_NONE) {
+    m_Sequence[prev].next = next;
+  }
+  else {
+    m_Pairs[pair].first = next;
+  }
+  if (next != g_REPAIR_NONE) {
+    m_Sequence[next].prev = prev;
+  }
+  else {
+    m_Pairs[pair].last = prev;
+  }
+  m_Sequence[i].next = g_REPAIR_NONE;
+  m_Sequence[i].prev = g_REPAIR_NONE;
+  DecreaseCount (pair);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Pairs
+//  -----------------------------------------------------------------
+
+/*!
+     Return the bucket of the hash table for a pair.
+
+     \param[in] left The left symbol
+     \param[in] right The right symbol
+     \return The bucket
+*/
+unsigned int RePairModel::Hash (unsigned int left, unsigned int right) const {
+  unsigned long long key = (static_cast<unsigned long long> (left) << 32) | right;
+
+  key *= 0x9E3779B97F4A7C15ULL;
+  return static_cast<unsigned int> (key >> 32) & m_HashMask;
+}
+
+
+/*!
+     Find a pair in the hash table.
+
+     \param[in] left The left symbol
+     \param[in] right The right symbol
+     \return The pair; g_REPAIR_NONE if it is not there
+*/
+unsigned int RePairModel::FindPair (unsigned int left, unsigned int right) const {
+  unsigned int pair = m_Hash[Hash (left, right)];
+
+  while ((pair != g_REPAIR_NONE) && ((m_Pairs[pair].left != left) || (m_Pairs[pair].right != right))) {
+    pair = m_Pairs[pair].hash_next;
+  }
+
+  return pair;
+}
+
+
+/*!
+     Add a pair with no positions to the arena and the hash table.
+
+     \param[in] left The left symbol
+     \param[in] right The right symbol
+     \return The pair
+*/
+unsigned int RePairModel::AddPair (unsigned int left, unsigned int right) {
+  unsigned int pair = m_FreePairs;
+
+  if (pair != g_REPAIR_NONE) {
+    m_FreePairs = m_Pairs[pair].hash_next;
+  }
+  else {
+    pair = static_cast<unsigned int> (m_Pairs.size ());
+    m_Pairs.push_back (RePairPair ());
+  }
+
+  unsigned int bucket = Hash (left, right);
+  RePairPair &record = m_Pairs[pair];
+  record.left = left;
+  record.right = right;
+  record.count = 0;
+  record.first = g_REPAIR_NONE;
+  record.last = g_REPAIR_NONE;
+  record.queue_prev = g_REPAIR_NONE;
+  record.queue_next = g_REPAIR_NONE;
+  record.hash_next = m_Hash[bucket];
+  m_Hash[bucket] = pair;
+
+  return pair;
+}
+
+
+/*!
+     Remove a pair with no positions from the hash table and return its record to the arena.
+
+     \param[in] pair The pair
+*/
+void RePairModel::FreePair (unsigned int pair) {
+  unsigned int bucket = Hash (m_Pairs[pair].left, m_Pairs[pair].right);
+
+  if (m_Hash[bucket] == pair) {
+    m_Hash[bucket] = m_Pairs[pair].hash_next;
+  }
+  else {
+    unsigned int e = m_Hash[bucket];
+    while (m_Pairs[e].hash_next != pair) {
+      e = m_Pairs[e].hash_next;
+    }
+    m_Pairs[e].hash_next = m_Pairs[pair].hash_next;
+  }
+
+  m_Pairs[pair].hash_next = m_FreePairs;
+  m_FreePairs = pair;
+
+  return;
+}
+
+
+/*!
+     Add 1 to the count of a pair, moving it to its new bucket of the priority queue.
+
+     \param[in] pair The pair
+*/
+void RePairModel::IncreaseCount (unsigned int pair) {
+  unsigned int count = m_Pairs[pair].count;
+
+  if (QueueBucket (count) != QueueBucket (count + 1)) {
+    QueueRemove (pair);
+    m_Pairs[pair].count++;
+    QueueInsert (pair);
+  }
+  else {
+    m_Pairs[pair].count++;
+  }
+
+  return;
+}
+
+
+/*!
+     Subtract 1 from the count of a pair, moving it to its new bucket of the priority queue.  A pair
+     with no positions is freed.
+
+     \param[in] pair The pair
+*/
+void RePairModel::DecreaseCount (unsigned int pair) {
+  unsigned int count = m_Pairs[pair].count;
+
+  if (QueueBucket (count) != QueueBucket (count - 1)) {
+    QueueRemove (pair);
+    m_Pairs[pair].count--;
+    QueueInsert (pair);
+  }
+  else {
+    m_Pairs[pair].count--;
+  }
+  if (m_Pairs[pair].count == 0) {
+    FreePair (pair);
+  }
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Priority queue
+//  -----------------------------------------------------------------
+
+/*!
+     Return the bucket of the priority queue for a count.
+
+     \param[in] count The count of a pair
+     \return The bucket; 0 if a pair with this count is not in the priority queue
+*/
+unsigned int RePairModel::QueueBucket (unsigned int count) const {
+  if (count < 2) {
+    return 0;
+  }
+  if (count >= m_Queue.size () - 1) {
+    return static_cast<unsigned int> (m_Queue.size () - 1);
+  }
+
+  return count;
+}
+
+
+/*!
+     Add a pair to the front of its bucket of the priority queue, if it occurs at least twice.
+
+     \param[in] pair The pair
+*/
+void RePairModel::QueueInsert (unsigned int pair) {
+  unsigned int bucket = QueueBucket (m_Pairs[pair].count);
+
+  if (bucket == 0) {
+    return;
+  }
+
+  m_Pairs[pair].queue_prev = g_REPAIR_NONE;
+  m_Pairs[pair].queue_next = m_Queue[bucket];
+  if (m_Queue[bucket] != g_REPAIR_NONE) {
+    m_Pairs[m_Queue[bucket]].queue_prev = pair;
+  }
+  m_Queue[bucket] = pair;
+
+  if ((bucket < m_Queue.size () - 1) && (bucket > m_QueueTop)) {
+    m_QueueTop = bucket;
+  }
+
+  return;
+}
+
+
+/*!
+     Remove a pair from the priority queue, if it is in it.
+
+     \param[in] pair The pair
+*/
+void RePairModel::QueueRemove (unsigned int pair) {
+  unsigned int bucket = QueueBucket (m_Pairs[pair].count);
+
+  if (bucket == 0) {
+    return;
+  }
+
+  unsigned int prev = m_Pairs[pair].queue_prev;
+  unsigned int next = m_Pairs[pair].queue_next;
+  if (prev != g_REPAIR_NONE) {
+    m_Pairs[prev].queue_next = next;
+  }
+  else {
+    m_Queue[bucket] = next;
+  }
+  if (next != g_REPAIR_NONE) {
+    m_Pairs[next].queue_prev = prev;
+  }
+  m_Pairs[pair].queue_prev = g_REPAIR_NONE;
+  m_Pairs[pair].queue_next = g_REPAIR_NONE;
+
+  return;
+}
+
+
+/*!
+     Return the most frequent pair.  The last bucket is searched, since its pairs have different
+     counts; otherwise, any pair of the highest bucket which is not empty is taken.
+
+     \return The pair; g_REPAIR_NONE if no pair occurs twice
+*/
+unsigned int RePairModel::QueueMostFrequent () {
+  unsigned int last = static_cast<unsigned int> (m_Queue.size () - 1);
+
+  if (m_Queue[last] != g_REPAIR_NONE) {
+    unsigned int best = m_Queue[last];
+    for (unsigned int pair = m_Pairs[best].queue_next; pair != g_REPAIR_NONE; pair = m_Pairs[pair].queue_next) {
+      if (m_Pairs[pair].count > m_Pairs[best].count) {
+        best = pair;
+      }
+    }
+    return best;
+  }
+
+  while ((m_QueueTop >= 2) && (m_Queue[m_QueueTop] == g_REPAIR_NONE)) {
+    m_QueueTop--;
+  }
+  if (m_QueueTop < 2) {
+    return g_REPAIR_NONE;
+  }
+
+  return m_Queue[m_QueueTop];
+}
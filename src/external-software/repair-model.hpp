@@ -0,0 +1,192 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file repair-model.hpp
+    Header file for the Re-Pair compressor used by ExternalSoftware.
+*/
+/*******************************************************************/
+
+#ifndef REPAIR_MODEL_HPP
+#define REPAIR_MODEL_HPP
+
+#include <climits>  //  UINT_MAX
+
+/*!
+     Default memory of RePairModel, in megabytes
+*/
+const unsigned int g_REPAIR_DEFAULT_MEMORY = 64;
+
+/*!
+     Maximum memory of RePairModel, in megabytes
+*/
+const unsigned int g_REPAIR_MAX_MEMORY = 4095;
+
+/*!
+     Smallest count of a pair which is replaced by a rule; a rule costs about as much as two or three
+     symbols of the sequence, so replacing a rarer pair does not pay for itself
+*/
+const unsigned int g_REPAIR_MIN_COUNT = 6;
+
+/*!
+     Index of a position or pair which does not exist
+*/
+const unsigned int g_REPAIR_NONE = UINT_MAX;
+
+/*!
+     Symbol of a position which has been removed from the sequence
+*/
+const unsigned int g_REPAIR_EMPTY = UINT_MAX;
+
+/*!
+     Number of different bytes; the symbol of the i-th rule (from 0) is g_REPAIR_ALPHABET + i
+*/
+const unsigned int g_REPAIR_ALPHABET = 256;
+
+
+/*!
+    \struct RePairPosition
+    A position of the sequence of RePairModel.
+*/
+struct RePairPosition {
+  //!  The symbol; g_REPAIR_EMPTY if the position has been removed
+  unsigned int symbol;
+  //!  Next position where the same pair starts; for the first of a run of removed positions, the position after the run
+  unsigned int next;
+  //!  Previous position where the same pair starts; for the last of a run of removed positions, the position before the run
+  unsigned int prev;
+};
+
+
+/*!
+    \struct RePairPair
+    A pair of adjacent symbols of RePairModel, with the list of its positions.
+*/
+struct RePairPair {
+  //!  The left symbol
+  unsigned int left;
+  //!  The right symbol
+  unsigned int right;
+  //!  Number of positions where the pair starts
+  unsigned int count;
+  //!  First position where the pair starts
+  unsigned int first;
+  //!  Last position where the pair starts
+  unsigned int last;
+  //!  Previous pair in the same bucket of the priority queue
+  unsigned int queue_prev;
+  //!  Next pair in the same bucket of the priority queue
+  unsigned int queue_next;
+  //!  Next pair in the same bucket of the hash table; or, for a free record, the next free record
+  unsigned int hash_next;
+};
+
+
+/*!
+    \class RePairModel
+
+    \details Class used to compress bytes with Re-Pair [Larsson and Moffat, 2000], so that
+    ExternalSoftware does not need to run the repair, despair and shuff programs.  The most frequent
+    pair of adjacent symbols is replaced by a new symbol (a rule) until no pair occurs
+    g_REPAIR_MIN_COUNT times.  The rules and the sequence which is left are then coded with the
+    Huffman class; the preludes of the Huffman codes give the symbols that are used with
+    interpolative coding.
+
+    The positions of each pair form a linked list in the sequence itself, in increasing order, so
+    that the pairs are replaced from left to right; a pair such as "aa" is not counted where it
+    overlaps the one before.  A removed position is skipped in constant time, since the first and last
+    position of each run of them point to the other end.  The pairs are records in an arena, found
+    with a hash table and kept in a priority queue with a bucket for each count up to the square root
+    of the length.  The pairs which occur more often share the last bucket, which is searched for the
+    most frequent one; there are few of them, so the time is linear in the length.
+
+    The memory for the sequence, the pairs and the hash table is at most m_Memory megabytes, so the
+    input is split into chunks (see GetChunkLength ()), each with its own rules.  The output starts
+    with the length of the input, and each chunk starts with its length, so that Decode () does not
+    need to be told the memory.
+*/
+class RePairModel {
+  public:
+    //  Constructors/destructors  [repair-model.cpp]
+    RePairModel (unsigned int memory=g_REPAIR_DEFAULT_MEMORY);
+    ~RePairModel ();
+    unsigned int GetMemory () const;
+    unsigned int GetChunkLength () const;
+
+    //  Main processing functions  [repair-model.cpp]
+    void Encode (const unsigned char *in, unsigned int len, vector<unsigned char> &out);
+    void Decode (const unsigned char *in, unsigned int len, vector<unsigned char> &out);
+  private:
+    void EncodeChunk (BitBuffer &bitbuffer, const unsigned char *in, unsigned int len);
+    void DecodeChunk (BitBuffer &bitbuffer, vector<unsigned char> &out);
+    void Initialize (const unsigned char *in, unsigned int len);
+    void Replace (unsigned int pair);
+
+    //  Sequence
+    unsigned int NextPosition (unsigned int i) const;
+    unsigned int PrevPosition (unsigned int i) const;
+    void RemovePosition (unsigned int i, unsigned int j);
+    void AddOccurrence (unsigned int i);
+    void RemoveOccurrence (unsigned int i);
+
+    //  Pairs
+    unsigned int Hash (unsigned int left, unsigned int right) const;
+    unsigned int FindPair (unsigned int left, unsigned int right) const;
+    unsigned int AddPair (unsigned int left, unsigned int right);
+    void FreePair (unsigned int pair);
+    void IncreaseCount (unsigned int pair);
+    void DecreaseCount (unsigned int pair);
+
+    //  Priority queue
+    void QueueInsert (unsigned int pair);
+    void QueueRemove (unsigned int pair);
+    unsigned int QueueBucket (unsigned int count) const;
+    unsigned int QueueMostFrequent ();
+
+    //!  Memory for the sequence, the pairs and the hash table, in megabytes
+    unsigned int m_Memory;
+
+    //!  The sequence
+    vector<RePairPosition> m_Sequence;
+    //!  Number of positions in m_Sequence
+    unsigned int m_Length;
+    //!  Arena of pairs
+    vector<RePairPair> m_Pairs;
+    //!  First free record of m_Pairs; g_REPAIR_NONE if there are none
+    unsigned int m_FreePairs;
+    //!  Hash table of the pairs; each bucket is the first pair of a chain
+    vector<unsigned int> m_Hash;
+    //!  Number of buckets of m_Hash minus 1 (a power of 2 minus 1)
+    unsigned int m_HashMask;
+    //!  Buckets of the priority queue, indexed by the count; the last one has the pairs which occur at least that often
+    vector<unsigned int> m_Queue;
+    //!  Highest bucket, except the last, which might not be empty
+    unsigned int m_QueueTop;
+    //!  Pair which is being replaced; g_REPAIR_NONE if there is none
+    unsigned int m_Replacing;
+    //!  Rules, as the left and right symbol of each in turn
+    vector<unsigned int> m_Rules;
+};
+
+#endif
@@ -0,0 +1,81 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file repair.cpp
+    Main processing functions for Re-Pair.
+*/
+/*******************************************************************/
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <climits>
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "external-software-local.hpp"
+#include "external-software-exception.hpp"
+#include "external-software.hpp"
+#include "repair-model.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Process the buffer of input using Re-Pair, with the memory given by SetRePairMemory ().  In the end,
+     the compressed data (the rules and the sequence of each chunk) is in m_OutBuffer, occupying
+     m_OutBufferPtr bytes.
+*/
+void ExternalSoftware::ProcessRePair () {
+  RePairModel repair (GetRePairMemory ());
+  vector<unsigned char> out;
+
+  repair.Encode (reinterpret_cast<const unsigned char*> (m_InBuffer), m_InBufferPtr, out);
+  SetOutBuffer (out);
+
+  return;
+}
+  
+
+/*!
+     Unprocess the buffer of input using Re-Pair.  In the end, the decompressed data is in m_OutBuffer,
+     occupying m_OutBufferPtr bytes.
+*/
+void ExternalSoftware::UnProcessRePair () {
+  RePairModel repair;
+  vector<unsigned char> out;
+
+  repair.Decode (reinterpret_cast<const unsigned char*> (m_InBuffer), m_InBufferPtr, out);
+  SetOutBuffer (out);
+
+  return;
+}
@@ -60,7 +60,6 @@ void ExternalSoftware::Initialize (enum e_EXTERNAL_METHOD method, bool compress)
 
 
 void ExternalSoftware::UnInitialize () {
-  m_DictionaryBufferPtr = 0;
   m_InBufferPtr = 0;
   m_InBufferRetrieval = 0;
   m_OutBufferPtr = 0;
@@ -119,30 +118,6 @@ void ExternalSoftware::InitializePaths () {
         SetBunzipCommand (tmp);
       }
     }
-
-    tmp = *iter + "/" + g_COMMAND_REPAIR;
-    if (!GetRepairCommand ()) {
-      bfs::path tmppath (tmp);
-      if (bfs::exists (tmppath)) {
-        SetRepairCommand (tmp);
-      }
-    }
-
-    tmp = *iter + "/" + g_COMMAND_DESPAIR;
-    if (!GetDespairCommand ()) {
-      bfs::path tmppath (tmp);
-      if (bfs::exists (tmppath)) {
-        SetDespairCommand (tmp);
-      }
-    }
-
-    tmp = *iter + "/" + g_COMMAND_SHUFF;
-    if (!GetShuffCommand ()) {
-      bfs::path tmppath (tmp);
-      if (bfs::exists (tmppath)) {
-        SetShuffCommand (tmp);
-      }
-    }
   }
 
   SetInitializePaths ();
@@ -0,0 +1,214 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file zstd.cpp
+    Main processing functions for Zstandard, using the zstd library.
+*/
+/*******************************************************************/
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <climits>
+
+using namespace std;
+
+#include "external-software-local.hpp"
+#include "external-software-exception.hpp"
+#include "external-software.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Train a dictionary for Zstandard from a set of samples (e.g., the reads of the first block).
+     Zstandard needs a sizeable number of samples, so the training can fail on a small block.
+
+     \param[in] samples The samples, one after the other
+     \param[in] sample_sizes The size of each sample, in bytes
+     \param[in] capacity Largest size of the dictionary, in bytes
+     \param[out] dictionary The dictionary; empty if it could not be trained
+     \return Returns false if the dictionary could not be trained; true otherwise.
+*/
+bool ExternalSoftware::TrainZstdDictionary (const vector<char> &samples, const vector<size_t> &sample_sizes, unsigned int capacity, vector<char> &dictionary) const {
+  dictionary.clear ();
+
+#if ZSTD_FOUND
+  if ((sample_sizes.empty ()) || (sample_sizes.size () >= UINT_MAX)) {
+    return false;
+  }
+
+  dictionary.resize (capacity);
+  size_t result = ZDICT_trainFromBuffer (dictionary.data (), capacity, samples.data (), sample_sizes.data (), static_cast<unsigned int> (sample_sizes.size ()));
+  if (ZDICT_isError (result)) {
+    dictionary.clear ();
+    return false;
+  }
+  dictionary.resize (result);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/*!
+     Set the dictionary of Zstandard, which is used for every block after this.  It is only loaded
+     into the contexts again if it has changed, so it can be set before each block.
+
+     \param[in] dictionary The dictionary; empty for none
+*/
+void ExternalSoftware::SetZstdDictionary (const vector<char> &dictionary) {
+  if (dictionary == m_ZstdDictionary) {
+    return;
+  }
+
+  m_ZstdDictionary = dictionary;
+#if ZSTD_FOUND
+  m_ZstdCCtxDictionary = false;
+  m_ZstdDCtxDictionary = false;
+#endif
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+
+#if ZSTD_FOUND
+/*!
+     Process the buffer of input using the zstd library.  The context is kept for the next block, so
+     that the dictionary is only loaded once.  In the end, the compressed data is in m_OutBuffer,
+     occupying m_OutBufferPtr bytes.
+*/
+void ExternalSoftware::ProcessZstd () {
+  if (m_ZstdCCtx == NULL) {
+    m_ZstdCCtx = ZSTD_createCCtx ();
+    if (m_ZstdCCtx == NULL) {
+      cerr << "EE\tError in initializing zstd for compression." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  //  The parameters are kept by the context, but they are set again in case they have changed; a window
+  //  log of 0 means the default of the level
+  size_t result = ZSTD_CCtx_setParameter (m_ZstdCCtx, ZSTD_c_compressionLevel, static_cast<int> (GetZstdLevel ()));
+  if (!ZSTD_isError (result)) {
+    result = ZSTD_CCtx_setParameter (m_ZstdCCtx, ZSTD_c_enableLongDistanceMatching, GetZstdLong () ? 1 : 0);
+  }
+  if (!ZSTD_isError (result)) {
+    result = ZSTD_CCtx_setParameter (m_ZstdCCtx, ZSTD_c_windowLog, GetZstdLong () ? static_cast<int> (g_ZSTD_LONG_WINDOW_LOG) : 0);
+  }
+  if ((!ZSTD_isError (result)) && (!m_ZstdCCtxDictionary)) {
+    result = ZSTD_CCtx_loadDictionary (m_ZstdCCtx, m_ZstdDictionary.data (), m_ZstdDictionary.size ());
+    m_ZstdCCtxDictionary = true;
+  }
+  if (ZSTD_isError (result)) {
+    cerr << "EE\tError in setting the parameters of zstd -- " << ZSTD_getErrorName (result) << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  vector<unsigned char> out (ZSTD_compressBound (m_InBufferPtr));
+  result = ZSTD_compress2 (m_ZstdCCtx, out.data (), out.size (), m_InBuffer, m_InBufferPtr);
+  if (ZSTD_isError (result)) {
+    cerr << "EE\tZstd compressor error -- " << ZSTD_getErrorName (result) << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+  out.resize (result);
+  SetOutBuffer (out);
+
+  return;
+}
+
+
+/*!
+     Unprocess the buffer of input using the zstd library.  The size of the block is taken from the
+     header of the frame.  In the end, the decompressed data is in m_OutBuffer, occupying
+     m_OutBufferPtr bytes.
+*/
+void ExternalSoftware::UnProcessZstd () {
+  if (m_ZstdDCtx == NULL) {
+    m_ZstdDCtx = ZSTD_createDCtx ();
+    if (m_ZstdDCtx == NULL) {
+      cerr << "EE\tError in initializing zstd for decompression." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if (!m_ZstdDCtxDictionary) {
+    size_t result = ZSTD_DCtx_loadDictionary (m_ZstdDCtx, m_ZstdDictionary.data (), m_ZstdDictionary.size ());
+    if (ZSTD_isError (result)) {
+      cerr << "EE\tError in loading the dictionary of zstd -- " << ZSTD_getErrorName (result) << "." << endl;
+      exit (EXIT_FAILURE);
+    }
+    m_ZstdDCtxDictionary = true;
+  }
+
+  unsigned long long size = ZSTD_getFrameContentSize (m_InBuffer, m_InBufferPtr);
+  if ((size == ZSTD_CONTENTSIZE_UNKNOWN) || (size == ZSTD_CONTENTSIZE_ERROR) || (size >= UINT_MAX)) {
+    cerr << "EE\tZstd decompressor error -- the size of the block is not valid." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  vector<unsigned char> out (size);
+  size_t result = ZSTD_decompressDCtx (m_ZstdDCtx, out.data (), out.size (), m_InBuffer, m_InBufferPtr);
+  if (ZSTD_isError (result)) {
+    cerr << "EE\tZstd decompressor error -- " << ZSTD_getErrorName (result) << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+  if (result != size) {
+    cerr << "EE\tZstd decompressor error -- the block is shorter than its header says." << endl;
+    exit (EXIT_FAILURE);
+  }
+  SetOutBuffer (out);
+
+  return;
+}
+#else
+/*!
+     Report that the zstd library was not found when the program was compiled.
+*/
+void ExternalSoftware::ProcessZstd () {
+  cerr << "EE\tZstandard is unavailable since the zstd library was not found during compilation." << endl;
+  exit (EXIT_FAILURE);
+}
+
+
+/*!
+     Report that the zstd library was not found when the program was compiled.
+*/
+void ExternalSoftware::UnProcessZstd () {
+  cerr << "EE\tZstandard is unavailable since the zstd library was not found during compilation." << endl;
+  exit (EXIT_FAILURE);
+}
+#endif
@@ -0,0 +1,419 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file context.cpp
+    Member functions for HuffmanContext class definition (order-1 Huffman coding).
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <iostream>
+#include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+#include <cmath>  //  log2 ()
+#include <algorithm>  //  max
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "interpolative.hpp"
+#include "huffman.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Default constructor that takes one optional argument.
+     
+     \param[in] debug Set to true if in debug mode; false by default
+*/
+HuffmanContext::HuffmanContext (bool debug)
+  : m_Debug (debug),
+    m_CodewordLimit (0),
+    m_Frequencies (),
+    m_ContextTable (),
+    m_NumTables (0),
+    m_Tables (NULL),
+    m_SharedUsed (false),
+    m_PeekBits (0),
+    m_TableLookup (),
+    m_ContextLookup ()
+{
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+HuffmanContext::~HuffmanContext () {
+  delete [] m_Tables;
+}
+
+
+//  -----------------------------------------------------------------
+//  Accessors and mutators
+//  -----------------------------------------------------------------
+
+/*!
+     Return m_Debug
+
+     \return Debug mode or not
+*/
+bool HuffmanContext::GetDebug () const {
+  return m_Debug;
+}
+
+
+/*!
+     Return m_NumTables
+
+     \return Number of tables, including the shared table (set by EncodeBegin () or DecodeBegin ())
+*/
+unsigned int HuffmanContext::GetTables () const {
+  return m_NumTables;
+}
+
+
+/*!
+     Set m_CodewordLimit, which is passed to each table; it must be set before EncodeBegin () is called.
+
+     \param[in] x Maximum length of a codeword in bits; 0 if there is no limit
+*/
+void HuffmanContext::SetCodewordLimit (unsigned int x) {
+  m_CodewordLimit = x;
+}
+
+
+//  -----------------------------------------------------------------
+//  Encoding functions
+//  -----------------------------------------------------------------
+
+/*!
+     Count the symbols of a message in each context.
+
+     \param[in] x The symbols of the message
+     \param[in] len The number of symbols in x
+*/
+void HuffmanContext::UpdateFrequencies (const unsigned int *x, unsigned int len) {
+  unsigned int prev = 0;
+
+  for (unsigned int i = 0; i < len; i++) {
+    if (prev >= m_Frequencies.size ()) {
+      m_Frequencies.resize (prev + 1);
+    }
+    if (x[i] >= m_Frequencies[prev].size ()) {
+      m_Frequencies[prev].resize (x[i] + 1, 0);
+    }
+    m_Frequencies[prev][x[i]]++;
+    prev = x[i];
+  }
+
+  return;
+}
+
+
+/*!
+     Choose the table of each context, then output which contexts have their own table, followed by
+     the prelude of each table.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void HuffmanContext::EncodeBegin (BitBuffer &bitbuffer) {
+  vector<unsigned int> contexts;
+
+  ChooseTables ();
+
+  //  The contexts with their own table, which are numbered from 1 in this order; add 1 since the first context is 0
+  for (unsigned int c = 0; c < m_ContextTable.size (); c++) {
+    if (m_ContextTable[c] != 0) {
+      contexts.push_back (c + 1);
+    }
+  }
+
+  Delta_Encode (bitbuffer, m_NumTables);
+  if (!contexts.empty ()) {
+    Interpolative_Encode (bitbuffer, contexts);
+  }
+  bitbuffer.WriteBits (m_SharedUsed ? 1 : 0, 1);
+
+  //  Output the preludes; the shared table is left out if no context uses it
+  m_PeekBits = g_HUFFMAN_LOOKUP_BITS;
+  for (unsigned int t = 0; t < m_NumTables; t++) {
+    if ((t == 0) && (!m_SharedUsed)) {
+      continue;
+    }
+    m_Tables[t].EncodeBegin (bitbuffer);
+    m_PeekBits = max (m_PeekBits, m_Tables[t].m_MaximumCodewordLen);
+  }
+
+  return;
+}
+
+
+/*!
+     Encode a message, with each symbol coded by the table of the symbol before it.  As in
+     Huffman::EncodeMessage (), the codewords are packed into 64 bits and written out 32 bits at a time.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+     \param[in] len The number of symbols in x.
+*/
+void HuffmanContext::EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len) {
+  unsigned long long packed = 0;
+  unsigned int packed_bits = 0;
+  unsigned int prev = 0;
+
+  for (unsigned int i = 0; i < len; i++) {
+    const Huffman &table = m_Tables[m_ContextTable[prev]];
+    packed = (packed << table.m_CodewordLen[x[i]]) | table.m_Codeword[x[i]];
+    packed_bits += table.m_CodewordLen[x[i]];
+    if (packed_bits >= g_UINT_SIZE_BITS) {
+      packed_bits -= g_UINT_SIZE_BITS;
+      bitbuffer.WriteBits<BitBufferTraceOff> (static_cast<unsigned int> (packed >> packed_bits), g_UINT_SIZE_BITS);
+    }
+    prev = x[i];
+  }
+  bitbuffer.WriteBits<BitBufferTraceOff> (static_cast<unsigned int> (packed), packed_bits);
+
+  return;
+}
+
+
+/*!
+     Finish encoding by writing out a 0 of length m_PeekBits, so that the decoder can always peek at
+     that many bits (see Huffman::EncodeFinish ()).
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void HuffmanContext::EncodeFinish (BitBuffer &bitbuffer) {
+  bitbuffer.WriteBits (0, m_PeekBits);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Decoding functions
+//  -----------------------------------------------------------------
+
+/*!
+     Read in which contexts have their own table and the prelude of each table.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void HuffmanContext::DecodeBegin (BitBuffer &bitbuffer) {
+  vector<unsigned int> contexts;
+  unsigned int maximum_symbol = 0;
+
+  m_NumTables = Delta_Decode (bitbuffer);
+  if (m_NumTables > 1) {
+    Interpolative_Decode (bitbuffer, contexts, m_NumTables - 1);
+  }
+  m_SharedUsed = (bitbuffer.ReadBits (1) == 1);
+
+  delete [] m_Tables;
+  m_Tables = new Huffman[m_NumTables];
+  m_PeekBits = g_HUFFMAN_LOOKUP_BITS;
+  for (unsigned int t = 0; t < m_NumTables; t++) {
+    if (GetDebug ()) {
+      m_Tables[t].SetDebug ();
+    }
+    if ((t == 0) && (!m_SharedUsed)) {
+      continue;
+    }
+    m_Tables[t].DecodeBegin (bitbuffer);
+    m_PeekBits = max (m_PeekBits, m_Tables[t].m_MaximumCodewordLen);
+    maximum_symbol = max (maximum_symbol, m_Tables[t].m_MaximumSymbol);
+  }
+
+  //  Every symbol that can be decoded is a context
+  if (!contexts.empty ()) {
+    maximum_symbol = max (maximum_symbol, contexts.back () - 1);
+  }
+  m_ContextTable.assign (maximum_symbol + 1, 0);
+  for (unsigned int i = 0; i < contexts.size (); i++) {
+    m_ContextTable[contexts[i] - 1] = i + 1;
+  }
+
+  //  Combine the first symbol of each lookup and its length into one value, so that each symbol needs one access
+  m_TableLookup.assign (m_NumTables, vector<unsigned int> (1 << g_HUFFMAN_LOOKUP_BITS, 0));
+  for (unsigned int t = 0; t < m_NumTables; t++) {
+    if ((t == 0) && (!m_SharedUsed)) {
+      continue;
+    }
+    for (unsigned int entry = 0; entry < (1u << g_HUFFMAN_LOOKUP_BITS); entry++) {
+      if (m_Tables[t].m_LookupCount[entry] != 0) {
+        m_TableLookup[t][entry] = (m_Tables[t].m_LookupSymbol[entry * g_HUFFMAN_LOOKUP_SYMBOLS] << g_CHAR_SIZE_BITS) | m_Tables[t].m_LookupFirstLen[entry];
+      }
+    }
+  }
+  m_ContextLookup.assign (m_ContextTable.size (), NULL);
+  for (unsigned int c = 0; c < m_ContextTable.size (); c++) {
+    m_ContextLookup[c] = m_TableLookup[m_ContextTable[c]].data ();
+  }
+
+  return;
+}
+
+
+/*!
+     Decode a message of a given length and append it to a vector.  Each symbol is looked up in
+     m_TableLookup for the table of the symbol before it; only the first codeword of the lookup is used,
+     since the next one may be in another table.  A codeword which is longer than g_HUFFMAN_LOOKUP_BITS
+     is found with the search over m_LJLimit, as in Huffman::DecodeSymbol ().
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len Length of the message, which must be the same as when it was encoded
+     \param[out] x The vector to append the message to
+*/
+void HuffmanContext::DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x) {
+  unsigned int prev = 0;
+  unsigned int start = static_cast<unsigned int> (x.size ());
+  const unsigned int peek_bits = m_PeekBits;
+  const unsigned int * const *context_lookup = m_ContextLookup.data ();
+
+  x.resize (start + len);
+  unsigned int *out = x.data () + start;
+
+  try {
+    for (unsigned int i = 0; i < len; i++) {
+      //  EncodeFinish () wrote m_PeekBits bits after the last codeword, so they can always be peeked at
+      unsigned int window = bitbuffer.PeekBits<BitBufferTraceOff> (peek_bits);
+      unsigned int entry = context_lookup[prev][window >> (peek_bits - g_HUFFMAN_LOOKUP_BITS)];
+      unsigned int symbol = entry >> g_CHAR_SIZE_BITS;
+      unsigned int l = entry & g_MASK_LOWER_BYTE;
+
+      if (l == 0) {
+        const Huffman &table = m_Tables[m_ContextTable[prev]];
+        unsigned int v = window >> (peek_bits - table.m_MaximumCodewordLen);
+        l = 1;
+        while (v >= table.m_LJLimit[l]) {
+          l++;
+        }
+        symbol = table.m_SymsUsed[((v >> (table.m_MaximumCodewordLen - l)) - table.m_Base[l]) + table.m_Offset[l]];
+      }
+
+      bitbuffer.SkipBits (l);
+      out[i] = symbol;
+      prev = symbol;
+    }
+  }
+  catch (exception &BitBuffer_Input_Exception) {
+    cerr << "EE\tOpps -- unexpected end to the input stream of bits!" << endl;
+  }
+
+  return;
+}
+
+
+/*!
+     Finish decoding by reading in the 0 written out by EncodeFinish ().
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void HuffmanContext::DecodeFinish (BitBuffer &bitbuffer) {
+  bitbuffer.ReadBits (m_PeekBits);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Decide which contexts have their own table and give each table its frequencies.  A context has its
+     own table if coding its symbols with their own distribution, instead of the distribution of all of
+     the symbols, saves more bits than the estimated size of its prelude (g_HUFFMAN_CONTEXT_SYMBOL_BITS
+     for each of its distinct symbols and g_HUFFMAN_CONTEXT_FIXED_BITS).  The rest share table 0.
+*/
+void HuffmanContext::ChooseTables () {
+  vector<unsigned long long> totals;
+  unsigned long long total = 0;
+
+  //  The frequency of each symbol over all of the contexts
+  for (unsigned int c = 0; c < m_Frequencies.size (); c++) {
+    if (m_Frequencies[c].size () > totals.size ()) {
+      totals.resize (m_Frequencies[c].size (), 0);
+    }
+    for (unsigned int s = 0; s < m_Frequencies[c].size (); s++) {
+      totals[s] += m_Frequencies[c][s];
+      total += m_Frequencies[c][s];
+    }
+  }
+
+  //  Any symbol can be a context
+  m_ContextTable.assign (max (totals.size (), m_Frequencies.size ()), 0);
+  m_NumTables = 1;
+  for (unsigned int c = 0; c < m_Frequencies.size (); c++) {
+    unsigned long long count = 0;
+    unsigned int distinct = 0;
+    for (unsigned int s = 0; s < m_Frequencies[c].size (); s++) {
+      if (m_Frequencies[c][s] != 0) {
+        count += m_Frequencies[c][s];
+        distinct++;
+      }
+    }
+    if (count == 0) {
+      continue;
+    }
+
+    double saving = 0.0;
+    for (unsigned int s = 0; s < m_Frequencies[c].size (); s++) {
+      if (m_Frequencies[c][s] != 0) {
+        saving += m_Frequencies[c][s] * log2 ((static_cast<double> (m_Frequencies[c][s]) * total) / (static_cast<double> (count) * totals[s]));
+      }
+    }
+    if (saving > (static_cast<double> (distinct) * g_HUFFMAN_CONTEXT_SYMBOL_BITS) + g_HUFFMAN_CONTEXT_FIXED_BITS) {
+      m_ContextTable[c] = m_NumTables;
+      m_NumTables++;
+    }
+  }
+
+  delete [] m_Tables;
+  m_Tables = new Huffman[m_NumTables];
+  for (unsigned int t = 0; t < m_NumTables; t++) {
+    if (GetDebug ()) {
+      m_Tables[t].SetDebug ();
+    }
+    m_Tables[t].SetCodewordLimit (m_CodewordLimit);
+  }
+
+  for (unsigned int c = 0; c < m_Frequencies.size (); c++) {
+    for (unsigned int s = 0; s < m_Frequencies[c].size (); s++) {
+      m_Tables[m_ContextTable[c]].UpdateFrequency (s, m_Frequencies[c][s]);
+    }
+  }
+  m_SharedUsed = (m_Tables[0].GetMessageLength () != 0);
+
+  return;
+}
+
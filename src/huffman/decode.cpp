@@ -88,6 +88,32 @@ void Huffman::DecodeBegin (BitBuffer &bitbuffer) {
     cerr << endl << endl;
   }
 
+  if (m_Streams > 1) {
+    DecodeStreamsBegin (bitbuffer);
+  }
+
+  return;
+}
+
+
+/*!
+     Commence decoding a message which was coded with a code that the decoder already has (see the
+     second EncodeBegin ()).  Only the length of the message is read.
+     
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] lengths The length of each symbol's codeword, indexed by the symbol; 0 if it has no codeword
+*/
+void Huffman::DecodeBegin (BitBuffer &bitbuffer, const vector<unsigned int> &lengths) {
+  m_MessageLength = Delta_Decode (bitbuffer);
+  SetCodewordLengths (lengths);
+
+  SetWBaseOffset ();
+  PreDecodeMessage ();
+
+  if (m_Streams > 1) {
+    DecodeStreamsBegin (bitbuffer);
+  }
+
   return;
 }
 
@@ -102,19 +128,62 @@ void Huffman::DecodeBegin (BitBuffer &bitbuffer) {
 vector<unsigned int> Huffman::DecodeMessage (BitBuffer &bitbuffer, unsigned int len) {
   vector<unsigned int> tmp;
 
+  DecodeMessage (bitbuffer, len, tmp);
+
+  return (tmp);
+}
+
+
+/*!
+     Decode part or all of the message, appending it to a vector.  While enough symbols remain,
+     each lookup in the table decodes as many symbols as fit in g_HUFFMAN_LOOKUP_BITS bits.
+     
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len Length of the message to decode; can be less than m_MessageLength if we want to decode a piece at a time
+     \param[out] x The vector to append the message to
+*/
+void Huffman::DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x) {
+  unsigned int i = 0;
+
   //  Ensure we aren't decoding too much
   if (m_MessageLengthDecoded + len > m_MessageLength) {
     len = m_MessageLength - m_MessageLengthDecoded;
   }
-  
-  for (unsigned int i = 0; i < len; i++) {
-    unsigned int x = DecodeSymbol (bitbuffer);
-    tmp.push_back (x);
+
+  if (m_Streams > 1) {
+    DecodeStreams (len, x);
+    return;
+  }
+
+  try {
+    while (i < len) {
+      //  Every symbol left takes at least 1 bit and EncodeFinish () wrote m_MaximumCodewordLen bits
+      //  after them, so at least this many bits can be peeked at
+      unsigned int remaining = (m_MessageLength - m_MessageLengthDecoded) - i;
+      if ((remaining + m_MaximumCodewordLen >= m_PeekBits) && (!GetDebug ())) {
+        unsigned int entry = bitbuffer.PeekBits<BitBufferTraceOff> (m_PeekBits) >> (m_PeekBits - g_HUFFMAN_LOOKUP_BITS);
+        unsigned int count = m_LookupCount[entry];
+        if ((count != 0) && (count <= len - i)) {
+          for (unsigned int j = 0; j < count; j++) {
+            x.push_back (m_LookupSymbol[(entry * g_HUFFMAN_LOOKUP_SYMBOLS) + j]);
+          }
+          bitbuffer.SkipBits (m_LookupLen[entry]);
+          i += count;
+          continue;
+        }
+      }
+
+      x.push_back (DecodeSymbol (bitbuffer));
+      i++;
+    }
+  }
+  catch (exception &BitBuffer_Input_Exception) {
+    cerr << "EE\tOpps -- unexpected end to the input stream of bits!" << endl;
   }
   
   m_MessageLengthDecoded += len;
 
-  return (tmp);
+  return;
 }
 
 
@@ -125,10 +194,15 @@ vector<unsigned int> Huffman::DecodeMessage (BitBuffer &bitbuffer, unsigned int
      \param[in] bitbuffer The bitbuffer to write the bits to.
 */
 void Huffman::DecodeFinish (BitBuffer &bitbuffer) {
-  unsigned int bits_to_read = m_MaximumCodewordLen - m_VBits;
-  
-  m_V = (m_V << bits_to_read) + bitbuffer.ReadBits (bits_to_read);
-  m_VBits += bits_to_read;
+  //  The streams have already been read in by DecodeBegin ()
+  if (m_Streams > 1) {
+    m_StreamReaders.clear ();
+    m_StreamData.clear ();
+
+    return;
+  }
+
+  bitbuffer.ReadBits (m_MaximumCodewordLen);
   
   return;
 }
@@ -169,11 +243,72 @@ void Huffman::PreDecodeMessage () {
   for (unsigned int i = 1; i <= m_DistinctSymbols; i++) {
     m_SymsUsed[m_Table[tmp[i]]] = tmp[i];
   }    
+
+  SetLookupTable ();
   
   return;
 }
 
 
+/*!
+     Fill in the table used by DecodeMessage () to decode the codewords in the next
+     g_HUFFMAN_LOOKUP_BITS bits with one access.  For each value of these bits, the codewords are
+     found with the search over m_LJLimit, as DecodeSymbol () would, with the bits after them taken
+     to be 0.  Since m_LJLimit[l] is a multiple of 2^(m_MaximumCodewordLen - l), the search gives the
+     correct length for any codeword which fits in the bits; if it does not fit, then it is left for
+     the next lookup.
+*/
+void Huffman::SetLookupTable () {
+  unsigned int window_mask = (1 << g_HUFFMAN_LOOKUP_BITS) - 1;
+
+  m_PeekBits = max (m_MaximumCodewordLen, g_HUFFMAN_LOOKUP_BITS);
+  m_LookupSymbol.assign ((1 << g_HUFFMAN_LOOKUP_BITS) * g_HUFFMAN_LOOKUP_SYMBOLS, 0);
+  m_LookupCount.assign (1 << g_HUFFMAN_LOOKUP_BITS, 0);
+  m_LookupLen.assign (1 << g_HUFFMAN_LOOKUP_BITS, 0);
+  m_LookupFirstLen.assign (1 << g_HUFFMAN_LOOKUP_BITS, 0);
+
+  //  Nothing to decode
+  if (m_MaximumCodewordLen == 0) {
+    return;
+  }
+
+  for (unsigned int i = 0; i <= window_mask; i++) {
+    unsigned int used = 0;
+    unsigned int count = 0;
+    while (count < g_HUFFMAN_LOOKUP_SYMBOLS) {
+      //  The next m_MaximumCodewordLen bits after the ones used, followed by 0's
+      unsigned int v = (i << used) & window_mask;
+      if (m_MaximumCodewordLen >= g_HUFFMAN_LOOKUP_BITS) {
+        v = v << (m_MaximumCodewordLen - g_HUFFMAN_LOOKUP_BITS);
+      }
+      else {
+        v = v >> (g_HUFFMAN_LOOKUP_BITS - m_MaximumCodewordLen);
+      }
+
+      unsigned int l = 1;
+      while (v >= m_LJLimit[l]) {
+        l++;
+      }
+      if (used + l > g_HUFFMAN_LOOKUP_BITS) {
+        break;
+      }
+
+      unsigned int c = (v >> (m_MaximumCodewordLen - l));
+      m_LookupSymbol[(i * g_HUFFMAN_LOOKUP_SYMBOLS) + count] = m_SymsUsed[(c - m_Base[l]) + m_Offset[l]];
+      if (count == 0) {
+        m_LookupFirstLen[i] = l;
+      }
+      used += l;
+      count++;
+    }
+    m_LookupCount[i] = count;
+    m_LookupLen[i] = used;
+  }
+
+  return;
+}
+
+
 /*!
      Decode the prelude
      
@@ -199,9 +334,11 @@ void Huffman::DecodePrelude (BitBuffer &bitbuffer) {
   }
 
   //  Decode the codeword lengths
+  m_CodewordLen.assign (m_MaximumSymbol + 1, 0);
   for (unsigned int i = 1; i < m_SymsUsed.size (); i++) {
     unsigned int x = Unary_Decode (bitbuffer);
     m_Table[m_SymsUsed[i]] = (m_MaximumCodewordLen + 1) - x;
+    m_CodewordLen[m_SymsUsed[i]] = m_Table[m_SymsUsed[i]];
 //     cerr << "\t[6]\t" << m_SymsUsed[i] << "\t" << m_Table[m_SymsUsed[i]] << endl;
   }
 
@@ -218,29 +355,18 @@ void Huffman::DecodePrelude (BitBuffer &bitbuffer) {
 unsigned int Huffman::DecodeSymbol (BitBuffer &bitbuffer) {
   unsigned int l = 1;
   
-  //  Fill up the bit buffer so that the number of bits is at
-  //    least the maximum codeword length
-  if (m_VBits < m_MaximumCodewordLen) {
-    unsigned int bits_to_read = m_MaximumCodewordLen - m_VBits;
-    try {
-      m_V = (m_V << bits_to_read) + bitbuffer.ReadBits (bits_to_read);
-      m_VBits += bits_to_read;
-    }
-    catch (exception &BitBuffer_Input_Exception) {
-      cerr << "EE\tOpps -- unexpected end to the input stream of bits!" << endl;
-    }
-  }
+  //  Look at the next m_MaximumCodewordLen bits, which are always there (see EncodeFinish ())
+  unsigned int v = bitbuffer.PeekBits (m_MaximumCodewordLen);
   
-  while (m_V >= m_LJLimit[l]) {
+  while (v >= m_LJLimit[l]) {
     l++;
   }
   
-  unsigned int c = (m_V >> (m_MaximumCodewordLen - l));
-  m_V = m_V - (c << (m_MaximumCodewordLen - l));
+  unsigned int c = (v >> (m_MaximumCodewordLen - l));
   unsigned int x = (c - m_Base[l]) + m_Offset[l];
   
-  //  Update the number of bits in the bit buffer
-  m_VBits -= l;
+  //  Read the bits of the codeword
+  bitbuffer.SkipBits (l);
 
   if (GetDebug ()) {
     cerr << "\t[*]\t" << c << "\t" << x << "\t" << m_SymsUsed[x] << "\t" << m_Offset[l] << "\t" << m_Base[l] << "\t(length " << l << ")" << endl;
@@ -249,3 +375,226 @@ unsigned int Huffman::DecodeSymbol (BitBuffer &bitbuffer) {
   return (m_SymsUsed[x]);
 }
 
+
+/*!
+     Read in the interleaved streams which follow the prelude (see EncodeStreamsFinish ()).  Each stream
+     is followed by 2 * g_BITBUFFER_ACCUMULATOR_BYTES 0's, so that its reader can always load 8 bytes at
+     a time without checking for the end.
+     
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Huffman::DecodeStreamsBegin (BitBuffer &bitbuffer) {
+  vector<unsigned long long> stream_bits;
+
+  for (unsigned int s = 0; s < m_Streams; s++) {
+    stream_bits.push_back (Delta_Decode (bitbuffer) - 1);
+  }
+
+  m_StreamData.resize (m_Streams);
+  m_StreamReaders.resize (m_Streams);
+  for (unsigned int s = 0; s < m_Streams; s++) {
+    m_StreamData[s].assign (((stream_bits[s] + g_CHAR_SIZE_BITS - 1) / g_CHAR_SIZE_BITS) + (2 * g_BITBUFFER_ACCUMULATOR_BYTES), 0);
+    bitbuffer.ExtractBits (m_StreamData[s].data (), stream_bits[s]);
+    m_StreamReaders[s].next = reinterpret_cast<const unsigned char*> (m_StreamData[s].data ());
+  }
+
+  return;
+}
+
+
+/*!
+     Load 8 bytes of a stream as a big-endian value.  Compilers turn this into a single load (followed by
+     a byte swap on little-endian processors).
+
+     \param[in] ptr Where to load the bytes from
+     \return The value of the bytes
+*/
+static inline unsigned long long LoadStreamBytes (const unsigned char *ptr) {
+  return ((static_cast<unsigned long long> (ptr[0]) << 56) | (static_cast<unsigned long long> (ptr[1]) << 48) |
+          (static_cast<unsigned long long> (ptr[2]) << 40) | (static_cast<unsigned long long> (ptr[3]) << 32) |
+          (static_cast<unsigned long long> (ptr[4]) << 24) | (static_cast<unsigned long long> (ptr[5]) << 16) |
+          (static_cast<unsigned long long> (ptr[6]) << 8) | static_cast<unsigned long long> (ptr[7]));
+}
+
+
+/*!
+     Top up a stream reader so that it has at least g_BITBUFFER_ACCUMULATOR_BITS - g_CHAR_SIZE_BITS bits.
+     The next 8 bytes are loaded and placed after the bits that the reader has; only the bytes which fit
+     completely are counted, so the bits after them are loaded again (with the same values) next time.
+
+     \param[in,out] reader The stream reader
+*/
+static inline void RefillStreamReader (HuffmanStreamReader &reader) {
+  reader.bits |= LoadStreamBytes (reader.next) >> reader.used;
+  reader.next += (g_BITBUFFER_ACCUMULATOR_BITS - 1 - reader.used) / g_CHAR_SIZE_BITS;
+  reader.used |= g_BITBUFFER_ACCUMULATOR_BITS - g_CHAR_SIZE_BITS;
+
+  return;
+}
+
+
+/*!
+     Decode part or all of the message from the interleaved streams and append it to a vector.  Each
+     stream's symbols are stored directly in their positions in the vector, m_Streams apart.  Most of
+     them are decoded by DecodeStreamsBulk (); the symbols that are left are decoded here, with a lookup
+     from each stream in turn, as in DecodeMessage ().  A codeword which is too long for the table is
+     found with the search over m_LJLimit, as in DecodeSymbol ().
+
+     Since the streams are followed by 0's, the bits after the last codeword do not need to be checked.
+     
+     \param[in] len Length of the message to decode; it must not be more than the rest of the message
+     \param[out] x The vector to append the message to
+*/
+void Huffman::DecodeStreams (unsigned int len, vector<unsigned int> &x) {
+  HuffmanStreamReader reader[g_HUFFMAN_MAX_STREAMS];
+  unsigned int next[g_HUFFMAN_MAX_STREAMS];
+  unsigned int left[g_HUFFMAN_MAX_STREAMS];
+  unsigned int start = static_cast<unsigned int> (x.size ());
+  unsigned int first = m_MessageLengthDecoded % m_Streams;
+
+  x.resize (start + len);
+  unsigned int *out = x.data ();
+
+  //  The position in x of each stream's next symbol and how many of its symbols are in this part
+  for (unsigned int s = 0; s < m_Streams; s++) {
+    unsigned int offset = (s + m_Streams - first) % m_Streams;
+    reader[s] = m_StreamReaders[s];
+    next[s] = start + offset;
+    left[s] = (len > offset) ? ((len - offset + m_Streams - 1) / m_Streams) : 0;
+  }
+
+  if (!GetDebug ()) {
+    if (m_Streams == 2) {
+      DecodeStreamsBulk<2> (reader, next, left, out);
+    }
+    else if (m_Streams == 4) {
+      DecodeStreamsBulk<4> (reader, next, left, out);
+    }
+    else if (m_Streams == 8) {
+      DecodeStreamsBulk<8> (reader, next, left, out);
+    }
+  }
+
+  bool more = true;
+  while (more) {
+    more = false;
+    for (unsigned int s = 0; s < m_Streams; s++) {
+      if (left[s] == 0) {
+        continue;
+      }
+      more = true;
+      RefillStreamReader (reader[s]);
+
+      unsigned int entry = static_cast<unsigned int> (reader[s].bits >> (g_BITBUFFER_ACCUMULATOR_BITS - g_HUFFMAN_LOOKUP_BITS));
+      unsigned int count = m_LookupCount[entry];
+      if ((!GetDebug ()) && (count != 0) && (count <= left[s])) {
+        for (unsigned int j = 0; j < count; j++) {
+          out[next[s]] = m_LookupSymbol[(entry * g_HUFFMAN_LOOKUP_SYMBOLS) + j];
+          next[s] += m_Streams;
+        }
+        reader[s].bits <<= m_LookupLen[entry];
+        reader[s].used -= m_LookupLen[entry];
+      }
+      else {
+        unsigned int v = static_cast<unsigned int> (reader[s].bits >> (g_BITBUFFER_ACCUMULATOR_BITS - m_MaximumCodewordLen));
+        unsigned int l = 1;
+        while (v >= m_LJLimit[l]) {
+          l++;
+        }
+        out[next[s]] = m_SymsUsed[((v >> (m_MaximumCodewordLen - l)) - m_Base[l]) + m_Offset[l]];
+        next[s] += m_Streams;
+        reader[s].bits <<= l;
+        reader[s].used -= l;
+        count = 1;
+      }
+      left[s] -= count;
+    }
+  }
+
+  for (unsigned int s = 0; s < m_Streams; s++) {
+    m_StreamReaders[s] = reader[s];
+  }
+  m_MessageLengthDecoded += len;
+
+  return;
+}
+
+
+/*!
+     Decode the symbols of the interleaved streams for DecodeStreams () while every stream has at least
+     g_HUFFMAN_LOOKUP_SYMBOLS symbols left, so that all of the symbols of a lookup can be used.  Each
+     round makes one lookup in every stream; as the number of streams is a template parameter, the
+     rounds are unrolled and the readers are kept in registers, so the lookups of a round do not wait
+     for each other.  All g_HUFFMAN_LOOKUP_SYMBOLS symbols of an entry are stored, since the positions
+     of those which were not decoded will be overwritten later.
+
+     \param[in,out] reader The reader of each stream
+     \param[in,out] next The position in out of each stream's next symbol
+     \param[in,out] left The number of symbols left to decode in each stream
+     \param[out] out Where to store the symbols
+*/
+template <unsigned int STREAMS>
+void Huffman::DecodeStreamsBulk (HuffmanStreamReader *reader, unsigned int *next, unsigned int *left, unsigned int *out) {
+  HuffmanStreamReader r[STREAMS];
+  unsigned int n[STREAMS];
+  unsigned int l[STREAMS];
+  const unsigned int max_len = m_MaximumCodewordLen;
+  const unsigned int *lookup_symbol = m_LookupSymbol.data ();
+  const unsigned int *lookup_count = m_LookupCount.data ();
+  const unsigned int *lookup_len = m_LookupLen.data ();
+
+  for (unsigned int s = 0; s < STREAMS; s++) {
+    r[s] = reader[s];
+    n[s] = next[s];
+    l[s] = left[s];
+  }
+
+  while (true) {
+    //  Each round decodes at most g_HUFFMAN_LOOKUP_SYMBOLS symbols from each stream
+    unsigned int rounds = l[0];
+    for (unsigned int s = 1; s < STREAMS; s++) {
+      rounds = min (rounds, l[s]);
+    }
+    rounds = rounds / g_HUFFMAN_LOOKUP_SYMBOLS;
+    if (rounds == 0) {
+      break;
+    }
+
+    for (unsigned int i = 0; i < rounds; i++) {
+      for (unsigned int s = 0; s < STREAMS; s++) {
+        RefillStreamReader (r[s]);
+
+        unsigned int entry = static_cast<unsigned int> (r[s].bits >> (g_BITBUFFER_ACCUMULATOR_BITS - g_HUFFMAN_LOOKUP_BITS));
+        unsigned int count = lookup_count[entry];
+        if (count != 0) {
+          for (unsigned int j = 0; j < g_HUFFMAN_LOOKUP_SYMBOLS; j++) {
+            out[n[s] + (j * STREAMS)] = lookup_symbol[(entry * g_HUFFMAN_LOOKUP_SYMBOLS) + j];
+          }
+          r[s].bits <<= lookup_len[entry];
+          r[s].used -= lookup_len[entry];
+        }
+        else {
+          unsigned int v = static_cast<unsigned int> (r[s].bits >> (g_BITBUFFER_ACCUMULATOR_BITS - max_len));
+          unsigned int len = 1;
+          while (v >= m_LJLimit[len]) {
+            len++;
+          }
+          out[n[s]] = m_SymsUsed[((v >> (max_len - len)) - m_Base[len]) + m_Offset[len]];
+          r[s].bits <<= len;
+          r[s].used -= len;
+          count = 1;
+        }
+        n[s] += count * STREAMS;
+        l[s] -= count;
+      }
+    }
+  }
+
+  for (unsigned int s = 0; s < STREAMS; s++) {
+    reader[s] = r[s];
+    next[s] = n[s];
+    left[s] = l[s];
+  }
+
+  return;
+}
@@ -77,6 +77,14 @@ void Huffman::EncodeBegin (BitBuffer &bitbuffer) {
     cerr << endl << endl;
   }
 
+  //  Keep the frequencies if the codeword lengths may need to be limited since CalculateHuffmanCode () replaces them
+  vector<unsigned int> freqs;
+  if (m_CodewordLimit != 0) {
+    for (unsigned int i = 0; i < m_SymsUsed.size (); i++) {
+      freqs.push_back (m_Table[m_SymsUsed[i]]);
+    }
+  }
+
   //  Calculate the Huffman codeword lengths
   if (GetDebug ()) {
     cerr << "II\tCalculateHuffmanCode ()" << endl;
@@ -84,6 +92,15 @@ void Huffman::EncodeBegin (BitBuffer &bitbuffer) {
 
   CalculateHuffmanCode ();
 
+  //  Recalculate the codeword lengths if the longest one is too long
+  if ((m_CodewordLimit != 0) && (m_Table[m_SymsUsed[m_DistinctSymbols]] > m_CodewordLimit)) {
+    if (GetDebug ()) {
+      cerr << "II\tLimitCodewordLengths ()" << endl;
+    }
+
+    LimitCodewordLengths (freqs, m_CodewordLimit);
+  }
+
   if (GetDebug ()) {
     for (unsigned int i = 0; i < m_SymsUsed.size (); i++) {
       cerr << "\t[2]\t" << i << "\t" << m_SymsUsed[i] << "\t" << m_Table[m_SymsUsed[i]] << endl;
@@ -156,6 +173,36 @@ void Huffman::EncodeBegin (BitBuffer &bitbuffer) {
     cerr << endl << endl;
   }
 
+  EncodeStreamsBegin ();
+
+  return;
+}
+
+
+/*!
+     Perform the preliminary calculations in preparation for encoding with a code that the decoder
+     already has, such as the code of an earlier message (see GetCodewordLengths ()).  Instead of the
+     prelude, only the length of the message is written.  Every symbol given to UpdateFrequencies ()
+     must have a codeword.
+     
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] lengths The length of each symbol's codeword, indexed by the symbol; 0 if it has no codeword
+*/
+void Huffman::EncodeBegin (BitBuffer &bitbuffer, const vector<unsigned int> &lengths) {
+  for (unsigned int i = 1; i < m_SymsUsed.size (); i++) {
+    if ((m_SymsUsed[i] >= lengths.size ()) || (lengths[m_SymsUsed[i]] == 0)) {
+      cerr << "EE\tThe symbol " << m_SymsUsed[i] << " has no codeword in the Huffman code given to EncodeBegin ()." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  SetCodewordLengths (lengths);
+  Delta_Encode (bitbuffer, m_MessageLength);
+
+  SetWBaseOffset ();
+  PreEncodeMessage ();
+  EncodeStreamsBegin ();
+
   return;
 }
 
@@ -166,15 +213,49 @@ void Huffman::EncodeBegin (BitBuffer &bitbuffer) {
      \param[in] bitbuffer The bitbuffer to write the bits to.
      \param[in] x The vector to encode.
 */
-void Huffman::EncodeMessage (BitBuffer &bitbuffer, vector<unsigned int> x) {
-//   cerr << "[Huffman::EncodeMessage**] size --\t" << x.size () << endl;
-//   cerr << "[Huffman::EncodeMessage*]\t10\t" << m_Table[10] << endl;
-//   cerr << "[Huffman::EncodeMessage*]\t70\t" << m_Table[70] << endl;
-//   cerr << "[Huffman::EncodeMessage*]\t90\t" << m_Table[90] << endl;
-  for (unsigned int i = 0; i < x.size (); i++) {
-//     cerr << "[Huffman::EncodeMessage]\t" << i << "\t" << x[i] << "\t" << m_Table[x[i]] << endl;
-    EncodeSymbol (bitbuffer, m_Table[x[i]]);
+void Huffman::EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x) {
+  EncodeMessage (bitbuffer, x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Encode an array of symbols using the calculated Huffman codes.  The codewords are looked up in
+     the table made by SetCodewordTable () and packed into 64 bits, which are written out 32 bits
+     at a time.
+     
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+     \param[in] len The number of symbols in x.
+*/
+void Huffman::EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len) {
+  unsigned long long packed = 0;
+  unsigned int packed_bits = 0;
+
+  if (m_Streams > 1) {
+    EncodeStreams (x, len);
+    return;
+  }
+
+  if (GetDebug ()) {
+    for (unsigned int i = 0; i < len; i++) {
+      EncodeSymbol (bitbuffer, m_Table[x[i]]);
+    }
+
+    return;
+  }
+
+  //  Since a codeword has at most 32 bits, fewer than 32 bits are kept in packed between codewords
+  for (unsigned int i = 0; i < len; i++) {
+    packed = (packed << m_CodewordLen[x[i]]) | m_Codeword[x[i]];
+    packed_bits += m_CodewordLen[x[i]];
+    if (packed_bits >= g_UINT_SIZE_BITS) {
+      packed_bits -= g_UINT_SIZE_BITS;
+      bitbuffer.WriteBits<BitBufferTraceOff> (static_cast<unsigned int> (packed >> packed_bits), g_UINT_SIZE_BITS);
+    }
   }
+  bitbuffer.WriteBits<BitBufferTraceOff> (static_cast<unsigned int> (packed), packed_bits);
   
   return;
 }
@@ -193,6 +274,11 @@ void Huffman::EncodeMessage (BitBuffer &bitbuffer, vector<unsigned int> x) {
      \param[in] bitbuffer The bitbuffer to write the bits to.
 */
 void Huffman::EncodeFinish (BitBuffer &bitbuffer) {
+  if (m_Streams > 1) {
+    EncodeStreamsFinish (bitbuffer);
+    return;
+  }
+
   //  Write out a 0 occupying m_MaximumCodewordLen bits
   bitbuffer.WriteBits (0, m_MaximumCodewordLen);
   
@@ -225,6 +311,118 @@ void Huffman::PreEncodeMessage () {
     m_W[codelen]++;
   }
 
+  SetCodewordTable ();
+
+  return;
+}
+
+
+/*!
+     Record the codeword of each symbol and its length, as EncodeSymbol () would calculate them, so
+     that EncodeMessage () does not need to search for them.
+*/
+void Huffman::SetCodewordTable () {
+  m_Codeword.assign (m_MaximumSymbol + 1, 0);
+  m_CodewordLen.assign (m_MaximumSymbol + 1, 0);
+
+  for (unsigned int i = 1; i < m_SymsUsed.size (); i++) {
+    unsigned int sym = m_SymsUsed[i];
+    unsigned int x = m_Table[sym];
+    unsigned int l = 1;
+    while (x >= m_Offset[l + 1]) {
+      l++;
+    }
+    m_Codeword[sym] = (x - m_Offset[l]) + m_Base[l];
+    m_CodewordLen[sym] = l;
+  }
+
+  return;
+}
+
+
+/*!
+     Create the BitBuffer of each stream in memory, where the streams are written until EncodeFinish ().
+     Nothing is done if the message is not split.
+*/
+void Huffman::EncodeStreamsBegin () {
+  if (m_Streams > 1) {
+    m_StreamBuffers = new BitBuffer[m_Streams];
+    for (unsigned int s = 0; s < m_Streams; s++) {
+      m_StreamBuffers[s].InitializeMemory ();
+    }
+    m_StreamNext = 0;
+  }
+
+  return;
+}
+
+
+/*!
+     Encode an array of symbols into the interleaved streams, in the same way as EncodeMessage () does
+     for one stream.  Each stream has its own 64 bits of packed codewords.
+
+     \param[in] x The symbols to encode.
+     \param[in] len The number of symbols in x.
+*/
+void Huffman::EncodeStreams (const unsigned int *x, unsigned int len) {
+  unsigned long long packed[g_HUFFMAN_MAX_STREAMS] = {0};
+  unsigned int packed_bits[g_HUFFMAN_MAX_STREAMS] = {0};
+  unsigned int s = m_StreamNext;
+
+  if (GetDebug ()) {
+    for (unsigned int i = 0; i < len; i++) {
+      EncodeSymbol (m_StreamBuffers[s], m_Table[x[i]]);
+      s = (s + 1 == m_Streams) ? 0 : s + 1;
+    }
+    m_StreamNext = s;
+
+    return;
+  }
+
+  for (unsigned int i = 0; i < len; i++) {
+    packed[s] = (packed[s] << m_CodewordLen[x[i]]) | m_Codeword[x[i]];
+    packed_bits[s] += m_CodewordLen[x[i]];
+    if (packed_bits[s] >= g_UINT_SIZE_BITS) {
+      packed_bits[s] -= g_UINT_SIZE_BITS;
+      m_StreamBuffers[s].WriteBits<BitBufferTraceOff> (static_cast<unsigned int> (packed[s] >> packed_bits[s]), g_UINT_SIZE_BITS);
+    }
+    s = (s + 1 == m_Streams) ? 0 : s + 1;
+  }
+  for (unsigned int j = 0; j < m_Streams; j++) {
+    m_StreamBuffers[j].WriteBits<BitBufferTraceOff> (static_cast<unsigned int> (packed[j]), packed_bits[j]);
+  }
+  m_StreamNext = s;
+
+  return;
+}
+
+
+/*!
+     Finish encoding the interleaved streams.  Each stream ends with a 0 of length m_MaximumCodewordLen,
+     as in EncodeFinish ().  The number of bits in each stream is written out, followed by the streams.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Huffman::EncodeStreamsFinish (BitBuffer &bitbuffer) {
+  for (unsigned int s = 0; s < m_Streams; s++) {
+    m_StreamBuffers[s].WriteBits (0, m_MaximumCodewordLen);
+    m_StreamBuffers[s].Finish ();
+
+    //  Add 1 since the number of bits is encoded with a Delta code
+    if (m_StreamBuffers[s].GetMemoryBits () >= UINT_MAX) {
+      cerr << "EE\tA Huffman stream is too long; please use fewer symbols in each message." << endl;
+      exit (EXIT_FAILURE);
+    }
+    Delta_Encode (bitbuffer, static_cast<unsigned int> (m_StreamBuffers[s].GetMemoryBits ()) + 1);
+  }
+
+  for (unsigned int s = 0; s < m_Streams; s++) {
+    bitbuffer.AppendBits (m_StreamBuffers[s].GetMemory (), m_StreamBuffers[s].GetMemoryBits ());
+  }
+
+  delete [] m_StreamBuffers;
+  m_StreamBuffers = NULL;
+
   return;
 }
 
@@ -79,14 +79,25 @@ Huffman::Huffman (bool debug)
     m_MaximumSymbol (0),
     m_DistinctSymbols (0),
     m_MaximumCodewordLen (0),
+    m_CodewordLimit (0),
     m_SymsUsed (),
     m_Table (),
     m_W (),
     m_Base (),
     m_Offset (),
     m_LJLimit (),
-    m_V (0),
-    m_VBits (0)
+    m_Codeword (),
+    m_CodewordLen (),
+    m_PeekBits (0),
+    m_LookupSymbol (),
+    m_LookupCount (),
+    m_LookupLen (),
+    m_LookupFirstLen (),
+    m_Streams (1),
+    m_StreamNext (0),
+    m_StreamBuffers (NULL),
+    m_StreamData (),
+    m_StreamReaders ()
 {
   //  Add symbol 0 with 0 frequency as a sentinel value.  Only positions from 1 are used.
   m_Table.push_back (0);
@@ -98,6 +109,7 @@ Huffman::Huffman (bool debug)
      Destructor that takes no arguments
 */
 Huffman::~Huffman () {
+  delete [] m_StreamBuffers;
 }
 
 
@@ -142,3 +154,59 @@ unsigned int Huffman::GetTableValue (unsigned int pos) const {
   return m_Table[pos];
 }
 
+
+/*!
+     Return m_MaximumCodewordLen
+
+     \return Length of the longest codeword (set by EncodeBegin () or DecodeBegin ())
+*/
+unsigned int Huffman::GetMaximumCodewordLen () const {
+  return m_MaximumCodewordLen;
+}
+
+
+/*!
+     Return m_CodewordLen, which can be given to EncodeBegin () or DecodeBegin () to code another
+     message with the same code.
+
+     \return The length of each symbol's codeword, indexed by the symbol; 0 if it has no codeword
+*/
+vector<unsigned int> Huffman::GetCodewordLengths () const {
+  return m_CodewordLen;
+}
+
+
+/*!
+     Set m_CodewordLimit; it must be set before EncodeBegin () is called.
+
+     \param[in] x Maximum length of a codeword in bits; 0 if there is no limit
+*/
+void Huffman::SetCodewordLimit (unsigned int x) {
+  m_CodewordLimit = x;
+}
+
+
+/*!
+     Return m_Streams
+
+     \return Number of interleaved streams
+*/
+unsigned int Huffman::GetStreams () const {
+  return m_Streams;
+}
+
+
+/*!
+     Set m_Streams; it must be set before EncodeBegin () or DecodeBegin () is called.
+
+     \param[in] x Number of interleaved streams; a power of 2 which is at most g_HUFFMAN_MAX_STREAMS
+*/
+void Huffman::SetStreams (unsigned int x) {
+  if ((x == 0) || (x > g_HUFFMAN_MAX_STREAMS) || ((x & (x - 1)) != 0)) {
+    cerr << "EE\tThe number of Huffman streams must be a power of 2 from 1 to " << g_HUFFMAN_MAX_STREAMS << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  m_Streams = x;
+}
+
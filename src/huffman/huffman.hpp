@@ -30,6 +30,58 @@
 #ifndef HUFFMAN_HPP
 #define HUFFMAN_HPP
 
+/*!
+     Number of bits looked up at once by the decoder; codewords which are longer than this are decoded
+     with the canonical search instead.
+*/
+const unsigned int g_HUFFMAN_LOOKUP_BITS = 11;
+
+/*!
+     Maximum number of symbols decoded with one lookup
+*/
+const unsigned int g_HUFFMAN_LOOKUP_SYMBOLS = 4;
+
+/*!
+     Maximum number of interleaved streams (see SetStreams ()); the number of streams is a power of 2
+*/
+const unsigned int g_HUFFMAN_MAX_STREAMS = 8;
+
+/*!
+     Estimated size in bits of a table's prelude, per distinct symbol, when HuffmanContext decides which
+     contexts have their own table
+*/
+const unsigned int g_HUFFMAN_CONTEXT_SYMBOL_BITS = 6;
+
+/*!
+     Estimated size in bits of the rest of a table's prelude, when HuffmanContext decides which contexts
+     have their own table
+*/
+const unsigned int g_HUFFMAN_CONTEXT_FIXED_BITS = 64;
+
+
+/*!
+    \struct HuffmanStreamReader
+
+    \details Position in one of the interleaved streams while it is decoded from memory.  As with the
+             mini-buffer of a BitBuffer, the bits which have been read from the stream but not decoded
+             yet are kept at the high-order end of 64 bits.
+*/
+struct HuffmanStreamReader {
+  //!  Next byte of the stream to read
+  const unsigned char *next;
+  //!  Bits read from the stream which have not been decoded yet
+  unsigned long long bits;
+  //!  Number of bits in bits
+  unsigned int used;
+
+  HuffmanStreamReader ()
+    : next (NULL),
+      bits (0),
+      used (0)
+        {
+        }
+};
+
 
 /*!
     \class Huffman
@@ -54,8 +106,10 @@
     1)  Initialize the BitBuffer.
     2)  Create a Huffman object.
     3)  foreach vector, run UpdateFrequencies () to accumulate probabilities.
-    4)  Perform block calculations and output the prelude using EncodeBegin ().
-    5)  foreach vector, run EncodeMessage ().
+    4)  Perform block calculations and output the prelude using EncodeBegin ().  If SetCodewordLimit ()
+        was called beforehand, codewords longer than the limit are avoided by LimitCodewordLengths ().
+    5)  foreach vector, run EncodeMessage ().  It looks up each symbol's codeword in a table made by
+        EncodeBegin () and writes them 32 bits at a time.
     6)  Finalize using EncodeFinish ().
     
     For decoding:
@@ -65,6 +119,25 @@
     3)  Decode the prelude with DecodeBegin ().
     4)  Decode a block of symbols using DecodeMessage ().  Setting the block size to the message length just reads it all in one go.
     5)  Finalize using DecodeFinish ()
+
+    The decoder looks up the next g_HUFFMAN_LOOKUP_BITS bits in a table built by PreDecodeMessage (),
+    which gives all of the codewords that they contain (up to g_HUFFMAN_LOOKUP_SYMBOLS) at once.  So,
+    when the codewords are short, several symbols are decoded with each lookup.  Only codewords
+    which are longer than g_HUFFMAN_LOOKUP_BITS are found with the search over m_LJLimit.  The bits
+    are looked at with BitBuffer::PeekBits () and only those of the decoded codewords are read.
+    
+    The message can also be split into interleaved streams with SetStreams (), which must be called
+    with the same number of streams before EncodeBegin () and DecodeBegin ().  Symbol i of the message
+    is then in stream (i mod the number of streams).  The streams are written to memory and, after the
+    number of bits in each of them, appended to the BitBuffer by EncodeFinish ().  The decoder reads
+    each stream into memory in DecodeBegin () and DecodeMessage () takes a lookup from each stream in
+    turn.  Since each stream has its own position (a HuffmanStreamReader), the lookups do not wait for
+    each other, so the processor can perform several of them at once.
+    
+    A code can also be used for more than one message without sending its prelude again.  After
+    EncodeBegin () or DecodeBegin (), GetCodewordLengths () returns the length of each symbol's
+    codeword.  Giving these lengths to the second EncodeBegin () and DecodeBegin () codes another
+    message with the same code; only the length of the message is written.
     
     Additional functions such as SetDebug () and DebugCumulativeSum () are useful for debugging.
     
@@ -72,6 +145,8 @@
 class Huffman {
   //  Friend function to print out statistics for debugging  [huffman.cpp]
   friend ostream &operator<< (ostream &os, const Huffman& hc);
+  //  Order-1 coding, which codes the symbols with a table chosen by the one before  [context.cpp]
+  friend class HuffmanContext;
   
   public:
     //  Constructors/destructors  [huffman.cpp]
@@ -81,19 +156,31 @@ class Huffman {
     void SetDebug ();
     unsigned int GetMessageLength () const;
     unsigned int GetTableValue (unsigned int pos) const;
+    unsigned int GetMaximumCodewordLen () const;
+    vector<unsigned int> GetCodewordLengths () const;
+    void SetCodewordLimit (unsigned int x);
+    unsigned int GetStreams () const;
+    void SetStreams (unsigned int x);
 
     //  Encoding functions  [encode.cpp]    
     void EncodeBegin (BitBuffer &bitbuffer);
-    void EncodeMessage (BitBuffer &bitbuffer, vector<unsigned int> x);
+    void EncodeBegin (BitBuffer &bitbuffer, const vector<unsigned int> &lengths);
+    void EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x);
+    void EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len);
     void EncodeFinish (BitBuffer &bitbuffer);
 
     //  Decoding functions  [decode.cpp]
     void DecodeBegin (BitBuffer &bitbuffer);
+    void DecodeBegin (BitBuffer &bitbuffer, const vector<unsigned int> &lengths);
     vector<unsigned int> DecodeMessage (BitBuffer &bitbuffer, unsigned int len);
+    void DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x);
     void DecodeFinish (BitBuffer &bitbuffer);
 
     //  Main processing functions  [process.cpp]
-    void UpdateFrequencies (vector<unsigned int> x);
+    void UpdateFrequencies (const vector<unsigned int> &x);
+    void UpdateFrequencies (const unsigned int *x, unsigned int len);
+    void UpdateFrequency (unsigned int x, unsigned int freq);
+    void AddSymbol (unsigned int x);
 
     //  Debugging functions  [debug.cpp]
     void DebugCumulativeSum ();
@@ -102,14 +189,25 @@ class Huffman {
     void PreEncodeMessage ();
     void EncodePrelude (BitBuffer &bitbuffer);
     void EncodeSymbol (BitBuffer &bitbuffer, unsigned int x);
+    void SetCodewordTable ();
+    void EncodeStreamsBegin ();
+    void EncodeStreams (const unsigned int *x, unsigned int len);
+    void EncodeStreamsFinish (BitBuffer &bitbuffer);
   
     //  Decoding functions  [decode.cpp]
     void PreDecodeMessage ();
+    void SetLookupTable ();
     void DecodePrelude (BitBuffer &bitbuffer);
     unsigned int DecodeSymbol (BitBuffer &bitbuffer);
+    void DecodeStreamsBegin (BitBuffer &bitbuffer);
+    void DecodeStreams (unsigned int len, vector<unsigned int> &x);
+    template <unsigned int STREAMS>
+    void DecodeStreamsBulk (HuffmanStreamReader *reader, unsigned int *next, unsigned int *left, unsigned int *out);
     
     //  Main processing functions  [process.cpp]
     void CalculateHuffmanCode ();
+    void LimitCodewordLengths (const vector<unsigned int> &freqs, unsigned int limit);
+    void SetCodewordLengths (const vector<unsigned int> &lengths);
     void SetWBaseOffset ();
 
     //  Sorting functions  [sort.cpp]
@@ -131,6 +229,8 @@ class Huffman {
     unsigned int m_DistinctSymbols;
     //!  Maximum length of any codeword
     unsigned int m_MaximumCodewordLen;
+    //!  Maximum length allowed for a codeword when encoding; 0 if there is no limit
+    unsigned int m_CodewordLimit;
 
     //!  Vector of symbols used
     vector<unsigned int> m_SymsUsed;
@@ -146,10 +246,102 @@ class Huffman {
     //!  ...
     vector<unsigned int> m_LJLimit;
 
-    //!  The input buffer of bits
-    unsigned int m_V;
-    //!  Number of usable bits in V (i.e., less than or equal to m_MaximumCodewordLen)
-    unsigned int m_VBits;
+    //!  For each symbol, its codeword (set by EncodeBegin ())
+    vector<unsigned int> m_Codeword;
+    //!  For each symbol, the length of its codeword (set by EncodeBegin () and DecodeBegin ())
+    vector<unsigned int> m_CodewordLen;
+
+    //!  Number of bits peeked at when decoding with the lookup table (the larger of g_HUFFMAN_LOOKUP_BITS and m_MaximumCodewordLen)
+    unsigned int m_PeekBits;
+    //!  For each value of the next g_HUFFMAN_LOOKUP_BITS bits, the symbols of the codewords which they start with (g_HUFFMAN_LOOKUP_SYMBOLS each)
+    vector<unsigned int> m_LookupSymbol;
+    //!  For each value of the next g_HUFFMAN_LOOKUP_BITS bits, the number of codewords which they start with; 0 if the first is longer
+    vector<unsigned int> m_LookupCount;
+    //!  For each value of the next g_HUFFMAN_LOOKUP_BITS bits, the total length of the codewords which they start with
+    vector<unsigned int> m_LookupLen;
+    //!  For each value of the next g_HUFFMAN_LOOKUP_BITS bits, the length of the first codeword which they start with (used by HuffmanContext)
+    vector<unsigned int> m_LookupFirstLen;
+
+    //!  Number of interleaved streams; 1 if the message is not split
+    unsigned int m_Streams;
+    //!  The stream of the next symbol to encode
+    unsigned int m_StreamNext;
+    //!  The BitBuffer of each stream when encoding, in memory; NULL if the message is not split
+    BitBuffer *m_StreamBuffers;
+    //!  The bits of each stream when decoding, read in by DecodeBegin ()
+    vector<vector<char> > m_StreamData;
+    //!  The position in each stream when decoding
+    vector<HuffmanStreamReader> m_StreamReaders;
+};
+
+
+
+/*!
+    \class HuffmanContext
+
+    \details Class used to represent order-1 Huffman coding, where each symbol is coded with a table
+    chosen by the symbol before it (its context).  The first symbol of each message has the context 0,
+    which is never a symbol.  Each table is a Huffman object, so its codes are calculated and its
+    prelude is written as usual; HuffmanContext only decides which table each context uses and codes
+    the symbols with them.
+    
+    A context only has its own table if the bits that it saves, compared to the distribution of all
+    the symbols, are more than the estimated size of its prelude.  The other contexts share table 0,
+    so rare contexts do not add preludes.
+    
+    For encoding, do the following:
+    
+    1)  foreach vector, run UpdateFrequencies () to count the symbols in each context.
+    2)  Choose the tables and output their preludes using EncodeBegin ().
+    3)  foreach vector, run EncodeMessage ().
+    4)  Finalize using EncodeFinish ().
+    
+    For decoding, call DecodeBegin (), DecodeMessage () with the length of each vector in the same
+    order, and DecodeFinish ().  Each symbol is decoded with one lookup in its table, unless its
+    codeword is longer than g_HUFFMAN_LOOKUP_BITS.  Interleaved streams are not supported.
+*/
+class HuffmanContext {
+  public:
+    //  Constructors/destructors  [context.cpp]
+    HuffmanContext (bool debug=false);
+    ~HuffmanContext ();
+    bool GetDebug () const;
+    unsigned int GetTables () const;
+    void SetCodewordLimit (unsigned int x);
+
+    //  Encoding functions  [context.cpp]
+    void UpdateFrequencies (const unsigned int *x, unsigned int len);
+    void EncodeBegin (BitBuffer &bitbuffer);
+    void EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len);
+    void EncodeFinish (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [context.cpp]
+    void DecodeBegin (BitBuffer &bitbuffer);
+    void DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x);
+    void DecodeFinish (BitBuffer &bitbuffer);
+  private:
+    void ChooseTables ();
+
+    //!  Debug mode?
+    bool m_Debug;
+    //!  Maximum length allowed for a codeword when encoding; 0 if there is no limit
+    unsigned int m_CodewordLimit;
+    //!  Number of times each symbol follows each context (not used for decoding)
+    vector<vector<unsigned int> > m_Frequencies;
+    //!  The table used by each context
+    vector<unsigned int> m_ContextTable;
+    //!  Number of tables, including the shared table 0
+    unsigned int m_NumTables;
+    //!  The tables
+    Huffman *m_Tables;
+    //!  Is the shared table 0 used by any symbol?
+    bool m_SharedUsed;
+    //!  Number of bits peeked at when decoding (the larger of g_HUFFMAN_LOOKUP_BITS and the longest codeword of any table)
+    unsigned int m_PeekBits;
+    //!  For each table and value of the next g_HUFFMAN_LOOKUP_BITS bits, the first symbol shifted left by 8 bits plus the length of its codeword; 0 if it is longer
+    vector<vector<unsigned int> > m_TableLookup;
+    //!  For each context, the lookup table in m_TableLookup of its table
+    vector<const unsigned int*> m_ContextLookup;
 };
 
 #endif
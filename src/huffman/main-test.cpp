@@ -76,6 +76,21 @@ int main(int argc, char **argv) {
   else if (strcmp (argv[1], "6") == 0) {
     result = HuffmanRandom ();
   }
+  else if (strcmp (argv[1], "7") == 0) {
+    result = HuffmanLongCodes ();
+  }
+  else if (strcmp (argv[1], "8") == 0) {
+    result = HuffmanLengthLimited ();
+  }
+  else if (strcmp (argv[1], "9") == 0) {
+    result = HuffmanStreams ();
+  }
+  else if (strcmp (argv[1], "10") == 0) {
+    result = HuffmanContextExample ();
+  }
+  else if (strcmp (argv[1], "11") == 0) {
+    result = HuffmanReuse ();
+  }
 
   if (!result) {
     return (EXIT_FAILURE);
@@ -33,6 +33,7 @@
 #include <algorithm>  //  sort
 #include <iostream>
 #include <cassert>
+#include <cstdlib>  //  exit
 
 using namespace std;
 
@@ -50,8 +51,21 @@ using namespace std;
 
      \param[in] x The vector of integers to update the table with
 */
-void Huffman::UpdateFrequencies (vector<unsigned int> x) {
-  for (unsigned int i = 0; i < x.size (); i++) {
+void Huffman::UpdateFrequencies (const vector<unsigned int> &x) {
+  UpdateFrequencies (x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Update the frequency table using an array of integers
+
+     \param[in] x The integers to update the table with
+     \param[in] len The number of integers in x
+*/
+void Huffman::UpdateFrequencies (const unsigned int *x, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
     unsigned int pos = x[i];
     if (pos >= m_Table.size ()) {
       m_Table.resize (pos + 1, 0);
@@ -63,7 +77,53 @@ void Huffman::UpdateFrequencies (vector<unsigned int> x) {
     m_Table[pos]++;
   }
 
-  m_MessageLength += x.size ();
+  m_MessageLength += len;
+
+  return;
+}
+
+
+/*!
+     Update the frequency table with a symbol which occurs a number of times
+
+     \param[in] x The symbol
+     \param[in] freq The number of times that it occurs
+*/
+void Huffman::UpdateFrequency (unsigned int x, unsigned int freq) {
+  if (freq == 0) {
+    return;
+  }
+
+  if (x >= m_Table.size ()) {
+    m_Table.resize (x + 1, 0);
+  }
+  if (m_Table[x] == 0) {
+    m_DistinctSymbols++;
+    m_SymsUsed.push_back (x);
+  }
+  m_Table[x] += freq;
+
+  m_MessageLength += freq;
+
+  return;
+}
+
+
+/*!
+     Give a symbol a codeword even if it does not occur in the message, as if it occurred once.  This is
+     useful when the code is also used for later messages (see GetCodewordLengths ()).
+
+     \param[in] x The symbol
+*/
+void Huffman::AddSymbol (unsigned int x) {
+  if (x >= m_Table.size ()) {
+    m_Table.resize (x + 1, 0);
+  }
+  if (m_Table[x] == 0) {
+    m_DistinctSymbols++;
+    m_SymsUsed.push_back (x);
+    m_Table[x] = 1;
+  }
 
   return;
 }
@@ -147,6 +207,123 @@ void Huffman::CalculateHuffmanCode () {
 }
 
 
+/*!
+     Replace the codeword lengths in m_Table with those of a code whose codewords are at most limit bits
+     long, using the package-merge algorithm of Larmore and Hirschberg [1990]; of all such codes, it has
+     the smallest expected codeword length.  The symbols in m_SymsUsed must be sorted by decreasing
+     frequency.  If limit is too small for the number of distinct symbols, the smallest possible limit
+     is used instead.
+
+     For each length l from limit down to 1, the list of level l is made of the symbols (as leaves)
+     merged with the pairs of adjacent items in the list of level l + 1 (as packages), in increasing
+     order of weight.  The first 2n - 2 items of the list of level 1 are chosen and the packages among
+     them choose items in the list of the next level.  A symbol's codeword length is the number of
+     times that it is chosen.
+
+     \param[in] freqs The frequency of each symbol in m_SymsUsed
+     \param[in] limit Maximum length of a codeword
+*/
+void Huffman::LimitCodewordLengths (const vector<unsigned int> &freqs, unsigned int limit) {
+  unsigned int distinct = m_DistinctSymbols;
+
+  //  The codewords of n symbols are at least ceil (log2 n) bits long
+  unsigned int min_limit = 0;
+  while ((1ULL << min_limit) < distinct) {
+    min_limit++;
+  }
+  if (limit < min_limit) {
+    limit = min_limit;
+  }
+
+  //  For each level, the weight of every item and the symbol it is (from 0, by increasing weight)
+  //  or UINT_MAX if it is a package
+  vector<vector<unsigned long long> > weight (limit + 1);
+  vector<vector<unsigned int> > leaf (limit + 1);
+
+  for (unsigned int l = limit; l >= 1; l--) {
+    unsigned int i = 0;
+    unsigned int j = 0;
+    unsigned int packages = 0;
+    if (l < limit) {
+      packages = static_cast<unsigned int> (weight[l + 1].size () / 2);
+    }
+
+    //  Merge the symbols with the packages; a symbol goes first when their weights are equal
+    while ((i < distinct) || (j < packages)) {
+      unsigned long long package_weight = 0;
+      if (j < packages) {
+        package_weight = weight[l + 1][2 * j] + weight[l + 1][2 * j + 1];
+      }
+
+      if ((i < distinct) && ((j == packages) || (freqs[distinct - i] <= package_weight))) {
+        weight[l].push_back (freqs[distinct - i]);
+        leaf[l].push_back (i);
+        i++;
+      }
+      else {
+        weight[l].push_back (package_weight);
+        leaf[l].push_back (UINT_MAX);
+        j++;
+      }
+    }
+  }
+
+  //  Count the number of times each symbol is chosen
+  for (unsigned int i = 1; i <= distinct; i++) {
+    m_Table[m_SymsUsed[i]] = 0;
+  }
+
+  unsigned int chosen = (2 * distinct) - 2;
+  for (unsigned int l = 1; l <= limit; l++) {
+    unsigned int packages = 0;
+    for (unsigned int k = 0; k < chosen; k++) {
+      if (leaf[l][k] == UINT_MAX) {
+        packages++;
+      }
+      else {
+        m_Table[m_SymsUsed[distinct - leaf[l][k]]]++;
+      }
+    }
+    chosen = 2 * packages;
+  }
+
+  return;
+}
+
+
+/*!
+     Use the given codeword lengths instead of calculating them, in the same state as EncodeBegin ()
+     and DecodePrelude () leave them:  m_SymsUsed holds the symbols with a codeword in increasing order
+     and m_Table holds the length of each one's codeword.
+
+     \param[in] lengths The length of each symbol's codeword, indexed by the symbol; 0 if it has no codeword
+*/
+void Huffman::SetCodewordLengths (const vector<unsigned int> &lengths) {
+  m_SymsUsed.assign (1, 0);
+  m_Table.assign (lengths.size (), 0);
+  m_CodewordLen = lengths;
+  m_DistinctSymbols = 0;
+  m_MaximumCodewordLen = 0;
+
+  for (unsigned int sym = 1; sym < lengths.size (); sym++) {
+    if (lengths[sym] != 0) {
+      m_SymsUsed.push_back (sym);
+      m_Table[sym] = lengths[sym];
+      m_DistinctSymbols++;
+      m_MaximumCodewordLen = max (m_MaximumCodewordLen, lengths[sym]);
+    }
+  }
+
+  if (m_DistinctSymbols == 0) {
+    cerr << "EE\tThe Huffman code has no codewords." << endl;
+    exit (EXIT_FAILURE);
+  }
+  m_MaximumSymbol = m_SymsUsed[m_DistinctSymbols];
+
+  return;
+}
+
+
 /*!
      Set the m_W, m_Base, and m_Offset arrays for efficient encoding/decoding.
 */
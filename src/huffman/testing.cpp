@@ -31,6 +31,7 @@
 #include <vector>
 #include <iostream>
 #include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+#include <algorithm>  //  swap
 
 using namespace std;
 
@@ -391,3 +392,368 @@ bool HuffmanRandom () {
   return (true);
 }
   
+
+
+/*!
+     Huffman code a set of random numbers whose frequencies halve from one symbol to the next, so that
+     some codewords are longer than g_HUFFMAN_LOOKUP_BITS.
+
+     \return true if the numbers are decoded correctly; false otherwise
+*/
+bool HuffmanLongCodes () {
+  string str = "tmp-long-codes.data";  //  Input/output filename
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; symbol i appears 2^(20 - i) times
+  for (unsigned int i = 1; i <= 20; i++) {
+    for (unsigned int j = 0; j < (1u << (20 - i)); j++) {
+      tmp.push_back (i);
+    }
+  }
+  for (unsigned int i = tmp.size () - 1; i > 0; i--) {
+    swap (tmp[i], tmp[rand () % (i + 1)]);
+  }
+
+  //  Test encoding
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  Huffman hm_out;
+  hm_out.UpdateFrequencies (tmp);
+  hm_out.EncodeBegin (bitbuff_out);
+  hm_out.EncodeMessage (bitbuff_out, tmp);
+  hm_out.EncodeFinish (bitbuff_out);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding..." << endl;
+
+  //  Test decoding, a piece at a time
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  Huffman hm_in;
+  hm_in.DecodeBegin (bitbuff_in);
+  while (tmp2.size () < hm_in.GetMessageLength ()) {
+    vector<unsigned int> piece = hm_in.DecodeMessage (bitbuff_in, 1000);
+    if (piece.empty ()) {
+      cerr << "EE\tHuffman decoding stopped after " << tmp2.size () << " symbols!" << endl;
+      return (false);
+    }
+    tmp2.insert (tmp2.end (), piece.begin (), piece.end ());
+  }
+  hm_in.DecodeFinish (bitbuff_in);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  //  Compare hm_in with hm_out
+  if (!VectorSame (tmp, tmp2)) {
+    cerr << "EE\tHuffman coding of long codewords unsuccessful!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tHuffman coding of long codewords successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Huffman code the same kind of numbers as HuffmanLongCodes (), but with the length of the codewords
+     limited to g_HUFFMAN_LOOKUP_BITS.
+
+     \return true if no codeword is too long and the numbers are decoded correctly; false otherwise
+*/
+bool HuffmanLengthLimited () {
+  string str = "tmp-length-limited.data";  //  Input/output filename
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; symbol i appears 2^(20 - i) times
+  for (unsigned int i = 1; i <= 20; i++) {
+    for (unsigned int j = 0; j < (1u << (20 - i)); j++) {
+      tmp.push_back (i);
+    }
+  }
+  for (unsigned int i = tmp.size () - 1; i > 0; i--) {
+    swap (tmp[i], tmp[rand () % (i + 1)]);
+  }
+
+  //  Test encoding
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  Huffman hm_out;
+  hm_out.SetCodewordLimit (g_HUFFMAN_LOOKUP_BITS);
+  hm_out.UpdateFrequencies (tmp);
+  hm_out.EncodeBegin (bitbuff_out);
+  hm_out.EncodeMessage (bitbuff_out, tmp);
+  hm_out.EncodeFinish (bitbuff_out);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding with codewords of at most " << hm_out.GetMaximumCodewordLen () << " bits..." << endl;
+
+  if (hm_out.GetMaximumCodewordLen () > g_HUFFMAN_LOOKUP_BITS) {
+    cerr << "EE\tHuffman codewords are longer than the limit of " << g_HUFFMAN_LOOKUP_BITS << " bits!" << endl;
+    return (false);
+  }
+
+  //  Test decoding
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  Huffman hm_in;
+  hm_in.DecodeBegin (bitbuff_in);
+  tmp2 = hm_in.DecodeMessage (bitbuff_in, hm_in.GetMessageLength ());
+  hm_in.DecodeFinish (bitbuff_in);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  //  Compare hm_in with hm_out
+  if (!VectorSame (tmp, tmp2)) {
+    cerr << "EE\tLength-limited Huffman coding unsuccessful!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tLength-limited Huffman coding successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Huffman code the same kind of numbers as HuffmanLongCodes () with the message split into
+     interleaved streams.  The message is encoded and decoded in pieces of different lengths and a
+     marker written after it checks that the decoder stops at its end.
+
+     \return true if the numbers are decoded correctly for each number of streams; false otherwise
+*/
+bool HuffmanStreams () {
+  string str = "tmp-streams.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the message
+  vector<unsigned int> tmp;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; symbol i appears 2^(16 - i) times
+  for (unsigned int i = 1; i <= 16; i++) {
+    for (unsigned int j = 0; j < (1u << (16 - i)); j++) {
+      tmp.push_back (i);
+    }
+  }
+  for (unsigned int i = tmp.size () - 1; i > 0; i--) {
+    swap (tmp[i], tmp[rand () % (i + 1)]);
+  }
+
+  for (unsigned int streams = 2; streams <= g_HUFFMAN_MAX_STREAMS; streams *= 2) {
+    vector<unsigned int> tmp2;
+
+    //  Test encoding, a piece at a time
+    BitBuffer bitbuff_out;
+    bitbuff_out.Initialize (str, e_MODE_WRITE);
+    Huffman hm_out;
+    hm_out.SetStreams (streams);
+    hm_out.UpdateFrequencies (tmp);
+    hm_out.EncodeBegin (bitbuff_out);
+    unsigned int pos = 0;
+    while (pos < tmp.size ()) {
+      unsigned int len = min (static_cast<unsigned int> (rand () % 100), static_cast<unsigned int> (tmp.size ()) - pos);
+      hm_out.EncodeMessage (bitbuff_out, &tmp[pos], len);
+      pos += len;
+    }
+    hm_out.EncodeFinish (bitbuff_out);
+    bitbuff_out.WriteBits (marker, 16);
+    bitbuff_out.Finish ();
+    cerr << "II\tFinished encoding with " << streams << " streams..." << endl;
+
+    //  Test decoding, a piece at a time
+    BitBuffer bitbuff_in;
+    bitbuff_in.Initialize (str, e_MODE_READ);
+    Huffman hm_in;
+    hm_in.SetStreams (streams);
+    hm_in.DecodeBegin (bitbuff_in);
+    while (tmp2.size () < hm_in.GetMessageLength ()) {
+      size_t decoded = tmp2.size ();
+      hm_in.DecodeMessage (bitbuff_in, (rand () % 100) + 1, tmp2);
+      if (tmp2.size () == decoded) {
+        cerr << "EE\tHuffman decoding with " << streams << " streams stopped after " << decoded << " symbols!" << endl;
+        return (false);
+      }
+    }
+    hm_in.DecodeFinish (bitbuff_in);
+    unsigned int marker_in = bitbuff_in.ReadBits (16);
+    bitbuff_in.Finish ();
+    cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+    //  Compare hm_in with hm_out
+    if ((!VectorSame (tmp, tmp2)) || (marker_in != marker)) {
+      cerr << "EE\tHuffman coding with " << streams << " streams unsuccessful!" << endl;
+      return (false);
+    }
+  }
+
+  cerr << "II\tHuffman coding with interleaved streams successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Huffman code messages in which each number depends on the one before it with HuffmanContext.
+     Most numbers are close to the previous one, but a few are rare, so that some contexts share a
+     table and some codewords are too long to be looked up.  A marker written after the messages
+     checks that the decoder stops at their end.
+
+     \return true if the messages are decoded correctly; false otherwise
+*/
+bool HuffmanContextExample () {
+  string str = "tmp-context.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the messages
+  const unsigned int messages = 1000;  //  Number of messages
+  const unsigned int message_len = 50;  //  Length of each message
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data
+  for (unsigned int i = 0; i < messages; i++) {
+    unsigned int prev = 20 + (rand () % 20);
+    for (unsigned int j = 0; j < message_len; j++) {
+      unsigned int x = prev;
+      if (rand () % 1000 == 0) {
+        x = 100 + (rand () % 50);
+      }
+      else if (prev >= 100) {
+        x = 30;
+      }
+      else {
+        x = max (1, static_cast<int> (prev) + (rand () % 5) - 2);
+      }
+      tmp.push_back (x);
+      prev = x;
+    }
+  }
+
+  //  Test encoding, a message at a time
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  HuffmanContext hc_out;
+  for (unsigned int i = 0; i < messages; i++) {
+    hc_out.UpdateFrequencies (&tmp[i * message_len], message_len);
+  }
+  hc_out.EncodeBegin (bitbuff_out);
+  for (unsigned int i = 0; i < messages; i++) {
+    hc_out.EncodeMessage (bitbuff_out, &tmp[i * message_len], message_len);
+  }
+  hc_out.EncodeFinish (bitbuff_out);
+  bitbuff_out.WriteBits (marker, 16);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding with " << hc_out.GetTables () << " tables..." << endl;
+
+  //  Test decoding, a message at a time
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  HuffmanContext hc_in;
+  hc_in.DecodeBegin (bitbuff_in);
+  for (unsigned int i = 0; i < messages; i++) {
+    hc_in.DecodeMessage (bitbuff_in, message_len, tmp2);
+  }
+  hc_in.DecodeFinish (bitbuff_in);
+  unsigned int marker_in = bitbuff_in.ReadBits (16);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  //  Compare hc_in with hc_out
+  if ((!VectorSame (tmp, tmp2)) || (marker_in != marker) || (hc_in.GetTables () != hc_out.GetTables ()) || (hc_out.GetTables () < 2)) {
+    cerr << "EE\tOrder-1 Huffman coding unsuccessful!" << endl;
+    return (false);
+  }
+
+  cerr << "II\tOrder-1 Huffman coding successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Huffman code two messages with the same code, whose prelude is only sent with the first.  The
+     second message is coded with the codeword lengths of the first (see GetCodewordLengths ()), both
+     with one stream and with interleaved streams.  A marker written after the messages checks that the
+     decoder stops at their end.
+
+     \return true if the messages are decoded correctly; false otherwise
+*/
+bool HuffmanReuse () {
+  string str = "tmp-reuse.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the messages
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; the second message only has symbols which are in the first
+  for (unsigned int i = 0; i < g_TEST_SIZE; i++) {
+    tmp.push_back ((rand () % 10) + (rand () % 10) + 1);
+  }
+  for (unsigned int i = 0; i < g_TEST_SIZE / 2; i++) {
+    tmp2.push_back (tmp[rand () % tmp.size ()]);
+  }
+
+  for (unsigned int streams = 1; streams <= g_HUFFMAN_MAX_STREAMS; streams *= 4) {
+    vector<unsigned int> tmp_in;
+    vector<unsigned int> tmp2_in;
+
+    //  Test encoding; the first message sends the code
+    BitBuffer bitbuff_out;
+    bitbuff_out.Initialize (str, e_MODE_WRITE);
+    Huffman hm_out;
+    hm_out.SetStreams (streams);
+    hm_out.UpdateFrequencies (tmp);
+    hm_out.EncodeBegin (bitbuff_out);
+    hm_out.EncodeMessage (bitbuff_out, tmp);
+    hm_out.EncodeFinish (bitbuff_out);
+
+    Huffman hm2_out;
+    hm2_out.SetStreams (streams);
+    hm2_out.UpdateFrequencies (tmp2);
+    hm2_out.EncodeBegin (bitbuff_out, hm_out.GetCodewordLengths ());
+    hm2_out.EncodeMessage (bitbuff_out, tmp2);
+    hm2_out.EncodeFinish (bitbuff_out);
+    bitbuff_out.WriteBits (marker, 16);
+    bitbuff_out.Finish ();
+    cerr << "II\tFinished encoding with " << streams << " streams..." << endl;
+
+    //  Test decoding; the second message is decoded with the code of the first
+    BitBuffer bitbuff_in;
+    bitbuff_in.Initialize (str, e_MODE_READ);
+    Huffman hm_in;
+    hm_in.SetStreams (streams);
+    hm_in.DecodeBegin (bitbuff_in);
+    hm_in.DecodeMessage (bitbuff_in, hm_in.GetMessageLength (), tmp_in);
+    hm_in.DecodeFinish (bitbuff_in);
+
+    Huffman hm2_in;
+    hm2_in.SetStreams (streams);
+    hm2_in.DecodeBegin (bitbuff_in, hm_in.GetCodewordLengths ());
+    hm2_in.DecodeMessage (bitbuff_in, hm2_in.GetMessageLength (), tmp2_in);
+    hm2_in.DecodeFinish (bitbuff_in);
+    unsigned int marker_in = bitbuff_in.ReadBits (16);
+    bitbuff_in.Finish ();
+    cerr << "II\tFinished decoding... " << tmp_in.size () << " and " << tmp2_in.size () << " symbols." << endl;
+
+    //  Compare the decoded messages and codes with the encoded ones
+    if ((!VectorSame (tmp, tmp_in)) || (!VectorSame (tmp2, tmp2_in)) || (marker_in != marker) ||
+        (!VectorSame (hm_in.GetCodewordLengths (), hm_out.GetCodewordLengths ()))) {
+      cerr << "EE\tHuffman coding with a reused code and " << streams << " streams unsuccessful!" << endl;
+      return (false);
+    }
+  }
+
+  cerr << "II\tHuffman coding with a reused code successful!" << endl;
+  return (true);
+}
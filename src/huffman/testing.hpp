@@ -40,5 +40,10 @@ bool HuffmanSimple2Example ();
 bool HuffmanSimple3Example ();
 bool HuffmanCACAExample ();
 bool HuffmanRandom ();
+bool HuffmanLongCodes ();
+bool HuffmanLengthLimited ();
+bool HuffmanStreams ();
+bool HuffmanContextExample ();
+bool HuffmanReuse ();
 
 #endif
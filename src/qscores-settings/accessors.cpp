@@ -129,6 +129,16 @@ int QScoresSettings::GetQScoresMappingMin () const {
 }
 
 
+/*!
+     Get the block index setting.
+
+     \return Boolean value representing the setting.
+*/
+bool QScoresSettings::GetBlockIndex () const {
+  return (m_BlockIndex);
+}
+
+
 /*!
      Get the maximum quality score for the selected mapping method.
 
@@ -370,6 +380,16 @@ bool QScoresSettings::GetCompressionHuffman () const {
 }
 
 
+/*!
+     Get whether the Huffman coding options are in the file header.
+
+     \return Boolean value representing the setting.
+*/
+bool QScoresSettings::GetCompressionHuffmanOptions () const {
+  return (m_CompressionHuffmanOptions);
+}
+
+
 /*!
      Get the arithmetic coding compression setting.
 
@@ -380,6 +400,36 @@ bool QScoresSettings::GetCompressionArithmetic () const {
 }
 
 
+/*!
+     Get the adaptive arithmetic coding with contexts compression setting.
+
+     \return Boolean value representing the setting.
+*/
+bool QScoresSettings::GetCompressionArithmeticContext () const {
+  return (m_CompressionArithmeticContext);
+}
+
+
+/*!
+     Get the rANS coding compression setting.
+
+     \return Boolean value representing the setting.
+*/
+bool QScoresSettings::GetCompressionRans () const {
+  return (m_CompressionRans);
+}
+
+
+/*!
+     Get the tANS coding compression setting.
+
+     \return Boolean value representing the setting.
+*/
+bool QScoresSettings::GetCompressionTans () const {
+  return (m_CompressionTans);
+}
+
+
 /*!
      Get the gzip compression setting.
 
@@ -420,6 +470,16 @@ bool QScoresSettings::GetCompressionPPM () const {
 }
 
 
+/*!
+     Get the Zstandard compression setting.
+
+     \return Boolean value representing the setting.
+*/
+bool QScoresSettings::GetCompressionZstd () const {
+  return (m_CompressionZstd);
+}
+
+
 /*!
      Get the no compression setting.
 
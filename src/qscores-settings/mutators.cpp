@@ -99,6 +99,16 @@ bool QScoresSettings::SetQScoresMapping (string x) {
   return true;
 }
 
+
+/*!
+     Indicate that a block index is added to the end of the file.
+*/
+void QScoresSettings::SetBlockIndex () {
+  m_BlockIndex = true;
+  return;
+}
+
+
 //  -----------------------------------------------------------------
 //  Lossy transformation options
 //  -----------------------------------------------------------------
@@ -281,6 +291,15 @@ void QScoresSettings::SetCompressionHuffman () {
 }
 
 
+/*!
+     Indicate that the Huffman coding options are in the file header.
+*/
+void QScoresSettings::SetCompressionHuffmanOptions () {
+  m_CompressionHuffmanOptions = true;
+  return;
+}
+
+
 /*!
      Indicate that arithmetic coding is used.
 */
@@ -290,6 +309,33 @@ void QScoresSettings::SetCompressionArithmetic () {
 }
 
 
+/*!
+     Indicate that adaptive arithmetic coding with contexts is used.
+*/
+void QScoresSettings::SetCompressionArithmeticContext () {
+  m_CompressionArithmeticContext = true;
+  return;
+}
+
+
+/*!
+     Indicate that rANS coding is used.
+*/
+void QScoresSettings::SetCompressionRans () {
+  m_CompressionRans = true;
+  return;
+}
+
+
+/*!
+     Indicate that tANS coding (or Huffman coding, whichever is smaller for each block) is used.
+*/
+void QScoresSettings::SetCompressionTans () {
+  m_CompressionTans = true;
+  return;
+}
+
+
 /*!
      Indicate that gzip is used.
 */
@@ -326,6 +372,15 @@ void QScoresSettings::SetCompressionPPM () {
 }
 
 
+/*!
+     Indicate that Zstandard is used.
+*/
+void QScoresSettings::SetCompressionZstd () {
+  m_CompressionZstd = true;
+  return;
+}
+
+
 /*!
      Indicate that no compression is used.
 */
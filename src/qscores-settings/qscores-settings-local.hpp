@@ -54,7 +54,7 @@ const unsigned int g_MAPPING_BITMASK = 3;
        AAAAAAAA BBBB CC DD
        
      A:  Compression method
-     B:  Lossless transformation
+     B:  Lossless transformation; the highest bit indicates whether a block index is at the end of the file
      C:  Lossy transformations (at most one)
      D:  Quality scores mapping (at most one)
 */
@@ -69,6 +69,7 @@ enum e_QSCORES_BINARY_SETTINGS {
   e_QSCORES_BINARY_SETTINGS_LOSSLESS_DIFF = 16,  /*!< Difference coding transformation */
   e_QSCORES_BINARY_SETTINGS_LOSSLESS_RESCALING = 32,  /*!< Re-scaling transformation */
   e_QSCORES_BINARY_SETTINGS_LOSSLESS_REMAPPING = 64,  /*!< Frequency-based remapping transformation */
+  e_QSCORES_BINARY_SETTINGS_BLOCK_INDEX = 128,  /*!< Block index at the end of the file */
   e_QSCORES_BINARY_SETTINGS_COMP_BINARY = 256,  /*!< Binary compression - 0000 0001 */  
   e_QSCORES_BINARY_SETTINGS_COMP_GAMMA = 512,  /*!< Gamma compression - 0000 0010 */
   e_QSCORES_BINARY_SETTINGS_COMP_DELTA = 768,  /*!< Delta compression - 0000 0011 */
@@ -77,9 +78,15 @@ enum e_QSCORES_BINARY_SETTINGS {
   e_QSCORES_BINARY_SETTINGS_COMP_INTERP = 2048,  /*!< Interpolative coding - 0000 1000 */
   e_QSCORES_BINARY_SETTINGS_COMP_HUFFMAN = 8192,  /*!< Huffman coding - 0010 0000 */
   e_QSCORES_BINARY_SETTINGS_COMP_ARITHMETIC = 8448,  /*!< Arithmetic coding - 0010 0001 */  
+  e_QSCORES_BINARY_SETTINGS_COMP_HUFFMAN_OPTIONS = 8704,  /*!< Huffman coding with options given after the block sizes - 0010 0010 */
+  e_QSCORES_BINARY_SETTINGS_COMP_ARITHMETIC_CONTEXT = 8960,  /*!< Adaptive arithmetic coding with contexts - 0010 0011 */
+  e_QSCORES_BINARY_SETTINGS_COMP_RANS = 9216,  /*!< rANS coding - 0010 0100 */
+  e_QSCORES_BINARY_SETTINGS_COMP_TANS = 9472,  /*!< tANS or Huffman coding, chosen for each block - 0010 0101 */
   e_QSCORES_BINARY_SETTINGS_COMP_GZIP = 16384,  /*!< gzip - 0100 0000 */
   e_QSCORES_BINARY_SETTINGS_COMP_BZIP = 16640,  /*!< bzip2 - 0100 0001 */
   e_QSCORES_BINARY_SETTINGS_COMP_REPAIR = 16896,  /*!< Re-Pair - 0100 0010 */
+  e_QSCORES_BINARY_SETTINGS_COMP_PPM = 17152,  /*!< PPM - 0100 0011 */
+  e_QSCORES_BINARY_SETTINGS_COMP_ZSTD = 17408,  /*!< Zstandard - 0100 0100 */
   e_QSCORES_BINARY_SETTINGS_COMP_NONE = 65024,  /*!< No compression - 1111 1110 */
   e_QSCORES_BINARY_SETTINGS_LAST = 65535  /*!< Upper boundary of enumerated type - 1111 1111 1111 1111 */
 };
@@ -56,6 +56,7 @@ QScoresSettings::QScoresSettings ()
     m_InputFn (""),
     m_OutputFn (""),
     m_Mapping (e_QSCORES_MAP_UNSET),
+    m_BlockIndex (false),
     m_LossyMinTruncation (false),
     m_LossyMaxTruncation (false),
     m_LossyLogBinning (false),
@@ -75,11 +76,16 @@ QScoresSettings::QScoresSettings ()
     m_CompressionInterP (false),
     m_CompressionGlobalParameter (g_DEFAULT_GOLOMB_RICE_PARAM),
     m_CompressionHuffman (false),
+    m_CompressionHuffmanOptions (false),
     m_CompressionArithmetic (false),
+    m_CompressionArithmeticContext (false),
+    m_CompressionRans (false),
+    m_CompressionTans (false),
     m_CompressionGzip (false),
     m_CompressionBzip (false),
     m_CompressionRepair (false),
     m_CompressionPPM (false),
+    m_CompressionZstd (false),
     m_CompressionNone (false)
 {
 }
@@ -106,6 +112,7 @@ ostream &operator<< (ostream &os, const QScoresSettings& qs) {
   
   os << left << "II\tMapping" << endl;
   os << left << setw (g_VERBOSE_WIDTH) << "II\t  Scheme:" << qs.GetQScoresMappingStr () << endl;
+  os << left << setw (g_VERBOSE_WIDTH) << "II\t  Block index:" << (qs.GetBlockIndex () == true ? "Yes" : "No") << endl;
 
   os << left << "II\tLossy transformations" << endl;
   if (qs.GetLossyMinTruncation () > 0) {
@@ -171,6 +178,15 @@ ostream &operator<< (ostream &os, const QScoresSettings& qs) {
   if (qs.GetCompressionArithmetic ()) {
     os << left << setw (g_VERBOSE_WIDTH) << "II\t  Arithmetic coding:" << (qs.GetCompressionArithmetic () == true ? "Yes" : "No") << endl;
   }
+  if (qs.GetCompressionArithmeticContext ()) {
+    os << left << setw (g_VERBOSE_WIDTH) << "II\t  Arithmetic coding with contexts:" << (qs.GetCompressionArithmeticContext () == true ? "Yes" : "No") << endl;
+  }
+  if (qs.GetCompressionRans ()) {
+    os << left << setw (g_VERBOSE_WIDTH) << "II\t  rANS coding:" << (qs.GetCompressionRans () == true ? "Yes" : "No") << endl;
+  }
+  if (qs.GetCompressionTans ()) {
+    os << left << setw (g_VERBOSE_WIDTH) << "II\t  tANS or Huffman coding:" << (qs.GetCompressionTans () == true ? "Yes" : "No") << endl;
+  }
   if (qs.GetCompressionGzip ()) {
     os << left << setw (g_VERBOSE_WIDTH) << "II\t  Gzip:" << (qs.GetCompressionGzip () == true ? "Yes" : "No") << endl;
   }
@@ -183,6 +199,9 @@ ostream &operator<< (ostream &os, const QScoresSettings& qs) {
   if (qs.GetCompressionPPM ()) {
     os << left << setw (g_VERBOSE_WIDTH) << "II\t  PPM:" << (qs.GetCompressionPPM () == true ? "Yes" : "No") << endl;
   }
+  if (qs.GetCompressionZstd ()) {
+    os << left << setw (g_VERBOSE_WIDTH) << "II\t  Zstandard:" << (qs.GetCompressionZstd () == true ? "Yes" : "No") << endl;
+  }
   if (qs.GetCompressionNone ()) {
     os << left << setw (g_VERBOSE_WIDTH) << "II\t  None:" << (qs.GetCompressionNone () == true ? "Yes" : "No") << endl;
   }
@@ -333,6 +352,15 @@ bool QScoresSettings::CheckCompressionSettings () const {
   if (GetCompressionArithmetic ()) {
     compression_count++;
   }
+  if (GetCompressionArithmeticContext ()) {
+    compression_count++;
+  }
+  if (GetCompressionRans ()) {
+    compression_count++;
+  }
+  if (GetCompressionTans ()) {
+    compression_count++;
+  }
   if (GetCompressionGzip ()) {
     compression_count++;
   }
@@ -345,6 +373,9 @@ bool QScoresSettings::CheckCompressionSettings () const {
   if (GetCompressionPPM ()) {
     compression_count++;
   }
+  if (GetCompressionZstd ()) {
+    compression_count++;
+  }
   if (GetCompressionNone ()) {
     compression_count++;
   }
@@ -431,6 +462,10 @@ bool QScoresSettings::ReadBinarySettings (BitBuffer &bitbuffer) {
   if ((setting & e_QSCORES_BINARY_SETTINGS_LOSSLESS_REMAPPING) != 0) {
     SetTransformFreqOrder ();
   }
+
+  if ((setting & e_QSCORES_BINARY_SETTINGS_BLOCK_INDEX) != 0) {
+    SetBlockIndex ();
+  }
   
   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_BINARY) {
     SetCompressionBinary ();
@@ -453,9 +488,22 @@ bool QScoresSettings::ReadBinarySettings (BitBuffer &bitbuffer) {
   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_HUFFMAN) {
     SetCompressionHuffman ();
   }
+  if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_HUFFMAN_OPTIONS) {
+    SetCompressionHuffman ();
+    SetCompressionHuffmanOptions ();
+  }
   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_ARITHMETIC) {
     SetCompressionArithmetic ();
   }
+  if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_ARITHMETIC_CONTEXT) {
+    SetCompressionArithmeticContext ();
+  }
+  if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_RANS) {
+    SetCompressionRans ();
+  }
+  if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_TANS) {
+    SetCompressionTans ();
+  }
   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_GZIP) {
     SetCompressionGzip ();
   }
@@ -465,9 +513,12 @@ bool QScoresSettings::ReadBinarySettings (BitBuffer &bitbuffer) {
   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_REPAIR) {
     SetCompressionRepair ();
   }
-//   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_PPM) {
-//     SetCompressionPPM ();
-//   }
+  if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_PPM) {
+    SetCompressionPPM ();
+  }
+  if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_ZSTD) {
+    SetCompressionZstd ();
+  }
   if ((setting & g_COMPRESSION_METHOD_BITMASK) == e_QSCORES_BINARY_SETTINGS_COMP_NONE) {
     SetCompressionNone ();
   }
@@ -509,6 +560,10 @@ bool QScoresSettings::WriteBinarySettings (BitBuffer &bitbuffer) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_LOSSLESS_REMAPPING & g_LOSSLESS_TRANSFORM_BITMASK);
   }
 
+  if (GetBlockIndex ()) {
+    setting = setting | e_QSCORES_BINARY_SETTINGS_BLOCK_INDEX;
+  }
+
   if (GetLossyMaxTruncation ()) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_LOSSY_MAXTRUNC & g_LOSSY_TRANSFORM_BITMASK);
   }
@@ -537,12 +592,24 @@ bool QScoresSettings::WriteBinarySettings (BitBuffer &bitbuffer) {
   else if (GetCompressionInterP ()) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_INTERP & g_COMPRESSION_METHOD_BITMASK);
   }
+  else if ((GetCompressionHuffman ()) && (GetCompressionHuffmanOptions ())) {
+    setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_HUFFMAN_OPTIONS & g_COMPRESSION_METHOD_BITMASK);
+  }
   else if (GetCompressionHuffman ()) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_HUFFMAN & g_COMPRESSION_METHOD_BITMASK);
   }
   else if (GetCompressionArithmetic ()) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_ARITHMETIC & g_COMPRESSION_METHOD_BITMASK);
   }
+  else if (GetCompressionArithmeticContext ()) {
+    setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_ARITHMETIC_CONTEXT & g_COMPRESSION_METHOD_BITMASK);
+  }
+  else if (GetCompressionRans ()) {
+    setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_RANS & g_COMPRESSION_METHOD_BITMASK);
+  }
+  else if (GetCompressionTans ()) {
+    setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_TANS & g_COMPRESSION_METHOD_BITMASK);
+  }
   else if (GetCompressionGzip ()) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_GZIP & g_COMPRESSION_METHOD_BITMASK);
   }
@@ -552,9 +619,12 @@ bool QScoresSettings::WriteBinarySettings (BitBuffer &bitbuffer) {
   else if (GetCompressionRepair ()) {
     setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_REPAIR & g_COMPRESSION_METHOD_BITMASK);
   }
-//   if (GetCompressionPPM ()) {
-//     setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_PPM & g_COMPRESSION_METHOD_BITMASK);
-//   }
+  else if (GetCompressionPPM ()) {
+    setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_PPM & g_COMPRESSION_METHOD_BITMASK);
+  }
+  else if (GetCompressionZstd ()) {
+    setting = setting | (e_QSCORES_BINARY_SETTINGS_COMP_ZSTD & g_COMPRESSION_METHOD_BITMASK);
+  }
 
   BinaryHigh_Encode (bitbuffer, setting, e_QSCORES_BINARY_SETTINGS_LAST);
   if (GetDebug ()) {
@@ -60,6 +60,7 @@ class QScoresSettings {
     int GetQScoresMappingMin () const;
     int GetQScoresMappingMax () const;
     int GetQScoresMappingRange () const;
+    bool GetBlockIndex () const;
 
     //  Lossless transformations
     bool GetTransformGapTrans () const;
@@ -84,11 +85,16 @@ class QScoresSettings {
     bool GetCompressionGolomb () const;
     bool GetCompressionRice () const;
     bool GetCompressionHuffman () const;
+    bool GetCompressionHuffmanOptions () const;
     bool GetCompressionArithmetic () const;
+    bool GetCompressionArithmeticContext () const;
+    bool GetCompressionRans () const;
+    bool GetCompressionTans () const;
     bool GetCompressionGzip () const;
     bool GetCompressionBzip () const;
     bool GetCompressionRepair () const;
     bool GetCompressionPPM () const;
+    bool GetCompressionZstd () const;
     bool GetCompressionNone () const;
 
     //  Compression parameters
@@ -99,6 +105,7 @@ class QScoresSettings {
     void SetOutputFn (string x);
     void SetDebug ();
     bool SetQScoresMapping (string x);
+    void SetBlockIndex ();
 
     //  Lossless transformations
     void SetTransformGapTrans ();
@@ -123,11 +130,16 @@ class QScoresSettings {
     void SetCompressionGolomb ();
     void SetCompressionRice ();
     void SetCompressionHuffman ();
+    void SetCompressionHuffmanOptions ();
     void SetCompressionArithmetic ();
+    void SetCompressionArithmeticContext ();
+    void SetCompressionRans ();
+    void SetCompressionTans ();
     void SetCompressionGzip ();
     void SetCompressionBzip ();
     void SetCompressionRepair ();
     void SetCompressionPPM ();
+    void SetCompressionZstd ();
     void SetCompressionNone ();
     
     //  Compression parameters
@@ -142,6 +154,8 @@ class QScoresSettings {
 
     //!  QScores mapping used
     enum e_QSCORES_MAP m_Mapping;
+    //!  Is a block index added to the end of the file?
+    bool m_BlockIndex;
 
     //!  Lossy transformation -- truncate values to a minimum?
     bool m_LossyMinTruncation;
@@ -185,8 +199,16 @@ class QScoresSettings {
     
     //!  Compression -- Huffman coding?
     bool m_CompressionHuffman;
+    //!  Compression -- Huffman coding options in the file header (i.e., not all of them have their default values)?
+    bool m_CompressionHuffmanOptions;
     //!  Compression -- Arithmetic coding?
     bool m_CompressionArithmetic;
+    //!  Compression -- Adaptive arithmetic coding with contexts?
+    bool m_CompressionArithmeticContext;
+    //!  Compression -- rANS coding?
+    bool m_CompressionRans;
+    //!  Compression -- tANS coding (or Huffman coding for some blocks)?
+    bool m_CompressionTans;
     //!  Compression -- gzip?
     bool m_CompressionGzip;
     //!  Compression -- bzip?
@@ -195,6 +217,8 @@ class QScoresSettings {
     bool m_CompressionRepair;
     //!  Compression -- PPM?
     bool m_CompressionPPM;
+    //!  Compression -- Zstandard?
+    bool m_CompressionZstd;
     //!  Compression -- None?
     bool m_CompressionNone;
 };
@@ -143,9 +143,9 @@ void QScoresSingle::PrintQScore () {
 /*!
      Print the integer representations of the quality scores out as-is
 
-     \return Integer representation of quality scores
+     \return Integer representation of quality scores, by reference
 */
-vector<unsigned int> QScoresSingle::GetQScoreInt () const {
+const vector<unsigned int> &QScoresSingle::GetQScoreInt () const {
   return m_QScoreInt;
 }
 
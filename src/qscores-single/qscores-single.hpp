@@ -73,7 +73,7 @@ class QScoresSingle {
     
     //  I/O functions  [io.cpp]
     void PrintQScore ();
-    vector<unsigned int> GetQScoreInt () const;
+    const vector<unsigned int> &GetQScoreInt () const;
     unsigned int GetQScoreIntAsBinary (char* buffer, unsigned int buffer_size);
     
     //  Mapping to/from quality scores  [mapping.cpp]
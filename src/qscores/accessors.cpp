@@ -127,3 +127,195 @@ bool QScores::GetUnbinningCheck () const {
 int QScores::GetBlocksize () const {
   return (m_Blocksize);
 }
+
+
+/*!
+     Get the number of threads.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetThreads () const {
+  return (m_Threads);
+}
+
+
+/*!
+     Get the maximum length of a Huffman codeword.
+
+     \return Unsigned integer representing the setting; 0 if there is no limit.
+*/
+unsigned int QScores::GetHuffmanMaxLen () const {
+  return (m_HuffmanMaxLen);
+}
+
+
+/*!
+     Get the number of interleaved streams in each Huffman-coded block.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetHuffmanStreams () const {
+  return (m_HuffmanStreams);
+}
+
+
+/*!
+     Get the number of read position bins that each Huffman-coded block is split into.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetHuffmanPositionBins () const {
+  return (m_HuffmanPositionBins);
+}
+
+
+/*!
+     Get whether Huffman coding uses order-1 contexts (see HuffmanContext).
+
+     \return Boolean representing the setting.
+*/
+bool QScores::GetHuffmanOrder1 () const {
+  return (m_HuffmanOrder1);
+}
+
+
+/*!
+     Get whether a Huffman-coded block can reuse the code of an earlier block.
+
+     \return Boolean representing the setting.
+*/
+bool QScores::GetHuffmanReuse () const {
+  return (m_HuffmanReuse);
+}
+
+
+/*!
+     Get how much larger a Huffman-coded block can be, in percent, when it reuses the code of an
+     earlier block instead of sending its own.
+
+     \return The tolerance in percent.
+*/
+unsigned int QScores::GetHuffmanReuseTolerance () const {
+  return (m_HuffmanReuseTolerance);
+}
+
+
+/*!
+     Get the number of consecutive blocks in each run when Huffman codes are reused.  A block can only
+     reuse a code sent by an earlier block of its run.
+
+     \return The number of blocks in each run.
+*/
+unsigned int QScores::GetHuffmanReuseRun () const {
+  return (m_HuffmanReuseRun);
+}
+
+
+/*!
+     Get the number of interleaved states in each rANS-coded block.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetRansStates () const {
+  return (m_RansStates);
+}
+
+
+/*!
+     Get the order of PPM.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetPPMOrder () const {
+  return (m_PPMOrder);
+}
+
+
+/*!
+     Get the memory of PPM, in megabytes.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetPPMMemory () const {
+  return (m_PPMMemory);
+}
+
+
+/*!
+     Get the memory of Re-Pair, in megabytes.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetRePairMemory () const {
+  return (m_RePairMemory);
+}
+
+
+/*!
+     Get the compression level of Zstandard.
+
+     \return Unsigned integer representing the setting.
+*/
+unsigned int QScores::GetZstdLevel () const {
+  return (m_ZstdLevel);
+}
+
+
+/*!
+     Get whether Zstandard uses long-distance matching.
+
+     \return Boolean value representing the setting.
+*/
+bool QScores::GetZstdLong () const {
+  return (m_ZstdLong);
+}
+
+
+/*!
+     Get the file with the dictionary of Zstandard.
+
+     \return The filename; empty if none was given.
+*/
+string QScores::GetZstdDictionaryFn () const {
+  return (m_ZstdDictionaryFn);
+}
+
+
+/*!
+     Get the largest size of the dictionary of Zstandard trained from the first block.
+
+     \return Size in bytes; 0 if no dictionary is trained.
+*/
+unsigned int QScores::GetZstdTrainSize () const {
+  return (m_ZstdTrainSize);
+}
+
+
+/*!
+     Get whether only a range of reads should be decoded.
+
+     \return Boolean value representing the setting.
+*/
+bool QScores::GetExtractReads () const {
+  return (m_ExtractReads);
+}
+
+
+/*!
+     Get the first read to decode.
+
+     \return The first read to decode (from 0).
+*/
+unsigned long long QScores::GetExtractFirst () const {
+  return (m_ExtractFirst);
+}
+
+
+/*!
+     Get the read after the last read to decode.
+
+     \return One past the last read to decode.
+*/
+unsigned long long QScores::GetExtractLast () const {
+  return (m_ExtractLast);
+}
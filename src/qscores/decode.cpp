@@ -33,6 +33,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <climits>  //  UINT_MAX
+#include <algorithm>  //  min
 
 #include "boost/filesystem.hpp"   // includes all needed Boost.Filesystem declarations
 
@@ -40,6 +41,7 @@ using namespace std;
 namespace bfs = boost::filesystem;
 // namespace btk = boost::tokenizer;
 
+#include "common.hpp"
 #include "external-software.hpp"
 #include "block-statistics.hpp"
 #include "bitbuffer.hpp"
@@ -47,6 +49,8 @@ namespace bfs = boost::filesystem;
 #include "bitio-defn.hpp"
 #include "interpolative.hpp"
 #include "huffman.hpp"
+#include "arithmetic.hpp"
+#include "rans.hpp"
 #include "qscores-single-defn.hpp"
 #include "qscores-single.hpp"
 #include "qscores-settings.hpp"
@@ -55,44 +59,118 @@ namespace bfs = boost::filesystem;
 #include "qscores.hpp"
 
 
-//!  The number of symbols to decode with Huffman coding with each call of DecodeMessage ()
-const unsigned int g_HUFFMAN_DECODE_SYMBOLS = 1024;
+/*!
+     Start decoding a Huffman-coded block when --huffman-reuse was given.  A bit tells whether the block
+     reuses the last code sent by an earlier block of its run, which is kept in code; otherwise, the
+     block's own code is read and kept in code for the blocks after it.
+
+     \param[in] code The last code sent in the run; cleared at the first block of a run
+     \param[in] block_count Block ID (from 0) of the block being decoded
+     \param[in] run Number of blocks in each run
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] hm_in The Huffman object to decode the block with
+*/
+static void DecodeHuffmanReuseBegin (QScoresHuffmanCode &code, int block_count, unsigned int run, BitBuffer &bitbuff, Huffman &hm_in) {
+  if (block_count % static_cast<int> (run) == 0) {
+    code = QScoresHuffmanCode ();
+  }
+
+  if (bitbuff.ReadBits (1) == 1) {
+    if (code.block_count == -1) {
+      cerr << "EE\tBlock " << block_count << " reuses a Huffman code, but no earlier block of its run sent one." << endl;
+      exit (EXIT_FAILURE);
+    }
+    hm_in.DecodeBegin (bitbuff, code.lengths);
+  }
+  else {
+    hm_in.DecodeBegin (bitbuff);
+    code.block_count = block_count;
+    code.lengths = hm_in.GetCodewordLengths ();
+  }
+
+  return;
+}
 
 
 /*!
      Decode the header of the current block.
 
-     \param[in] block_count Block ID (from 0); not encoded and just used for printing
-                information to the screen
+     \param[in] block The block to decode the header into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] block_count Block ID (from 0); not encoded; recorded in the block (see --huffman-reuse)
+                and used for printing information to the screen
 */
-int QScores::DecodeHeaderBlock (int block_count) {
+int QScores::DecodeHeaderBlock (QScoresBlock &block, BitBuffer &bitbuff, int block_count) {
   unsigned int lossless_remap_size = 0;
   vector<unsigned int> lossless_remap;
   int current_blocksize = g_NO_BLOCKSIZE;
 
+  block.block_count = block_count;
+
   //  Length of the reads for the file
   if (block_count == 0) {
-    m_FileReadLength = Delta_Decode (m_BitBuff_In);
+    m_FileReadLength = Delta_Decode (bitbuff);
     m_FileReadLength--;
     
-    m_FileBlockSize = Delta_Decode (m_BitBuff_In);
+    m_FileBlockSize = Delta_Decode (bitbuff);
     m_FileBlockSize--;
     
     //  Output the lossy transformation parameter
     if (m_QScoresSettings.GetLossyLogBinning ()) {
-      unsigned int tmp = Delta_Decode (m_BitBuff_In);
+      unsigned int tmp = Delta_Decode (bitbuff);
       tmp--;
       m_QScoresSettings.SetLossyLogBinningParameter (static_cast<int> (tmp));
     }
     else if (m_QScoresSettings.GetLossyUniBinning ()) {
-      unsigned int tmp = Delta_Decode (m_BitBuff_In);
+      unsigned int tmp = Delta_Decode (bitbuff);
       tmp--;
       m_QScoresSettings.SetLossyUniBinningParameter (static_cast<int> (tmp));
     }
+
+    //  Input the Huffman coding options; without them, the defaults were used
+    SetHuffmanStreams (1);
+    SetHuffmanPositionBins (1);
+    SetHuffmanOrder1 (false);
+    SetHuffmanReuse (false);
+    if (m_QScoresSettings.GetCompressionHuffmanOptions ()) {
+      SetHuffmanStreams (Delta_Decode (bitbuff));
+      if ((GetHuffmanStreams () == 0) || (GetHuffmanStreams () > g_HUFFMAN_MAX_STREAMS) || ((GetHuffmanStreams () & (GetHuffmanStreams () - 1)) != 0)) {
+        cerr << "EE\tThe number of Huffman streams in the file header is invalid." << endl;
+        exit (EXIT_FAILURE);
+      }
+
+      SetHuffmanPositionBins (Delta_Decode (bitbuff));
+      if (GetHuffmanPositionBins () > g_HUFFMAN_MAX_POSITION_BINS) {
+        cerr << "EE\tThe number of Huffman read position bins in the file header is invalid." << endl;
+        exit (EXIT_FAILURE);
+      }
+
+      SetHuffmanOrder1 (Delta_Decode (bitbuff) == 2);
+      //  The number of blocks in each run, plus 1; 1 if no code is reused
+      unsigned int reuse_run = Delta_Decode (bitbuff);
+      SetHuffmanReuse (reuse_run > 1);
+      if (reuse_run > 1) {
+        SetHuffmanReuseRun (reuse_run - 1);
+      }
+    }
+
+    //  Input the dictionary of Zstandard
+    m_ZstdDictionary.clear ();
+    if (m_QScoresSettings.GetCompressionZstd ()) {
+      unsigned int dictionary_size = Delta_Decode (bitbuff) - 1;
+      if (dictionary_size > g_ZSTD_MAX_DICTIONARY_SIZE) {
+        cerr << "EE\tThe size of the Zstandard dictionary in the file header is invalid." << endl;
+        exit (EXIT_FAILURE);
+      }
+      m_ZstdDictionary.resize (dictionary_size);
+      if (dictionary_size != 0) {
+        bitbuff.ReadChars (m_ZstdDictionary.data (), static_cast<int> (dictionary_size));
+      }
+    }
   }
 
   //  Decode the number of reads in this block
-  current_blocksize = Delta_Decode (m_BitBuff_In);
+  current_blocksize = Delta_Decode (bitbuff);
   if (current_blocksize == g_EOF_REACHED) {
     return (g_EOF_REACHED);
   }
@@ -106,50 +184,50 @@ int QScores::DecodeHeaderBlock (int block_count) {
   }
 
   //  Length of the reads; see EncodeHeaderBlock ()
-  m_BlockReadLength = Delta_Decode (m_BitBuff_In);
-  if (m_BlockReadLength == 1) {
-    m_BlockReadLength = m_FileReadLength;
+  block.read_length = Delta_Decode (bitbuff);
+  if (block.read_length == 1) {
+    block.read_length = m_FileReadLength;
   }
-  else if (m_BlockReadLength == 2) {
-    m_BlockReadLength = g_READ_LENGTH_VARIABLE;
+  else if (block.read_length == 2) {
+    block.read_length = g_READ_LENGTH_VARIABLE;
   }
   else {
-    m_BlockReadLength -= 2;
+    block.read_length -= 2;
   }
 
-  m_BlockMinimum = 0;
+  block.minimum = 0;
   if (m_QScoresSettings.GetTransformMinShift ()) {
     //  Offset from the smallest value; subtract 1 from it
-    m_BlockMinimum = Delta_Decode (m_BitBuff_In);
-    m_BlockMinimum--;
+    block.minimum = Delta_Decode (bitbuff);
+    block.minimum--;
   }
 
   //  Sub-alphabet remapping
   if (m_QScoresSettings.GetTransformFreqOrder ()) {
-    lossless_remap_size = Delta_Decode (m_BitBuff_In);
-    Interpolative_Decode (m_BitBuff_In, lossless_remap, lossless_remap_size);
+    lossless_remap_size = Delta_Decode (bitbuff);
+    Interpolative_Decode (bitbuff, lossless_remap, lossless_remap_size);
 
-    m_BlockStatistics.Initialize ();
-    m_BlockStatistics.CopyIDsToQScores (lossless_remap);
+    block.statistics.Initialize ();
+    block.statistics.CopyIDsToQScores (lossless_remap);
   }
 
   //  Binary coding parameter
   if (m_QScoresSettings.GetCompressionBinary ()) {
-    m_CompressionParameter = Delta_Decode (m_BitBuff_In);
+    block.compression_parameter = Delta_Decode (bitbuff);
   }
 
   //  Golomb or Rice coding parameter
   if ((m_QScoresSettings.GetCompressionGolomb ()) ||
       (m_QScoresSettings.GetCompressionRice ())) {
-    m_CompressionParameter = Delta_Decode (m_BitBuff_In);
+    block.compression_parameter = Delta_Decode (bitbuff);
   }  
   
   if (GetDebug ()) {
     if (block_count % g_BLOCK_STATUS_FREQUENCY == 0) {
       cerr << "II\tDecoding block " << block_count << "\t";
       cerr << current_blocksize << "\t";
-      cerr << m_BlockMinimum << "\t";
-      cerr << m_BlockReadLength << "\t";
+      cerr << block.minimum << "\t";
+      cerr << block.read_length << "\t";
       if (m_QScoresSettings.GetLossyLogBinning ()) {
         cerr << "[QB " << m_QScoresSettings.GetLossyLogBinningParameter () << "]\t";
       }
@@ -157,16 +235,16 @@ int QScores::DecodeHeaderBlock (int block_count) {
         cerr << "[EB " << m_QScoresSettings.GetLossyUniBinningParameter () << "]\t";
       }
       if (m_QScoresSettings.GetCompressionBinary ()) {
-        cerr << "[B " << m_CompressionParameter << "]\t";
+        cerr << "[B " << block.compression_parameter << "]\t";
       }
       else if (m_QScoresSettings.GetCompressionGolomb ()) {
-        cerr << "[G " << m_CompressionParameter << "]\t";
+        cerr << "[G " << block.compression_parameter << "]\t";
       }
       else if (m_QScoresSettings.GetCompressionRice ()) {
-        cerr << "[R " << m_CompressionParameter << "]\t";
+        cerr << "[R " << block.compression_parameter << "]\t";
       }
       if (m_QScoresSettings.GetTransformMinShift ()) {
-        cerr << "[RS " << m_BlockMinimum << "]\t";
+        cerr << "[RS " << block.minimum << "]\t";
       }
       if (m_QScoresSettings.GetTransformFreqOrder ()) {
         cerr << "[LS " << lossless_remap_size << "]\t";
@@ -179,35 +257,83 @@ int QScores::DecodeHeaderBlock (int block_count) {
 }
 
 
+/*!
+     Decode the current block, whose header has already been decoded, and undo the transformations
+     applied when it was encoded.
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] external The object managing the external compression system
+     \param[in] current_blocksize Number of reads in this block
+*/
+void QScores::DecodeBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize) {
+  if ((m_QScoresSettings.GetCompressionBinary ()) ||
+      (m_QScoresSettings.GetCompressionGamma ()) ||
+      (m_QScoresSettings.GetCompressionDelta ()) ||
+      (m_QScoresSettings.GetCompressionGolomb () > 0) ||
+      (m_QScoresSettings.GetCompressionRice () > 0) ||
+      (m_QScoresSettings.GetCompressionInterP ())) {
+    DecodeStaticCodesBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionHuffman ()) {
+    DecodeHuffmanBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionArithmetic ()) {
+    DecodeArithmeticBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionArithmeticContext ()) {
+    DecodeArithmeticContextBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionRans ()) {
+    DecodeRansBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionTans ()) {
+    DecodeTansBlock (block, bitbuff, current_blocksize);
+  }
+  else if ((m_QScoresSettings.GetCompressionGzip ()) ||
+           (m_QScoresSettings.GetCompressionBzip ()) ||
+           (m_QScoresSettings.GetCompressionRepair ()) ||
+           (m_QScoresSettings.GetCompressionPPM ()) ||
+           (m_QScoresSettings.GetCompressionZstd ())) {
+    DecodeExternalBlock (block, bitbuff, external, current_blocksize);
+  }
+  UnPreprocessBlock (block, current_blocksize);
+
+  return;
+}
+
+
 /*!
      Decode the current block using static codes.
 
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
      \param[in] blocksize Number of reads in this block
 */
-void QScores::DecodeStaticCodesBlock (int blocksize) {
+void QScores::DecodeStaticCodesBlock (QScoresBlock &block, BitBuffer &bitbuff, int blocksize) {
   for (int i = 0; i < blocksize; i++) {
     QScoresSingle tmp = QScoresSingle ();
 
     if (m_QScoresSettings.GetCompressionBinary ()) {
-      tmp.UnapplyCompressionBinary (m_BitBuff_In, m_CompressionParameter, m_BlockReadLength);
+      tmp.UnapplyCompressionBinary (bitbuff, block.compression_parameter, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionGamma ()) {
-      tmp.UnapplyCompressionGamma (m_BitBuff_In, m_BlockReadLength);
+      tmp.UnapplyCompressionGamma (bitbuff, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionDelta ()) {
-      tmp.UnapplyCompressionDelta (m_BitBuff_In, m_BlockReadLength);
+      tmp.UnapplyCompressionDelta (bitbuff, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionGolomb () > 0) {
-      tmp.UnapplyCompressionGolomb (m_BitBuff_In, m_CompressionParameter, m_BlockReadLength);
+      tmp.UnapplyCompressionGolomb (bitbuff, block.compression_parameter, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionRice () > 0) {
-      tmp.UnapplyCompressionRice (m_BitBuff_In, m_CompressionParameter, m_BlockReadLength);
+      tmp.UnapplyCompressionRice (bitbuff, block.compression_parameter, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionInterP ()) {
-      tmp.UnapplyCompressionInterP (m_BitBuff_In, m_BlockReadLength);
+      tmp.UnapplyCompressionInterP (bitbuff, block.read_length);
     }
     
-    m_Qscores.push_back (tmp);
+    block.qscores.push_back (tmp);
   }
 
   return;
@@ -215,48 +341,306 @@ void QScores::DecodeStaticCodesBlock (int blocksize) {
 
 
 /*!
-     Decode the current block of quality scores using Huffman coding.
-
+     Decode the current block of quality scores using Huffman coding.  When the block was split into
+     read position bins (see EncodeHuffmanBlock ()), the part of every read in a bin is decoded before
+     moving on to the next bin.  When the block reuses the Huffman code of an earlier block of its run,
+     the code is taken from block.huffman_code, so the earlier blocks of the run must have been decoded
+     (or skipped with SkipHuffmanBlock ()) with the same block first.
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
      \param[in] blocksize Number of reads in this block
 */
-void QScores::DecodeHuffmanBlock (int blocksize) {
-  vector<unsigned int> buffer;  //  Temporary buffer of quality scores (not yet split)
+void QScores::DecodeHuffmanBlock (QScoresBlock &block, BitBuffer &bitbuff, int blocksize) {
   vector<unsigned int> tmp;  //  Temporary quality scores' read
   unsigned int block_length = 0;  //  Length of the block in # of symbols
-  unsigned int curr_read_length = 0;
-  
+  vector<unsigned int> bins (1, 0);  //  First read position of each bin
+
+  if (GetHuffmanPositionBins () > 1) {
+    unsigned int num_bins = Delta_Decode (bitbuff);
+    for (unsigned int b = 1; b < num_bins; b++) {
+      bins.push_back (bins[b - 1] + Delta_Decode (bitbuff));
+    }
+    if ((num_bins > 1) && ((block.read_length == g_READ_LENGTH_VARIABLE) || (bins.back () >= block.read_length))) {
+      cerr << "EE\tThe Huffman read position bins of a block are invalid." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  if ((bins.size () > 1) || (GetHuffmanOrder1 ())) {
+    DecodeHuffmanPositionBins (block, bitbuff, blocksize, bins);
+    return;
+  }
+
   Huffman hm_in;
+  hm_in.SetStreams (GetHuffmanStreams ());
 
-  //  Start decoding
-  hm_in.DecodeBegin (m_BitBuff_In);
+  //  Start decoding; with --huffman-reuse, a bit first tells whether the code of an earlier block of the run is used
+  if (GetHuffmanReuse ()) {
+    DecodeHuffmanReuseBegin (block.huffman_code, block.block_count, GetHuffmanReuseRun (), bitbuff, hm_in);
+  }
+  else {
+    hm_in.DecodeBegin (bitbuff);
+  }
   block_length = hm_in.GetMessageLength ();
 
-  //  Continue while there are still symbols left to decode
+  //  Decode the rest of the current read with each call; if its length is then equal to block.read_length, then we completed a read
   while (block_length != 0) {
-    if (block_length > g_HUFFMAN_DECODE_SYMBOLS) {
-      buffer = hm_in.DecodeMessage (m_BitBuff_In, g_HUFFMAN_DECODE_SYMBOLS);
-      block_length -= g_HUFFMAN_DECODE_SYMBOLS;
+    unsigned int len = min (block_length, block.read_length - static_cast<unsigned int> (tmp.size ()));
+    hm_in.DecodeMessage (bitbuff, len, tmp);
+    block_length -= len;
+
+    if (tmp.size () == block.read_length) {
+      QScoresSingle qscores_tmp (tmp);
+      block.qscores.push_back (qscores_tmp);
+      tmp.clear ();
+    }
+  }
+
+  //  Finish decoding
+  hm_in.DecodeFinish (bitbuff);
+
+  return;
+}
+
+
+/*!
+     Decode the current block of quality scores, which was split into read position bins, using Huffman
+     coding.  Each bin has its own Huffman code (or HuffmanContext, with --huffman-order1) and holds
+     the quality scores at its positions of every read; they are appended to the reads, which are then
+     added to the block.  With --huffman-order1, a block whose reads do not all have the same length
+     has one bin and the length of each read comes first (see EncodeHuffmanBlock ()).
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] blocksize Number of reads in this block
+     \param[in] bins The first read position of each bin
+*/
+void QScores::DecodeHuffmanPositionBins (QScoresBlock &block, BitBuffer &bitbuff, int blocksize, const vector<unsigned int> &bins) {
+  vector<vector<unsigned int> > reads (blocksize);
+  vector<unsigned int> lengths;  //  Length of each read, if they are not all the same
+
+  if ((GetHuffmanOrder1 ()) && (block.read_length == g_READ_LENGTH_VARIABLE)) {
+    for (int i = 0; i < blocksize; i++) {
+      lengths.push_back (Delta_Decode (bitbuff) - 1);
+    }
+  }
+
+  for (unsigned int b = 0; b < bins.size (); b++) {
+    unsigned int width = ((b + 1 < bins.size ()) ? bins[b + 1] : block.read_length) - bins[b];
+
+    if (GetHuffmanOrder1 ()) {
+      HuffmanContext hc_in;
+
+      hc_in.DecodeBegin (bitbuff);
+      for (int i = 0; i < blocksize; i++) {
+        hc_in.DecodeMessage (bitbuff, lengths.empty () ? width : lengths[i], reads[i]);
+      }
+      hc_in.DecodeFinish (bitbuff);
+
+      continue;
+    }
+
+    Huffman hm_in;
+    hm_in.SetStreams (GetHuffmanStreams ());
+
+    //  Start decoding
+    hm_in.DecodeBegin (bitbuff);
+    if (hm_in.GetMessageLength () != static_cast<unsigned long long> (width) * blocksize) {
+      cerr << "EE\tThe length of a Huffman read position bin does not match the block." << endl;
+      exit (EXIT_FAILURE);
+    }
+
+    //  Decode the part of each read in this bin
+    for (int i = 0; i < blocksize; i++) {
+      hm_in.DecodeMessage (bitbuff, width, reads[i]);
+    }
+
+    //  Finish decoding
+    hm_in.DecodeFinish (bitbuff);
+  }
+
+  for (int i = 0; i < blocksize; i++) {
+    QScoresSingle qscores_tmp (reads[i]);
+    block.qscores.push_back (qscores_tmp);
+  }
+
+  return;
+}
+
+
+/*!
+     Decode the current block of quality scores using arithmetic coding.  The length of each read is
+     either the block's read length or, if they are not all the same, was encoded before the message
+     (see EncodeArithmeticBlock ()).
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] blocksize Number of reads in this block
+*/
+void QScores::DecodeArithmeticBlock (QScoresBlock &block, BitBuffer &bitbuff, int blocksize) {
+  vector<unsigned int> lengths;  //  Length of each read
+  vector<unsigned int> tmp;  //  Temporary quality scores' read
+
+  for (int i = 0; i < blocksize; i++) {
+    if (block.read_length == g_READ_LENGTH_VARIABLE) {
+      lengths.push_back (Delta_Decode (bitbuff) - 1);
     }
     else {
-      buffer = hm_in.DecodeMessage (m_BitBuff_In, block_length);
-      block_length = 0;
+      lengths.push_back (block.read_length);
     }
-    
-    //  Process the decoded symbols; if the current length is equal to m_BlockReadLength, then we completed a read
-    for (unsigned int i = 0; i < buffer.size (); i++) {
-        tmp.push_back (buffer[i]);
-        curr_read_length++;
-        if (curr_read_length == m_BlockReadLength) {
-          QScoresSingle qscores_tmp (tmp);
-          m_Qscores.push_back (qscores_tmp);
-          tmp.clear ();
-          curr_read_length = 0;
-        }
+  }
+
+  Arithmetic ac_in;
+  ac_in.DecodeBegin (bitbuff);
+  for (int i = 0; i < blocksize; i++) {
+    tmp.clear ();
+    ac_in.DecodeMessage (bitbuff, lengths[i], tmp);
+    if (tmp.size () != lengths[i]) {
+      cerr << "EE\tAn arithmetic coded block has fewer quality scores than its reads." << endl;
+      exit (EXIT_FAILURE);
     }
+
+    QScoresSingle qscores_tmp (tmp);
+    block.qscores.push_back (qscores_tmp);
   }
+  ac_in.DecodeFinish (bitbuff);
 
-  //  Finish decoding
-  hm_in.DecodeFinish (m_BitBuff_In);
+  return;
+}
+
+
+/*!
+     Decode the current block of quality scores using adaptive arithmetic coding with contexts (see
+     EncodeArithmeticContextBlock ()).
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] blocksize Number of reads in this block
+*/
+void QScores::DecodeArithmeticContextBlock (QScoresBlock &block, BitBuffer &bitbuff, int blocksize) {
+  vector<unsigned int> lengths;  //  Length of each read
+  vector<unsigned int> tmp;  //  Temporary quality scores' read
+
+  for (int i = 0; i < blocksize; i++) {
+    if (block.read_length == g_READ_LENGTH_VARIABLE) {
+      lengths.push_back (Delta_Decode (bitbuff) - 1);
+    }
+    else {
+      lengths.push_back (block.read_length);
+    }
+  }
+
+  ArithmeticContext ac_in;
+  ac_in.DecodeBegin (bitbuff);
+  for (int i = 0; i < blocksize; i++) {
+    tmp.clear ();
+    ac_in.DecodeMessage (bitbuff, lengths[i], tmp);
+
+    QScoresSingle qscores_tmp (tmp);
+    block.qscores.push_back (qscores_tmp);
+  }
+  ac_in.DecodeFinish (bitbuff);
+
+  return;
+}
+
+
+/*!
+     Decode the current block of quality scores using rANS coding.  The length of each read is either
+     the block's read length or, if they are not all the same, was encoded before the message (see
+     EncodeRansBlock ()).  The number of states is read from the message's prelude.
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] blocksize Number of reads in this block
+*/
+void QScores::DecodeRansBlock (QScoresBlock &block, BitBuffer &bitbuff, int blocksize) {
+  vector<unsigned int> lengths;  //  Length of each read
+  vector<unsigned int> tmp;  //  Temporary quality scores' read
+
+  for (int i = 0; i < blocksize; i++) {
+    if (block.read_length == g_READ_LENGTH_VARIABLE) {
+      lengths.push_back (Delta_Decode (bitbuff) - 1);
+    }
+    else {
+      lengths.push_back (block.read_length);
+    }
+  }
+
+  Rans rc_in;
+  rc_in.DecodeBegin (bitbuff);
+  for (int i = 0; i < blocksize; i++) {
+    tmp.clear ();
+    rc_in.DecodeMessage (bitbuff, lengths[i], tmp);
+    if (tmp.size () != lengths[i]) {
+      cerr << "EE\tA rANS coded block has fewer quality scores than its reads." << endl;
+      exit (EXIT_FAILURE);
+    }
+
+    QScoresSingle qscores_tmp (tmp);
+    block.qscores.push_back (qscores_tmp);
+  }
+  rc_in.DecodeFinish (bitbuff);
+
+  return;
+}
+
+
+/*!
+     Decode the current block of quality scores using tANS coding or Huffman coding, as told by the
+     first bit after the lengths of the reads (see EncodeTansBlock ()).
+
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] blocksize Number of reads in this block
+*/
+void QScores::DecodeTansBlock (QScoresBlock &block, BitBuffer &bitbuff, int blocksize) {
+  vector<unsigned int> lengths;  //  Length of each read
+  vector<unsigned int> tmp;  //  Temporary quality scores' read
+
+  for (int i = 0; i < blocksize; i++) {
+    if (block.read_length == g_READ_LENGTH_VARIABLE) {
+      lengths.push_back (Delta_Decode (bitbuff) - 1);
+    }
+    else {
+      lengths.push_back (block.read_length);
+    }
+  }
+
+  bool use_tans = (bitbuff.ReadBits (1) == 1);
+  Tans tc_in;
+  Huffman hm_in;
+  if (use_tans) {
+    tc_in.DecodeBegin (bitbuff);
+  }
+  else {
+    hm_in.DecodeBegin (bitbuff);
+  }
+
+  for (int i = 0; i < blocksize; i++) {
+    tmp.clear ();
+    if (use_tans) {
+      tc_in.DecodeMessage (bitbuff, lengths[i], tmp);
+    }
+    else {
+      hm_in.DecodeMessage (bitbuff, lengths[i], tmp);
+    }
+    if (tmp.size () != lengths[i]) {
+      cerr << "EE\tA tANS or Huffman coded block has fewer quality scores than its reads." << endl;
+      exit (EXIT_FAILURE);
+    }
+
+    QScoresSingle qscores_tmp (tmp);
+    block.qscores.push_back (qscores_tmp);
+  }
+
+  if (use_tans) {
+    tc_in.DecodeFinish (bitbuff);
+  }
+  else {
+    hm_in.DecodeFinish (bitbuff);
+  }
 
   return;
 }
@@ -265,43 +649,65 @@ void QScores::DecodeHuffmanBlock (int blocksize) {
 /*!
      Decode the current block using an external compression system.
 
+     \param[in] block The block to decode into
+     \param[in] bitbuff The BitBuffer to decode from
+     \param[in] external The object managing the external compression system
      \param[in] blocksize Number of reads in this block
 */
-void QScores::DecodeExternalBlock (int blocksize) {
+void QScores::DecodeExternalBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int blocksize) {
   char *buffer = NULL;
   
   //  Read in the size of the binary representation from the BitBuffer
   unsigned int compressed_filesize = 0;
-  m_BitBuff_In.ReadUInts (&compressed_filesize, 1);
+  bitbuff.ReadUInts (&compressed_filesize, 1);
 
   //  Read in the bytes of the binary representation from the BitBuffer
   buffer = new char [compressed_filesize];
-  m_BitBuff_In.ReadChars (buffer, compressed_filesize);
+  bitbuff.ReadChars (buffer, compressed_filesize);
 
-  //  Decompress the buffer using an external program/library
-  m_ExternalSoftware.UnProcess (buffer, compressed_filesize, true);
+  //  Decompress the buffer using an external program/library; with Zstandard, every block uses the
+  //  dictionary in the first block's header
+  if (m_QScoresSettings.GetCompressionZstd ()) {
+    external.SetZstdDictionary (m_ZstdDictionary);
+  }
+  external.UnProcess (buffer, compressed_filesize, true);
   delete [] buffer;
   
-  unsigned int uncompressed_filesize = m_ExternalSoftware.GetOutBufferLength ();
-  buffer = m_ExternalSoftware.RetrieveChar ();
+  unsigned int uncompressed_filesize = external.GetOutBufferLength ();
+  buffer = external.RetrieveChar ();
   buffer[uncompressed_filesize] = '\0';
   
   //  Convert the buffer to a string
   string buffer_string (buffer);
-  for (unsigned int i = 0; i < buffer_string.length (); i += m_BlockReadLength) {
-    string tmp_str = buffer_string.substr (i, m_BlockReadLength);
+  for (unsigned int i = 0; i < buffer_string.length (); i += block.read_length) {
+    string tmp_str = buffer_string.substr (i, block.read_length);
     QScoresSingle tmp (tmp_str);
     tmp.StrToInt ();
-    m_Qscores.push_back (tmp);
+    block.qscores.push_back (tmp);
   }
   
   //  Free memory
   free (buffer);
 
   //  Reset for next block
-  m_ExternalSoftware.UnInitialize ();
+  external.UnInitialize ();
   
   return;
 }
 
 
+/*!
+     Read only the Huffman code of the current block, whose header has already been decoded, and not its
+     quality scores.  With --huffman-reuse, this keeps the code in block.huffman_code, so that a later
+     block of the same run can be decoded without decoding this one (see ExtractReads ()).
+
+     \param[in] block The block whose code is read
+     \param[in] bitbuff The BitBuffer to decode from
+*/
+void QScores::SkipHuffmanBlock (QScoresBlock &block, BitBuffer &bitbuff) {
+  Huffman hm_in;
+  hm_in.SetStreams (GetHuffmanStreams ());
+  DecodeHuffmanReuseBegin (block.huffman_code, block.block_count, GetHuffmanReuseRun (), bitbuff, hm_in);
+
+  return;
+}
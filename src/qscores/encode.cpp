@@ -32,20 +32,24 @@
 #include <fstream>
 #include <cstdlib>
 #include <iostream>
-#include <climits>  //  UINT_MAX
+#include <climits>  //  UINT_MAX, ULLONG_MAX
 #include <cmath>
+#include <algorithm>  //  min, max, fill
 
 #include "boost/filesystem.hpp"   // includes all needed Boost.Filesystem declarations
 
 using namespace std;
 namespace bfs = boost::filesystem;
 
+#include "common.hpp"
 #include "external-software-exception.hpp"
 #include "external-software.hpp"
 #include "block-statistics.hpp"
 #include "bitbuffer.hpp"
 #include "bitio-defn.hpp"
 #include "huffman.hpp"
+#include "arithmetic.hpp"
+#include "rans.hpp"
 #include "interpolative.hpp"
 #include "qscores-single-defn.hpp"
 #include "qscores-single.hpp"
@@ -55,6 +59,30 @@ namespace bfs = boost::filesystem;
 #include "qscores.hpp"
 
 
+/*!
+     Return the number of bits taken by the Huffman codewords of some symbols.
+
+     \param[in] counts The number of times that each symbol occurs
+     \param[in] lengths The length of each symbol's codeword; 0 if it has no codeword
+     \return The number of bits, or ULLONG_MAX if a symbol which occurs has no codeword
+*/
+static unsigned long long HuffmanCodeBits (const vector<unsigned long long> &counts, const vector<unsigned int> &lengths) {
+  unsigned long long bits = 0;
+
+  for (unsigned int sym = 0; sym < counts.size (); sym++) {
+    if (counts[sym] == 0) {
+      continue;
+    }
+    if ((sym >= lengths.size ()) || (lengths[sym] == 0)) {
+      return (ULLONG_MAX);
+    }
+    bits += counts[sym] * lengths[sym];
+  }
+
+  return bits;
+}
+
+
 /*!
      Encode a value to mark the end of the file.
 */
@@ -65,83 +93,152 @@ void QScores::EncodeEOF () {
 }
 
 
+/*!
+     Preprocess and then encode a block, including its header.  The block is encoded to bitbuff, which is
+     either m_BitBuff_Out or, when more than one thread is used, a thread's private buffer in memory.
+
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] external The object managing the external compression system
+     \param[in] current_blocksize The size of the current block
+     \param[in] block_count Block ID (from 0)
+*/
+void QScores::EncodeBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize, int block_count) {
+  PreprocessBlock (block, current_blocksize);
+
+  EncodeHeaderBlock (block, bitbuff, current_blocksize, block_count);
+  if ((m_QScoresSettings.GetCompressionBinary ()) ||
+      (m_QScoresSettings.GetCompressionGamma ()) ||
+      (m_QScoresSettings.GetCompressionDelta ()) ||
+      (m_QScoresSettings.GetCompressionGolomb () > 0) ||
+      (m_QScoresSettings.GetCompressionRice () > 0) ||
+      (m_QScoresSettings.GetCompressionInterP ())) {
+    EncodeStaticCodesBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionHuffman ()) {
+    EncodeHuffmanBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionArithmetic ()) {
+    EncodeArithmeticBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionArithmeticContext ()) {
+    EncodeArithmeticContextBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionRans ()) {
+    EncodeRansBlock (block, bitbuff, current_blocksize);
+  }
+  else if (m_QScoresSettings.GetCompressionTans ()) {
+    EncodeTansBlock (block, bitbuff, current_blocksize);
+  }
+  else if ((m_QScoresSettings.GetCompressionGzip ()) ||
+           (m_QScoresSettings.GetCompressionBzip ()) ||
+           (m_QScoresSettings.GetCompressionRepair ()) ||
+           (m_QScoresSettings.GetCompressionPPM ()) ||
+           (m_QScoresSettings.GetCompressionZstd ())) {
+    EncodeExternalBlock (block, bitbuff, external, current_blocksize);
+  }
+
+  return;
+}
+
+
 /*!
      Encode the header of the current block.  For Golomb, Rice, and Binary coding, also 
      determine the compression parameter for this block.
 
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
      \param[in] current_blocksize The size of the current block
-     \param[in] block_count Block ID (from 0); not encoded and just used for printing
-                information to the screen
+     \param[in] block_count Block ID (from 0); not encoded; recorded in the block (see --huffman-reuse)
+                and used for printing information to the screen
 */
-void QScores::EncodeHeaderBlock (int current_blocksize, int block_count) {
+void QScores::EncodeHeaderBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize, int block_count) {
   unsigned int lossless_remap_size = 0;
   vector<unsigned int> lossless_remap;
 
-  //  Parameters that are global to the entire file (continuation of the global header)
+  block.block_count = block_count;
+
+  //  Parameters that are global to the entire file (continuation of the global header); these are taken
+  //  from block 0 by Run () when it is read in
   if (block_count == 0) {
-    m_FileReadLength = m_BlockReadLength;
-    Delta_Encode (m_BitBuff_Out, m_FileReadLength + 1);
+    Delta_Encode (bitbuff, m_FileReadLength + 1);
     
-    m_FileBlockSize = current_blocksize;
-    Delta_Encode (m_BitBuff_Out, m_FileBlockSize + 1);
+    Delta_Encode (bitbuff, m_FileBlockSize + 1);
 
     //  Output the lossy transformation parameter
     if (m_QScoresSettings.GetLossyLogBinning ()) {
-      Delta_Encode (m_BitBuff_Out, static_cast<unsigned int> (m_QScoresSettings.GetLossyLogBinningParameter () + 1));
+      Delta_Encode (bitbuff, static_cast<unsigned int> (m_QScoresSettings.GetLossyLogBinningParameter () + 1));
     }
     else if (m_QScoresSettings.GetLossyUniBinning ()) {
-      Delta_Encode (m_BitBuff_Out, static_cast<unsigned int> (m_QScoresSettings.GetLossyUniBinningParameter () + 1));
+      Delta_Encode (bitbuff, static_cast<unsigned int> (m_QScoresSettings.GetLossyUniBinningParameter () + 1));
+    }
+
+    //  Output the Huffman coding options
+    if (m_QScoresSettings.GetCompressionHuffmanOptions ()) {
+      Delta_Encode (bitbuff, GetHuffmanStreams ());
+      Delta_Encode (bitbuff, GetHuffmanPositionBins ());
+      Delta_Encode (bitbuff, GetHuffmanOrder1 () ? 2 : 1);
+      Delta_Encode (bitbuff, GetHuffmanReuse () ? GetHuffmanReuseRun () + 1 : 1);
+    }
+
+    //  Output the dictionary of Zstandard; its size is 0 if there is none
+    if (m_QScoresSettings.GetCompressionZstd ()) {
+      unsigned int dictionary_size = static_cast<unsigned int> (m_ZstdDictionary.size ());
+      Delta_Encode (bitbuff, dictionary_size + 1);
+      if (dictionary_size != 0) {
+        bitbuff.WriteChars (m_ZstdDictionary.data (), static_cast<int> (dictionary_size));
+      }
     }
   }
   
   //  Encode the number of reads in this block; add 1 so that 1 = use the file level value; otherwise, the block size as it appears (minus 1)
   if (current_blocksize == m_FileBlockSize) {
-    Delta_Encode (m_BitBuff_Out, 1);
+    Delta_Encode (bitbuff, 1);
   }
   else {
-    Delta_Encode (m_BitBuff_Out, current_blocksize + 1);
+    Delta_Encode (bitbuff, current_blocksize + 1);
   }
   
   //  Length of the reads; add 2 so that 1 = use the file-level value; g_READ_LENGTH_VARIABLE (2) means not all the same
-  if (m_BlockReadLength == m_FileReadLength) {
-    Delta_Encode (m_BitBuff_Out, 1);
+  if (block.read_length == m_FileReadLength) {
+    Delta_Encode (bitbuff, 1);
   }
-  else if (m_BlockReadLength == g_READ_LENGTH_VARIABLE) {
-    Delta_Encode (m_BitBuff_Out, 2);
+  else if (block.read_length == g_READ_LENGTH_VARIABLE) {
+    Delta_Encode (bitbuff, 2);
   }
   else {
-    Delta_Encode (m_BitBuff_Out, m_BlockReadLength + 2);
+    Delta_Encode (bitbuff, block.read_length + 2);
   }
 
   if (m_QScoresSettings.GetTransformMinShift ()) {
     //  Offset from the smallest value; add 1 in case it is 0
-    Delta_Encode (m_BitBuff_Out, m_BlockMinimum + 1);
+    Delta_Encode (bitbuff, block.minimum + 1);
   }
 
   //  Sub-alphabet remapping
   if (m_QScoresSettings.GetTransformFreqOrder ()) {
-    lossless_remap_size = m_BlockStatistics.GetIDsToQScoresSize ();
-    lossless_remap = m_BlockStatistics.GetIDsToQScores ();
+    lossless_remap_size = block.statistics.GetIDsToQScoresSize ();
+    lossless_remap = block.statistics.GetIDsToQScores ();
     lossless_remap.resize (lossless_remap_size);
     
-    Delta_Encode (m_BitBuff_Out, lossless_remap_size);
-    Interpolative_Encode (m_BitBuff_Out, lossless_remap);
+    Delta_Encode (bitbuff, lossless_remap_size);
+    Interpolative_Encode (bitbuff, lossless_remap);
   }
 
   //  Binary coding parameter
   if (m_QScoresSettings.GetCompressionBinary ()) {
     unsigned int current_max = 0;
     for (int i = 0; i < current_blocksize; i++) {
-      m_Qscores[i].SetMinMax ();
-      if (m_Qscores[i].GetMax () > current_max) {
-        current_max = m_Qscores[i].GetMax ();
+      block.qscores[i].SetMinMax ();
+      if (block.qscores[i].GetMax () > current_max) {
+        current_max = block.qscores[i].GetMax ();
       }
     }
     
-    m_CompressionParameter = current_max;
+    block.compression_parameter = current_max;
     
     //  Encode the parameter
-    Delta_Encode (m_BitBuff_Out, m_CompressionParameter);
+    Delta_Encode (bitbuff, block.compression_parameter);
   }
 
   //  Golomb or Rice coding parameter
@@ -149,45 +246,45 @@ void QScores::EncodeHeaderBlock (int current_blocksize, int block_count) {
       (m_QScoresSettings.GetCompressionRice ())) {
     //  Check if we are using a global parameter or a local one
     if (m_QScoresSettings.GetCompressionGlobalParameter () != g_DEFAULT_GOLOMB_RICE_PARAM) {
-      m_CompressionParameter = m_QScoresSettings.GetCompressionGlobalParameter ();
+      block.compression_parameter = m_QScoresSettings.GetCompressionGlobalParameter ();
     }
     else {
       //  Tabulate the average across all reads
       unsigned int sum = 0;
       unsigned int count = 0;
       for (int i = 0; i < current_blocksize; i++) {
-        sum += m_Qscores[i].GetIntSum ();
-        count += m_Qscores[i].GetIntLength ();
+        sum += block.qscores[i].GetIntSum ();
+        count += block.qscores[i].GetIntLength ();
       }
 
       double average = (static_cast<double> (sum)) / (static_cast<double> (count));
-      m_CompressionParameter = static_cast<unsigned int> (ceil (g_GOLOMB_RICE_CONSTANT * (average)));
+      block.compression_parameter = static_cast<unsigned int> (ceil (g_GOLOMB_RICE_CONSTANT * (average)));
       
       //  Rice coding -- need to find the largest power of 2
       if (m_QScoresSettings.GetCompressionRice ()) {
         unsigned int tmp = 1;
         unsigned int shift = 0;
-        while ((tmp << shift) < m_CompressionParameter) {
+        while ((tmp << shift) < block.compression_parameter) {
           shift++;
         }
-        m_CompressionParameter = (shift - 1);
+        block.compression_parameter = (shift - 1);
       }
       
-      if ((m_CompressionParameter == UINT_MAX) || (m_CompressionParameter == 0)) {
-        m_CompressionParameter = 1;
+      if ((block.compression_parameter == UINT_MAX) || (block.compression_parameter == 0)) {
+        block.compression_parameter = 1;
       }
     }
     
     //  Encode the parameter
-    Delta_Encode (m_BitBuff_Out, m_CompressionParameter);
+    Delta_Encode (bitbuff, block.compression_parameter);
   }
   
   if (GetDebug ()) {
     if (block_count % g_BLOCK_STATUS_FREQUENCY == 0) {
       cerr << "II\tEncoding block " << block_count << "\t";
       cerr << current_blocksize << "\t";
-      cerr << m_BlockMinimum << "\t";
-      cerr << m_BlockReadLength << "\t";
+      cerr << block.minimum << "\t";
+      cerr << block.read_length << "\t";
       if (m_QScoresSettings.GetLossyLogBinning ()) {
         cerr << "[LB " << m_QScoresSettings.GetLossyLogBinningParameter () << "]\t";
       }
@@ -195,16 +292,16 @@ void QScores::EncodeHeaderBlock (int current_blocksize, int block_count) {
         cerr << "[UB " << m_QScoresSettings.GetLossyUniBinningParameter () << "]\t";
       }
       if (m_QScoresSettings.GetCompressionBinary ()) {
-        cerr << "[B " << m_CompressionParameter << "]\t";
+        cerr << "[B " << block.compression_parameter << "]\t";
       }
       else if (m_QScoresSettings.GetCompressionGolomb ()) {
-        cerr << "[G " << m_CompressionParameter << "]\t";
+        cerr << "[G " << block.compression_parameter << "]\t";
       }
       else if (m_QScoresSettings.GetCompressionRice ()) {
-        cerr << "[R " << m_CompressionParameter << "]\t";
+        cerr << "[R " << block.compression_parameter << "]\t";
       }
       if (m_QScoresSettings.GetTransformMinShift ()) {
-        cerr << "[RS " << m_BlockMinimum << "]\t";
+        cerr << "[RS " << block.minimum << "]\t";
       }
       if (m_QScoresSettings.GetTransformFreqOrder ()) {
         cerr << "[LS " << lossless_remap_size << "]\t";
@@ -220,27 +317,29 @@ void QScores::EncodeHeaderBlock (int current_blocksize, int block_count) {
 /*!
      Encode the current block using static codes.
 
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
      \param[in] current_blocksize The size of the current block
 */
-void QScores::EncodeStaticCodesBlock (int current_blocksize) {
+void QScores::EncodeStaticCodesBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize) {
   for (int i = 0; i < current_blocksize; i++) {
     if (m_QScoresSettings.GetCompressionBinary ()) {
-      m_Qscores[i].ApplyCompressionBinary (m_BitBuff_Out, m_CompressionParameter, m_BlockReadLength);
+      block.qscores[i].ApplyCompressionBinary (bitbuff, block.compression_parameter, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionGamma ()) {
-      m_Qscores[i].ApplyCompressionGamma (m_BitBuff_Out, m_BlockReadLength);
+      block.qscores[i].ApplyCompressionGamma (bitbuff, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionDelta ()) {
-      m_Qscores[i].ApplyCompressionDelta (m_BitBuff_Out, m_BlockReadLength);
+      block.qscores[i].ApplyCompressionDelta (bitbuff, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionGolomb () > 0) {
-      m_Qscores[i].ApplyCompressionGolomb (m_BitBuff_Out, m_CompressionParameter, m_BlockReadLength);
+      block.qscores[i].ApplyCompressionGolomb (bitbuff, block.compression_parameter, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionRice () > 0) {
-      m_Qscores[i].ApplyCompressionRice (m_BitBuff_Out, m_CompressionParameter, m_BlockReadLength);
+      block.qscores[i].ApplyCompressionRice (bitbuff, block.compression_parameter, block.read_length);
     }
     else if (m_QScoresSettings.GetCompressionInterP ()) {
-      m_Qscores[i].ApplyCompressionInterP (m_BitBuff_Out, m_BlockReadLength);
+      block.qscores[i].ApplyCompressionInterP (bitbuff, block.read_length);
     }
   }
   
@@ -249,28 +348,444 @@ void QScores::EncodeStaticCodesBlock (int current_blocksize) {
 
 
 /*!
-     Encode the current block using Huffman coding.
+     Encode the current block using Huffman coding.  If --huffman-position-bins was given, the read
+     positions are split into bins by ChooseHuffmanPositionBins () and the quality scores of each bin
+     are coded with their own Huffman code, one bin after the other.  The number of bins and the width
+     of each (except the last) come first.  With --huffman-order1, each bin is coded with a
+     HuffmanContext instead, so that each quality score is coded with a table chosen by the one before.
+     Since the decoder then splits the block into reads using their length, the length of each read
+     comes next if they are not all the same (such a block has just one bin).
+
+     With --huffman-reuse (and only one bin), the block can instead reuse the last Huffman code sent by
+     an earlier block of its run of GetHuffmanReuseRun () blocks, which is kept in block.huffman_code.
+     A bit tells whether it does; if so, it is followed by the length of the message instead of a
+     prelude.  The first block of each run always sends its own code, so the output does not depend
+     on how the blocks were shared among threads.
+
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] current_blocksize The size of the current block
+*/
+void QScores::EncodeHuffmanBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize) {
+  vector<unsigned int> bins (1, 0);  //  First read position of each bin
+
+  if (GetHuffmanPositionBins () > 1) {
+    bins = ChooseHuffmanPositionBins (block, current_blocksize);
+    Delta_Encode (bitbuff, static_cast<unsigned int> (bins.size ()));
+    for (unsigned int b = 1; b < bins.size (); b++) {
+      Delta_Encode (bitbuff, bins[b] - bins[b - 1]);
+    }
+  }
 
+  //  Add 1 to each length since it is encoded with a Delta code
+  if ((GetHuffmanOrder1 ()) && (block.read_length == g_READ_LENGTH_VARIABLE)) {
+    for (int i = 0; i < current_blocksize; i++) {
+      Delta_Encode (bitbuff, static_cast<unsigned int> (block.qscores[i].GetQScoreInt ().size ()) + 1);
+    }
+  }
+
+  for (unsigned int b = 0; b < bins.size (); b++) {
+    //  The last bin goes up to the end of each read
+    unsigned int start = bins[b];
+    unsigned int end = (b + 1 < bins.size ()) ? bins[b + 1] : UINT_MAX;
+
+    if (GetHuffmanOrder1 ()) {
+      HuffmanContext hc_out;
+      hc_out.SetCodewordLimit (GetHuffmanMaxLen ());
+
+      for (int i = 0; i < current_blocksize; i++) {
+        const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+        hc_out.UpdateFrequencies (x.data () + start, min (end, static_cast<unsigned int> (x.size ())) - start);
+      }
+
+      hc_out.EncodeBegin (bitbuff);
+      for (int i = 0; i < current_blocksize; i++) {
+        const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+        hc_out.EncodeMessage (bitbuff, x.data () + start, min (end, static_cast<unsigned int> (x.size ())) - start);
+      }
+      hc_out.EncodeFinish (bitbuff);
+
+      continue;
+    }
+
+    Huffman hm_out;
+    hm_out.SetCodewordLimit (GetHuffmanMaxLen ());
+    hm_out.SetStreams (GetHuffmanStreams ());
+
+    //  Update frequencies with the quality scores of this bin
+    for (int i = 0; i < current_blocksize; i++) {
+      const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+      unsigned int x_end = min (end, static_cast<unsigned int> (x.size ()));
+      hm_out.UpdateFrequencies (x.data () + start, x_end - start);
+    }
+
+    //  Start encoding; with --huffman-reuse, a bit first tells whether the code of an earlier block of the run is used
+    Huffman hm_reused;
+    bool reuse = false;
+    if (GetHuffmanReuse ()) {
+      QScoresHuffmanCode &code = block.huffman_code;
+      if (block.block_count % static_cast<int> (GetHuffmanReuseRun ()) == 0) {
+        code = QScoresHuffmanCode ();
+      }
+
+      vector<unsigned long long> counts;
+      for (int i = 0; i < current_blocksize; i++) {
+        const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+        for (unsigned int p = 0; p < x.size (); p++) {
+          if (x[p] >= counts.size ()) {
+            counts.resize (x[p] + 1, 0);
+          }
+          counts[x[p]]++;
+        }
+      }
+
+      //  The block's own code and its prelude, which is written to memory in order to know its size.  The
+      //  symbols of the earlier code also have a codeword, so that later blocks are more likely to reuse it
+      for (unsigned int sym = 1; sym < code.lengths.size (); sym++) {
+        if (code.lengths[sym] != 0) {
+          hm_out.AddSymbol (sym);
+        }
+      }
+      BitBuffer prelude;
+      prelude.InitializeMemory ();
+      hm_out.EncodeBegin (prelude);
+      prelude.Finish ();
+      unsigned long long own_bits = prelude.GetMemoryBits () + HuffmanCodeBits (counts, hm_out.GetCodewordLengths ());
+
+      //  The earlier code is reused if the block is at most GetHuffmanReuseTolerance () percent larger with it
+      if (code.block_count != -1) {
+        unsigned long long reused_bits = HuffmanCodeBits (counts, code.lengths);
+        reuse = ((reused_bits != ULLONG_MAX) && (reused_bits * 100 <= own_bits * (100 + GetHuffmanReuseTolerance ())));
+      }
+
+      bitbuff.WriteBits (reuse ? 1 : 0, 1);
+      if (reuse) {
+        hm_reused.SetStreams (GetHuffmanStreams ());
+        for (unsigned int sym = 0; sym < counts.size (); sym++) {
+          hm_reused.UpdateFrequency (sym, static_cast<unsigned int> (counts[sym]));
+        }
+        hm_reused.EncodeBegin (bitbuff, code.lengths);
+      }
+      else {
+        code.block_count = block.block_count;
+        code.lengths = hm_out.GetCodewordLengths ();
+        bitbuff.AppendBits (prelude.GetMemory (), prelude.GetMemoryBits ());
+      }
+    }
+    else {
+      hm_out.EncodeBegin (bitbuff);
+    }
+    Huffman &hm = reuse ? hm_reused : hm_out;
+
+    //  Encode the part of each vector of quality scores in this bin
+    for (int i = 0; i < current_blocksize; i++) {
+      const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+      unsigned int x_end = min (end, static_cast<unsigned int> (x.size ()));
+      hm.EncodeMessage (bitbuff, x.data () + start, x_end - start);
+    }
+
+    //  Finish encoding
+    hm.EncodeFinish (bitbuff);
+  }
+
+  return;
+}
+
+
+/*!
+     Choose the read position bins for Huffman coding the current block, up to GetHuffmanPositionBins () of
+     them.  A histogram of the quality scores at each position is made, with the positions grouped into at
+     most g_HUFFMAN_POSITION_SEGMENTS segments.  Then the bins are chosen by dynamic programming so that
+     the total entropy of the quality scores, with each bin having its own distribution, is the least.
+     Since each bin also needs a prelude, fewer bins are used if the estimated size of the preludes
+     (see g_HUFFMAN_BIN_SYMBOL_BITS) outweighs what they save.  Only a block whose reads all have the
+     same length is split; otherwise, there is just one bin.
+
+     \param[in] block The block to encode
      \param[in] current_blocksize The size of the current block
+     \return The first read position of each bin, starting with 0
 */
-void QScores::EncodeHuffmanBlock (int current_blocksize) {
-  Huffman hm_out;
+vector<unsigned int> QScores::ChooseHuffmanPositionBins (const QScoresBlock &block, int current_blocksize) const {
+  vector<unsigned int> bins (1, 0);
+
+  if ((block.read_length == g_READ_LENGTH_VARIABLE) || (block.read_length < 2)) {
+    return bins;
+  }
+
+  unsigned int segments = min (block.read_length, g_HUFFMAN_POSITION_SEGMENTS);
+  unsigned int num_bins = min (GetHuffmanPositionBins (), segments);
+
+  //  The first read position of each segment; all segments have at least one position
+  vector<unsigned int> segment_start (segments + 1, 0);
+  for (unsigned int g = 0; g <= segments; g++) {
+    segment_start[g] = static_cast<unsigned int> (((static_cast<unsigned long long> (g) * block.read_length) + segments - 1) / segments);
+  }
 
-  //  Update frequencies with the quality scores in this block
+  //  The histogram of quality scores in each segment
+  unsigned int symbols = 0;
   for (int i = 0; i < current_blocksize; i++) {
-    hm_out.UpdateFrequencies (m_Qscores[i].GetQScoreInt ());
+    const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+    for (unsigned int p = 0; p < x.size (); p++) {
+      symbols = max (symbols, x[p] + 1);
+    }
+  }
+  vector<unsigned int> histogram (static_cast<size_t> (segments) * symbols, 0);
+  for (int i = 0; i < current_blocksize; i++) {
+    const vector<unsigned int> &x = block.qscores[i].GetQScoreInt ();
+    for (unsigned int g = 0; g < segments; g++) {
+      unsigned int *row = &histogram[static_cast<size_t> (g) * symbols];
+      for (unsigned int p = segment_start[g]; p < segment_start[g + 1]; p++) {
+        row[x[p]]++;
+      }
+    }
+  }
+
+  //  The cost in bits of coding segments a to b - 1 with one distribution; cost[a * (segments + 1) + b]
+  vector<double> cost (static_cast<size_t> (segments + 1) * (segments + 1), 0.0);
+  vector<unsigned long long> counts (symbols, 0);
+  for (unsigned int a = 0; a < segments; a++) {
+    fill (counts.begin (), counts.end (), 0);
+    for (unsigned int b = a + 1; b <= segments; b++) {
+      const unsigned int *row = &histogram[static_cast<size_t> (b - 1) * symbols];
+      unsigned long long total = 0;
+      double sum = 0.0;
+      for (unsigned int s = 0; s < symbols; s++) {
+        counts[s] += row[s];
+        if (counts[s] != 0) {
+          total += counts[s];
+          sum += counts[s] * log2 (static_cast<double> (counts[s]));
+        }
+      }
+      if (total != 0) {
+        cost[(static_cast<size_t> (a) * (segments + 1)) + b] = (total * log2 (static_cast<double> (total))) - sum;
+      }
+    }
+  }
+
+  //  best[k * (segments + 1) + b] is the least cost of the first b segments in k + 1 bins; the last bin starts at segment from[...]
+  vector<double> best (static_cast<size_t> (num_bins) * (segments + 1), 0.0);
+  vector<unsigned int> from (static_cast<size_t> (num_bins) * (segments + 1), 0);
+  for (unsigned int b = 1; b <= segments; b++) {
+    best[b] = cost[b];
+  }
+  for (unsigned int k = 1; k < num_bins; k++) {
+    for (unsigned int b = k + 1; b <= segments; b++) {
+      size_t pos = (static_cast<size_t> (k) * (segments + 1)) + b;
+      best[pos] = -1.0;
+      for (unsigned int a = k; a < b; a++) {
+        double value = best[(static_cast<size_t> (k - 1) * (segments + 1)) + a] + cost[(static_cast<size_t> (a) * (segments + 1)) + b];
+        if ((best[pos] < 0.0) || (value < best[pos])) {
+          best[pos] = value;
+          from[pos] = a;
+        }
+      }
+    }
+  }
+
+  //  The number of bins, including the cost of their preludes
+  unsigned int distinct = 0;
+  for (unsigned int s = 0; s < symbols; s++) {
+    if (counts[s] != 0) {
+      distinct++;
+    }
+  }
+  double overhead = (static_cast<double> (distinct) * g_HUFFMAN_BIN_SYMBOL_BITS) + g_HUFFMAN_BIN_FIXED_BITS;
+  unsigned int used_bins = 1;
+  for (unsigned int k = 1; k < num_bins; k++) {
+    size_t pos = (static_cast<size_t> (k) * (segments + 1)) + segments;
+    if (best[pos] + (k * overhead) < best[(static_cast<size_t> (used_bins - 1) * (segments + 1)) + segments] + ((used_bins - 1) * overhead)) {
+      used_bins = k + 1;
+    }
+  }
+
+  //  Trace the bins back from the last one
+  bins.assign (used_bins, 0);
+  unsigned int b = segments;
+  for (unsigned int k = used_bins - 1; k > 0; k--) {
+    b = from[(static_cast<size_t> (k) * (segments + 1)) + b];
+    bins[k] = segment_start[b];
+  }
+
+  return bins;
+}
+
+
+/*!
+     Encode the current block using arithmetic coding.  All of the quality scores in the block are coded
+     as one message with the frequencies of the block (see Arithmetic).  If the reads in the block do not
+     all have the same length, the length of each read comes first.
+
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] current_blocksize The size of the current block
+*/
+void QScores::EncodeArithmeticBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize) {
+  Arithmetic ac_out;
+
+  //  Add 1 to each length since it is encoded with a Delta code
+  if (block.read_length == g_READ_LENGTH_VARIABLE) {
+    for (int i = 0; i < current_blocksize; i++) {
+      Delta_Encode (bitbuff, static_cast<unsigned int> (block.qscores[i].GetQScoreInt ().size ()) + 1);
+    }
   }
-  
-  //  Start encoding
-  hm_out.EncodeBegin (m_BitBuff_Out);
 
-  //  Encode each vector of quality score
   for (int i = 0; i < current_blocksize; i++) {
-    hm_out.EncodeMessage (m_BitBuff_Out, m_Qscores[i].GetQScoreInt ());
+    ac_out.UpdateFrequencies (block.qscores[i].GetQScoreInt ());
+  }
+
+  ac_out.EncodeBegin (bitbuff);
+  for (int i = 0; i < current_blocksize; i++) {
+    ac_out.EncodeMessage (bitbuff, block.qscores[i].GetQScoreInt ());
+  }
+  ac_out.EncodeFinish (bitbuff);
+
+  return;
+}
+
+
+/*!
+     Encode the current block using adaptive arithmetic coding with contexts (see ArithmeticContext).
+     Only the largest quality score is found before coding; each read is then coded as it is reached,
+     with the model learned from the reads before it.  If the reads in the block do not all have the
+     same length, the length of each read comes first.
+
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] current_blocksize The size of the current block
+*/
+void QScores::EncodeArithmeticContextBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize) {
+  ArithmeticContext ac_out;
+  unsigned int maximum_symbol = 1;
+
+  //  Add 1 to each length since it is encoded with a Delta code
+  if (block.read_length == g_READ_LENGTH_VARIABLE) {
+    for (int i = 0; i < current_blocksize; i++) {
+      Delta_Encode (bitbuff, static_cast<unsigned int> (block.qscores[i].GetQScoreInt ().size ()) + 1);
+    }
+  }
+
+  for (int i = 0; i < current_blocksize; i++) {
+    const vector<unsigned int> &read = block.qscores[i].GetQScoreInt ();
+    for (unsigned int j = 0; j < read.size (); j++) {
+      maximum_symbol = max (maximum_symbol, read[j]);
+    }
+  }
+
+  ac_out.EncodeBegin (bitbuff, maximum_symbol);
+  for (int i = 0; i < current_blocksize; i++) {
+    const vector<unsigned int> &read = block.qscores[i].GetQScoreInt ();
+    ac_out.EncodeMessage (bitbuff, read.data (), static_cast<unsigned int> (read.size ()));
+  }
+  ac_out.EncodeFinish (bitbuff);
+
+  return;
+}
+
+
+/*!
+     Encode the current block using rANS coding with GetRansStates () interleaved states.  The frequencies
+     are those of the histogram of the block's quality scores, counted by a BlockStatistics object, and
+     the quality scores are coded as one message (see Rans).  If the reads in the block do not all have
+     the same length, the length of each read comes first.
+
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] current_blocksize The size of the current block
+*/
+void QScores::EncodeRansBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize) {
+  BlockStatistics histogram;
+  Rans rc_out;
+
+  //  Add 1 to each length since it is encoded with a Delta code
+  if (block.read_length == g_READ_LENGTH_VARIABLE) {
+    for (int i = 0; i < current_blocksize; i++) {
+      Delta_Encode (bitbuff, static_cast<unsigned int> (block.qscores[i].GetQScoreInt ().size ()) + 1);
+    }
+  }
+
+  histogram.Initialize ();
+  for (int i = 0; i < current_blocksize; i++) {
+    histogram.UpdateFrequencyTable (block.qscores[i].GetQScoreInt ());
+  }
+  for (unsigned int i = 1; i < g_MAX_ASCII; i++) {
+    rc_out.AddFrequency (i, histogram.GetFrequencyTableFreq (i));
+  }
+
+  rc_out.SetStates (GetRansStates ());
+  rc_out.EncodeBegin (bitbuff);
+  for (int i = 0; i < current_blocksize; i++) {
+    rc_out.EncodeMessage (bitbuff, block.qscores[i].GetQScoreInt ());
+  }
+  rc_out.EncodeFinish (bitbuff);
+
+  return;
+}
+
+
+/*!
+     Encode the current block using tANS coding or Huffman coding, whichever should be smaller.  Both
+     are given the histogram of the block's quality scores, counted by a BlockStatistics object, and
+     their preludes are written to memory.  The size of each is its prelude plus the size of the message
+     computed from the histogram:  the codeword lengths for Huffman coding and GetEstimatedBits () for
+     tANS coding.  A bit tells which is used (1 for tANS coding); its prelude then follows and the
+     quality scores are coded as one message.  If the reads in the block do not all have the same
+     length, the length of each read comes first.
+
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] current_blocksize The size of the current block
+*/
+void QScores::EncodeTansBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize) {
+  BlockStatistics histogram;
+  vector<unsigned long long> counts (g_MAX_ASCII, 0);
+  Huffman hm_out;
+  Tans tc_out;
+
+  //  Add 1 to each length since it is encoded with a Delta code
+  if (block.read_length == g_READ_LENGTH_VARIABLE) {
+    for (int i = 0; i < current_blocksize; i++) {
+      Delta_Encode (bitbuff, static_cast<unsigned int> (block.qscores[i].GetQScoreInt ().size ()) + 1);
+    }
+  }
+
+  histogram.Initialize ();
+  for (int i = 0; i < current_blocksize; i++) {
+    histogram.UpdateFrequencyTable (block.qscores[i].GetQScoreInt ());
+  }
+  for (unsigned int i = 1; i < g_MAX_ASCII; i++) {
+    counts[i] = histogram.GetFrequencyTableFreq (i);
+    hm_out.UpdateFrequency (i, static_cast<unsigned int> (counts[i]));
+    tc_out.AddFrequency (i, static_cast<unsigned int> (counts[i]));
+  }
+
+  BitBuffer hm_prelude;
+  hm_prelude.InitializeMemory ();
+  hm_out.EncodeBegin (hm_prelude);
+  hm_prelude.Finish ();
+  unsigned long long hm_bits = hm_prelude.GetMemoryBits () + HuffmanCodeBits (counts, hm_out.GetCodewordLengths ());
+
+  BitBuffer tc_prelude;
+  tc_prelude.InitializeMemory ();
+  tc_out.EncodeBegin (tc_prelude);
+  tc_prelude.Finish ();
+  unsigned long long tc_bits = tc_prelude.GetMemoryBits () + tc_out.GetEstimatedBits ();
+
+  bool use_tans = (tc_bits < hm_bits);
+  bitbuff.WriteBits (use_tans ? 1 : 0, 1);
+  if (use_tans) {
+    bitbuff.AppendBits (tc_prelude.GetMemory (), tc_prelude.GetMemoryBits ());
+    for (int i = 0; i < current_blocksize; i++) {
+      tc_out.EncodeMessage (bitbuff, block.qscores[i].GetQScoreInt ());
+    }
+    tc_out.EncodeFinish (bitbuff);
+  }
+  else {
+    bitbuff.AppendBits (hm_prelude.GetMemory (), hm_prelude.GetMemoryBits ());
+    for (int i = 0; i < current_blocksize; i++) {
+      hm_out.EncodeMessage (bitbuff, block.qscores[i].GetQScoreInt ());
+    }
+    hm_out.EncodeFinish (bitbuff);
   }
-  
-  //  Finish encoding
-  hm_out.EncodeFinish (m_BitBuff_Out);
 
   return;
 }
@@ -279,9 +794,12 @@ void QScores::EncodeHuffmanBlock (int current_blocksize) {
 /*!
      Encode the current block using an external compression system.
 
+     \param[in] block The block to encode
+     \param[in] bitbuff The BitBuffer to encode to
+     \param[in] external The object managing the external compression system
      \param[in] current_blocksize The size of the current block
 */
-void QScores::EncodeExternalBlock (int current_blocksize) {
+void QScores::EncodeExternalBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize) {
   bool last = false;
 
   //  Add a read at a time
@@ -289,31 +807,37 @@ void QScores::EncodeExternalBlock (int current_blocksize) {
   //  This is the longest that a read can be; if it is too short, the program will exit
   unsigned int max_buffer_size = 65536;  
   char* mini_buffer = (char*) calloc (max_buffer_size, sizeof (char));
+
+  //  Every block is compressed with the dictionary in the first block's header
+  if (m_QScoresSettings.GetCompressionZstd ()) {
+    external.SetZstdDictionary (m_ZstdDictionary);
+  }
+
   for (int i = 0; i < current_blocksize; i++) {
     if (i == (current_blocksize - 1)) {
-      //  Last iteration, so notify m_ExternalSoftware
+      //  Last iteration, so notify external
       last = true;
     }
 
-    mini_buffer_size = m_Qscores[i].GetQScoreIntAsBinary (mini_buffer, max_buffer_size);
-    m_ExternalSoftware.Process (mini_buffer, mini_buffer_size, last);
+    mini_buffer_size = block.qscores[i].GetQScoreIntAsBinary (mini_buffer, max_buffer_size);
+    external.Process (mini_buffer, mini_buffer_size, last);
   }
   free (mini_buffer);
 
-  unsigned int buffer_size = m_ExternalSoftware.GetOutBufferLength ();
-  char *buffer = m_ExternalSoftware.RetrieveChar ();
+  unsigned int buffer_size = external.GetOutBufferLength ();
+  char *buffer = external.RetrieveChar ();
   
   //  Append size to bitbuffer
-  m_BitBuff_Out.WriteUInts (&buffer_size, 1);
+  bitbuff.WriteUInts (&buffer_size, 1);
     
   //  Append binary representation to bitbuffer
-  m_BitBuff_Out.WriteChars (buffer, buffer_size);
+  bitbuff.WriteChars (buffer, buffer_size);
 
   //  Free memory
   free (buffer);
   
   //  Reset for next block
-  m_ExternalSoftware.UnInitialize ();
+  external.UnInitialize ();
   
   return;
 }
@@ -322,12 +846,13 @@ void QScores::EncodeExternalBlock (int current_blocksize) {
 /*!
      Convert the integers to quality scores for printing (required for the --nocompress option).
 
+     \param[in] block The block to convert
      \param[in] current_blocksize The size of the current block
 */
-void QScores::EncodeIntToQScore (int current_blocksize) {
+void QScores::EncodeIntToQScore (QScoresBlock &block, int current_blocksize) {
   for (int i = 0; i < current_blocksize; i++) {
-//     m_Qscores[i].UnapplyFinalize ();
-    m_Qscores[i].IntToQScore ();
+//     block.qscores[i].UnapplyFinalize ();
+    block.qscores[i].IntToQScore ();
   }
   
   return;
@@ -33,6 +33,8 @@
 #include <iomanip>  //  setw
 #include <iostream>
 #include <climits>  //  UINT_MAX
+#include <iterator>  //  istreambuf_iterator
+#include <cstdlib>  //  exit
 
 using namespace std;
 
@@ -66,3 +68,54 @@ void QScores::PerformExternalSoftwareCheck () {
   return;
 }
 
+
+/*!
+     Set the dictionary of Zstandard before any block is encoded.  It is read from the file given by
+     --zstd-dict or, with --zstd-train, trained with each read of the first block as a sample;
+     otherwise, there is no dictionary.  It is kept in the first block's header (see
+     EncodeHeaderBlock ()), so decoding does not need the file.
+
+     \param[in] block The first block, before it is preprocessed
+     \param[in] current_blocksize The size of the first block
+*/
+void QScores::InitializeZstdDictionary (const QScoresBlock &block, int current_blocksize) {
+  m_ZstdDictionary.clear ();
+
+  if (GetZstdDictionaryFn () != "") {
+    ifstream fp (GetZstdDictionaryFn ().c_str (), ios::in | ios::binary);
+    if (!fp.is_open ()) {
+      cerr << "EE\tCannot open " << GetZstdDictionaryFn () << " for reading." << endl;
+      exit (EXIT_FAILURE);
+    }
+    m_ZstdDictionary.assign (istreambuf_iterator<char> (fp), istreambuf_iterator<char> ());
+    if ((m_ZstdDictionary.empty ()) || (m_ZstdDictionary.size () > g_ZSTD_MAX_DICTIONARY_SIZE)) {
+      cerr << "EE\tThe dictionary in " << GetZstdDictionaryFn () << " must have from 1 to " << g_ZSTD_MAX_DICTIONARY_SIZE << " bytes." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+  else if (GetZstdTrainSize () != 0) {
+    //  The samples must be the bytes that Zstandard compresses, so a copy of the block is preprocessed
+    QScoresBlock sample_block = block;
+    PreprocessBlock (sample_block, current_blocksize);
+
+    //  This is the longest that a read can be (see EncodeExternalBlock ())
+    unsigned int max_buffer_size = 65536;
+    vector<char> buffer (max_buffer_size);
+    vector<char> samples;
+    vector<size_t> sample_sizes;
+    for (int i = 0; i < current_blocksize; i++) {
+      unsigned int len = sample_block.qscores[i].GetQScoreIntAsBinary (buffer.data (), max_buffer_size);
+      samples.insert (samples.end (), buffer.begin (), buffer.begin () + len);
+      sample_sizes.push_back (len);
+    }
+
+    if (!m_ExternalSoftware.TrainZstdDictionary (samples, sample_sizes, GetZstdTrainSize (), m_ZstdDictionary)) {
+      cerr << "WW\tA dictionary for Zstandard could not be trained from the first block, so none is used." << endl;
+    }
+    else if (GetVerbose ()) {
+      cerr << "II\tA dictionary of " << m_ZstdDictionary.size () << " bytes for Zstandard was trained from the first block." << endl;
+    }
+  }
+
+  return;
+}
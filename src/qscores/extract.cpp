@@ -0,0 +1,134 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file extract.cpp
+    Random access to a range of reads using the block index.
+*/
+/*******************************************************************/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>  //  min, max
+#include <climits>  //  UINT_MAX
+#include <cstdlib>
+
+using namespace std;
+
+#include "common.hpp"
+#include "external-software.hpp"
+#include "block-statistics.hpp"
+#include "bitbuffer.hpp"
+#include "qscores-local.hpp"
+#include "qscores-single-defn.hpp"
+#include "qscores-single.hpp"
+#include "qscores-settings.hpp"
+#include "qscores-defn.hpp"
+#include "qscores.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Decode the reads numbered first to last - 1 (from 0) of the input file.  Only the blocks which hold
+     these reads are decoded, using the block index to seek to them; with --huffman-reuse, only the
+     Huffman codes of the blocks before them in the same run are read as well.  The input file must
+     have been opened for decoding with OpenFiles () and Initialize () called, as is done by Run ().
+
+     \param[in] first The first read to decode
+     \param[in] last One past the last read to decode
+     \param[out] reads The decoded reads are appended to this vector
+     \return Returns true on success, false on failure.
+*/
+bool QScores::ExtractReads (unsigned long long first, unsigned long long last, vector<QScoresSingle> &reads) {
+  if (!m_QScoresSettings.GetBlockIndex ()) {
+    cerr << "EE\tThe file does not have a block index (see --index), so reads cannot be extracted." << endl;
+    return false;
+  }
+
+  if ((m_BlockIndex.empty ()) && (!ReadBlockIndex ())) {
+    return false;
+  }
+
+  unsigned long long num_reads = 0;
+  if (!m_BlockIndex.empty ()) {
+    num_reads = m_BlockIndex.back ().first_read + m_BlockIndex.back ().num_reads;
+  }
+  if ((first > last) || (last > num_reads)) {
+    cerr << "EE\tThe reads " << first << ":" << last << " are not within the " << num_reads << " reads in the file." << endl;
+    return false;
+  }
+
+  if (first == last) {
+    return true;
+  }
+
+  //  The first block's header holds the parameters that are global to the entire file
+  QScoresBlock block;
+  unsigned int block_count = FindBlockIndexEntry (first);
+  if (!m_FileHeaderDecoded) {
+    m_BitBuff_In.SeekBits (m_BlockIndex[0].bit_offset);
+    DecodeHeaderBlock (block, m_BitBuff_In, 0);
+    m_FileHeaderDecoded = true;
+  }
+
+  //  With --huffman-reuse, the block can reuse the code of an earlier block of its run, so only the codes
+  //  of the earlier blocks of the run are read first
+  if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanReuse ())) {
+    for (unsigned int i = block_count - (block_count % GetHuffmanReuseRun ()); i < block_count; i++) {
+      m_BitBuff_In.SeekBits (m_BlockIndex[i].bit_offset);
+      if (DecodeHeaderBlock (block, m_BitBuff_In, static_cast<int> (i)) == g_EOF_REACHED) {
+        cerr << "EE\tBlock " << i << " does not match the block index." << endl;
+        return false;
+      }
+      SkipHuffmanBlock (block, m_BitBuff_In);
+    }
+  }
+
+  //  Decode each block which holds some of the reads, keeping only those that were asked for
+  while ((block_count < m_BlockIndex.size ()) && (m_BlockIndex[block_count].first_read < last)) {
+    const QScoresIndexEntry &entry = m_BlockIndex[block_count];
+
+    block.qscores.clear ();
+    m_BitBuff_In.SeekBits (entry.bit_offset);
+    int current_blocksize = DecodeHeaderBlock (block, m_BitBuff_In, static_cast<int> (block_count));
+    if ((current_blocksize == g_EOF_REACHED) || (static_cast<unsigned int> (current_blocksize) != entry.num_reads)) {
+      cerr << "EE\tBlock " << block_count << " does not match the block index." << endl;
+      return false;
+    }
+    DecodeBlock (block, m_BitBuff_In, m_ExternalSoftware, current_blocksize);
+
+    unsigned long long start = max (first, entry.first_read) - entry.first_read;
+    unsigned long long end = min (last, entry.first_read + entry.num_reads) - entry.first_read;
+    reads.insert (reads.end (), block.qscores.begin () + start, block.qscores.begin () + end);
+
+    block_count++;
+  }
+
+  return true;
+}
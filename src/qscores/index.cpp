@@ -0,0 +1,262 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file index.cpp
+    Block index at the end of the file.
+
+    The block index follows the EOF marker.  Both the index and its trailer
+    start on an unsigned int boundary and are made up of unsigned int's,
+    so that the trailer occupies the last g_BLOCK_INDEX_TRAILER_UINTS
+    unsigned int's of the file:
+
+      Index:    number of blocks
+                for each block:  bit offset (high, low), number of reads,
+                                 first read (high, low)
+      Trailer:  bit offset of the index (high, low), g_BLOCK_INDEX_MAGIC
+
+    Decoders which do not know about the index stop at the EOF marker, so
+    they can still decode the file.
+*/
+/*******************************************************************/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <climits>  //  UINT_MAX
+#include <cstdlib>
+
+#include "boost/filesystem.hpp"   // includes all needed Boost.Filesystem declarations
+
+using namespace std;
+namespace bfs = boost::filesystem;
+
+#include "common.hpp"
+#include "external-software.hpp"
+#include "block-statistics.hpp"
+#include "bitbuffer.hpp"
+#include "bitbuffer_exception.hpp"
+#include "qscores-local.hpp"
+#include "qscores-single-defn.hpp"
+#include "qscores-single.hpp"
+#include "qscores-settings.hpp"
+#include "qscores-defn.hpp"
+#include "qscores.hpp"
+
+
+/*!
+     Write an unsigned long long as two unsigned int's, the high-order one first.
+
+     \param[in] bitbuff The BitBuffer to write to
+     \param[in] x The value to write
+*/
+static void WriteULongLong (BitBuffer &bitbuff, unsigned long long x) {
+  unsigned int values[2];
+
+  values[0] = static_cast<unsigned int> (x >> g_UINT_SIZE_BITS);
+  values[1] = static_cast<unsigned int> (x & UINT_MAX);
+  bitbuff.WriteUInts (values, 2);
+
+  return;
+}
+
+
+/*!
+     Read an unsigned long long written by WriteULongLong ().
+
+     \param[in] bitbuff The BitBuffer to read from
+     \return The value read
+     \throw BitBuffer_Input_Exception
+*/
+static unsigned long long ReadULongLong (BitBuffer &bitbuff) {
+  unsigned int values[2];
+
+  bitbuff.ReadUInts (values, 2);
+
+  return ((static_cast<unsigned long long> (values[0]) << g_UINT_SIZE_BITS) | values[1]);
+}
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Add a block to the block index.  Blocks must be added in order.
+
+     \param[in] bit_offset Position of the block's header in the file, in bits
+     \param[in] num_reads Number of reads in the block
+*/
+void QScores::AddBlockIndexEntry (unsigned long long bit_offset, unsigned int num_reads) {
+  unsigned long long first_read = 0;
+
+  if (!m_BlockIndex.empty ()) {
+    first_read = m_BlockIndex.back ().first_read + m_BlockIndex.back ().num_reads;
+  }
+  m_BlockIndex.push_back (QScoresIndexEntry (bit_offset, num_reads, first_read));
+
+  return;
+}
+
+
+/*!
+     Write the block index and its trailer to m_BitBuff_Out; called after the EOF marker has been written.
+*/
+void QScores::WriteBlockIndex () {
+  unsigned int padding = static_cast<unsigned int> ((g_UINT_SIZE_BITS - (m_BitBuff_Out.GetBitPosition () % g_UINT_SIZE_BITS)) % g_UINT_SIZE_BITS);
+
+  //  Start the index on an unsigned int boundary
+  if (padding != 0) {
+    m_BitBuff_Out.WriteBits (0, padding);
+  }
+  unsigned long long index_offset = m_BitBuff_Out.GetBitPosition ();
+
+  unsigned int num_blocks = static_cast<unsigned int> (m_BlockIndex.size ());
+  m_BitBuff_Out.WriteUInts (&num_blocks, 1);
+  for (unsigned int i = 0; i < num_blocks; i++) {
+    WriteULongLong (m_BitBuff_Out, m_BlockIndex[i].bit_offset);
+    m_BitBuff_Out.WriteUInts (&(m_BlockIndex[i].num_reads), 1);
+    WriteULongLong (m_BitBuff_Out, m_BlockIndex[i].first_read);
+  }
+
+  //  Trailer
+  unsigned int magic = g_BLOCK_INDEX_MAGIC;
+  WriteULongLong (m_BitBuff_Out, index_offset);
+  m_BitBuff_Out.WriteUInts (&magic, 1);
+
+  if (GetVerbose ()) {
+    cerr << "II\tBlock index of " << num_blocks << " blocks written." << endl;
+  }
+
+  return;
+}
+
+
+/*!
+     Read the block index from the end of m_BitBuff_In into m_BlockIndex.  The position in m_BitBuff_In is
+     restored afterwards.
+
+     \return Returns true on success, false on failure.
+*/
+bool QScores::ReadBlockIndex () {
+  unsigned long long position = m_BitBuff_In.GetBitPosition ();
+  unsigned long long file_size = bfs::file_size (bfs::path (m_QScoresSettings.GetInputFn ()));
+  unsigned long long trailer_size = g_BLOCK_INDEX_TRAILER_UINTS * (g_UINT_SIZE_BITS / g_CHAR_SIZE_BITS);
+
+  m_BlockIndex.clear ();
+
+  if (file_size < trailer_size) {
+    cerr << "EE\tThe file is too short to contain a block index." << endl;
+    return false;
+  }
+
+  try {
+    //  Locate the index using the trailer
+    m_BitBuff_In.SeekBits ((file_size - trailer_size) * g_CHAR_SIZE_BITS);
+    unsigned long long index_offset = ReadULongLong (m_BitBuff_In);
+    unsigned int magic = 0;
+    m_BitBuff_In.ReadUInts (&magic, 1);
+    if ((magic != g_BLOCK_INDEX_MAGIC) || (index_offset >= (file_size - trailer_size) * g_CHAR_SIZE_BITS)) {
+      cerr << "EE\tThe block index at the end of the file is invalid." << endl;
+      return false;
+    }
+
+    m_BitBuff_In.SeekBits (index_offset);
+    unsigned int num_blocks = 0;
+    m_BitBuff_In.ReadUInts (&num_blocks, 1);
+    for (unsigned int i = 0; i < num_blocks; i++) {
+      unsigned long long bit_offset = ReadULongLong (m_BitBuff_In);
+      unsigned int num_reads = 0;
+      m_BitBuff_In.ReadUInts (&num_reads, 1);
+      unsigned long long first_read = ReadULongLong (m_BitBuff_In);
+      m_BlockIndex.push_back (QScoresIndexEntry (bit_offset, num_reads, first_read));
+    }
+  }
+  catch (BitBuffer_Input_Exception &e) {
+    cerr << "EE\tThe block index at the end of the file is incomplete." << endl;
+    return false;
+  }
+
+  m_BitBuff_In.SeekBits (position);
+
+  if (GetVerbose ()) {
+    cerr << "II\tBlock index of " << m_BlockIndex.size () << " blocks read." << endl;
+  }
+
+  return true;
+}
+
+
+/*!
+     Find the block in the block index which holds a read.
+
+     \param[in] read The read to look for (from 0)
+     \return The position of the block in m_BlockIndex, or the size of m_BlockIndex if no block holds the read
+*/
+unsigned int QScores::FindBlockIndexEntry (unsigned long long read) const {
+  unsigned int low = 0;
+  unsigned int high = static_cast<unsigned int> (m_BlockIndex.size ());
+
+  //  Binary search for the first block which starts after the read
+  while (low < high) {
+    unsigned int middle = low + ((high - low) / 2);
+    if (m_BlockIndex[middle].first_read <= read) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+
+  //  The read is in the block before it, if it is not beyond the end of that block
+  if ((low == 0) || (read >= m_BlockIndex[low - 1].first_read + m_BlockIndex[low - 1].num_reads)) {
+    return (static_cast<unsigned int> (m_BlockIndex.size ()));
+  }
+
+  return (low - 1);
+}
+
+
+/*!
+     Check that the block about to be decoded starts where the block index says it does.  Exits if it
+     does not, since either the file or its index is corrupt.
+
+     \param[in] block_count Block ID (from 0); the EOF marker if equal to the number of blocks
+*/
+void QScores::CheckBlockIndexEntry (int block_count) {
+  unsigned long long position = m_BitBuff_In.GetBitPosition ();
+
+  if ((block_count < static_cast<int> (m_BlockIndex.size ())) && (m_BlockIndex[block_count].bit_offset == position)) {
+    return;
+  }
+
+  //  The EOF marker was reached after the last block in the index
+  if (block_count == static_cast<int> (m_BlockIndex.size ())) {
+    return;
+  }
+
+  cerr << "EE\tBlock " << block_count << " does not match the block index." << endl;
+  exit (EXIT_FAILURE);
+}
@@ -87,8 +87,8 @@ bool QScores::OpenFiles () {
     }
   }
   else {
-    //  Binary input
-    m_BitBuff_In.Initialize (m_QScoresSettings.GetInputFn(), e_MODE_READ);
+    //  Binary input, read from a memory-mapped file if possible
+    m_BitBuff_In.Initialize (m_QScoresSettings.GetInputFn(), e_MODE_MMAP);
     m_QScoresSettings.ReadBinarySettings (m_BitBuff_In);
 
     //  Open text output and check if it succeeded
@@ -130,10 +130,11 @@ bool QScores::CloseFiles () {
 /*!
      Read in a block of quality scores from file.
 
+     \param[in] block The block to fill
      \param[in] blocksize The number of quality scores to read in
      \return Returns the number of quality score strings read in
 */
-int QScores::ReadInFileBlock (int blocksize) {
+int QScores::ReadInFileBlock (QScoresBlock &block, int blocksize) {
   int i = 0;
   int num_qscores = 0;
   string tmp;
@@ -141,8 +142,8 @@ int QScores::ReadInFileBlock (int blocksize) {
   bool lengths_same = true;  //  true/false whether all lengths the same in this block
 
   //  Clear the vector of quality scores and assume the lengths all differ
-  m_Qscores.clear ();
-  m_BlockReadLength = g_READ_LENGTH_VARIABLE;
+  block.qscores.clear ();
+  block.read_length = g_READ_LENGTH_VARIABLE;
 
   //  Check if EOF has already been reached
   if (m_Text_In.eof ()) {
@@ -165,7 +166,7 @@ int QScores::ReadInFileBlock (int blocksize) {
     }
 
     //  Change the second argument to "true" to set to debug mode
-    m_Qscores.push_back (QScoresSingle (tmp, false));
+    block.qscores.push_back (QScoresSingle (tmp, false));
     num_qscores++;
   }
 
@@ -177,12 +178,12 @@ int QScores::ReadInFileBlock (int blocksize) {
 
   //  Resize the array if the number of quality scores read is less than the blocksize
   if (num_qscores != blocksize) {
-    m_Qscores.resize (num_qscores);
+    block.qscores.resize (num_qscores);
   }
 
   //  All reads are the same length, so set the block's length
   if (lengths_same) {
-    m_BlockReadLength = read_length;
+    block.read_length = read_length;
   }
 
   return (num_qscores);
@@ -194,14 +195,16 @@ int QScores::ReadInFileBlock (int blocksize) {
      scores could include the newline character, which would make the location of the newline character ambigious.
      
      Values are 0-based.  To make them 1-based, change UnapplyFinalize () in QScoresSingle.
+
+     \param[in] block The block to write out
 */
-void QScores::WriteOutFileBlock () {
+void QScores::WriteOutFileBlock (QScoresBlock &block) {
   unsigned int num_qscores = 0;
   string tmp;
   
-  for (num_qscores = 0; num_qscores < m_Qscores.size (); num_qscores++) {
-//     cerr << num_qscores << "\t" << m_Qscores[num_qscores] << endl;
-    m_Text_Out << m_Qscores[num_qscores] << endl;
+  for (num_qscores = 0; num_qscores < block.qscores.size (); num_qscores++) {
+//     cerr << num_qscores << "\t" << block.qscores[num_qscores] << endl;
+    m_Text_Out << block.qscores[num_qscores] << "\n";
   }
 
   return;
@@ -123,3 +123,194 @@ void QScores::SetBlocksize (int x) {
 }
 
 
+/*!
+     Set the number of threads.
+
+     \param[in] x Number of threads
+*/
+void QScores::SetThreads (unsigned int x) {
+  m_Threads = x;
+  return;
+}
+
+
+/*!
+     Set the maximum length of a Huffman codeword.
+
+     \param[in] x Maximum length in bits; 0 for no limit
+*/
+void QScores::SetHuffmanMaxLen (unsigned int x) {
+  m_HuffmanMaxLen = x;
+  return;
+}
+
+
+/*!
+     Set the number of interleaved streams in each Huffman-coded block.
+
+     \param[in] x Number of streams
+*/
+void QScores::SetHuffmanStreams (unsigned int x) {
+  m_HuffmanStreams = x;
+  return;
+}
+
+
+/*!
+     Set the number of read position bins that each Huffman-coded block is split into.
+
+     \param[in] x Number of bins
+*/
+void QScores::SetHuffmanPositionBins (unsigned int x) {
+  m_HuffmanPositionBins = x;
+  return;
+}
+
+
+/*!
+     Set whether Huffman coding uses order-1 contexts.
+
+     \param[in] x true to code each quality score with a table chosen by the one before
+*/
+void QScores::SetHuffmanOrder1 (bool x) {
+  m_HuffmanOrder1 = x;
+  return;
+}
+
+
+/*!
+     Set whether a Huffman-coded block can reuse the code of an earlier block.
+
+     \param[in] x true to allow blocks to reuse an earlier code
+*/
+void QScores::SetHuffmanReuse (bool x) {
+  m_HuffmanReuse = x;
+  return;
+}
+
+
+/*!
+     Set how much larger a Huffman-coded block can be, in percent, when it reuses the code of an
+     earlier block.
+
+     \param[in] x The tolerance in percent
+*/
+void QScores::SetHuffmanReuseTolerance (unsigned int x) {
+  m_HuffmanReuseTolerance = x;
+  return;
+}
+
+
+/*!
+     Set the number of consecutive blocks in each run when Huffman codes are reused.
+
+     \param[in] x The number of blocks in each run
+*/
+void QScores::SetHuffmanReuseRun (unsigned int x) {
+  m_HuffmanReuseRun = x;
+  return;
+}
+
+
+/*!
+     Set the number of interleaved states in each rANS-coded block.
+
+     \param[in] x Number of states
+*/
+void QScores::SetRansStates (unsigned int x) {
+  m_RansStates = x;
+  return;
+}
+
+
+/*!
+     Set the order of PPM.
+
+     \param[in] x Number of quality scores in the longest context
+*/
+void QScores::SetPPMOrder (unsigned int x) {
+  m_PPMOrder = x;
+  return;
+}
+
+
+/*!
+     Set the memory of PPM.
+
+     \param[in] x Memory in megabytes
+*/
+void QScores::SetPPMMemory (unsigned int x) {
+  m_PPMMemory = x;
+  return;
+}
+
+
+/*!
+     Set the memory of Re-Pair.
+
+     \param[in] x Memory in megabytes
+*/
+void QScores::SetRePairMemory (unsigned int x) {
+  m_RePairMemory = x;
+  return;
+}
+
+
+/*!
+     Set the compression level of Zstandard.
+
+     \param[in] x Compression level
+*/
+void QScores::SetZstdLevel (unsigned int x) {
+  m_ZstdLevel = x;
+  return;
+}
+
+
+/*!
+     Set whether Zstandard uses long-distance matching.
+
+     \param[in] x true to use long-distance matching
+*/
+void QScores::SetZstdLong (bool x) {
+  m_ZstdLong = x;
+  return;
+}
+
+
+/*!
+     Set the file with the dictionary of Zstandard.
+
+     \param[in] x The filename
+*/
+void QScores::SetZstdDictionaryFn (string x) {
+  m_ZstdDictionaryFn = x;
+  return;
+}
+
+
+/*!
+     Set the largest size of the dictionary of Zstandard trained from the first block.
+
+     \param[in] x Size in bytes; 0 to not train a dictionary
+*/
+void QScores::SetZstdTrainSize (unsigned int x) {
+  m_ZstdTrainSize = x;
+  return;
+}
+
+
+/*!
+     Set the range of reads to decode.
+
+     \param[in] first The first read to decode (from 0)
+     \param[in] last One past the last read to decode
+*/
+void QScores::SetExtractReads (unsigned long long first, unsigned long long last) {
+  m_ExtractReads = true;
+  m_ExtractFirst = first;
+  m_ExtractLast = last;
+  return;
+}
+
+
@@ -51,8 +51,12 @@ namespace po = boost::program_options;
 
 #include "common.hpp"
 #include "external-software.hpp"
+#include "ppm-model.hpp"
 #include "block-statistics.hpp"
 #include "bitbuffer.hpp"
+#include "repair-model.hpp"
+#include "huffman.hpp"
+#include "rans.hpp"
 #include "qscores-single-defn.hpp"
 #include "qscores-single.hpp"
 #include "qscores-settings.hpp"
@@ -106,6 +110,9 @@ bool QScores::ProcessOptions (int argc, char *argv[]) {
       ("output", po::value<string>(), "Output filename.")
       ("mapping", po::value<string>(), "Quality scores mapping [sanger* | solexa | illumina].")
       ("blocksize", po::value<int>() -> default_value (INT_MAX), "Block size [Infinite size*].")
+      ("threads", po::value<unsigned int>() -> default_value (1), "Number of threads used for encoding, and for decoding files with a block index [1*].")
+      ("index", "Add a block index to the end of the compressed file.")
+      ("extract-reads", po::value<string>(), "Decode only reads A to B - 1 (from 0), given as A:B; requires a block index.")
       ;
 
     po::options_description lossy ("Lossy transformation options");
@@ -132,7 +139,16 @@ bool QScores::ProcessOptions (int argc, char *argv[]) {
       ("rice", "Rice coding")
       ("interp", "Interpolative coding")
       ("huffman", "Huffman coding")
-      ("arithmetic", "Arithmetic coding (unavailable)")
+      ("huffman-maxlen", po::value<unsigned int>() -> default_value (0), "Maximum length of a Huffman codeword, in bits [No limit*].")
+      ("huffman-streams", po::value<unsigned int>() -> default_value (1), "Number of interleaved streams in each Huffman-coded block, for faster decoding [1*].")
+      ("huffman-position-bins", po::value<unsigned int>() -> default_value (1), "Number of read position bins in each Huffman-coded block, each with its own code [1*].")
+      ("huffman-order1", "Huffman code each quality score with a table chosen by the one before it.")
+      ("huffman-reuse", po::value<unsigned int>(), "Reuse the Huffman code of an earlier block if the block is at most this many percent larger with it [Not used*].")
+      ("arithmetic", "Arithmetic coding")
+      ("arithmetic-context", "Adaptive arithmetic coding with contexts from the previous quality scores and the position in the read")
+      ("rans", "rANS coding")
+      ("rans-states", po::value<unsigned int>() -> default_value (4), "Number of interleaved states in each rANS-coded block, for faster decoding [4*].")
+      ("tans", "tANS coding for small alphabets, or Huffman coding for the blocks where it is smaller")
       ("param", po::value<unsigned int>() -> default_value (UINT_MAX), "Global parameter for Golomb or Rice coding [Default:  Use block-based parameters.]")
       ;
 
@@ -140,8 +156,16 @@ bool QScores::ProcessOptions (int argc, char *argv[]) {
     ext_compression.add_options ()
       ("gzip", "gzip")
       ("bzip", "bzip2")
-      ("repair", "Re-Pair (unavailable)")
-      ("ppm", "PPM (unavailable)")
+      ("repair", "Re-Pair")
+      ("repair-memory", po::value<unsigned int>() -> default_value (g_REPAIR_DEFAULT_MEMORY), "Memory of Re-Pair in megabytes; larger blocks are split into chunks [64*].")
+      ("ppm", "PPM")
+      ("ppm-order", po::value<unsigned int>() -> default_value (g_PPM_DEFAULT_ORDER), "Number of quality scores in the longest context of PPM [2*].")
+      ("ppm-memory", po::value<unsigned int>() -> default_value (g_PPM_DEFAULT_MEMORY), "Memory of PPM in megabytes; the model starts again when it is used up [16*].")
+      ("zstd", "Zstandard (requires the zstd library)")
+      ("zstd-level", po::value<unsigned int>() -> default_value (g_ZSTD_DEFAULT_LEVEL), "Compression level of Zstandard, from 1 to 22 [19*].")
+      ("zstd-long", "Use long-distance matching with Zstandard, with a window of 128 MB.")
+      ("zstd-dict", po::value<string>(), "File with a dictionary for Zstandard; it is kept in the compressed file [None*].")
+      ("zstd-train", po::value<unsigned int>(), "Train a dictionary of at most this many bytes for Zstandard from the first block [Not used*].")
       ;
 
     //  Command line options
@@ -238,6 +262,38 @@ bool QScores::ProcessOptions (int argc, char *argv[]) {
       SetBlocksize (vm["blocksize"].as<int>());
     }
 
+    if (vm.count ("threads")) {
+      SetThreads (vm["threads"].as<unsigned int>());
+    }
+
+    if (vm.count ("index")) {
+      m_QScoresSettings.SetBlockIndex ();
+    }
+
+    if (vm.count ("extract-reads")) {
+      string range = vm["extract-reads"].as<string>();
+      size_t colon = range.find (':');
+      size_t first_end = 0;
+      size_t last_end = 0;
+      unsigned long long first = 0;
+      unsigned long long last = 0;
+
+      if (colon != string::npos) {
+        try {
+          first = stoull (range.substr (0, colon), &first_end);
+          last = stoull (range.substr (colon + 1), &last_end);
+        }
+        catch (std::exception& e) {
+          first_end = 0;
+        }
+      }
+      if ((colon == string::npos) || (first_end != colon) || (last_end != range.length () - colon - 1) || (first > last)) {
+        cerr << "EE\tThe range accompanying --extract-reads should be A:B, with A <= B." << endl;
+        exit (EXIT_FAILURE);
+      }
+      SetExtractReads (first, last);
+    }
+
     //  -----------------------------------------------------------------
     //  Lossy transformation options
     //  -----------------------------------------------------------------
@@ -308,10 +364,45 @@ bool QScores::ProcessOptions (int argc, char *argv[]) {
       m_QScoresSettings.SetCompressionHuffman ();
     }
 
+    if (vm.count ("huffman-maxlen")) {
+      SetHuffmanMaxLen (vm["huffman-maxlen"].as<unsigned int>());
+    }
+
+    if (vm.count ("huffman-streams")) {
+      SetHuffmanStreams (vm["huffman-streams"].as<unsigned int>());
+    }
+
+    if (vm.count ("huffman-position-bins")) {
+      SetHuffmanPositionBins (vm["huffman-position-bins"].as<unsigned int>());
+    }
+
+    if (vm.count ("huffman-order1")) {
+      SetHuffmanOrder1 (true);
+    }
+
+    if (vm.count ("huffman-reuse")) {
+      SetHuffmanReuse (true);
+      SetHuffmanReuseTolerance (vm["huffman-reuse"].as<unsigned int>());
+    }
+
     if (vm.count ("arithmetic")) {
       m_QScoresSettings.SetCompressionArithmetic ();
-      cerr << "EE\t--arithmetic has not been implemented yet." << endl;
-      exit (EXIT_FAILURE);
+    }
+
+    if (vm.count ("arithmetic-context")) {
+      m_QScoresSettings.SetCompressionArithmeticContext ();
+    }
+
+    if (vm.count ("rans")) {
+      m_QScoresSettings.SetCompressionRans ();
+    }
+
+    if (vm.count ("rans-states")) {
+      SetRansStates (vm["rans-states"].as<unsigned int>());
+    }
+
+    if (vm.count ("tans")) {
+      m_QScoresSettings.SetCompressionTans ();
     }
 
     if (vm.count ("gzip")) {
@@ -324,14 +415,42 @@ bool QScores::ProcessOptions (int argc, char *argv[]) {
 
     if (vm.count ("repair")) {
       m_QScoresSettings.SetCompressionRepair ();
-      cerr << "EE\t--repair has not been implemented yet." << endl;
-      exit (EXIT_FAILURE);
+    }
+
+    if (vm.count ("repair-memory")) {
+      SetRePairMemory (vm["repair-memory"].as<unsigned int>());
     }
 
     if (vm.count ("ppm")) {
       m_QScoresSettings.SetCompressionPPM ();
-      cerr << "EE\t--ppm has not been implemented yet." << endl;
-      exit (EXIT_FAILURE);
+    }
+
+    if (vm.count ("ppm-order")) {
+      SetPPMOrder (vm["ppm-order"].as<unsigned int>());
+    }
+
+    if (vm.count ("ppm-memory")) {
+      SetPPMMemory (vm["ppm-memory"].as<unsigned int>());
+    }
+
+    if (vm.count ("zstd")) {
+      m_QScoresSettings.SetCompressionZstd ();
+    }
+
+    if (vm.count ("zstd-level")) {
+      SetZstdLevel (vm["zstd-level"].as<unsigned int>());
+    }
+
+    if (vm.count ("zstd-long")) {
+      SetZstdLong (true);
+    }
+
+    if (vm.count ("zstd-dict")) {
+      SetZstdDictionaryFn (vm["zstd-dict"].as<string>());
+    }
+
+    if (vm.count ("zstd-train")) {
+      SetZstdTrainSize (vm["zstd-train"].as<unsigned int>());
     }
     
     if (vm.count ("nocompress")) {
@@ -375,6 +494,95 @@ bool QScores::CheckSettings () {
     }
   }
 
+  if ((GetExtractReads ()) && (!GetDecode ())) {
+    cerr << "EE\tThe --extract-reads option is only valid with decoding.  Please use the --decode option." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (GetThreads () == 0) {
+    cerr << "EE\tThe number of threads accompanying --threads cannot be 0." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (GetHuffmanMaxLen () > g_UINT_SIZE_BITS) {
+    cerr << "EE\tThe length accompanying --huffman-maxlen cannot be more than " << g_UINT_SIZE_BITS << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetHuffmanStreams () == 0) || (GetHuffmanStreams () > g_HUFFMAN_MAX_STREAMS) || ((GetHuffmanStreams () & (GetHuffmanStreams () - 1)) != 0)) {
+    cerr << "EE\tThe number accompanying --huffman-streams must be a power of 2 from 1 to " << g_HUFFMAN_MAX_STREAMS << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetRansStates () == 0) || (GetRansStates () > g_RANS_MAX_STATES) || ((GetRansStates () & (GetRansStates () - 1)) != 0)) {
+    cerr << "EE\tThe number accompanying --rans-states must be a power of 2 from 1 to " << g_RANS_MAX_STATES << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (GetPPMOrder () > g_PPM_MAX_ORDER) {
+    cerr << "EE\tThe number accompanying --ppm-order cannot be more than " << g_PPM_MAX_ORDER << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetPPMMemory () == 0) || (GetPPMMemory () > g_PPM_MAX_MEMORY)) {
+    cerr << "EE\tThe number accompanying --ppm-memory must be from 1 to " << g_PPM_MAX_MEMORY << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetZstdLevel () == 0) || (GetZstdLevel () > g_ZSTD_MAX_LEVEL)) {
+    cerr << "EE\tThe number accompanying --zstd-level must be from 1 to " << g_ZSTD_MAX_LEVEL << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetZstdTrainSize () != 0) && ((GetZstdTrainSize () < g_ZSTD_MIN_DICTIONARY_SIZE) || (GetZstdTrainSize () > g_ZSTD_MAX_DICTIONARY_SIZE))) {
+    cerr << "EE\tThe number accompanying --zstd-train must be from " << g_ZSTD_MIN_DICTIONARY_SIZE << " to " << g_ZSTD_MAX_DICTIONARY_SIZE << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetZstdTrainSize () != 0) && (GetZstdDictionaryFn () != "")) {
+    cerr << "EE\tThe --zstd-dict and --zstd-train options cannot be used together." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetEncode ()) && (m_QScoresSettings.GetCompressionZstd ()) && (!g_USE_ZSTD)) {
+    cerr << "EE\tThe --zstd option requires the zstd library, which was not found during compilation." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetRePairMemory () == 0) || (GetRePairMemory () > g_REPAIR_MAX_MEMORY)) {
+    cerr << "EE\tThe number accompanying --repair-memory must be from 1 to " << g_REPAIR_MAX_MEMORY << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetHuffmanPositionBins () == 0) || (GetHuffmanPositionBins () > g_HUFFMAN_MAX_POSITION_BINS)) {
+    cerr << "EE\tThe number accompanying --huffman-position-bins must be from 1 to " << g_HUFFMAN_MAX_POSITION_BINS << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetHuffmanOrder1 ()) && (GetHuffmanStreams () != 1)) {
+    cerr << "EE\tThe --huffman-order1 option cannot be used with more than one stream (--huffman-streams)." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if ((GetHuffmanReuse ()) && ((GetHuffmanPositionBins () != 1) || (GetHuffmanOrder1 ()))) {
+    cerr << "EE\tThe --huffman-reuse option cannot be used with --huffman-position-bins or --huffman-order1." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  //  Options that differ from their defaults are recorded in the file header; see EncodeHeaderBlock ()
+  if ((GetEncode ()) && (m_QScoresSettings.GetCompressionHuffman ()) && ((GetHuffmanStreams () != 1) || (GetHuffmanPositionBins () != 1) || (GetHuffmanOrder1 ()) || (GetHuffmanReuse ()))) {
+    m_QScoresSettings.SetCompressionHuffmanOptions ();
+  }
+
+  //  The external programs (used when the libraries are not found) share temporary files, so only one
+  //  block can be compressed at a time
+  if ((GetThreads () > 1) &&
+      (((m_QScoresSettings.GetCompressionGzip ()) && (!g_USE_ZLIB)) ||
+       ((m_QScoresSettings.GetCompressionBzip ()) && (!g_USE_BZLIB)))) {
+    cerr << "WW\tOnly one thread can be used with an external program; ignoring --threads." << endl;
+    SetThreads (1);
+  }
+
   if (m_QScoresSettings.GetQScoresMapping () == e_QSCORES_MAP_UNSET) {
     m_QScoresSettings.SetQScoresMapping ("sanger");  //  Sanger is the default method
   }
@@ -384,6 +592,11 @@ bool QScores::CheckSettings () {
     exit (EXIT_FAILURE);
   }
 
+  if (m_QScoresSettings.GetCompressionNone () && (m_QScoresSettings.GetBlockIndex ())) {
+    cerr << "EE\tThe --index option cannot be used with --nocompress." << endl;
+    exit (EXIT_FAILURE);
+  }
+
   //  Pass debug parameters to other objects here
   if (GetDebug ()) {
     m_QScoresSettings.SetDebug ();
@@ -396,6 +609,22 @@ bool QScores::CheckSettings () {
     cerr << left << setw (g_VERBOSE_WIDTH) << "II\tProgram mode:" << (GetEncode () == true ? "Encoding" : "Decoding") << endl;
     if (GetEncode ()) {
       cerr << left << setw (g_VERBOSE_WIDTH) << "II\tBlocksize:" << GetBlocksize () << endl;
+      cerr << left << setw (g_VERBOSE_WIDTH) << "II\tThreads:" << GetThreads () << endl;
+      if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanMaxLen () != 0)) {
+        cerr << left << setw (g_VERBOSE_WIDTH) << "II\tMaximum Huffman codeword length:" << GetHuffmanMaxLen () << endl;
+      }
+      if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanStreams () != 1)) {
+        cerr << left << setw (g_VERBOSE_WIDTH) << "II\tHuffman streams:" << GetHuffmanStreams () << endl;
+      }
+      if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanPositionBins () != 1)) {
+        cerr << left << setw (g_VERBOSE_WIDTH) << "II\tHuffman read position bins:" << GetHuffmanPositionBins () << endl;
+      }
+      if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanOrder1 ())) {
+        cerr << left << setw (g_VERBOSE_WIDTH) << "II\tHuffman contexts:" << "Order-1" << endl;
+      }
+      if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanReuse ())) {
+        cerr << left << setw (g_VERBOSE_WIDTH) << "II\tHuffman code reuse tolerance:" << GetHuffmanReuseTolerance () << "%" << endl;
+      }
     }
   }
 
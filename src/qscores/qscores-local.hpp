@@ -42,5 +42,26 @@ const unsigned int g_EXTERNAL_BUFFER_SIZE = 1048576;
 //!  Special value indicating that the read length varies
 const unsigned int g_READ_LENGTH_VARIABLE = UINT_MAX;
 
+//!  Maximum number of read position bins in a Huffman-coded block (see --huffman-position-bins)
+const unsigned int g_HUFFMAN_MAX_POSITION_BINS = 64;
+
+//!  Number of segments that the reads are divided into when the position bins are chosen; each bin is made up of whole segments
+const unsigned int g_HUFFMAN_POSITION_SEGMENTS = 256;
+
+//!  Estimated size in bits of each bin's prelude, per distinct quality score, when the position bins are chosen
+const unsigned int g_HUFFMAN_BIN_SYMBOL_BITS = 6;
+
+//!  Estimated size in bits of the rest of each bin's prelude and its trailer, when the position bins are chosen
+const unsigned int g_HUFFMAN_BIN_FIXED_BITS = 64;
+
+//!  Number of consecutive blocks in each run when Huffman codes are reused; a run is coded by one thread (see --huffman-reuse)
+const unsigned int g_HUFFMAN_REUSE_RUN = 8;
+
+//!  Last value in a file with a block index ("QSIX")
+const unsigned int g_BLOCK_INDEX_MAGIC = 0x51534958;
+
+//!  Size of the trailer which follows the block index, in unsigned int's (the index's position and g_BLOCK_INDEX_MAGIC)
+const unsigned int g_BLOCK_INDEX_TRAILER_UINTS = 3;
+
 #endif
 
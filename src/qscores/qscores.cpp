@@ -37,8 +37,11 @@
 using namespace std;
 
 #include "external-software.hpp"
+#include "ppm-model.hpp"
 #include "block-statistics.hpp"
 #include "bitbuffer.hpp"
+#include "repair-model.hpp"
+#include "qscores-local.hpp"
 #include "qscores-single-defn.hpp"
 #include "qscores-single.hpp"
 #include "qscores-settings.hpp"
@@ -60,14 +63,31 @@ QScores::QScores()
     m_Text_Out (),
     m_QScoresSettings (),
     m_ExternalSoftware (),
-    m_Qscores (0),
     m_FileReadLength (0),
     m_FileBlockSize (0),
-    m_BlockReadLength (0),
+    m_BlockIndex (),
+    m_FileHeaderDecoded (false),
     m_Blocksize (INT_MAX),
-    m_BlockMinimum (0),
-    m_BlockStatistics (),
-    m_CompressionParameter (UINT_MAX),
+    m_Threads (1),
+    m_HuffmanMaxLen (0),
+    m_HuffmanStreams (1),
+    m_HuffmanPositionBins (1),
+    m_HuffmanOrder1 (false),
+    m_HuffmanReuse (false),
+    m_HuffmanReuseTolerance (0),
+    m_HuffmanReuseRun (g_HUFFMAN_REUSE_RUN),
+    m_RansStates (4),
+    m_PPMOrder (g_PPM_DEFAULT_ORDER),
+    m_PPMMemory (g_PPM_DEFAULT_MEMORY),
+    m_RePairMemory (g_REPAIR_DEFAULT_MEMORY),
+    m_ZstdLevel (g_ZSTD_DEFAULT_LEVEL),
+    m_ZstdLong (false),
+    m_ZstdDictionaryFn (""),
+    m_ZstdTrainSize (0),
+    m_ZstdDictionary (),
+    m_ExtractReads (false),
+    m_ExtractFirst (0),
+    m_ExtractLast (0),
     m_CompressionParameter_2 (UINT_MAX)
 {
 }
@@ -84,22 +104,49 @@ QScores::~QScores() {
      \return Returns true on success, false on failure.
 */
 bool QScores::Initialize () {
+  m_ExternalSoftware.InitializePaths ();
+
+  InitializeExternalSoftware (m_ExternalSoftware);
+  
+  return true;
+}
+
+
+/*!
+     Set the method of an ExternalSoftware object according to the settings.  Besides m_ExternalSoftware,
+     this is also used for the private objects of each thread.
+
+     \param[in] external The object to initialize
+*/
+void QScores::InitializeExternalSoftware (ExternalSoftware &external) {
   bool encode = true;
   
   if (GetDecode ()) {
     encode = false;
   }
 
-  m_ExternalSoftware.InitializePaths ();
-
   if (m_QScoresSettings.GetCompressionGzip ()) {
-    m_ExternalSoftware.Initialize (e_EXTERNAL_METHOD_GZIP_ZLIB, encode);
+    external.Initialize (e_EXTERNAL_METHOD_GZIP_ZLIB, encode);
   }
   else if (m_QScoresSettings.GetCompressionBzip ()) {
-    m_ExternalSoftware.Initialize (e_EXTERNAL_METHOD_BZIP_BZLIB, encode);
+    external.Initialize (e_EXTERNAL_METHOD_BZIP_BZLIB, encode);
   }
-  
-  return true;
+  else if (m_QScoresSettings.GetCompressionRepair ()) {
+    external.Initialize (e_EXTERNAL_METHOD_REPAIR, encode);
+    external.SetRePairMemory (GetRePairMemory ());
+  }
+  else if (m_QScoresSettings.GetCompressionPPM ()) {
+    external.Initialize (e_EXTERNAL_METHOD_PPM, encode);
+    external.SetPPMOrder (GetPPMOrder ());
+    external.SetPPMMemory (GetPPMMemory ());
+  }
+  else if (m_QScoresSettings.GetCompressionZstd ()) {
+    external.Initialize (e_EXTERNAL_METHOD_ZSTD, encode);
+    external.SetZstdLevel (GetZstdLevel ());
+    external.SetZstdLong (GetZstdLong ());
+  }
+
+  return;
 }
 
 
@@ -30,6 +30,92 @@
 #ifndef QSCORES_HPP
 #define QSCORES_HPP
 
+/*!
+    \struct QScoresHuffmanCode
+
+    \details A Huffman code which was sent by an earlier block of the same run, so that later blocks
+             of the run can reuse it instead of sending their own (see --huffman-reuse).
+*/
+struct QScoresHuffmanCode {
+  //!  Block ID (from 0) of the block which sent the code; -1 if no code has been sent in the run
+  int block_count;
+  //!  The length of each symbol's codeword (see Huffman::GetCodewordLengths ())
+  vector<unsigned int> lengths;
+
+  QScoresHuffmanCode ()
+    : block_count (-1),
+      lengths ()
+        {
+        }
+};
+
+
+/*!
+    \struct QScoresBlock
+
+    \details The quality scores of a single block and the values that are stored in the block's header.
+             Blocks are coded independently of each other, so several of these can be in use at the same
+             time when more than one thread is used.  The only exception is --huffman-reuse, where a
+             block can refer to the Huffman code of an earlier block in its run of GetHuffmanReuseRun ()
+             blocks; the last code of the run that was sent or read is kept in huffman_code, and each
+             run is coded by one thread.
+*/
+struct QScoresBlock {
+  //!  Vector of quality score objects
+  vector <QScoresSingle> qscores;
+  //!  Read length for the block; encoded as 0 if same as the file's read length
+  unsigned int read_length;
+  //!  Minimum for the block
+  unsigned int minimum;
+  //!  Statistics for the block
+  BlockStatistics statistics;
+  //!  Parameter to be used for some coding schemes
+  unsigned int compression_parameter;
+  //!  Block ID (from 0); set by EncodeHeaderBlock () and DecodeHeaderBlock ()
+  int block_count;
+  //!  The last Huffman code sent by this or an earlier block of its run (see --huffman-reuse)
+  QScoresHuffmanCode huffman_code;
+
+  QScoresBlock ()
+    : qscores (0),
+      read_length (0),
+      minimum (0),
+      statistics (),
+      compression_parameter (UINT_MAX),
+      block_count (0),
+      huffman_code ()
+        {
+        }
+};
+
+
+/*!
+    \struct QScoresIndexEntry
+
+    \details An entry of the block index, which records where a block starts in the file and which reads
+             it holds.
+*/
+struct QScoresIndexEntry {
+  //!  Position of the block's header in the file, in bits from the start of the file
+  unsigned long long bit_offset;
+  //!  Number of reads in the block
+  unsigned int num_reads;
+  //!  Ordinal of the first read in the block (from 0)
+  unsigned long long first_read;
+
+  QScoresIndexEntry (unsigned long long bit_offset_pos, unsigned int num_reads_pos, unsigned long long first_read_pos)
+    : bit_offset (bit_offset_pos),
+      num_reads (num_reads_pos),
+      first_read (first_read_pos)
+        {
+        }
+};
+
+
+//  Shared state of the threads when encoding or decoding with more than one thread  [threads.cpp]
+struct QScoresPipeline;
+
+
 /*!
     \class QScores
 
@@ -41,6 +127,7 @@ class QScores {
     QScores ();
     ~QScores ();
     bool Initialize ();
+    void InitializeExternalSoftware (ExternalSoftware &external);
     
     //  Execution  [run.cpp]
     bool Run ();
@@ -52,31 +139,59 @@ class QScores {
     //  Reading in data  [io.cpp]
     bool OpenFiles ();
     bool CloseFiles ();
-    int ReadInFileBlock (int blocksize);
-    void WriteOutFileBlock ();
+    int ReadInFileBlock (QScoresBlock &block, int blocksize);
+    void WriteOutFileBlock (QScoresBlock &block);
     
     //  Block transformation functions  [transform.cpp]
     void PerformBinningCheck ();
     void PerformUnbinningCheck ();
-    void PreprocessBlock (int current_blocksize);
-    void UnPreprocessBlock (int current_blocksize);
+    void PreprocessBlock (QScoresBlock &block, int current_blocksize);
+    void UnPreprocessBlock (QScoresBlock &block, int current_blocksize);
 
     //  Block encoding functions  [encode.cpp]
     void EncodeEOF ();
-    void EncodeHeaderBlock (int current_blocksize, int block_count);
-    void EncodeStaticCodesBlock (int current_blocksize);
-    void EncodeHuffmanBlock (int current_blocksize);
-    void EncodeExternalBlock (int current_blocksize);
-    void EncodeIntToQScore (int current_blocksize);
+    void EncodeBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize, int block_count);
+    void EncodeHeaderBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize, int block_count);
+    void EncodeStaticCodesBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void EncodeHuffmanBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    vector<unsigned int> ChooseHuffmanPositionBins (const QScoresBlock &block, int current_blocksize) const;
+    void EncodeArithmeticBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void EncodeArithmeticContextBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void EncodeRansBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void EncodeTansBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void EncodeExternalBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize);
+    void EncodeIntToQScore (QScoresBlock &block, int current_blocksize);
 
     //  Block decoding functions  [decode.cpp]
-    int DecodeHeaderBlock (int block_count);
-    void DecodeStaticCodesBlock (int current_blocksize);
-    void DecodeHuffmanBlock (int current_blocksize);
-    void DecodeExternalBlock (int current_blocksize);
+    int DecodeHeaderBlock (QScoresBlock &block, BitBuffer &bitbuff, int block_count);
+    void DecodeBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize);
+    void DecodeStaticCodesBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void DecodeHuffmanBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void DecodeHuffmanPositionBins (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize, const vector<unsigned int> &bins);
+    void SkipHuffmanBlock (QScoresBlock &block, BitBuffer &bitbuff);
+    void DecodeArithmeticBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void DecodeArithmeticContextBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void DecodeRansBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void DecodeTansBlock (QScoresBlock &block, BitBuffer &bitbuff, int current_blocksize);
+    void DecodeExternalBlock (QScoresBlock &block, BitBuffer &bitbuff, ExternalSoftware &external, int current_blocksize);
+
+    //  Encoding and decoding with more than one thread  [threads.cpp]
+    int EncodeThreaded ();
+    int DecodeThreaded ();
+
+    //  Block index  [index.cpp]
+    void AddBlockIndexEntry (unsigned long long bit_offset, unsigned int num_reads);
+    void WriteBlockIndex ();
+    bool ReadBlockIndex ();
+    void CheckBlockIndexEntry (int block_count);
+    unsigned int FindBlockIndexEntry (unsigned long long read) const;
+
+    //  Random access to reads  [extract.cpp]
+    bool ExtractReads (unsigned long long first, unsigned long long last, vector<QScoresSingle> &reads);
 
     //  External compression software [external.cpp]
     void PerformExternalSoftwareCheck ();
+    void InitializeZstdDictionary (const QScoresBlock &block, int current_blocksize);
     
     //  Accessors  [accessors.cpp]
     bool GetDebug () const;
@@ -89,6 +204,25 @@ class QScores {
     enum e_QSCORES_MAP GetQScoresMapping () const;
     string GetQScoresMappingStr () const;
     int GetBlocksize () const;
+    unsigned int GetThreads () const;
+    unsigned int GetHuffmanMaxLen () const;
+    unsigned int GetHuffmanStreams () const;
+    unsigned int GetHuffmanPositionBins () const;
+    bool GetHuffmanOrder1 () const;
+    bool GetHuffmanReuse () const;
+    unsigned int GetHuffmanReuseTolerance () const;
+    unsigned int GetHuffmanReuseRun () const;
+    unsigned int GetRansStates () const;
+    unsigned int GetPPMOrder () const;
+    unsigned int GetPPMMemory () const;
+    unsigned int GetRePairMemory () const;
+    unsigned int GetZstdLevel () const;
+    bool GetZstdLong () const;
+    string GetZstdDictionaryFn () const;
+    unsigned int GetZstdTrainSize () const;
+    bool GetExtractReads () const;
+    unsigned long long GetExtractFirst () const;
+    unsigned long long GetExtractLast () const;
     
     //  Mutators  [mutators.cpp]
     void SetDebug ();
@@ -100,7 +234,29 @@ class QScores {
     void SetUnbinningCheck ();
     void SetQScoresMapping (string x);
     void SetBlocksize (int x);
+    void SetThreads (unsigned int x);
+    void SetHuffmanMaxLen (unsigned int x);
+    void SetHuffmanStreams (unsigned int x);
+    void SetHuffmanPositionBins (unsigned int x);
+    void SetHuffmanOrder1 (bool x);
+    void SetHuffmanReuse (bool x);
+    void SetHuffmanReuseTolerance (unsigned int x);
+    void SetHuffmanReuseRun (unsigned int x);
+    void SetRansStates (unsigned int x);
+    void SetPPMOrder (unsigned int x);
+    void SetPPMMemory (unsigned int x);
+    void SetRePairMemory (unsigned int x);
+    void SetZstdLevel (unsigned int x);
+    void SetZstdLong (bool x);
+    void SetZstdDictionaryFn (string x);
+    void SetZstdTrainSize (unsigned int x);
+    void SetExtractReads (unsigned long long first, unsigned long long last);
   private:
+    //  Encoding and decoding with more than one thread  [threads.cpp]
+    void EncodeThreadedWorker (QScoresPipeline &pipeline);
+    void EncodeThreadedWriter (QScoresPipeline &pipeline);
+    void DecodeThreadedWorker (QScoresPipeline &pipeline);
+
     //!  Debug mode?
     bool m_Debug;
     //!  Verbose mode?
@@ -131,26 +287,58 @@ class QScores {
     //!  Management of external software
     ExternalSoftware m_ExternalSoftware;
     
-    //!  Vector of quality score objects
-    vector <QScoresSingle> m_Qscores;
-
     //!  Read length for the entire data file
     unsigned int m_FileReadLength;
     //!  Block size fo the entire file
     int m_FileBlockSize;
     
-    //  Variables related to the current block; need to make them into a vector of values
-    //  to make this work for multiple processors
-    //!  Read length for the block; encoded as 0 if same as m_FileReadLength for this block
-    unsigned int m_BlockReadLength;
+    //!  Block index; filled in as blocks are encoded, or read from the end of the file when decoding
+    vector <QScoresIndexEntry> m_BlockIndex;
+    //!  Have the parameters in the first block's header been decoded?
+    bool m_FileHeaderDecoded;
+
     //!  Block size
     int m_Blocksize;
-    //!  Minimum for the current block
-    unsigned int m_BlockMinimum;
-    //!  Statistics for the current block
-    BlockStatistics m_BlockStatistics;
-    //!  Parameter to be used for some coding schemes
-    unsigned int m_CompressionParameter;
+    //!  Number of threads to use for encoding
+    unsigned int m_Threads;
+    //!  Maximum length of a Huffman codeword; 0 if there is no limit
+    unsigned int m_HuffmanMaxLen;
+    //!  Number of interleaved streams that each Huffman-coded block is split into
+    unsigned int m_HuffmanStreams;
+    //!  Maximum number of read position bins, each with its own Huffman code, that a block is split into
+    unsigned int m_HuffmanPositionBins;
+    //!  Code each quality score with a Huffman table chosen by the one before it?
+    bool m_HuffmanOrder1;
+    //!  Reuse the Huffman code of an earlier block when it is good enough?
+    bool m_HuffmanReuse;
+    //!  How much larger a block can be, in percent, when it reuses the Huffman code of an earlier block
+    unsigned int m_HuffmanReuseTolerance;
+    //!  Number of consecutive blocks in each run, whose blocks can only reuse a Huffman code of the same run
+    unsigned int m_HuffmanReuseRun;
+    //!  Number of interleaved states in each rANS-coded block
+    unsigned int m_RansStates;
+    //!  Order of PPM (the number of quality scores in its longest context)
+    unsigned int m_PPMOrder;
+    //!  Memory of PPM, in megabytes
+    unsigned int m_PPMMemory;
+    //!  Memory of Re-Pair, in megabytes
+    unsigned int m_RePairMemory;
+    //!  Compression level of Zstandard
+    unsigned int m_ZstdLevel;
+    //!  Use long-distance matching with Zstandard?
+    bool m_ZstdLong;
+    //!  File with the dictionary of Zstandard; empty if none was given
+    string m_ZstdDictionaryFn;
+    //!  Largest size of the dictionary of Zstandard trained from the first block, in bytes; 0 if none is trained
+    unsigned int m_ZstdTrainSize;
+    //!  Dictionary of Zstandard used for every block; kept in the first block's header
+    vector<char> m_ZstdDictionary;
+    //!  Decode only a range of reads?
+    bool m_ExtractReads;
+    //!  First read to decode (from 0)
+    unsigned long long m_ExtractFirst;
+    //!  One past the last read to decode
+    unsigned long long m_ExtractLast;
     //!  Second parameter to be used for some coding schemes
     unsigned int m_CompressionParameter_2;
 };
@@ -34,6 +34,7 @@
 #include <fstream>
 #include <cstdlib>
 #include <iomanip>  //  setw
+#include <algorithm>  //  min
 
 using namespace std;
 
@@ -79,49 +80,52 @@ bool QScores::Run() {
       cerr << "II\tEncoding data file..." << endl;
     }
 
-    while (true) {
-      //  Read in the block
-      int current_blocksize = ReadInFileBlock (m_Blocksize);      
-      if (current_blocksize == g_EOF_REACHED) {
-        if (!m_QScoresSettings.GetCompressionNone ()) {
-          EncodeEOF ();
-        }
-        
-        if (GetVerbose ()) {
-          cerr << "II\t" << block_count << " blocks created of at most " << m_Blocksize << " reads each." << endl;
+    if ((GetThreads () > 1) && (!m_QScoresSettings.GetCompressionNone ())) {
+      block_count = EncodeThreaded ();
+    }
+    else {
+      QScoresBlock block;
+
+      while (true) {
+        //  Read in the block
+        int current_blocksize = ReadInFileBlock (block, m_Blocksize);
+        if (current_blocksize == g_EOF_REACHED) {
+          break;
         }
-        break;
-      }
-      PreprocessBlock (current_blocksize);
 
-      if (m_QScoresSettings.GetCompressionNone ()) {
-        EncodeIntToQScore (current_blocksize);
-      }
-      else {
-        EncodeHeaderBlock (current_blocksize, block_count);
-        if ((m_QScoresSettings.GetCompressionBinary ()) ||
-            (m_QScoresSettings.GetCompressionGamma ()) ||
-            (m_QScoresSettings.GetCompressionDelta ()) ||
-            (m_QScoresSettings.GetCompressionGolomb () > 0) ||
-            (m_QScoresSettings.GetCompressionRice () > 0) ||
-            (m_QScoresSettings.GetCompressionInterP ())) {
-          EncodeStaticCodesBlock (current_blocksize);
+        //  The first block sets the parameters that are global to the entire file
+        if (block_count == 0) {
+          m_FileReadLength = block.read_length;
+          m_FileBlockSize = current_blocksize;
+          if (m_QScoresSettings.GetCompressionZstd ()) {
+            InitializeZstdDictionary (block, current_blocksize);
+          }
         }
-        else if (m_QScoresSettings.GetCompressionHuffman ()) {
-          EncodeHuffmanBlock (current_blocksize);
+
+        if (m_QScoresSettings.GetCompressionNone ()) {
+          PreprocessBlock (block, current_blocksize);
+          EncodeIntToQScore (block, current_blocksize);
+          WriteOutFileBlock (block);
         }
-        else if ((m_QScoresSettings.GetCompressionGzip ()) ||
-                 (m_QScoresSettings.GetCompressionBzip ()) ||
-                 (m_QScoresSettings.GetCompressionRepair ()) ||
-                 (m_QScoresSettings.GetCompressionPPM ())) {
-          EncodeExternalBlock (current_blocksize);
+        else {
+          if (m_QScoresSettings.GetBlockIndex ()) {
+            AddBlockIndexEntry (m_BitBuff_Out.GetBitPosition (), static_cast<unsigned int> (current_blocksize));
+          }
+          EncodeBlock (block, m_BitBuff_Out, m_ExternalSoftware, current_blocksize, block_count);
         }
+        block_count++;
       }
+    }
 
-      if (m_QScoresSettings.GetCompressionNone ()) {
-        WriteOutFileBlock ();
+    if (!m_QScoresSettings.GetCompressionNone ()) {
+      EncodeEOF ();
+      if (m_QScoresSettings.GetBlockIndex ()) {
+        WriteBlockIndex ();
       }
-      block_count++;
+    }
+
+    if (GetVerbose ()) {
+      cerr << "II\t" << block_count << " blocks created of at most " << m_Blocksize << " reads each." << endl;
     }
   }
   else {
@@ -130,39 +134,84 @@ bool QScores::Run() {
       cerr << "II\tDecoding data file..." << endl;
     }
     
-    int current_blocksize = g_EOF_REACHED;
-    while (1) {
-      //  Clear the vector of quality scores
-      m_Qscores.clear ();
-
-      current_blocksize = DecodeHeaderBlock (block_count);
-      if (current_blocksize == g_EOF_REACHED) {
-        if (GetVerbose ()) {
-          cerr << "II\t" << block_count << " blocks decoded." << endl;
-        }
-        break;
+    //  The block index is used to check the positions of the blocks and to decode them in parallel
+    if (m_QScoresSettings.GetBlockIndex ()) {
+      if (!ReadBlockIndex ()) {
+        return (false);
+      }
+    }
+    else if (GetExtractReads ()) {
+      cerr << "EE\tThe file does not have a block index (see --index), so reads cannot be extracted." << endl;
+      return (false);
+    }
+    else if (GetThreads () > 1) {
+      //  Blocks can only be decoded in parallel if their positions are known
+      cerr << "WW\tThe file does not have a block index (see --index); ignoring --threads." << endl;
+      SetThreads (1);
+    }
+
+    if (GetExtractReads ()) {
+      //  Extract the reads one block at a time, so that only one block is kept in memory
+      QScoresBlock block;
+      unsigned long long first = GetExtractFirst ();
+      if ((first < GetExtractLast ()) && (FindBlockIndexEntry (GetExtractLast () - 1) == m_BlockIndex.size ())) {
+        cerr << "EE\tThe reads " << first << ":" << GetExtractLast () << " are not within the file." << endl;
+        return (false);
       }
+      do {
+        unsigned long long last = GetExtractLast ();
+        unsigned int index_pos = FindBlockIndexEntry (first);
+        if (index_pos < m_BlockIndex.size ()) {
+          last = min (last, m_BlockIndex[index_pos].first_read + m_BlockIndex[index_pos].num_reads);
+        }
+
+        block.qscores.clear ();
+        if (!ExtractReads (first, last, block.qscores)) {
+          return (false);
+        }
+        WriteOutFileBlock (block);
+        if (first != last) {
+          block_count++;
+        }
+        first = last;
+      } while (first < GetExtractLast ());
 
-      if ((m_QScoresSettings.GetCompressionBinary ()) ||
-          (m_QScoresSettings.GetCompressionGamma ()) ||
-          (m_QScoresSettings.GetCompressionDelta ()) ||
-          (m_QScoresSettings.GetCompressionGolomb () > 0) ||
-          (m_QScoresSettings.GetCompressionRice () > 0) ||
-          (m_QScoresSettings.GetCompressionInterP ())) {          
-        DecodeStaticCodesBlock (current_blocksize);
+      if (GetVerbose ()) {
+        cerr << "II\t" << block_count << " blocks decoded." << endl;
       }
-      else if (m_QScoresSettings.GetCompressionHuffman ()) {
-        DecodeHuffmanBlock (current_blocksize);
+    }
+    else if (GetThreads () > 1) {
+      block_count = DecodeThreaded ();
+      if (GetVerbose ()) {
+        cerr << "II\t" << block_count << " blocks decoded." << endl;
       }
-      else if ((m_QScoresSettings.GetCompressionGzip ()) ||
-               (m_QScoresSettings.GetCompressionBzip ()) ||
-               (m_QScoresSettings.GetCompressionRepair ()) ||
-               (m_QScoresSettings.GetCompressionPPM ())) {
-        DecodeExternalBlock (current_blocksize);
+    }
+    else {
+      QScoresBlock block;
+      int current_blocksize = g_EOF_REACHED;
+      while (1) {
+        //  Clear the vector of quality scores
+        block.qscores.clear ();
+
+        if (m_QScoresSettings.GetBlockIndex ()) {
+          CheckBlockIndexEntry (block_count);
+        }
+        current_blocksize = DecodeHeaderBlock (block, m_BitBuff_In, block_count);
+        if (current_blocksize == g_EOF_REACHED) {
+          if ((m_QScoresSettings.GetBlockIndex ()) && (block_count != static_cast<int> (m_BlockIndex.size ()))) {
+            cerr << "EE\tThe number of blocks does not match the block index." << endl;
+            exit (EXIT_FAILURE);
+          }
+          if (GetVerbose ()) {
+            cerr << "II\t" << block_count << " blocks decoded." << endl;
+          }
+          break;
+        }
+
+        DecodeBlock (block, m_BitBuff_In, m_ExternalSoftware, current_blocksize);
+        WriteOutFileBlock (block);
+        block_count++;
       }
-      UnPreprocessBlock (current_blocksize);
-      WriteOutFileBlock ();
-      block_count++;
     }
   }
 
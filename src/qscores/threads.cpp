@@ -0,0 +1,470 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file threads.cpp
+    Encoding and decoding of blocks using more than one thread.
+*/
+/*******************************************************************/
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <utility>  //  swap
+#include <algorithm>  //  max, min
+#include <fstream>
+#include <iostream>
+#include <climits>  //  UINT_MAX
+#include <cstdlib>
+
+using namespace std;
+
+#include "common.hpp"
+#include "external-software.hpp"
+#include "block-statistics.hpp"
+#include "bitbuffer.hpp"
+#include "qscores-single-defn.hpp"
+#include "qscores-single.hpp"
+#include "qscores-settings.hpp"
+#include "qscores-local.hpp"
+#include "qscores-defn.hpp"
+#include "qscores.hpp"
+
+
+//!  The number of blocks per thread that can be read in but not yet written out
+const unsigned int g_BLOCKS_PER_THREAD = 2;
+
+
+/*!
+    \struct QScoresJob
+
+    \details A block that has been read in, together with the bits produced by encoding it.  When
+             decoding, only the block itself is used.
+*/
+struct QScoresJob {
+  //!  Block ID (from 0)
+  int block_count;
+  //!  The size of the block
+  int blocksize;
+  //!  The block itself
+  QScoresBlock block;
+  //!  The encoded block, which is kept in memory until it can be written out
+  BitBuffer bitbuff;
+};
+
+
+/*!
+    \struct QScoresPipeline
+
+    \details State shared by the reader (the main thread), the threads which encode blocks, and the thread
+             which writes the encoded blocks to m_BitBuff_Out in their original order.  When decoding,
+             the threads take the next run of blocks from the block index and the main thread writes
+             the decoded blocks out, so pending is not used.
+
+             Each run of consecutive blocks is coded by one thread, in order.  A run is a single block,
+             except with --huffman-reuse, where a block can reuse the Huffman code of an earlier block
+             of its run (see EncodeHuffmanBlock ()).
+*/
+struct QScoresPipeline {
+  //!  Protects all of the values below
+  mutex lock;
+  //!  Signalled when a block has been read in or the end of the input has been reached
+  condition_variable block_read;
+  //!  Signalled when a block has been encoded (or decoded) or the end of the input has been reached
+  condition_variable block_encoded;
+  //!  Signalled when a block has been written out
+  condition_variable block_written;
+  //!  Blocks waiting to be encoded, in the order that they were read
+  deque<QScoresJob*> pending;
+  //!  Blocks that have been encoded (or decoded) but not yet written out, indexed by their block ID
+  map<int, QScoresJob*> encoded;
+  //!  Number of blocks read in so far
+  int blocks_read;
+  //!  Number of blocks written out so far
+  int blocks_written;
+  //!  Has the end of the input been reached?
+  bool input_finished;
+  //!  Number of consecutive blocks in each run; not changed once the threads have started
+  int run;
+
+  QScoresPipeline ()
+    : pending (),
+      encoded (),
+      blocks_read (0),
+      blocks_written (0),
+      input_finished (false),
+      run (1)
+        {
+        }
+};
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Encode the input file using GetThreads () threads.  The main thread reads in the blocks, which are
+     encoded by the other threads to memory.  A separate thread then appends them to m_BitBuff_Out in
+     order, so that the output is identical to encoding with one thread.  Each run of blocks is encoded
+     by one thread in order, so the codes that --huffman-reuse can reuse do not depend on the threads.
+
+     Only GetThreads () * g_BLOCKS_PER_THREAD blocks (or GetThreads () runs, if that is more) are kept in
+     memory at any one time.
+
+     \return The number of blocks encoded
+*/
+int QScores::EncodeThreaded () {
+  QScoresPipeline pipeline;
+  vector<thread> workers;
+
+  if ((m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanReuse ())) {
+    pipeline.run = static_cast<int> (GetHuffmanReuseRun ());
+  }
+  int max_blocks = static_cast<int> (GetThreads ()) * max (static_cast<int> (g_BLOCKS_PER_THREAD), pipeline.run);
+
+  for (unsigned int i = 0; i < GetThreads (); i++) {
+    workers.push_back (thread (&QScores::EncodeThreadedWorker, this, ref (pipeline)));
+  }
+  thread writer (&QScores::EncodeThreadedWriter, this, ref (pipeline));
+
+  while (true) {
+    //  Wait until there is space for another block
+    {
+      unique_lock<mutex> guard (pipeline.lock);
+      while (pipeline.blocks_read - pipeline.blocks_written >= max_blocks) {
+        pipeline.block_written.wait (guard);
+      }
+    }
+
+    //  Read in the block
+    QScoresJob *job = new QScoresJob;
+    int current_blocksize = ReadInFileBlock (job -> block, m_Blocksize);
+    if (current_blocksize == g_EOF_REACHED) {
+      delete job;
+      break;
+    }
+    job -> block_count = pipeline.blocks_read;
+    job -> blocksize = current_blocksize;
+
+    //  The first block sets the parameters that are global to the entire file; no thread has
+    //  been given a block yet, so it is safe to change them here
+    if (job -> block_count == 0) {
+      m_FileReadLength = job -> block.read_length;
+      m_FileBlockSize = current_blocksize;
+      if (m_QScoresSettings.GetCompressionZstd ()) {
+        InitializeZstdDictionary (job -> block, current_blocksize);
+      }
+    }
+
+    //  Hand the block to the threads
+    {
+      unique_lock<mutex> guard (pipeline.lock);
+      pipeline.pending.push_back (job);
+      pipeline.blocks_read++;
+    }
+    //  Only the thread with the block's run (or any thread, for the first block of a run) can take it
+    pipeline.block_read.notify_all ();
+  }
+
+  //  Tell the threads that there are no more blocks and wait for them to finish
+  {
+    unique_lock<mutex> guard (pipeline.lock);
+    pipeline.input_finished = true;
+  }
+  pipeline.block_read.notify_all ();
+  pipeline.block_encoded.notify_all ();
+
+  for (unsigned int i = 0; i < workers.size (); i++) {
+    workers[i].join ();
+  }
+  writer.join ();
+
+  return (pipeline.blocks_read);
+}
+
+
+/*!
+     Decode the input file using GetThreads () threads and the block index.  Each thread has its own
+     BitBuffer on the input file and seeks to the blocks of the runs that it decodes, while the main
+     thread writes the decoded blocks out in order.
+
+     The first run is decoded by the main thread before the other threads are started, since its first
+     block holds the parameters that are global to the entire file.  Only GetThreads () *
+     g_BLOCKS_PER_THREAD blocks (or GetThreads () runs, if that is more) are kept in memory at any one
+     time.
+
+     \return The number of blocks decoded
+*/
+int QScores::DecodeThreaded () {
+  QScoresPipeline pipeline;
+  vector<thread> workers;
+  int num_blocks = static_cast<int> (m_BlockIndex.size ());
+
+  if (num_blocks == 0) {
+    return (0);
+  }
+
+  //  Decode the first run with m_BitBuff_In; the parameters of the file are known after its first block
+  QScoresBlock block;
+  int block_count = 0;
+  do {
+    block.qscores.clear ();
+    CheckBlockIndexEntry (block_count);
+    int current_blocksize = DecodeHeaderBlock (block, m_BitBuff_In, block_count);
+    if (current_blocksize == g_EOF_REACHED) {
+      cerr << "EE\tThe number of blocks does not match the block index." << endl;
+      exit (EXIT_FAILURE);
+    }
+    DecodeBlock (block, m_BitBuff_In, m_ExternalSoftware, current_blocksize);
+    WriteOutFileBlock (block);
+
+    if ((block_count == 0) && (m_QScoresSettings.GetCompressionHuffman ()) && (GetHuffmanReuse ())) {
+      pipeline.run = static_cast<int> (GetHuffmanReuseRun ());
+    }
+    block_count++;
+  } while ((block_count < pipeline.run) && (block_count < num_blocks));
+
+  pipeline.blocks_read = block_count;
+  pipeline.blocks_written = block_count;
+
+  for (unsigned int i = 0; i < GetThreads (); i++) {
+    workers.push_back (thread (&QScores::DecodeThreadedWorker, this, ref (pipeline)));
+  }
+
+  //  Write out the blocks in order
+  {
+    unique_lock<mutex> guard (pipeline.lock);
+
+    while (pipeline.blocks_written < num_blocks) {
+      map<int, QScoresJob*>::iterator iter = pipeline.encoded.find (pipeline.blocks_written);
+
+      //  The next block has not been decoded yet
+      if (iter == pipeline.encoded.end ()) {
+        pipeline.block_encoded.wait (guard);
+        continue;
+      }
+
+      QScoresJob *job = iter -> second;
+      pipeline.encoded.erase (iter);
+
+      guard.unlock ();
+      WriteOutFileBlock (job -> block);
+      delete job;
+      guard.lock ();
+
+      pipeline.blocks_written++;
+      pipeline.block_written.notify_all ();
+    }
+  }
+
+  for (unsigned int i = 0; i < workers.size (); i++) {
+    workers[i].join ();
+  }
+
+  return (num_blocks);
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+
+/*!
+     Thread which encodes blocks, each to its own BitBuffer in memory, taking all of the blocks of a run
+     in order.  Each thread has its own ExternalSoftware object; the remaining members of QScores are only read.
+
+     \param[in] pipeline State shared by all of the threads
+*/
+void QScores::EncodeThreadedWorker (QScoresPipeline &pipeline) {
+  ExternalSoftware external;
+  QScoresHuffmanCode huffman_code;  //  The last Huffman code sent in this thread's run (see --huffman-reuse)
+  int next_block = -1;  //  The next block of this thread's run; -1 if it has no run
+
+  InitializeExternalSoftware (external);
+
+  while (true) {
+    QScoresJob *job = NULL;
+
+    //  Take the next block of this thread's run, or else the first block of the earliest run that has not
+    //  been started; stop if there are none left
+    {
+      unique_lock<mutex> guard (pipeline.lock);
+      while (true) {
+        deque<QScoresJob*>::iterator iter = pipeline.pending.begin ();
+        while ((iter != pipeline.pending.end ()) &&
+               (((next_block == -1) && ((*iter) -> block_count % pipeline.run != 0)) ||
+                ((next_block != -1) && ((*iter) -> block_count != next_block)))) {
+          iter++;
+        }
+        if (iter != pipeline.pending.end ()) {
+          job = *iter;
+          pipeline.pending.erase (iter);
+          break;
+        }
+
+        if (pipeline.input_finished) {
+          //  The run was cut short by the end of the input
+          if (next_block == -1) {
+            break;
+          }
+          next_block = -1;
+          continue;
+        }
+        pipeline.block_read.wait (guard);
+      }
+    }
+    if (job == NULL) {
+      break;
+    }
+
+    next_block = job -> block_count + 1;
+    if (next_block % pipeline.run == 0) {
+      next_block = -1;
+    }
+
+    job -> bitbuff.InitializeMemory ();
+    swap (job -> block.huffman_code, huffman_code);
+    EncodeBlock (job -> block, job -> bitbuff, external, job -> blocksize, job -> block_count);
+    swap (job -> block.huffman_code, huffman_code);
+    job -> bitbuff.Finish ();
+
+    //  The quality scores are no longer needed
+    job -> block.qscores.clear ();
+
+    {
+      unique_lock<mutex> guard (pipeline.lock);
+      pipeline.encoded[job -> block_count] = job;
+    }
+    pipeline.block_encoded.notify_one ();
+  }
+
+  return;
+}
+
+
+/*!
+     Thread which appends the encoded blocks to m_BitBuff_Out in the order that they were read in.
+
+     \param[in] pipeline State shared by all of the threads
+*/
+void QScores::EncodeThreadedWriter (QScoresPipeline &pipeline) {
+  unique_lock<mutex> guard (pipeline.lock);
+
+  while (true) {
+    map<int, QScoresJob*>::iterator iter = pipeline.encoded.find (pipeline.blocks_written);
+
+    //  The next block has not been encoded yet
+    if (iter == pipeline.encoded.end ()) {
+      if ((pipeline.input_finished) && (pipeline.blocks_written == pipeline.blocks_read)) {
+        break;
+      }
+      pipeline.block_encoded.wait (guard);
+      continue;
+    }
+
+    QScoresJob *job = iter -> second;
+    pipeline.encoded.erase (iter);
+
+    guard.unlock ();
+    if (m_QScoresSettings.GetBlockIndex ()) {
+      AddBlockIndexEntry (m_BitBuff_Out.GetBitPosition (), static_cast<unsigned int> (job -> blocksize));
+    }
+    m_BitBuff_Out.AppendBits (job -> bitbuff.GetMemory (), job -> bitbuff.GetMemoryBits ());
+    delete job;
+    guard.lock ();
+
+    pipeline.blocks_written++;
+    pipeline.block_written.notify_one ();
+  }
+
+  return;
+}
+
+
+/*!
+     Thread which decodes blocks, a run at a time.  Each thread has its own BitBuffer on the input file
+     and its own ExternalSoftware object; the remaining members of QScores are only read.
+
+     \param[in] pipeline State shared by all of the threads
+*/
+void QScores::DecodeThreadedWorker (QScoresPipeline &pipeline) {
+  ExternalSoftware external;
+  BitBuffer bitbuff;
+  QScoresHuffmanCode huffman_code;  //  The last Huffman code read in this thread's run (see --huffman-reuse)
+  int num_blocks = static_cast<int> (m_BlockIndex.size ());
+  int max_blocks = static_cast<int> (GetThreads ()) * max (static_cast<int> (g_BLOCKS_PER_THREAD), pipeline.run);
+
+  InitializeExternalSoftware (external);
+  bitbuff.Initialize (m_QScoresSettings.GetInputFn (), e_MODE_MMAP);
+
+  while (true) {
+    int first_block = 0;
+    int last_block = 0;
+
+    //  Take the next run once there is space for it, or stop if there are none left
+    {
+      unique_lock<mutex> guard (pipeline.lock);
+      while ((pipeline.blocks_read < num_blocks) && (pipeline.blocks_read - pipeline.blocks_written >= max_blocks)) {
+        pipeline.block_written.wait (guard);
+      }
+      if (pipeline.blocks_read == num_blocks) {
+        break;
+      }
+      first_block = pipeline.blocks_read;
+      last_block = min (first_block + pipeline.run, num_blocks);
+      pipeline.blocks_read = last_block;
+    }
+
+    for (int block_count = first_block; block_count < last_block; block_count++) {
+      QScoresJob *job = new QScoresJob;
+      job -> block_count = block_count;
+
+      bitbuff.SeekBits (m_BlockIndex[block_count].bit_offset);
+      job -> blocksize = DecodeHeaderBlock (job -> block, bitbuff, block_count);
+      if (job -> blocksize == g_EOF_REACHED) {
+        cerr << "EE\tBlock " << block_count << " does not match the block index." << endl;
+        exit (EXIT_FAILURE);
+      }
+      swap (job -> block.huffman_code, huffman_code);
+      DecodeBlock (job -> block, bitbuff, external, job -> blocksize);
+      swap (job -> block.huffman_code, huffman_code);
+
+      {
+        unique_lock<mutex> guard (pipeline.lock);
+        pipeline.encoded[block_count] = job;
+      }
+      pipeline.block_encoded.notify_one ();
+    }
+  }
+
+  bitbuff.Finish ();
+
+  return;
+}
@@ -161,9 +161,10 @@ void QScores::PerformUnbinningCheck () {
      save one loop.  However, we've separated it into 5 loops to divide up the process and
      (hopefully) make this source code easier to read.
 
+     \param[in] block The block to transform
      \param[in] current_blocksize The size of the current block
 */
-void QScores::PreprocessBlock (int current_blocksize) {
+void QScores::PreprocessBlock (QScoresBlock &block, int current_blocksize) {
   vector<unsigned int> lossy_mapping;
   vector<unsigned int> lossless_mapping;
 
@@ -178,20 +179,20 @@ void QScores::PreprocessBlock (int current_blocksize) {
   //  Map quality scores to integers and then perform lossy transformations
   for (int i = 0; i < current_blocksize; i++) {
     //  Map quality scores to ASCII
-    m_Qscores[i].QScoreToInt ();
+    block.qscores[i].QScoreToInt ();
 
     //  Lossy transformations, order does not matter since they do not conflict
     if (m_QScoresSettings.GetLossyMinTruncation ()) {
-      m_Qscores[i].ApplyLossyMinTruncation (static_cast<unsigned int> (m_QScoresSettings.GetLossyMinTruncationParameter ()));
+      block.qscores[i].ApplyLossyMinTruncation (static_cast<unsigned int> (m_QScoresSettings.GetLossyMinTruncationParameter ()));
     }
     else if (m_QScoresSettings.GetLossyMaxTruncation ()) {
-      m_Qscores[i].ApplyLossyMaxTruncation (static_cast<unsigned int> (m_QScoresSettings.GetLossyMaxTruncationParameter ()));
+      block.qscores[i].ApplyLossyMaxTruncation (static_cast<unsigned int> (m_QScoresSettings.GetLossyMaxTruncationParameter ()));
     }
     else if (m_QScoresSettings.GetLossyLogBinning ()) {
-      m_Qscores[i].ApplyLossyRemapping (lossy_mapping);
+      block.qscores[i].ApplyLossyRemapping (lossy_mapping);
     }
     else if (m_QScoresSettings.GetLossyUniBinning ()) {
-      m_Qscores[i].ApplyLossyRemapping (lossy_mapping);
+      block.qscores[i].ApplyLossyRemapping (lossy_mapping);
     }
   }
 
@@ -199,47 +200,47 @@ void QScores::PreprocessBlock (int current_blocksize) {
   if (m_QScoresSettings.GetTransformGapTrans ()) {
     unsigned int previous = UINT_MAX;
     for (int i = 0; i < current_blocksize; i++) {
-      previous = m_Qscores[i].ApplyDifferenceCoding (previous);
+      previous = block.qscores[i].ApplyDifferenceCoding (previous);
     }
   }
 
   //  Lossless transformation -- need to find the minimum for rescaling
-  m_BlockMinimum = UINT_MAX;
+  block.minimum = UINT_MAX;
   if (m_QScoresSettings.GetTransformMinShift ()) {
     for (int i = 0; i < current_blocksize; i++) {
-      m_Qscores[i].SetMinMax ();
-      unsigned int tmp = m_Qscores[i].GetMin ();
-      if (tmp < m_BlockMinimum) {
-        m_BlockMinimum = tmp;
+      block.qscores[i].SetMinMax ();
+      unsigned int tmp = block.qscores[i].GetMin ();
+      if (tmp < block.minimum) {
+        block.minimum = tmp;
       }
     }
   }
 
   //  Lossless transformation -- perform rescaling
-  if ((m_QScoresSettings.GetTransformMinShift ()) && (m_BlockMinimum != 0)) {
+  if ((m_QScoresSettings.GetTransformMinShift ()) && (block.minimum != 0)) {
     for (int i = 0; i < current_blocksize; i++) {
-      m_Qscores[i].ApplyRescaling (m_BlockMinimum);
+      block.qscores[i].ApplyRescaling (block.minimum);
     }
   }
   
   //  Lossless transformation -- need to prepare to collect the statistics for remapping
   if (m_QScoresSettings.GetTransformFreqOrder ()) {
-    m_BlockStatistics.Initialize ();
+    block.statistics.Initialize ();
 
     for (int i = 0; i < current_blocksize; i++) {
-      m_BlockStatistics.UpdateFrequencyTable (m_Qscores[i].GetQScoreInt ());
+      block.statistics.UpdateFrequencyTable (block.qscores[i].GetQScoreInt ());
     }
-    lossless_mapping = m_BlockStatistics.GetQScoresToIDs ();
+    lossless_mapping = block.statistics.GetQScoresToIDs ();
   }
   
   //  Lossless transformation -- Perform remapping (if requested) and then finalize
   for (int i = 0; i < current_blocksize; i++) {
     if (m_QScoresSettings.GetTransformFreqOrder ()) {
-      m_Qscores[i].ApplyLosslessRemapping (lossless_mapping);
+      block.qscores[i].ApplyLosslessRemapping (lossless_mapping);
     }
 
     //  Finalize (required) -- shift by 1 to prevent a 0 from ever appearing beyond this point
-//     m_Qscores[i].ApplyFinalize ();
+//     block.qscores[i].ApplyFinalize ();
   }
   
   return;
@@ -249,9 +250,10 @@ void QScores::PreprocessBlock (int current_blocksize) {
 /*!
      Reverse the work done by PreprocessBlock ().
 
+     \param[in] block The block to transform
      \param[in] current_blocksize The size of the current block
 */
-void QScores::UnPreprocessBlock (int current_blocksize) {
+void QScores::UnPreprocessBlock (QScoresBlock &block, int current_blocksize) {
   vector<unsigned int> lossy_mapping;
   vector<unsigned int> lossless_remapping;
   unsigned int previous = UINT_MAX;
@@ -265,34 +267,34 @@ void QScores::UnPreprocessBlock (int current_blocksize) {
   }
   
   if (m_QScoresSettings.GetTransformFreqOrder ()) {
-    lossless_remapping = m_BlockStatistics.GetIDsToQScores ();
+    lossless_remapping = block.statistics.GetIDsToQScores ();
   }
   //  Reverse everything done by PreprocessBlock (), except for the lossy transformations
   for (int i = 0; i < current_blocksize; i++) {
-//     m_Qscores[i].UnapplyFinalize ();
+//     block.qscores[i].UnapplyFinalize ();
 
     if (m_QScoresSettings.GetTransformFreqOrder ()) {
-      m_Qscores[i].UnapplyLosslessRemapping (lossless_remapping);
+      block.qscores[i].UnapplyLosslessRemapping (lossless_remapping);
     }
     
-    if ((m_QScoresSettings.GetTransformMinShift ()) && (m_BlockMinimum != 0)) {
-      m_Qscores[i].UnapplyRescaling (m_BlockMinimum);
+    if ((m_QScoresSettings.GetTransformMinShift ()) && (block.minimum != 0)) {
+      block.qscores[i].UnapplyRescaling (block.minimum);
     }
 
     if (m_QScoresSettings.GetTransformGapTrans ()) {
-      previous = m_Qscores[i].UnapplyDifferenceCoding (previous);
+      previous = block.qscores[i].UnapplyDifferenceCoding (previous);
     }
 
     //  Lossy transformations
     if (m_QScoresSettings.GetLossyLogBinning ()) {
-      m_Qscores[i].UnapplyLossyRemapping (lossy_mapping);
+      block.qscores[i].UnapplyLossyRemapping (lossy_mapping);
     }
     else if (m_QScoresSettings.GetLossyUniBinning ()) {
-      m_Qscores[i].UnapplyLossyRemapping (lossy_mapping);
+      block.qscores[i].UnapplyLossyRemapping (lossy_mapping);
     }
 
     //  Map quality scores to ASCII
-    m_Qscores[i].IntToQScore ();
+    block.qscores[i].IntToQScore ();
   }
   
   return;
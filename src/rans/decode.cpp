@@ -0,0 +1,231 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file decode.cpp
+    Decoding functions for Rans class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <iostream>
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "interpolative.hpp"
+#include "rans.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+/*!
+     Decode the prelude and read the bytes of the rANS coder into memory in preparation for decoding.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Rans::DecodeBegin (BitBuffer &bitbuffer) {
+  DecodePrelude (bitbuffer);
+  SetCumulativeFrequencies ();
+  SetLookupTable ();
+  ReadBytes (bitbuffer);
+
+  return;
+}
+
+
+/*!
+     Decode a number of symbols and return them as a vector
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len The number of symbols to decode.
+     \return The decoded symbols
+*/
+vector<unsigned int> Rans::DecodeMessage (BitBuffer &bitbuffer, unsigned int len) {
+  vector<unsigned int> x;
+
+  DecodeMessage (bitbuffer, len, x);
+
+  return x;
+}
+
+
+/*!
+     Decode a number of symbols and append them to a vector.  The bytes of the rANS coder were read into
+     memory by DecodeBegin (), so the BitBuffer is not used.  Each symbol is decoded by the state after
+     the one which decoded the symbol before it.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len Length of the message to decode; can be less than m_MessageLength if we want to decode a piece at a time
+     \param[out] x The vector to append the message to
+*/
+void Rans::DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x) {
+  const RansEntry *lookup = m_Lookup.data ();
+  const unsigned char *bytes = m_Bytes.data ();
+  const size_t num_bytes = m_Bytes.size ();
+  const unsigned int bits = m_FrequencyBits;
+  const unsigned int slot_mask = (1U << bits) - 1;
+  const unsigned int mask = m_States - 1;
+  unsigned int *state = m_State.data ();
+  unsigned int s = m_StateNext;
+  size_t next = m_BytesNext;
+
+  //  Ensure we aren't decoding too much
+  if (m_MessageLengthDecoded + len > m_MessageLength) {
+    len = m_MessageLength - m_MessageLengthDecoded;
+  }
+
+  size_t start = x.size ();
+  x.resize (start + len);
+  unsigned int *out = x.data () + start;
+
+  for (unsigned int i = 0; i < len; i++) {
+    unsigned int value = state[s];
+    unsigned int slot = value & slot_mask;
+    const RansEntry &entry = lookup[slot];
+    value = (static_cast<unsigned int> (entry.frequency) * (value >> bits)) + slot - entry.start;
+    if (value < g_RANS_LOWER_BOUND) {
+      unsigned int word = (next + 1 < num_bytes) ? (bytes[next] | (bytes[next + 1] << g_CHAR_SIZE_BITS)) : 0;
+      value = (value << g_RANS_WORD_BITS) | word;
+      next += 2;
+    }
+    state[s] = value;
+    s = (s + 1) & mask;
+    out[i] = entry.symbol;
+  }
+
+  m_StateNext = s;
+  m_BytesNext = static_cast<unsigned int> (next);
+  m_MessageLengthDecoded += len;
+
+  return;
+}
+
+
+/*!
+     Finish decoding; check that the whole message was decoded.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Rans::DecodeFinish (BitBuffer &bitbuffer) {
+  if (m_MessageLengthDecoded != m_MessageLength) {
+    cerr << "WW\tOnly " << m_MessageLengthDecoded << " of the " << m_MessageLength << " rANS coded symbols were decoded." << endl;
+  }
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Decode the prelude written by EncodePrelude ().
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Rans::DecodePrelude (BitBuffer &bitbuffer) {
+  vector<unsigned int> tmp;
+  unsigned int sum = 0;
+
+  m_MessageLength = Delta_Decode (bitbuffer);
+  m_MaximumSymbol = Delta_Decode (bitbuffer);
+  m_DistinctSymbols = Delta_Decode (bitbuffer);
+  m_FrequencyBits = Delta_Decode (bitbuffer) - 1;
+  m_States = Delta_Decode (bitbuffer);
+  if ((m_FrequencyBits > g_RANS_FREQUENCY_BITS) || (m_States == 0) || (m_States > g_RANS_MAX_STATES) || ((m_States & (m_States - 1)) != 0)) {
+    cerr << "EE\tThe prelude of a rANS coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  const unsigned int total = (1U << m_FrequencyBits);
+
+  Interpolative_Decode (bitbuffer, tmp, m_DistinctSymbols);
+
+  m_Frequency.assign (m_MaximumSymbol + 1, 0);
+  for (unsigned int i = 0; i + 1 < tmp.size (); i++) {
+    m_Frequency[tmp[i]] = Delta_Decode (bitbuffer);
+    sum += m_Frequency[tmp[i]];
+  }
+  if ((tmp.empty ()) || (sum >= total)) {
+    cerr << "EE\tThe prelude of a rANS coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  m_Frequency[tmp.back ()] = total - sum;
+
+  return;
+}
+
+
+/*!
+     Set m_Lookup, which gives the entry for each value of the sum of the scaled frequencies.
+*/
+void Rans::SetLookupTable () {
+  m_Lookup.resize (1U << m_FrequencyBits);
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    for (unsigned int j = 0; j < m_Frequency[i]; j++) {
+      RansEntry &entry = m_Lookup[m_Cumulative[i] + j];
+      entry.symbol = i;
+      entry.frequency = static_cast<unsigned short> (m_Frequency[i]);
+      entry.start = static_cast<unsigned short> (m_Cumulative[i]);
+    }
+  }
+
+  return;
+}
+
+
+/*!
+     Read the bytes of the rANS coder, written by WriteBytes (), into memory and start each state from
+     them.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Rans::ReadBytes (BitBuffer &bitbuffer) {
+  unsigned int num_bytes = Delta_Decode (bitbuffer);
+  if (num_bytes < m_States * g_RANS_STATE_BYTES) {
+    cerr << "EE\tA rANS coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  m_Bytes.assign (num_bytes, 0);
+  bitbuffer.ExtractBits (reinterpret_cast<char*> (m_Bytes.data ()), static_cast<unsigned long long> (num_bytes) * g_CHAR_SIZE_BITS);
+
+  m_State.assign (m_States, 0);
+  m_StateNext = 0;
+  m_BytesNext = 0;
+  for (unsigned int j = 0; j < m_States; j++) {
+    for (unsigned int k = 0; k < g_RANS_STATE_BYTES; k++) {
+      m_State[j] |= static_cast<unsigned int> (m_Bytes[m_BytesNext]) << (k * g_CHAR_SIZE_BITS);
+      m_BytesNext++;
+    }
+  }
+
+  return;
+}
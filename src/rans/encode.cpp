@@ -0,0 +1,217 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file encode.cpp
+    Encoding functions for Rans class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <iostream>
+#include <algorithm>  //  reverse
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "interpolative.hpp"
+#include "rans.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+/*!
+     Scale the frequencies and write the prelude in preparation for encoding.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Rans::EncodeBegin (BitBuffer &bitbuffer) {
+  if (m_MessageLength == 0) {
+    cerr << "EE\trANS coding requires a message of at least one symbol." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  ScaleFrequencies ();
+  SetCumulativeFrequencies ();
+
+  if (GetDebug ()) {
+    for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+      if (m_Frequency[i] != 0) {
+        cerr << "\t[EncodeBegin]\t" << i << "\t" << m_Cumulative[i] << "\t" << m_Frequency[i] << endl;
+      }
+    }
+  }
+
+  EncodePrelude (bitbuffer);
+  m_Symbols.reserve (m_MessageLength);
+
+  return;
+}
+
+
+/*!
+     Encode a vector of symbols
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+*/
+void Rans::EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x) {
+  EncodeMessage (bitbuffer, x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Encode an array of symbols.  Since rANS encodes backwards, the symbols are only kept until
+     EncodeFinish (), so the BitBuffer is not used.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+     \param[in] len The number of symbols in x
+*/
+void Rans::EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
+    if ((x[i] >= m_Frequency.size ()) || (m_Frequency[x[i]] == 0)) {
+      cerr << "EE\tThe symbol " << x[i] << " was not counted before rANS encoding began." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+  m_Symbols.insert (m_Symbols.end (), x, x + len);
+
+  return;
+}
+
+
+/*!
+     Encode the symbols from the last one to the first, each with the state that the decoder will use
+     for it, and write the bytes to the BitBuffer.  The bytes are produced in the reverse of the order
+     in which the decoder reads them, so they are reversed before they are written.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Rans::EncodeFinish (BitBuffer &bitbuffer) {
+  const unsigned int *frequency = m_Frequency.data ();
+  const unsigned int *cumulative = m_Cumulative.data ();
+  const unsigned int bits = m_FrequencyBits;
+  const unsigned int mask = m_States - 1;
+  unsigned int state[g_RANS_MAX_STATES];
+
+  if (m_Symbols.size () != m_MessageLength) {
+    cerr << "EE\trANS encoding was given " << m_Symbols.size () << " symbols instead of the " << m_MessageLength << " that were counted." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  for (unsigned int j = 0; j < m_States; j++) {
+    state[j] = g_RANS_LOWER_BOUND;
+  }
+
+  //  Each symbol takes up to about 1.5 bytes when the frequencies have 12 bits
+  m_Bytes.clear ();
+  m_Bytes.reserve ((static_cast<size_t> (m_MessageLength) * 3 / 2) + (m_States * g_RANS_STATE_BYTES));
+  for (unsigned int i = m_MessageLength; i > 0; i--) {
+    unsigned int sym = m_Symbols[i - 1];
+    unsigned int &x = state[(i - 1) & mask];
+    unsigned long long x_max = (static_cast<unsigned long long> (g_RANS_LOWER_BOUND >> bits) << g_RANS_WORD_BITS) * frequency[sym];
+    if (x >= x_max) {
+      //  The word is reversed with the rest of the bytes, so its higher byte goes first
+      m_Bytes.push_back (static_cast<unsigned char> ((x >> g_CHAR_SIZE_BITS) & g_MASK_LOWER_BYTE));
+      m_Bytes.push_back (static_cast<unsigned char> (x & g_MASK_LOWER_BYTE));
+      x >>= g_RANS_WORD_BITS;
+    }
+    x = ((x / frequency[sym]) << bits) + (x % frequency[sym]) + cumulative[sym];
+  }
+
+  //  Flush the states so that the decoder reads the first state first, with its lowest byte first
+  for (unsigned int j = m_States; j > 0; j--) {
+    for (unsigned int k = g_RANS_STATE_BYTES; k > 0; k--) {
+      m_Bytes.push_back (static_cast<unsigned char> ((state[j - 1] >> ((k - 1) * g_CHAR_SIZE_BITS)) & g_MASK_LOWER_BYTE));
+    }
+  }
+  reverse (m_Bytes.begin (), m_Bytes.end ());
+
+  WriteBytes (bitbuffer);
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Encode the prelude:  the length of the message, the number of states, the symbols which appear in
+     it and their scaled frequencies.  The scaled frequency of the last symbol is not written since they
+     sum to 2 to the power of m_FrequencyBits.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Rans::EncodePrelude (BitBuffer &bitbuffer) {
+  vector<unsigned int> tmp;
+
+  Delta_Encode (bitbuffer, m_MessageLength);
+  Delta_Encode (bitbuffer, m_MaximumSymbol);
+  Delta_Encode (bitbuffer, m_DistinctSymbols);
+  Delta_Encode (bitbuffer, m_FrequencyBits + 1);
+  Delta_Encode (bitbuffer, m_States);
+
+  //  Encode the sub-alphabet (symbols that appear in this block)
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    if (m_Frequency[i] != 0) {
+      tmp.push_back (i);
+    }
+  }
+  Interpolative_Encode (bitbuffer, tmp);
+
+  //  Encode the scaled frequencies
+  for (unsigned int i = 0; i + 1 < tmp.size (); i++) {
+    Delta_Encode (bitbuffer, m_Frequency[tmp[i]]);
+  }
+
+  return;
+}
+
+
+/*!
+     Write the bytes of the rANS coder to the BitBuffer, after the number of them.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Rans::WriteBytes (BitBuffer &bitbuffer) {
+  if (m_Bytes.size () >= UINT_MAX) {
+    cerr << "EE\tA rANS coded message is too long; please use fewer symbols in each message." << endl;
+    exit (EXIT_FAILURE);
+  }
+  Delta_Encode (bitbuffer, static_cast<unsigned int> (m_Bytes.size ()));
+  bitbuffer.AppendBits (reinterpret_cast<const char*> (m_Bytes.data ()), static_cast<unsigned long long> (m_Bytes.size ()) * g_CHAR_SIZE_BITS);
+
+  return;
+}
@@ -0,0 +1,184 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+
+/*******************************************************************/
+/*!
+    \file process.cpp
+    Processing functions for Rans class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <iostream>
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "rans.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Public functions
+//  -----------------------------------------------------------------
+
+/*!
+     Update the frequency table using a vector of integers
+
+     \param[in] x The vector of integers to update the table with
+*/
+void Rans::UpdateFrequencies (const vector<unsigned int> &x) {
+  UpdateFrequencies (x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Update the frequency table using an array of integers
+
+     \param[in] x The integers to update the table with
+     \param[in] len The number of integers in x
+*/
+void Rans::UpdateFrequencies (const unsigned int *x, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
+    unsigned int pos = x[i];
+    if (pos >= m_Frequency.size ()) {
+      m_Frequency.resize (pos + 1, 0);
+    }
+    if (m_Frequency[pos] == 0) {
+      m_DistinctSymbols++;
+    }
+    m_Frequency[pos]++;
+  }
+
+  m_MessageLength += len;
+
+  return;
+}
+
+
+/*!
+     Add to the frequency of one symbol, e.g., from a histogram which has already been counted.
+
+     \param[in] symbol The symbol
+     \param[in] count The number of times that it appears
+*/
+void Rans::AddFrequency (unsigned int symbol, unsigned int count) {
+  if (count == 0) {
+    return;
+  }
+
+  if (symbol >= m_Frequency.size ()) {
+    m_Frequency.resize (symbol + 1, 0);
+  }
+  if (m_Frequency[symbol] == 0) {
+    m_DistinctSymbols++;
+  }
+  m_Frequency[symbol] += count;
+
+  m_MessageLength += count;
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Private functions
+//  -----------------------------------------------------------------
+
+/*!
+     Scale the frequencies so that they sum to 2 to the power of m_FrequencyBits, the fewest bits that
+     cover the length of the message (but at most g_RANS_FREQUENCY_BITS).  Each symbol which
+     appears keeps a frequency of at least 1; the difference from the total is given to (or, if needed,
+     taken from) the most frequent symbols.
+*/
+void Rans::ScaleFrequencies () {
+  unsigned int sum = 0;
+
+  if (m_DistinctSymbols > (1U << g_RANS_FREQUENCY_BITS)) {
+    cerr << "EE\trANS coding is limited to " << (1U << g_RANS_FREQUENCY_BITS) << " distinct symbols in each message." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  m_FrequencyBits = 0;
+  while ((m_FrequencyBits < g_RANS_FREQUENCY_BITS) && ((1U << m_FrequencyBits) < m_MessageLength)) {
+    m_FrequencyBits++;
+  }
+  const unsigned int total = (1U << m_FrequencyBits);
+
+  m_MaximumSymbol = static_cast<unsigned int> (m_Frequency.size ()) - 1;
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    if (m_Frequency[i] != 0) {
+      unsigned int scaled = static_cast<unsigned int> ((static_cast<unsigned long long> (m_Frequency[i]) * total) / m_MessageLength);
+      if (scaled == 0) {
+        scaled = 1;
+      }
+      m_Frequency[i] = scaled;
+      sum += scaled;
+    }
+  }
+
+  while (sum != total) {
+    unsigned int largest = 1;
+    for (unsigned int i = 2; i < m_Frequency.size (); i++) {
+      if (m_Frequency[i] > m_Frequency[largest]) {
+        largest = i;
+      }
+    }
+
+    if (sum < total) {
+      m_Frequency[largest] += total - sum;
+      sum = total;
+    }
+    else {
+      unsigned int excess = sum - total;
+      if (excess > m_Frequency[largest] / 2) {
+        excess = m_Frequency[largest] / 2;
+      }
+      m_Frequency[largest] -= excess;
+      sum -= excess;
+    }
+  }
+
+  return;
+}
+
+
+/*!
+     Set m_Cumulative from the scaled frequencies.
+*/
+void Rans::SetCumulativeFrequencies () {
+  unsigned int sum = 0;
+
+  m_Cumulative.assign (m_Frequency.size (), 0);
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    m_Cumulative[i] = sum;
+    sum += m_Frequency[i];
+  }
+
+  return;
+}
+
@@ -0,0 +1,164 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file rans.cpp
+    Constructor and destructor for Rans class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <iostream>
+#include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "rans.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Friends
+//  -----------------------------------------------------------------
+
+
+/*!
+     Overloaded << operator defined as a friend of Rans for debugging purposes.
+
+     \param[in] os Output stream
+     \param[in] rc Rans passed as reference
+     \return Output stream
+*/
+ostream &operator<< (ostream &os, const Rans& rc) {
+  os << "II\tRans:  " << rc.m_MessageLength << " symbols; " << rc.m_DistinctSymbols << " distinct; " << rc.m_States << " states; " << rc.m_Bytes.size () << " bytes";
+
+  return os;
+}
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Default constructor that takes one optional argument.
+
+     \param[in] debug Set to true if in debug mode; false by default
+*/
+Rans::Rans (bool debug)
+  : m_Debug (debug),
+    m_MessageLength (0),
+    m_MessageLengthDecoded (0),
+    m_MaximumSymbol (0),
+    m_DistinctSymbols (0),
+    m_FrequencyBits (0),
+    m_States (1),
+    m_Frequency (),
+    m_Cumulative (),
+    m_Lookup (),
+    m_Symbols (),
+    m_State (),
+    m_StateNext (0),
+    m_Bytes (),
+    m_BytesNext (0)
+{
+  //  Symbol 0 is never used
+  m_Frequency.push_back (0);
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+Rans::~Rans () {
+}
+
+
+//  -----------------------------------------------------------------
+//  Accessors and mutators
+//  -----------------------------------------------------------------
+
+/*!
+     Return m_Debug
+
+     \return Debug mode or not
+*/
+bool Rans::GetDebug () const {
+  return m_Debug;
+}
+
+
+/*!
+     Set m_Debug to true
+*/
+void Rans::SetDebug () {
+  m_Debug = true;
+}
+
+
+/*!
+     Return m_MessageLength
+
+     \return Length of the encoded message (same as "one/current" block)
+*/
+unsigned int Rans::GetMessageLength () const {
+  return m_MessageLength;
+}
+
+
+/*!
+     Return m_DistinctSymbols
+
+     \return Number of distinct symbols in the message (set by EncodeBegin () or DecodeBegin ())
+*/
+unsigned int Rans::GetDistinctSymbols () const {
+  return m_DistinctSymbols;
+}
+
+
+/*!
+     Return m_States
+
+     \return Number of interleaved states
+*/
+unsigned int Rans::GetStates () const {
+  return m_States;
+}
+
+
+/*!
+     Set m_States; it must be set before EncodeBegin () is called.  The decoder reads it from the prelude.
+
+     \param[in] x Number of interleaved states; a power of 2 which is at most g_RANS_MAX_STATES
+*/
+void Rans::SetStates (unsigned int x) {
+  if ((x == 0) || (x > g_RANS_MAX_STATES) || ((x & (x - 1)) != 0)) {
+    cerr << "EE\tThe number of rANS states must be a power of 2 from 1 to " << g_RANS_MAX_STATES << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  m_States = x;
+}
@@ -0,0 +1,380 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file rans.hpp
+    Header file for Rans class.
+*/
+/*******************************************************************/
+
+#ifndef RANS_HPP
+#define RANS_HPP
+
+/*!
+     Maximum number of bits in the total of the scaled frequencies; each symbol which appears is given
+     a frequency of at least 1 out of 2 to the power of this
+*/
+const unsigned int g_RANS_FREQUENCY_BITS = 12;
+
+/*!
+     Lower bound of each state; a state is renormalized (by writing or reading g_RANS_WORD_BITS bits) so
+     that it is always at least this
+*/
+const unsigned int g_RANS_LOWER_BOUND = (1U << 16);
+
+/*!
+     Number of bits written or read at a time to renormalize a state; since it is at least
+     g_RANS_FREQUENCY_BITS, a state never needs more than one of them for each symbol
+*/
+const unsigned int g_RANS_WORD_BITS = 16;
+
+/*!
+     Number of bytes used to flush each state
+*/
+const unsigned int g_RANS_STATE_BYTES = 4;
+
+/*!
+     Maximum number of interleaved states
+*/
+const unsigned int g_RANS_MAX_STATES = 32;
+
+/*!
+     Maximum number of bits in the number of states of Tans; the table for decoding then has at most
+     1024 entries of 4 bytes
+*/
+const unsigned int g_TANS_MAX_TABLE_BITS = 10;
+
+/*!
+     Minimum number of bits in the number of states of Tans
+*/
+const unsigned int g_TANS_MIN_TABLE_BITS = 5;
+
+/*!
+     Number of interleaved states of Tans
+*/
+const unsigned int g_TANS_STATES = 2;
+
+/*!
+     Number of bytes of 0's added after the bytes of Tans when decoding, so that 8 bytes can always be
+     read at once
+*/
+const unsigned int g_TANS_PADDING_BYTES = 8;
+
+/*!
+     Number of symbols which Tans decodes from each read of 8 bytes; each needs at most
+     g_TANS_MAX_TABLE_BITS bits, and at least 56 bits of the 8 bytes can be used
+*/
+const unsigned int g_TANS_SYMBOLS_PER_PEEK = 4;
+
+
+/*!
+    \struct RansEntry
+
+    \details An entry of the table used for decoding, which gives the symbol for a value of the sum of
+             the scaled frequencies, with the symbol's scaled frequency and the sum of the scaled
+             frequencies of the symbols before it.  It is 8 bytes, so the table for
+             g_RANS_FREQUENCY_BITS is 32 KB.
+*/
+struct RansEntry {
+  //!  Symbol
+  unsigned int symbol;
+  //!  Scaled frequency of the symbol
+  unsigned short frequency;
+  //!  Sum of the scaled frequencies of the symbols before it
+  unsigned short start;
+};
+
+
+/*!
+    \struct TansEntry
+
+    \details An entry of the table used by Tans for decoding, which gives the symbol for a state, the
+             number of bits to read and the state that they are added to.
+*/
+struct TansEntry {
+  //!  The state to add the bits read to
+  unsigned short new_state;
+  //!  Symbol
+  unsigned char symbol;
+  //!  Number of bits to read
+  unsigned char bits;
+};
+
+
+/*!
+    \struct TansTransform
+
+    \details How Tans encodes a symbol:  the number of bits written from a state is
+              (state + delta_bits) >> 16, and the next state is found at (state >> bits) + delta_state
+              in the table of states.
+*/
+struct TansTransform {
+  //!  Added to a state to find the number of bits to write in its upper 16 bits
+  unsigned int delta_bits;
+  //!  Added to the remaining upper bits of a state to find its place in the table of states
+  int delta_state;
+};
+
+
+/*!
+    \class Rans
+
+    \details Class used to represent range asymmetric numeral systems (rANS) coding with a static
+    model.  As with Arithmetic, the frequencies of the symbols are counted for the whole message and
+    scaled so that they sum to a power of 2, and a symbol can be coded in less than 1 bit.  Unlike
+    arithmetic coding, the state of the coder is a single 32-bit value, and decoding a symbol is a mask,
+    a lookup in a table of RansEntry's, a multiplication and an addition.  The state is renormalized
+    16 bits at a time, so that it stays at least g_RANS_LOWER_BOUND; since that is at most once for
+    each symbol, it is an if statement instead of a loop.  As with Huffman coding, we assume symbols are
+    1-based.
+
+    Several states (m_States; a power of 2 up to g_RANS_MAX_STATES) are interleaved:  the i-th symbol is
+    coded by state i mod m_States.  They share the same bytes, but since the states do not depend on
+    each other, the processor can decode one symbol while the last one is still being finished.
+
+    rANS decodes the symbols in the reverse of the order in which they were encoded.  So, the encoder
+    only keeps the symbols given to EncodeMessage () and encodes them backwards in EncodeFinish (); the
+    decoder can then decode them from the front.  The bytes are appended to the BitBuffer after their
+    number, and the decoder reads them into memory in DecodeBegin ().
+
+    See the test driver in testing.cpp for example usage.  For encoding, do the following:
+
+    1)  Initialize the BitBuffer.
+    2)  Create a Rans object and set the number of states with SetStates ().
+    3)  foreach vector, run UpdateFrequencies () (or AddFrequency () for each symbol) to accumulate the frequencies.
+    4)  Scale the frequencies and output the prelude using EncodeBegin ().
+    5)  foreach vector, run EncodeMessage ().
+    6)  Encode the symbols and write them using EncodeFinish ().
+
+    For decoding:
+
+    1)  Initialize the BitBuffer.
+    2)  Create a Rans object.
+    3)  Decode the prelude with DecodeBegin ().
+    4)  Decode a block of symbols using DecodeMessage ().
+    5)  Finalize using DecodeFinish ().
+*/
+class Rans {
+  //  Friend function to print out statistics for debugging  [rans.cpp]
+  friend ostream &operator<< (ostream &os, const Rans& rc);
+
+  public:
+    //  Constructors/destructors  [rans.cpp]
+    Rans (bool debug=false);
+    ~Rans ();
+    bool GetDebug () const;
+    void SetDebug ();
+    unsigned int GetMessageLength () const;
+    unsigned int GetDistinctSymbols () const;
+    unsigned int GetStates () const;
+    void SetStates (unsigned int x);
+
+    //  Encoding functions  [encode.cpp]
+    void EncodeBegin (BitBuffer &bitbuffer);
+    void EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x);
+    void EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len);
+    void EncodeFinish (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [decode.cpp]
+    void DecodeBegin (BitBuffer &bitbuffer);
+    vector<unsigned int> DecodeMessage (BitBuffer &bitbuffer, unsigned int len);
+    void DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x);
+    void DecodeFinish (BitBuffer &bitbuffer);
+
+    //  Main processing functions  [process.cpp]
+    void UpdateFrequencies (const vector<unsigned int> &x);
+    void UpdateFrequencies (const unsigned int *x, unsigned int len);
+    void AddFrequency (unsigned int symbol, unsigned int count);
+  private:
+    //  Encoding functions  [encode.cpp]
+    void EncodePrelude (BitBuffer &bitbuffer);
+    void WriteBytes (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [decode.cpp]
+    void DecodePrelude (BitBuffer &bitbuffer);
+    void SetLookupTable ();
+    void ReadBytes (BitBuffer &bitbuffer);
+
+    //  Main processing functions  [process.cpp]
+    void ScaleFrequencies ();
+    void SetCumulativeFrequencies ();
+
+    //!  Debug mode?
+    bool m_Debug;
+    //!  Length of the message (i.e., number of symbols to encode/decode)
+    unsigned int m_MessageLength;
+    //!  Length of the message already decoded (must be <= m_MessageLength); not used for encoding
+    unsigned int m_MessageLengthDecoded;
+    //!  Maximum possible symbol
+    unsigned int m_MaximumSymbol;
+    //!  Number of distinct values
+    unsigned int m_DistinctSymbols;
+    //!  Number of bits in the total of the scaled frequencies
+    unsigned int m_FrequencyBits;
+    //!  Number of interleaved states
+    unsigned int m_States;
+
+    //!  For each symbol, its frequency; after EncodeBegin () or DecodeBegin (), its scaled frequency
+    vector<unsigned int> m_Frequency;
+    //!  For each symbol, the sum of the scaled frequencies of the symbols before it
+    vector<unsigned int> m_Cumulative;
+    //!  For each value of the sum of scaled frequencies, its entry (set by DecodeBegin ())
+    vector<RansEntry> m_Lookup;
+
+    //!  The symbols given to EncodeMessage (); not used for decoding
+    vector<unsigned int> m_Symbols;
+    //!  The value of each state (only used for decoding)
+    vector<unsigned int> m_State;
+    //!  The state which decodes the next symbol (only used for decoding)
+    unsigned int m_StateNext;
+    //!  The bytes of the rANS coder
+    vector<unsigned char> m_Bytes;
+    //!  Position of the next byte of m_Bytes to read (only used for decoding)
+    unsigned int m_BytesNext;
+};
+
+
+/*!
+    \class Tans
+
+    \details Class used to represent table-based asymmetric numeral systems (tANS) coding with a
+    static model, in the style of Finite State Entropy.  As with Rans, the frequencies of the message
+    are scaled so that they sum to a power of 2 (m_TableBits), but here that is the number of states,
+    which are spread among the symbols in proportion to their frequencies.  Every transition is then
+    in a table:  decoding a symbol is a lookup of its TansEntry, a read of a few bits and an addition,
+    with no multiplication and no branches.  Encoding a symbol is a shift, a lookup in the table of
+    states and a write of a few bits.
+
+    The number of states is kept small (at most 2 to the power of g_TANS_MAX_TABLE_BITS; fewer for
+    short messages), since it is meant for the small alphabets which are left after quality scores are
+    remapped or binned; the table for decoding is then at most 4 KB.  Two states are interleaved, for
+    the even and odd symbols, so that the processor can work on both at once.  Symbols are 1-based and
+    at most g_MAX_ASCII.
+
+    As with Rans, the encoder keeps the symbols given to EncodeMessage () and encodes them backwards in
+    EncodeFinish ().  The bits of each symbol are written in the reverse order, so that the decoder
+    reads them forwards.  The bytes are appended to the BitBuffer after their number.
+
+    The functions are used in the same order as those of Rans.  After EncodeBegin (),
+    GetEstimatedBits () gives the number of bits that the message should take, without its prelude,
+    so that it can be compared with other codes.
+*/
+class Tans {
+  public:
+    //  Constructors/destructors  [tans.cpp]
+    Tans (bool debug=false);
+    ~Tans ();
+    bool GetDebug () const;
+    unsigned int GetMessageLength () const;
+    unsigned int GetDistinctSymbols () const;
+    unsigned int GetTableBits () const;
+    unsigned long long GetEstimatedBits () const;
+
+    //  Encoding functions  [tans.cpp]
+    void EncodeBegin (BitBuffer &bitbuffer);
+    void EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x);
+    void EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len);
+    void EncodeFinish (BitBuffer &bitbuffer);
+
+    //  Decoding functions  [tans.cpp]
+    void DecodeBegin (BitBuffer &bitbuffer);
+    vector<unsigned int> DecodeMessage (BitBuffer &bitbuffer, unsigned int len);
+    void DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x);
+    void DecodeFinish (BitBuffer &bitbuffer);
+
+    //  Main processing functions  [tans.cpp]
+    void UpdateFrequencies (const vector<unsigned int> &x);
+    void UpdateFrequencies (const unsigned int *x, unsigned int len);
+    void AddFrequency (unsigned int symbol, unsigned int count);
+  private:
+    void ScaleFrequencies ();
+    vector<unsigned char> SpreadSymbols () const;
+    void SetEncodingTables ();
+    void SetDecodingTable ();
+    void EncodePrelude (BitBuffer &bitbuffer);
+    void DecodePrelude (BitBuffer &bitbuffer);
+    unsigned long long PeekBits () const;
+
+    //!  Debug mode?
+    bool m_Debug;
+    //!  Length of the message (i.e., number of symbols to encode/decode)
+    unsigned int m_MessageLength;
+    //!  Length of the message already decoded (must be <= m_MessageLength); not used for encoding
+    unsigned int m_MessageLengthDecoded;
+    //!  Maximum possible symbol
+    unsigned int m_MaximumSymbol;
+    //!  Number of distinct values
+    unsigned int m_DistinctSymbols;
+    //!  Number of bits in the number of states
+    unsigned int m_TableBits;
+    //!  Number of bits that the message should take (set by EncodeBegin ())
+    unsigned long long m_EstimatedBits;
+
+    //!  For each symbol, its frequency; after EncodeBegin () or DecodeBegin (), its scaled frequency
+    vector<unsigned int> m_Frequency;
+    //!  For each symbol, how it is encoded (set by EncodeBegin ())
+    vector<TansTransform> m_Transform;
+    //!  The states, grouped by the symbol which leads to them (set by EncodeBegin ())
+    vector<unsigned short> m_NextState;
+    //!  For each state, its entry (set by DecodeBegin ())
+    vector<TansEntry> m_Lookup;
+
+    //!  The symbols given to EncodeMessage (); not used for decoding
+    vector<unsigned int> m_Symbols;
+    //!  The value of each state, less the number of states (only used for decoding)
+    unsigned int m_State[g_TANS_STATES];
+    //!  The state which decodes the next symbol (only used for decoding)
+    unsigned int m_StateNext;
+    //!  The bytes of the tANS coder; when decoding, followed by g_TANS_PADDING_BYTES 0's
+    vector<unsigned char> m_Bytes;
+    //!  Position of the next bit of m_Bytes to read (only used for decoding)
+    unsigned long long m_BitsNext;
+};
+
+
+//  -----------------------------------------------------------------
+//  Inline functions
+//  -----------------------------------------------------------------
+
+/*!
+     Return the bits of m_Bytes from m_BitsNext, starting from the lowest bit of each byte.  Eight bytes
+     are read at once, so at least 56 bits are returned; past the end of the bytes of the coder, the 0's
+     after them are read, so that there is no branch.  m_BitsNext is not changed.
+
+     \return The next bits, from the lowest bit
+*/
+inline unsigned long long Tans::PeekBits () const {
+  const unsigned char *bytes = m_Bytes.data ();
+  unsigned long long limit = m_Bytes.size () - g_TANS_PADDING_BYTES;
+  unsigned long long pos = m_BitsNext >> 3;
+  pos = (pos < limit) ? pos : limit;
+
+  unsigned long long word = 0;
+  for (unsigned int k = 0; k < g_TANS_PADDING_BYTES; k++) {
+    word |= static_cast<unsigned long long> (bytes[pos + k]) << (k * g_CHAR_SIZE_BITS);
+  }
+
+  return (word >> (m_BitsNext & 7));
+}
+
+#endif
@@ -0,0 +1,691 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file tans.cpp
+    Member functions for Tans class definition .
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <climits>  //  UINT_MAX
+#include <cmath>  //  log2
+#include <iostream>
+#include <cstdlib>  //  exit
+
+using namespace std;
+
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "bitio-defn.hpp"
+#include "interpolative.hpp"
+#include "rans.hpp"
+
+
+//  -----------------------------------------------------------------
+//  Constructors and destructors
+//  -----------------------------------------------------------------
+
+
+/*!
+     Default constructor that takes one optional argument.
+
+     \param[in] debug Set to true if in debug mode; false by default
+*/
+Tans::Tans (bool debug)
+  : m_Debug (debug),
+    m_MessageLength (0),
+    m_MessageLengthDecoded (0),
+    m_MaximumSymbol (0),
+    m_DistinctSymbols (0),
+    m_TableBits (0),
+    m_EstimatedBits (0),
+    m_Frequency (),
+    m_Transform (),
+    m_NextState (),
+    m_Lookup (),
+    m_Symbols (),
+    m_StateNext (0),
+    m_Bytes (),
+    m_BitsNext (0)
+{
+  //  Symbol 0 is never used
+  m_Frequency.push_back (0);
+
+  for (unsigned int j = 0; j < g_TANS_STATES; j++) {
+    m_State[j] = 0;
+  }
+}
+
+
+/*!
+     Destructor that takes no arguments
+*/
+Tans::~Tans () {
+}
+
+
+//  -----------------------------------------------------------------
+//  Accessors
+//  -----------------------------------------------------------------
+
+/*!
+     Return m_Debug
+
+     \return Debug mode or not
+*/
+bool Tans::GetDebug () const {
+  return m_Debug;
+}
+
+
+/*!
+     Return m_MessageLength
+
+     \return Length of the encoded message (same as "one/current" block)
+*/
+unsigned int Tans::GetMessageLength () const {
+  return m_MessageLength;
+}
+
+
+/*!
+     Return m_DistinctSymbols
+
+     \return Number of distinct symbols in the message
+*/
+unsigned int Tans::GetDistinctSymbols () const {
+  return m_DistinctSymbols;
+}
+
+
+/*!
+     Return m_TableBits
+
+     \return Number of bits in the number of states (set by EncodeBegin () or DecodeBegin ())
+*/
+unsigned int Tans::GetTableBits () const {
+  return m_TableBits;
+}
+
+
+/*!
+     Return m_EstimatedBits
+
+     \return Number of bits that the message should take after the prelude (set by EncodeBegin ())
+*/
+unsigned long long Tans::GetEstimatedBits () const {
+  return m_EstimatedBits;
+}
+
+
+//  -----------------------------------------------------------------
+//  Main processing functions
+//  -----------------------------------------------------------------
+
+/*!
+     Update the frequency table using a vector of integers
+
+     \param[in] x The vector of integers to update the table with
+*/
+void Tans::UpdateFrequencies (const vector<unsigned int> &x) {
+  UpdateFrequencies (x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Update the frequency table using an array of integers
+
+     \param[in] x The integers to update the table with
+     \param[in] len The number of integers in x
+*/
+void Tans::UpdateFrequencies (const unsigned int *x, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
+    AddFrequency (x[i], 1);
+  }
+
+  return;
+}
+
+
+/*!
+     Add to the frequency of one symbol, e.g., from a histogram which has already been counted.
+
+     \param[in] symbol The symbol
+     \param[in] count The number of times that it appears
+*/
+void Tans::AddFrequency (unsigned int symbol, unsigned int count) {
+  if (count == 0) {
+    return;
+  }
+
+  if ((symbol == 0) || (symbol > g_MAX_ASCII)) {
+    cerr << "EE\tThe symbol " << symbol << " cannot be coded by tANS coding, which is limited to symbols from 1 to " << g_MAX_ASCII << "." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (symbol >= m_Frequency.size ()) {
+    m_Frequency.resize (symbol + 1, 0);
+  }
+  if (m_Frequency[symbol] == 0) {
+    m_DistinctSymbols++;
+  }
+  m_Frequency[symbol] += count;
+
+  m_MessageLength += count;
+
+  return;
+}
+
+
+/*!
+     Scale the frequencies so that they sum to the number of states, 2 to the power of m_TableBits.  This
+     is the fewest bits that cover the length of the message and the number of distinct symbols, but at
+     least g_TANS_MIN_TABLE_BITS and at most g_TANS_MAX_TABLE_BITS.  Each symbol which appears keeps a
+     frequency of at least 1; the difference from the total is given to (or, if needed, taken from) the
+     most frequent symbols.
+*/
+void Tans::ScaleFrequencies () {
+  unsigned int sum = 0;
+
+  if (m_DistinctSymbols > (1U << g_TANS_MAX_TABLE_BITS)) {
+    cerr << "EE\ttANS coding is limited to " << (1U << g_TANS_MAX_TABLE_BITS) << " distinct symbols in each message." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  m_TableBits = g_TANS_MIN_TABLE_BITS;
+  while ((m_TableBits < g_TANS_MAX_TABLE_BITS) && (((1U << m_TableBits) < m_MessageLength) || ((1U << m_TableBits) < m_DistinctSymbols))) {
+    m_TableBits++;
+  }
+  const unsigned int total = (1U << m_TableBits);
+
+  m_MaximumSymbol = static_cast<unsigned int> (m_Frequency.size ()) - 1;
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    if (m_Frequency[i] != 0) {
+      unsigned int scaled = static_cast<unsigned int> ((static_cast<unsigned long long> (m_Frequency[i]) * total) / m_MessageLength);
+      if (scaled == 0) {
+        scaled = 1;
+      }
+      m_Frequency[i] = scaled;
+      sum += scaled;
+    }
+  }
+
+  while (sum != total) {
+    unsigned int largest = 1;
+    for (unsigned int i = 2; i < m_Frequency.size (); i++) {
+      if (m_Frequency[i] > m_Frequency[largest]) {
+        largest = i;
+      }
+    }
+
+    if (sum < total) {
+      m_Frequency[largest] += total - sum;
+      sum = total;
+    }
+    else {
+      unsigned int excess = sum - total;
+      if (excess > m_Frequency[largest] / 2) {
+        excess = m_Frequency[largest] / 2;
+      }
+      m_Frequency[largest] -= excess;
+      sum -= excess;
+    }
+  }
+
+  return;
+}
+
+
+/*!
+     Spread the symbols among the states, each as many times as its scaled frequency.  A symbol's states
+     are placed a fixed (odd) step apart, so that they are scattered over all of the states; this is how
+     Finite State Entropy spreads them.
+
+     \return The symbol of each state
+*/
+vector<unsigned char> Tans::SpreadSymbols () const {
+  const unsigned int total = (1U << m_TableBits);
+  const unsigned int mask = total - 1;
+  const unsigned int step = (total >> 1) + (total >> 3) + 3;
+  vector<unsigned char> spread (total, 0);
+  unsigned int pos = 0;
+
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    for (unsigned int j = 0; j < m_Frequency[i]; j++) {
+      spread[pos] = static_cast<unsigned char> (i);
+      pos = (pos + step) & mask;
+    }
+  }
+
+  return spread;
+}
+
+
+/*!
+     Set m_NextState and m_Transform from the scaled frequencies.  A symbol with scaled frequency f is
+     encoded from a state (from 2 to the power of m_TableBits to twice that) by writing bits from it until
+     it is from f to 2f; that is then used to find the next state among the f states of the symbol.
+*/
+void Tans::SetEncodingTables () {
+  const unsigned int total = (1U << m_TableBits);
+  vector<unsigned char> spread = SpreadSymbols ();
+  vector<unsigned int> start (m_Frequency.size (), 0);
+  vector<unsigned int> seen (m_Frequency.size (), 0);
+  unsigned int sum = 0;
+
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    start[i] = sum;
+    sum += m_Frequency[i];
+  }
+
+  m_NextState.assign (total, 0);
+  for (unsigned int u = 0; u < total; u++) {
+    unsigned int sym = spread[u];
+    m_NextState[start[sym] + seen[sym]] = static_cast<unsigned short> (total + u);
+    seen[sym]++;
+  }
+
+  m_Transform.assign (m_Frequency.size (), TansTransform ());
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    unsigned int f = m_Frequency[i];
+    if (f == 0) {
+      continue;
+    }
+
+    //  The most bits which are written for the symbol; one fewer are written from the lower states
+    unsigned int max_bits = m_TableBits;
+    for (unsigned int k = f - 1; k > 1; k >>= 1) {
+      max_bits--;
+    }
+    m_Transform[i].delta_bits = (max_bits << 16) - (f << max_bits);
+    m_Transform[i].delta_state = static_cast<int> (start[i]) - static_cast<int> (f);
+  }
+
+  return;
+}
+
+
+/*!
+     Set m_Lookup from the scaled frequencies.  The states of a symbol with scaled frequency f are
+     numbered from f to 2f - 1 in order; each is followed by the number of bits which bring it back up to
+     the number of states.
+*/
+void Tans::SetDecodingTable () {
+  const unsigned int total = (1U << m_TableBits);
+  vector<unsigned char> spread = SpreadSymbols ();
+  vector<unsigned int> next (m_Frequency);
+
+  m_Lookup.assign (total, TansEntry ());
+  for (unsigned int u = 0; u < total; u++) {
+    unsigned int sym = spread[u];
+    unsigned int x = next[sym];
+    next[sym]++;
+
+    unsigned int bits = m_TableBits;
+    for (unsigned int k = x; k > 1; k >>= 1) {
+      bits--;
+    }
+    m_Lookup[u].symbol = static_cast<unsigned char> (sym);
+    m_Lookup[u].bits = static_cast<unsigned char> (bits);
+    m_Lookup[u].new_state = static_cast<unsigned short> ((x << bits) - total);
+  }
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Encoding functions
+//  -----------------------------------------------------------------
+
+/*!
+     Scale the frequencies, set the tables and write the prelude in preparation for encoding.  The
+     number of bits that the message should take is estimated from the frequencies before and after
+     they are scaled.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Tans::EncodeBegin (BitBuffer &bitbuffer) {
+  if (m_MessageLength == 0) {
+    cerr << "EE\ttANS coding requires a message of at least one symbol." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  vector<unsigned int> counts (m_Frequency);
+  ScaleFrequencies ();
+  SetEncodingTables ();
+
+  double bits = g_TANS_STATES * m_TableBits;
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    if (counts[i] != 0) {
+      bits += counts[i] * (m_TableBits - log2 (static_cast<double> (m_Frequency[i])));
+    }
+  }
+  m_EstimatedBits = static_cast<unsigned long long> (bits + 0.5);
+
+  if (GetDebug ()) {
+    for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+      if (m_Frequency[i] != 0) {
+        cerr << "\t[EncodeBegin]\t" << i << "\t" << counts[i] << "\t" << m_Frequency[i] << endl;
+      }
+    }
+  }
+
+  EncodePrelude (bitbuffer);
+  m_Symbols.reserve (m_MessageLength);
+
+  return;
+}
+
+
+/*!
+     Encode a vector of symbols
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+*/
+void Tans::EncodeMessage (BitBuffer &bitbuffer, const vector<unsigned int> &x) {
+  EncodeMessage (bitbuffer, x.data (), static_cast<unsigned int> (x.size ()));
+
+  return;
+}
+
+
+/*!
+     Encode an array of symbols.  Since tANS encodes backwards, the symbols are only kept until
+     EncodeFinish (), so the BitBuffer is not used.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+     \param[in] x The symbols to encode.
+     \param[in] len The number of symbols in x
+*/
+void Tans::EncodeMessage (BitBuffer &bitbuffer, const unsigned int *x, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
+    if ((x[i] >= m_Frequency.size ()) || (m_Frequency[x[i]] == 0)) {
+      cerr << "EE\tThe symbol " << x[i] << " was not counted before tANS encoding began." << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+  m_Symbols.insert (m_Symbols.end (), x, x + len);
+
+  return;
+}
+
+
+/*!
+     Encode the symbols from the last one to the first, each with the state that the decoder will use
+     for it, and write the bytes to the BitBuffer.  The bits written for each symbol (and, at the end,
+     for each state) are kept and then packed in the reverse order, so that the decoder reads the states
+     first and then the bits of the symbols in order.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Tans::EncodeFinish (BitBuffer &bitbuffer) {
+  const unsigned int total = (1U << m_TableBits);
+  const TansTransform *transform = m_Transform.data ();
+  const unsigned short *next_state = m_NextState.data ();
+  unsigned int state[g_TANS_STATES];
+  vector<unsigned short> values;
+  vector<unsigned char> lengths;
+
+  if (m_Symbols.size () != m_MessageLength) {
+    cerr << "EE\ttANS encoding was given " << m_Symbols.size () << " symbols instead of the " << m_MessageLength << " that were counted." << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  for (unsigned int j = 0; j < g_TANS_STATES; j++) {
+    state[j] = total;
+  }
+
+  values.reserve (m_MessageLength + g_TANS_STATES);
+  lengths.reserve (m_MessageLength + g_TANS_STATES);
+  for (unsigned int i = m_MessageLength; i > 0; i--) {
+    const TansTransform &t = transform[m_Symbols[i - 1]];
+    unsigned int &x = state[(i - 1) % g_TANS_STATES];
+    unsigned int bits = (x + t.delta_bits) >> 16;
+    values.push_back (static_cast<unsigned short> (x & ((1U << bits) - 1)));
+    lengths.push_back (static_cast<unsigned char> (bits));
+    x = next_state[static_cast<int> (x >> bits) + t.delta_state];
+  }
+  for (unsigned int j = g_TANS_STATES; j > 0; j--) {
+    values.push_back (static_cast<unsigned short> (state[j - 1] - total));
+    lengths.push_back (static_cast<unsigned char> (m_TableBits));
+  }
+
+  //  Pack the bits from the lowest bit of each byte
+  unsigned long long buffer = 0;
+  unsigned int used = 0;
+  m_Bytes.clear ();
+  for (size_t i = values.size (); i > 0; i--) {
+    buffer |= static_cast<unsigned long long> (values[i - 1]) << used;
+    used += lengths[i - 1];
+    while (used >= g_CHAR_SIZE_BITS) {
+      m_Bytes.push_back (static_cast<unsigned char> (buffer & g_MASK_LOWER_BYTE));
+      buffer >>= g_CHAR_SIZE_BITS;
+      used -= g_CHAR_SIZE_BITS;
+    }
+  }
+  if (used > 0) {
+    m_Bytes.push_back (static_cast<unsigned char> (buffer & g_MASK_LOWER_BYTE));
+  }
+
+  if (m_Bytes.size () >= UINT_MAX) {
+    cerr << "EE\tA tANS coded message is too long; please use fewer symbols in each message." << endl;
+    exit (EXIT_FAILURE);
+  }
+  Delta_Encode (bitbuffer, static_cast<unsigned int> (m_Bytes.size ()));
+  bitbuffer.AppendBits (reinterpret_cast<const char*> (m_Bytes.data ()), static_cast<unsigned long long> (m_Bytes.size ()) * g_CHAR_SIZE_BITS);
+
+  return;
+}
+
+
+/*!
+     Encode the prelude:  the length of the message, the symbols which appear in it and their scaled
+     frequencies.  The scaled frequency of the last symbol is not written since they sum to 2 to the
+     power of m_TableBits.
+
+     \param[in] bitbuffer The bitbuffer to write the bits to.
+*/
+void Tans::EncodePrelude (BitBuffer &bitbuffer) {
+  vector<unsigned int> tmp;
+
+  Delta_Encode (bitbuffer, m_MessageLength);
+  Delta_Encode (bitbuffer, m_MaximumSymbol);
+  Delta_Encode (bitbuffer, m_DistinctSymbols);
+  Delta_Encode (bitbuffer, m_TableBits);
+
+  //  Encode the sub-alphabet (symbols that appear in this block)
+  for (unsigned int i = 1; i < m_Frequency.size (); i++) {
+    if (m_Frequency[i] != 0) {
+      tmp.push_back (i);
+    }
+  }
+  Interpolative_Encode (bitbuffer, tmp);
+
+  //  Encode the scaled frequencies
+  for (unsigned int i = 0; i + 1 < tmp.size (); i++) {
+    Delta_Encode (bitbuffer, m_Frequency[tmp[i]]);
+  }
+
+  return;
+}
+
+
+//  -----------------------------------------------------------------
+//  Decoding functions
+//  -----------------------------------------------------------------
+
+/*!
+     Decode the prelude, set the table and read the bytes of the tANS coder into memory in preparation
+     for decoding.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Tans::DecodeBegin (BitBuffer &bitbuffer) {
+  DecodePrelude (bitbuffer);
+  SetDecodingTable ();
+
+  unsigned int num_bytes = Delta_Decode (bitbuffer);
+  m_Bytes.assign (static_cast<size_t> (num_bytes) + g_TANS_PADDING_BYTES, 0);
+  bitbuffer.ExtractBits (reinterpret_cast<char*> (m_Bytes.data ()), static_cast<unsigned long long> (num_bytes) * g_CHAR_SIZE_BITS);
+
+  m_BitsNext = 0;
+  m_StateNext = 0;
+  for (unsigned int j = 0; j < g_TANS_STATES; j++) {
+    m_State[j] = static_cast<unsigned int> (PeekBits ()) & ((1U << m_TableBits) - 1);
+    m_BitsNext += m_TableBits;
+  }
+
+  return;
+}
+
+
+/*!
+     Decode a number of symbols and return them as a vector
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len The number of symbols to decode.
+     \return The decoded symbols
+*/
+vector<unsigned int> Tans::DecodeMessage (BitBuffer &bitbuffer, unsigned int len) {
+  vector<unsigned int> x;
+
+  DecodeMessage (bitbuffer, len, x);
+
+  return x;
+}
+
+
+/*!
+     Decode a number of symbols and append them to a vector.  The bytes of the tANS coder were read into
+     memory by DecodeBegin (), so the BitBuffer is not used.  The states take turns decoding the symbols.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+     \param[in] len Length of the message to decode; can be less than m_MessageLength if we want to decode a piece at a time
+     \param[out] x The vector to append the message to
+*/
+void Tans::DecodeMessage (BitBuffer &bitbuffer, unsigned int len, vector<unsigned int> &x) {
+  const TansEntry *lookup = m_Lookup.data ();
+
+  //  Ensure we aren't decoding too much
+  if (m_MessageLengthDecoded + len > m_MessageLength) {
+    len = m_MessageLength - m_MessageLengthDecoded;
+  }
+
+  size_t start = x.size ();
+  x.resize (start + len);
+  unsigned int *out = x.data () + start;
+
+  //  The states are kept in local variables, since the compiler cannot keep m_State in registers while
+  //  writing to out
+  unsigned int state[g_TANS_STATES];
+  for (unsigned int j = 0; j < g_TANS_STATES; j++) {
+    state[j] = m_State[(m_StateNext + j) % g_TANS_STATES];
+  }
+
+  //  Each read of m_Bytes has the bits of g_TANS_SYMBOLS_PER_PEEK symbols
+  unsigned int i = 0;
+  for (; i + g_TANS_SYMBOLS_PER_PEEK <= len; i += g_TANS_SYMBOLS_PER_PEEK) {
+    unsigned long long bits = PeekBits ();
+    unsigned int used = 0;
+    for (unsigned int j = 0; j < g_TANS_SYMBOLS_PER_PEEK; j++) {
+      unsigned int &st = state[j % g_TANS_STATES];
+      const TansEntry entry = lookup[st];
+      out[i + j] = entry.symbol;
+      st = entry.new_state + (static_cast<unsigned int> (bits >> used) & ((1U << entry.bits) - 1));
+      used += entry.bits;
+    }
+    m_BitsNext += used;
+  }
+  for (unsigned int j = 0; i < len; i++, j++) {
+    unsigned int &st = state[j % g_TANS_STATES];
+    const TansEntry entry = lookup[st];
+    out[i] = entry.symbol;
+    st = entry.new_state + (static_cast<unsigned int> (PeekBits ()) & ((1U << entry.bits) - 1));
+    m_BitsNext += entry.bits;
+  }
+
+  //  Put the states back so that the next state to use is first
+  for (unsigned int j = 0; j < g_TANS_STATES; j++) {
+    m_State[(m_StateNext + j) % g_TANS_STATES] = state[j];
+  }
+  m_StateNext = (m_StateNext + len) % g_TANS_STATES;
+  m_MessageLengthDecoded += len;
+
+  return;
+}
+
+
+/*!
+     Finish decoding; check that the whole message was decoded.
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Tans::DecodeFinish (BitBuffer &bitbuffer) {
+  if (m_MessageLengthDecoded != m_MessageLength) {
+    cerr << "WW\tOnly " << m_MessageLengthDecoded << " of the " << m_MessageLength << " tANS coded symbols were decoded." << endl;
+  }
+
+  return;
+}
+
+
+/*!
+     Decode the prelude written by EncodePrelude ().
+
+     \param[in] bitbuffer The bitbuffer to read the bits from.
+*/
+void Tans::DecodePrelude (BitBuffer &bitbuffer) {
+  vector<unsigned int> tmp;
+  unsigned int sum = 0;
+
+  m_MessageLength = Delta_Decode (bitbuffer);
+  m_MaximumSymbol = Delta_Decode (bitbuffer);
+  m_DistinctSymbols = Delta_Decode (bitbuffer);
+  m_TableBits = Delta_Decode (bitbuffer);
+  if ((m_TableBits < g_TANS_MIN_TABLE_BITS) || (m_TableBits > g_TANS_MAX_TABLE_BITS) || (m_MaximumSymbol > g_MAX_ASCII)) {
+    cerr << "EE\tThe prelude of a tANS coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  const unsigned int total = (1U << m_TableBits);
+
+  Interpolative_Decode (bitbuffer, tmp, m_DistinctSymbols);
+
+  m_Frequency.assign (m_MaximumSymbol + 1, 0);
+  for (unsigned int i = 0; i + 1 < tmp.size (); i++) {
+    m_Frequency[tmp[i]] = Delta_Decode (bitbuffer);
+    sum += m_Frequency[tmp[i]];
+  }
+  if ((tmp.empty ()) || (sum >= total)) {
+    cerr << "EE\tThe prelude of a tANS coded message is corrupt." << endl;
+    exit (EXIT_FAILURE);
+  }
+  m_Frequency[tmp.back ()] = total - sum;
+
+  return;
+}
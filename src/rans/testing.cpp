@@ -0,0 +1,487 @@
+//  ###########################################################################
+//  Copyright 2011-2015, 2024 by Raymond Wan (rwan.work@gmail.com)
+//    https://github.com/rwanwork/QScores-Archiver
+//
+//  This file is part of QScores-Archiver.
+//
+//  QScores-Archiver is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public License
+//  as published by the Free Software Foundation; either version
+//  3 of the License, or (at your option) any later version.
+//
+//  QScores-Archiver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with QScores-Archiver; if not, see
+//  <http://www.gnu.org/licenses/>.
+//  ###########################################################################
+
+
+/*******************************************************************/
+/*!
+    \file testing.cpp
+    Testing functions of main-test.
+*/
+/*******************************************************************/
+
+#include <fstream>  //  ostream
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>  //  sort
+#include <iostream>
+#include <cstdlib>  //  EXIT_SUCCESS, EXIT_FAILURE, exit ()
+
+using namespace std;
+
+#include "Rans_Config.hpp"
+#include "common.hpp"
+#include "bitbuffer.hpp"
+#include "huffman.hpp"
+#include "rans.hpp"
+#include "testing.hpp"
+
+
+/*!
+     Compare two vectors
+
+     \return true if the vectors are the same; false otherwise
+*/
+bool VectorSame (vector<unsigned int> x, vector<unsigned int> y) {
+  if (x.size () != y.size ()) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < x.size (); i++) {
+    if (x[i] != y[i]) {
+      cerr << "EE\tMismatch at position " << i << endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*!
+     Encode a message with rANS coding, followed by a marker, and then decode it a random number of
+     symbols at a time.
+
+     \param[in] tmp The message to encode
+     \param[in] states The number of interleaved states
+     \param[out] tmp2 The decoded message
+     \param[out] bits The number of bits used by the prelude and the message
+     \return true if the marker was read correctly after the message; false otherwise
+*/
+static bool RansRoundTrip (const vector<unsigned int> &tmp, unsigned int states, vector<unsigned int> &tmp2, unsigned long long &bits) {
+  string str = "tmp.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the message
+
+  //  Test encoding
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  Rans rc_out;
+  rc_out.SetStates (states);
+  rc_out.UpdateFrequencies (tmp);
+  rc_out.EncodeBegin (bitbuff_out);
+  rc_out.EncodeMessage (bitbuff_out, tmp);
+  rc_out.EncodeFinish (bitbuff_out);
+  cout << rc_out << endl;
+  bits = bitbuff_out.GetBitPosition ();
+  bitbuff_out.WriteBits (marker, 16);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding " << tmp.size () << " symbols with " << states << " states in " << bits << " bits..." << endl;
+
+  //  Test decoding
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  Rans rc_in;
+  rc_in.DecodeBegin (bitbuff_in);
+  while (tmp2.size () < rc_in.GetMessageLength ()) {
+    rc_in.DecodeMessage (bitbuff_in, (rand () % 100) + 1, tmp2);
+  }
+  rc_in.DecodeFinish (bitbuff_in);
+  unsigned int marker_in = bitbuff_in.ReadBits (16);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  return (marker_in == marker);
+}
+
+
+/*!
+     Encode a message with tANS coding, followed by a marker, and then decode it a random number of
+     symbols at a time.
+
+     \param[in] tmp The message to encode
+     \param[out] tmp2 The decoded message
+     \param[out] bits The number of bits used by the prelude and the message
+     \return true if the marker was read correctly after the message; false otherwise
+*/
+static bool TansRoundTrip (const vector<unsigned int> &tmp, vector<unsigned int> &tmp2, unsigned long long &bits) {
+  string str = "tmp.data";  //  Input/output filename
+  const unsigned int marker = 0x5a5a;  //  Value written after the message
+
+  //  Test encoding
+  BitBuffer bitbuff_out;
+  bitbuff_out.Initialize (str, e_MODE_WRITE);
+  Tans tc_out;
+  tc_out.UpdateFrequencies (tmp);
+  tc_out.EncodeBegin (bitbuff_out);
+  unsigned long long prelude_bits = bitbuff_out.GetBitPosition ();
+  tc_out.EncodeMessage (bitbuff_out, tmp);
+  tc_out.EncodeFinish (bitbuff_out);
+  bits = bitbuff_out.GetBitPosition ();
+  bitbuff_out.WriteBits (marker, 16);
+  bitbuff_out.Finish ();
+  cerr << "II\tFinished encoding " << tmp.size () << " symbols with " << (1U << tc_out.GetTableBits ()) << " states in " << bits << " bits (" << prelude_bits << " + " << tc_out.GetEstimatedBits () << " estimated)..." << endl;
+
+  //  Test decoding
+  BitBuffer bitbuff_in;
+  bitbuff_in.Initialize (str, e_MODE_READ);
+  Tans tc_in;
+  tc_in.DecodeBegin (bitbuff_in);
+  while (tmp2.size () < tc_in.GetMessageLength ()) {
+    tc_in.DecodeMessage (bitbuff_in, (rand () % 100) + 1, tmp2);
+  }
+  tc_in.DecodeFinish (bitbuff_in);
+  unsigned int marker_in = bitbuff_in.ReadBits (16);
+  bitbuff_in.Finish ();
+  cerr << "II\tFinished decoding... " << tmp2.size () << " symbols." << endl;
+
+  return (marker_in == marker);
+}
+
+
+/*!
+     Read the quality scores of a file with one read on each line as symbols from 1.
+
+     \param[in] fn The name of the file
+     \return The quality scores of all of the reads, one after the other
+*/
+static vector<unsigned int> ReadSampleData (const string &fn) {
+  vector<unsigned int> x;
+  ifstream in (fn.c_str ());
+  string line;
+
+  while (getline (in, line)) {
+    for (unsigned int i = 0; i < line.size (); i++) {
+      x.push_back (static_cast<unsigned int> (line[i] - '!') + 1);
+    }
+  }
+
+  return x;
+}
+
+
+/*!
+     Remap the symbols so that the most frequent is 1, the next is 2, etc., as the --freqorder option
+     does.
+
+     \param[in] x The symbols to remap
+     \return The remapped symbols
+*/
+static vector<unsigned int> FrequencyOrder (const vector<unsigned int> &x) {
+  vector<unsigned int> counts (g_MAX_ASCII + 1, 0);
+  vector<unsigned int> order;
+  vector<unsigned int> rank (g_MAX_ASCII + 1, 0);
+  vector<unsigned int> y;
+
+  for (unsigned int i = 0; i < x.size (); i++) {
+    counts[x[i]]++;
+  }
+  for (unsigned int sym = 1; sym <= g_MAX_ASCII; sym++) {
+    if (counts[sym] != 0) {
+      order.push_back (sym);
+    }
+  }
+  stable_sort (order.begin (), order.end (), [&counts] (unsigned int a, unsigned int b) { return (counts[a] > counts[b]); });
+  for (unsigned int i = 0; i < order.size (); i++) {
+    rank[order[i]] = i + 1;
+  }
+
+  for (unsigned int i = 0; i < x.size (); i++) {
+    y.push_back (rank[x[i]]);
+  }
+
+  return y;
+}
+
+
+/*!
+     Encode and then decode a message with Huffman coding and with tANS coding, printing the number of
+     bits and the time taken per symbol to decode it.
+
+     \param[in] name The name of the message, for printing
+     \param[in] x The message
+     \return true if both coders decode the message correctly; false otherwise
+*/
+static bool BenchmarkMessage (string name, const vector<unsigned int> &x) {
+  const unsigned int repeats = 10;  //  Number of times to decode the message
+  unsigned int len = static_cast<unsigned int> (x.size ());
+  vector<unsigned int> y;  //  The decoded message
+
+  //  Huffman coding
+  BitBuffer hm_buff_out;
+  hm_buff_out.InitializeMemory ();
+  Huffman hm_out;
+  hm_out.UpdateFrequencies (x);
+  hm_out.EncodeBegin (hm_buff_out);
+  hm_out.EncodeMessage (hm_buff_out, x);
+  hm_out.EncodeFinish (hm_buff_out);
+  hm_buff_out.Finish ();
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now ();
+  for (unsigned int r = 0; r < repeats; r++) {
+    BitBuffer bitbuff_in;
+    bitbuff_in.InitializeMemory (hm_buff_out.GetMemory (), hm_buff_out.GetMemoryBytes ());
+    Huffman hm_in;
+    hm_in.DecodeBegin (bitbuff_in);
+    y.clear ();
+    hm_in.DecodeMessage (bitbuff_in, len, y);
+    hm_in.DecodeFinish (bitbuff_in);
+    bitbuff_in.Finish ();
+  }
+  chrono::steady_clock::time_point middle = chrono::steady_clock::now ();
+  if (!VectorSame (x, y)) {
+    cerr << "EE\tHuffman coding of " << name << " unsuccessful!" << endl;
+    return (false);
+  }
+
+  //  tANS coding
+  BitBuffer tc_buff_out;
+  tc_buff_out.InitializeMemory ();
+  Tans tc_out;
+  tc_out.UpdateFrequencies (x);
+  tc_out.EncodeBegin (tc_buff_out);
+  tc_out.EncodeMessage (tc_buff_out, x);
+  tc_out.EncodeFinish (tc_buff_out);
+  tc_buff_out.Finish ();
+
+  chrono::steady_clock::time_point middle2 = chrono::steady_clock::now ();
+  for (unsigned int r = 0; r < repeats; r++) {
+    BitBuffer bitbuff_in;
+    bitbuff_in.InitializeMemory (tc_buff_out.GetMemory (), tc_buff_out.GetMemoryBytes ());
+    Tans tc_in;
+    tc_in.DecodeBegin (bitbuff_in);
+    y.clear ();
+    tc_in.DecodeMessage (bitbuff_in, len, y);
+    tc_in.DecodeFinish (bitbuff_in);
+    bitbuff_in.Finish ();
+  }
+  chrono::steady_clock::time_point end = chrono::steady_clock::now ();
+  if (!VectorSame (x, y)) {
+    cerr << "EE\ttANS coding of " << name << " unsuccessful!" << endl;
+    return (false);
+  }
+
+  double hm_ns = chrono::duration<double, nano> (middle - start).count () / (static_cast<double> (len) * repeats);
+  double tc_ns = chrono::duration<double, nano> (end - middle2).count () / (static_cast<double> (len) * repeats);
+  cerr << "II\t" << name << " (" << len << " symbols):" << endl;
+  cerr << "II\t  Huffman:  " << hm_buff_out.GetMemoryBits () << " bits, " << hm_ns << " ns per symbol decoded" << endl;
+  cerr << "II\t  tANS:     " << tc_buff_out.GetMemoryBits () << " bits, " << tc_ns << " ns per symbol decoded" << endl;
+
+  return (true);
+}
+
+
+/*!
+     Show basic information about the program
+
+     \return Always returns true
+*/
+bool ShowInfo () {
+  cout << "Rans version " << RANS_PROGRAM_VERSION << " compiled on:  " << __DATE__ <<  " (" << __TIME__ << ")" << endl;
+  cout << "Git hash:  " << RANS_GIT_HASH << endl;
+
+  cout << "II\tShowInfo successful!" << endl;
+
+  return (true);
+}
+
+
+/*!
+     Simple example with only one symbol in the alphabet and fewer symbols than states.
+
+     \return true if the symbols are decoded correctly; false otherwise
+*/
+bool RansSimpleExample () {
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+  unsigned long long bits = 0;
+
+  //  Generate test data
+  for (unsigned int i = 0; i < 11; i++) {
+    tmp.push_back (10);
+  }
+
+  if ((!RansRoundTrip (tmp, g_RANS_MAX_STATES, tmp2, bits)) || (!VectorSame (tmp, tmp2))) {
+    cerr << "EE\trANS coding of one symbol unsuccessful!" << endl;
+    return (false);
+  }
+
+  cerr << "II\trANS coding of one symbol successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     rANS code a set of random numbers with each number of states.
+
+     \return true if the numbers are decoded correctly; false otherwise
+*/
+bool RansRandom () {
+  vector<unsigned int> tmp;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data
+  for (unsigned int i = 0; i < g_TEST_SIZE; i++) {
+    unsigned int pos = (rand () % g_MAX_ASCII) + 1;  //  Avoid a 0 from appearing
+    tmp.push_back (pos);
+  }
+
+  for (unsigned int states = 1; states <= g_RANS_MAX_STATES; states *= 2) {
+    vector<unsigned int> tmp2;
+    unsigned long long bits = 0;
+
+    if ((!RansRoundTrip (tmp, states, tmp2, bits)) || (!VectorSame (tmp, tmp2))) {
+      cerr << "EE\trANS coding of random numbers with " << states << " states unsuccessful!" << endl;
+      return (false);
+    }
+  }
+
+  cerr << "II\trANS coding of random numbers successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     rANS code a set of random numbers where one symbol is much more frequent than the others, as it is
+     after quality scores are binned.  As with arithmetic coding, less than 1 bit should be needed for
+     each symbol.
+
+     \return true if the numbers are decoded correctly in less than 1 bit each; false otherwise
+*/
+bool RansSkewed () {
+  vector<unsigned int> tmp;
+  vector<unsigned int> tmp2;
+  unsigned long long bits = 0;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data; about 95% of the symbols are 1
+  for (unsigned int i = 0; i < g_TEST_SIZE * 10; i++) {
+    if (rand () % 20 == 0) {
+      tmp.push_back ((rand () % 4) + 2);
+    }
+    else {
+      tmp.push_back (1);
+    }
+  }
+
+  if ((!RansRoundTrip (tmp, 4, tmp2, bits)) || (!VectorSame (tmp, tmp2))) {
+    cerr << "EE\trANS coding of skewed random numbers unsuccessful!" << endl;
+    return (false);
+  }
+
+  if (bits >= tmp.size ()) {
+    cerr << "EE\trANS coding of skewed random numbers used " << bits << " bits for " << tmp.size () << " symbols!" << endl;
+    return (false);
+  }
+
+  cerr << "II\trANS coding of skewed random numbers successful!" << endl;
+  return (true);
+}
+
+
+
+/*!
+     tANS code one symbol, a set of random numbers and a set of skewed random numbers.  The skewed
+     numbers should need less than 1 bit each, as with rANS coding.
+
+     \return true if the numbers are decoded correctly; false otherwise
+*/
+bool TansRandom () {
+  vector<unsigned int> one;
+  vector<unsigned int> uniform;
+  vector<unsigned int> skewed;
+
+  unsigned long long int seed = time (NULL);
+  srand (seed);
+  cerr << "II\tSeed:  " << seed << endl;
+
+  //  Generate test data
+  for (unsigned int i = 0; i < 11; i++) {
+    one.push_back (10);
+  }
+  for (unsigned int i = 0; i < g_TEST_SIZE; i++) {
+    uniform.push_back ((rand () % g_MAX_ASCII) + 1);  //  Avoid a 0 from appearing
+  }
+  for (unsigned int i = 0; i < g_TEST_SIZE * 10; i++) {
+    skewed.push_back ((rand () % 20 == 0) ? (rand () % 4) + 2 : 1);
+  }
+
+  vector<unsigned int> tmp2;
+  unsigned long long bits = 0;
+  if ((!TansRoundTrip (one, tmp2, bits)) || (!VectorSame (one, tmp2))) {
+    cerr << "EE\ttANS coding of one symbol unsuccessful!" << endl;
+    return (false);
+  }
+
+  tmp2.clear ();
+  if ((!TansRoundTrip (uniform, tmp2, bits)) || (!VectorSame (uniform, tmp2))) {
+    cerr << "EE\ttANS coding of random numbers unsuccessful!" << endl;
+    return (false);
+  }
+
+  tmp2.clear ();
+  if ((!TansRoundTrip (skewed, tmp2, bits)) || (!VectorSame (skewed, tmp2))) {
+    cerr << "EE\ttANS coding of skewed random numbers unsuccessful!" << endl;
+    return (false);
+  }
+  if (bits >= skewed.size ()) {
+    cerr << "EE\ttANS coding of skewed random numbers used " << bits << " bits for " << skewed.size () << " symbols!" << endl;
+    return (false);
+  }
+
+  cerr << "II\ttANS coding of random numbers successful!" << endl;
+  return (true);
+}
+
+
+/*!
+     Compare Huffman coding and tANS coding on the sample quality scores, as they are and after they
+     are remapped by frequency and binned into 8 levels, which leaves a small alphabet.
+
+     \return true if the quality scores are decoded correctly; false otherwise
+*/
+bool TansBenchmark () {
+  vector<unsigned int> x = ReadSampleData (RANS_SAMPLE_DATA);
+  vector<unsigned int> binned;
+
+  if (x.empty ()) {
+    cerr << "EE\tCould not read the sample data from " << RANS_SAMPLE_DATA << "." << endl;
+    return (false);
+  }
+
+  for (unsigned int i = 0; i < x.size (); i++) {
+    binned.push_back (((x[i] - 1) / 11) + 1);
+  }
+
+  if ((!BenchmarkMessage ("Sample", x)) ||
+      (!BenchmarkMessage ("Sample, remapped by frequency", FrequencyOrder (x))) ||
+      (!BenchmarkMessage ("Sample, binned into 8 levels and remapped", FrequencyOrder (binned)))) {
+    return (false);
+  }
+
+  cerr << "II\tTansBenchmark successful!" << endl;
+  return (true);
+}